@@ -32,6 +32,14 @@ namespace MSDParser
 		return FileReader::define_directives;
 	}
 	
+	// Clears the list of read files, which would otherwise make any "include" directive fail when the same input is loaded again.
+	// The definitions are replaced as well, e.g. by those given on the commandline, as the "define" directives of the input would be duplicates.
+	void FileReader::Reset(const std::map<std::string, std::string>& _definitions)
+	{
+		FileReader::filelist.clear();
+		FileReader::define_directives = _definitions;
+	}
+	
 	// Extracts the path from the filename
 	std::string FileReader::PathFromFileName(const std::string& _filename)
 	{
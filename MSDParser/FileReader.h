@@ -78,6 +78,7 @@ namespace MSDParser
 		static std::vector<std::string> GetFileList();
 		static std::map<std::string, std::string> GetDefinitions();
 		static bool AddDefinition(const std::string &, const std::string &_value = "");
+		static void Reset(const std::map<std::string, std::string> &_definitions = std::map<std::string, std::string>()); // Forgets the read files and replaces the definitions, such that the same input can be loaded again
 	};
 }
 
@@ -224,6 +224,12 @@ namespace RunSection
 		return this->runsection.settings;
 	}
 
+	// Returns true if the task is a copy that runs only some of the steps, and its output is written by the task of another RunSection
+	bool BasicTask::IsOutputBuffered() const
+	{
+		return this->runsection.bufferOutput;
+	}
+
 	// Method that provides access to spin systems
 	std::vector<std::shared_ptr<SpinAPI::SpinSystem>> BasicTask::SpinSystems() const // TODO: Make the shared_ptrs point to const SpinSystems
 	{
@@ -260,6 +266,25 @@ namespace RunSection
 		return this->runsection.WriteOutput(_stream);
 	}
 
+	// Checks for groups of equivalent spins, for tasks that sample or diagonalize the reduced basis without the multiplicities of its blocks
+	bool BasicTask::HasEquivalentSpins()
+	{
+		bool hasEquivalentSpins = false;
+		for (auto i = this->runsection.systems.cbegin(); i != this->runsection.systems.cend(); i++)
+		{
+			for (auto j = (*i)->spins_cbegin(); j != (*i)->spins_cend(); j++)
+			{
+				if ((*j)->Equivalent() > 1)
+				{
+					this->Log() << "ERROR: Spin \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\" represents " << (*j)->Equivalent() << " equivalent spins, which is not supported by this task." << std::endl;
+					hasEquivalentSpins = true;
+				}
+			}
+		}
+
+		return hasEquivalentSpins;
+	}
+
 	// Sets a reference to the requested ActionScalar
 	bool BasicTask::Scalar(std::string _name, ActionScalar **_scalar)
 	{
@@ -411,5 +436,15 @@ namespace RunSection
 	{
 		return this->output.SetDataStream(_stream);
 	}
+
+	// Writes log and data output as-is, the messages were already filtered by the notification level of the task that produced them
+	void BasicTask::WriteBufferedOutput(const std::string &_log, const std::string &_data)
+	{
+		if (!_log.empty())
+			this->output.Log(MessageType_Critical) << _log << std::flush;
+
+		if (!_data.empty())
+			this->output.Data() << _data << std::flush;
+	}
 	// -----------------------------------------------------
 }
@@ -58,12 +58,14 @@ namespace RunSection
 
 		// Allow access to settings, properties, spin systems, etc. for derived classes
 		std::shared_ptr<const Settings> RunSettings() const;
+		bool IsOutputBuffered() const; // Whether the output is kept in memory, i.e. for the copies of the task that run the steps of "--parallel-steps"
 		std::vector<SpinAPI::system_ptr> SpinSystems() const;
 		const std::shared_ptr<MSDParser::ObjectParser> &Properties() const;
 		std::ostream &Log(const MessageType &_msgtype = MessageType_Normal);
 		std::ostream &Data();
 		bool WriteStandardOutputHeader(std::ostream &);
 		bool WriteStandardOutput(std::ostream &);
+		bool HasEquivalentSpins(); // Whether a spin in any of the spin systems represents a group of equivalent spins, which is written to the log
 
 		// ActionTarget access
 		bool Scalar(std::string _name, ActionScalar **_scalar = nullptr);
@@ -89,6 +91,9 @@ namespace RunSection
 		// Methods to change the Log and Data stream
 		bool SetLogStream(std::ostream &);
 		bool SetDataStream(std::ostream &);
+
+		// Writes output that was produced by a copy of the task, e.g. when running steps in parallel
+		void WriteBufferedOutput(const std::string &, const std::string &);
 	};
 }
 
@@ -0,0 +1,256 @@
+/////////////////////////////////////////////////////////////////////////
+// OrientationGrid implementation (RunSection module)
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include "OrientationGrid.h"
+
+namespace RunSection
+{
+	// -----------------------------------------------------
+	// OrientationGrid Constructors and Destructor
+	// -----------------------------------------------------
+	OrientationGrid::OrientationGrid() : directions(), weights(), gammaPoints(1)
+	{
+	}
+
+	OrientationGrid::OrientationGrid(const std::string &_type, unsigned int _points, unsigned int _gammaPoints) : directions(), weights(), gammaPoints(1)
+	{
+		this->Create(_type, _points, _gammaPoints);
+	}
+
+	OrientationGrid::OrientationGrid(const OrientationGrid &_grid) : directions(_grid.directions), weights(_grid.weights), gammaPoints(_grid.gammaPoints)
+	{
+	}
+
+	OrientationGrid::~OrientationGrid()
+	{
+	}
+	// -----------------------------------------------------
+	// Operators
+	// -----------------------------------------------------
+	const OrientationGrid &OrientationGrid::operator=(const OrientationGrid &_grid)
+	{
+		this->directions = _grid.directions;
+		this->weights = _grid.weights;
+		this->gammaPoints = _grid.gammaPoints;
+
+		return (*this);
+	}
+	// -----------------------------------------------------
+	// Public methods
+	// -----------------------------------------------------
+	bool OrientationGrid::Create(const std::string &_type, unsigned int _points, unsigned int _gammaPoints)
+	{
+		this->directions.clear();
+		this->weights.clear();
+		this->gammaPoints = 1;
+
+		if (_gammaPoints < 1)
+			return false;
+		this->gammaPoints = _gammaPoints;
+
+		if (_type.compare("zcw") == 0)
+			return this->CreateZCW(_points);
+		else if (_type.compare("lebedev") == 0)
+			return this->CreateLebedev(_points);
+
+		return false;
+	}
+
+	// The rotation that takes the z-axis into the direction, after the rotation by the gamma angle about the z-axis
+	arma::mat OrientationGrid::Rotation(unsigned int _i) const
+	{
+		return this->Rotation(_i, arma::vec({0.0, 0.0, 1.0}));
+	}
+
+	// The rotation by the gamma angle of the grid point about the vector, followed by the rotation that takes the vector into the direction.
+	// Only the direction of the vector matters, and the z-axis is used for a vector of zero length.
+	arma::mat OrientationGrid::Rotation(unsigned int _i, const arma::vec &_vector) const
+	{
+		double length = arma::norm(_vector);
+		arma::vec u = (length > 0.0) ? arma::vec(_vector / length) : arma::vec({0.0, 0.0, 1.0});
+
+		// Rodrigues' formula for the rotation about u
+		double gamma = this->Gamma(_i);
+		arma::mat K(3, 3, arma::fill::zeros);
+		K(0, 1) = -u(2);
+		K(0, 2) = u(1);
+		K(1, 0) = u(2);
+		K(1, 2) = -u(0);
+		K(2, 0) = -u(1);
+		K(2, 1) = u(0);
+		arma::mat G = arma::mat(3, 3, arma::fill::eye) + std::sin(gamma) * K + (1.0 - std::cos(gamma)) * K * K;
+
+		return RotationOnto(u, this->Direction(_i)) * G;
+	}
+	// -----------------------------------------------------
+	// Private methods
+	// -----------------------------------------------------
+	// Full sphere ZCW grid with a Fibonacci number of points, see M. Eden and M. H. Levitt, J. Magn. Reson. 132, 220 (1998)
+	bool OrientationGrid::CreateZCW(unsigned int _points)
+	{
+		// Find the smallest Fibonacci number (at least 8) that gives the requested number of points
+		unsigned int previous = 3;
+		unsigned int current = 5;
+		unsigned int next = 8;
+		while (next < _points)
+		{
+			previous = current;
+			current = next;
+			next = previous + current;
+		}
+
+		// The azimuthal angles are generated by the Fibonacci number two below the number of points
+		const unsigned int N = next;
+		const unsigned int g = next - current;
+		for (unsigned int j = 0; j < N; j++)
+		{
+			double cosbeta = 2.0 * static_cast<double>(j) / static_cast<double>(N) - 1.0;
+			double sinbeta = std::sqrt(std::max(0.0, 1.0 - cosbeta * cosbeta));
+			double alpha = 2.0 * M_PI * std::fmod(static_cast<double>(j) * static_cast<double>(g) / static_cast<double>(N), 1.0);
+			this->directions.push_back(arma::vec({sinbeta * std::cos(alpha), sinbeta * std::sin(alpha), cosbeta}));
+			this->weights.push_back(1.0 / static_cast<double>(N));
+		}
+
+		return true;
+	}
+
+	// Lebedev grids, see V. I. Lebedev and D. N. Laikov, Doklady Mathematics 59, 477 (1999)
+	// The smallest tabulated grid with at least the requested number of points is used
+	bool OrientationGrid::CreateLebedev(unsigned int _points)
+	{
+		if (_points <= 6)
+		{
+			this->AddLebedevPoints(1, 0.0, 1.0 / 6.0);
+		}
+		else if (_points <= 14)
+		{
+			this->AddLebedevPoints(1, 0.0, 1.0 / 15.0);
+			this->AddLebedevPoints(3, 0.0, 3.0 / 40.0);
+		}
+		else if (_points <= 26)
+		{
+			this->AddLebedevPoints(1, 0.0, 1.0 / 21.0);
+			this->AddLebedevPoints(2, 0.0, 4.0 / 105.0);
+			this->AddLebedevPoints(3, 0.0, 9.0 / 280.0);
+		}
+		else if (_points <= 38)
+		{
+			this->AddLebedevPoints(1, 0.0, 1.0 / 105.0);
+			this->AddLebedevPoints(3, 0.0, 9.0 / 280.0);
+			this->AddLebedevPoints(5, 0.4597008433809831, 1.0 / 35.0);
+		}
+		else if (_points <= 50)
+		{
+			this->AddLebedevPoints(1, 0.0, 4.0 / 315.0);
+			this->AddLebedevPoints(2, 0.0, 64.0 / 2835.0);
+			this->AddLebedevPoints(3, 0.0, 27.0 / 1280.0);
+			this->AddLebedevPoints(4, 1.0 / std::sqrt(11.0), 14641.0 / 725760.0);
+		}
+		else if (_points <= 74)
+		{
+			this->AddLebedevPoints(1, 0.0, 0.5130671797338464e-3);
+			this->AddLebedevPoints(2, 0.0, 0.1660406956574204e-1);
+			this->AddLebedevPoints(3, 0.0, -0.2958603896103896e-1);
+			this->AddLebedevPoints(4, 0.4803844614152614, 0.2657620708215946e-1);
+			this->AddLebedevPoints(5, 0.3207726489807764, 0.1652217099371571e-1);
+		}
+		else if (_points <= 86)
+		{
+			this->AddLebedevPoints(1, 0.0, 0.1154401154401154e-1);
+			this->AddLebedevPoints(3, 0.0, 0.1194390908585628e-1);
+			this->AddLebedevPoints(4, 0.3696028464541502, 0.1111055571060340e-1);
+			this->AddLebedevPoints(4, 0.6943540066026664, 0.1187650129453714e-1);
+			this->AddLebedevPoints(5, 0.3742430390903412, 0.1181230374690448e-1);
+		}
+		else if (_points <= 110)
+		{
+			this->AddLebedevPoints(1, 0.0, 0.3828270494937162e-2);
+			this->AddLebedevPoints(3, 0.0, 0.9793737512487512e-2);
+			this->AddLebedevPoints(4, 0.1851156353447362, 0.8211737283191111e-2);
+			this->AddLebedevPoints(4, 0.6904210483822922, 0.9942814891178103e-2);
+			this->AddLebedevPoints(4, 0.3956894730559419, 0.9595471336070963e-2);
+			this->AddLebedevPoints(5, 0.4783690288121502, 0.9694996361663028e-2);
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	// The generators are numbered as in the tables of Lebedev: (1,0,0), (0,a,a), (a,a,a), (l,l,m) and (p,q,0)
+	void OrientationGrid::AddLebedevPoints(unsigned int _generator, double _parameter, double _weight)
+	{
+		arma::vec generator(3, arma::fill::zeros);
+		if (_generator == 1)
+			generator = {1.0, 0.0, 0.0};
+		else if (_generator == 2)
+			generator = {0.0, 1.0 / std::sqrt(2.0), 1.0 / std::sqrt(2.0)};
+		else if (_generator == 3)
+			generator = {1.0 / std::sqrt(3.0), 1.0 / std::sqrt(3.0), 1.0 / std::sqrt(3.0)};
+		else if (_generator == 4)
+			generator = {_parameter, _parameter, std::sqrt(1.0 - 2.0 * _parameter * _parameter)};
+		else if (_generator == 5)
+			generator = {_parameter, std::sqrt(1.0 - _parameter * _parameter), 0.0};
+		else
+			return;
+
+		// All permutations of the coordinates with all combinations of signs, without duplicates
+		const unsigned int permutations[6][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}};
+		const unsigned int first = static_cast<unsigned int>(this->directions.size());
+		for (unsigned int p = 0; p < 6; p++)
+		{
+			for (unsigned int signs = 0; signs < 8; signs++)
+			{
+				arma::vec point(3);
+				for (unsigned int k = 0; k < 3; k++)
+					point(k) = ((signs >> k) & 1 ? -1.0 : 1.0) * generator(permutations[p][k]);
+
+				bool duplicate = false;
+				for (unsigned int i = first; i < this->directions.size() && !duplicate; i++)
+					duplicate = arma::norm(this->directions[i] - point) < 1e-12;
+
+				if (!duplicate)
+				{
+					this->directions.push_back(point);
+					this->weights.push_back(_weight);
+				}
+			}
+		}
+	}
+
+	// The rotation about the axis perpendicular to both unit vectors, such that the first vector is rotated into the second
+	arma::mat OrientationGrid::RotationOnto(const arma::vec &_from, const arma::vec &_to)
+	{
+		arma::mat R(3, 3, arma::fill::eye);
+		double c = arma::dot(_from, _to);
+
+		// Antiparallel vectors, rotate by 180 degrees about an axis perpendicular to the first vector
+		if (c < -1.0 + 1e-12)
+		{
+			arma::vec axis = arma::cross(_from, (std::abs(_from(0)) < 0.9) ? arma::vec({1.0, 0.0, 0.0}) : arma::vec({0.0, 1.0, 0.0}));
+			axis /= arma::norm(axis);
+			return 2.0 * axis * axis.t() - R;
+		}
+
+		// Rodrigues' formula with k = from x to, written without normalising k: R = I + [k]x + [k]x^2 / (1 + cos(angle))
+		arma::vec k = arma::cross(_from, _to);
+		arma::mat K(3, 3, arma::fill::zeros);
+		K(0, 1) = -k(2);
+		K(0, 2) = k(1);
+		K(1, 0) = k(2);
+		K(1, 2) = -k(0);
+		K(2, 0) = -k(1);
+		K(2, 1) = k(0);
+		R += K + K * K / (1.0 + c);
+
+		return R;
+	}
+	// -----------------------------------------------------
+}
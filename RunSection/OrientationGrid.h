@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////////////
+// OrientationGrid (RunSection module)
+// ------------------
+// A set of directions on the unit sphere with quadrature weights, used
+// to average the output of the tasks over the orientations of a sample
+// (e.g. the yields of a powder sample). The ZCW (Zaremba-Conroy-Wolfsberg)
+// grids can have any size, while the Lebedev grids are exact for
+// polynomials up to a certain degree and are tabulated up to 110 points.
+// Each direction can be combined with several equally spaced angles
+// (gamma) about the rotated vector, which is needed to average over all
+// orientations when more than one vector is rotated.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#ifndef MOD_RunSection_OrientationGrid
+#define MOD_RunSection_OrientationGrid
+
+#include <string>
+#include <vector>
+#include <armadillo>
+
+namespace RunSection
+{
+	class OrientationGrid
+	{
+	private:
+		// Implementation
+		std::vector<arma::vec> directions;
+		std::vector<double> weights;
+		unsigned int gammaPoints; // Number of angles about the rotated vector for each direction
+
+		// Private methods to create the grids
+		bool CreateZCW(unsigned int);
+		bool CreateLebedev(unsigned int);
+		void AddLebedevPoints(unsigned int, double, double); // Adds all points generated by the octahedral symmetry from a generator
+		static arma::mat RotationOnto(const arma::vec &, const arma::vec &); // Rotation about the common perpendicular that takes the first unit vector into the second
+
+	public:
+		// Constructors / Destructors
+		OrientationGrid();									 // Default constructor, creates an empty grid
+		OrientationGrid(const std::string &, unsigned int, unsigned int _gammaPoints = 1); // Normal constructor, see Create
+		OrientationGrid(const OrientationGrid &);			 // Copy-constructor
+		~OrientationGrid();									 // Destructor
+
+		// Operators
+		const OrientationGrid &operator=(const OrientationGrid &); // Copy-assignment
+
+		// Creates a "zcw" or "lebedev" grid with at least the given number of directions, each combined with the given number of gamma angles.
+		// The weights sum to 1.
+		bool Create(const std::string &, unsigned int, unsigned int _gammaPoints = 1);
+
+		// Public const methods, the points are numbered such that the gamma angles of a direction are consecutive
+		unsigned int Size() const { return static_cast<unsigned int>(this->directions.size()) * this->gammaPoints; }
+		unsigned int GammaPoints() const { return this->gammaPoints; }
+		const arma::vec &Direction(unsigned int _i) const { return this->directions[_i / this->gammaPoints]; }
+		double Gamma(unsigned int _i) const { return 2.0 * M_PI * static_cast<double>(_i % this->gammaPoints) / static_cast<double>(this->gammaPoints); }
+		double Weight(unsigned int _i) const { return this->weights[_i / this->gammaPoints] / static_cast<double>(this->gammaPoints); }
+		arma::mat Rotation(unsigned int) const;						  // Rotation matrix that takes the z-axis into the direction of the grid point
+		arma::mat Rotation(unsigned int, const arma::vec &) const; // Rotation matrix that takes the given vector into the direction of the grid point
+	};
+}
+
+#endif
@@ -0,0 +1,179 @@
+/////////////////////////////////////////////////////////////////////////
+// OutputAverage implementation (RunSection module)
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include "OutputAverage.h"
+
+namespace RunSection
+{
+	// -----------------------------------------------------
+	// OutputAverage Constructors and Destructor
+	// -----------------------------------------------------
+	OutputAverage::OutputAverage() : separators(), tokens(), sums(), numerical(), varying(), totalWeight(0.0), count(0)
+	{
+	}
+
+	OutputAverage::OutputAverage(const OutputAverage &_average) : separators(_average.separators), tokens(_average.tokens), sums(_average.sums), numerical(_average.numerical),
+																  varying(_average.varying), totalWeight(_average.totalWeight), count(_average.count)
+	{
+	}
+
+	OutputAverage::~OutputAverage()
+	{
+	}
+	// -----------------------------------------------------
+	// Operators
+	// -----------------------------------------------------
+	const OutputAverage &OutputAverage::operator=(const OutputAverage &_average)
+	{
+		this->separators = _average.separators;
+		this->tokens = _average.tokens;
+		this->sums = _average.sums;
+		this->numerical = _average.numerical;
+		this->varying = _average.varying;
+		this->totalWeight = _average.totalWeight;
+		this->count = _average.count;
+
+		return (*this);
+	}
+	// -----------------------------------------------------
+	// Public methods
+	// -----------------------------------------------------
+	bool OutputAverage::Add(const std::string &_output, double _weight)
+	{
+		std::vector<std::string> newSeparators;
+		std::vector<std::string> newTokens;
+		Split(_output, newSeparators, newTokens);
+
+		// The first output defines the layout
+		if (this->count == 0)
+		{
+			this->separators = newSeparators;
+			this->tokens = newTokens;
+			this->sums.assign(newTokens.size(), 0.0);
+			this->numerical.assign(newTokens.size(), true);
+			this->varying.assign(newTokens.size(), false);
+		}
+		else if (newTokens.size() != this->tokens.size())
+		{
+			return false;
+		}
+
+		bool matches = true;
+		for (unsigned int i = 0; i < newTokens.size(); i++)
+		{
+			// Only tokens that are read completely as a number can be averaged
+			char *end = nullptr;
+			double value = std::strtod(newTokens[i].c_str(), &end);
+			this->numerical[i] = this->numerical[i] && (*end == '\0');
+			this->sums[i] += _weight * value;
+
+			if (newTokens[i].compare(this->tokens[i]) != 0)
+			{
+				this->varying[i] = true;
+				matches &= this->numerical[i];
+			}
+		}
+
+		this->totalWeight += _weight;
+		this->count++;
+
+		return matches;
+	}
+
+	bool OutputAverage::Add(const OutputAverage &_average)
+	{
+		if (_average.count == 0)
+			return true;
+
+		if (this->count == 0)
+		{
+			(*this) = _average;
+			return true;
+		}
+
+		if (_average.tokens.size() != this->tokens.size())
+			return false;
+
+		bool matches = true;
+		for (unsigned int i = 0; i < this->tokens.size(); i++)
+		{
+			this->numerical[i] = this->numerical[i] && _average.numerical[i];
+			this->sums[i] += _average.sums[i];
+
+			if (_average.varying[i] || _average.tokens[i].compare(this->tokens[i]) != 0)
+			{
+				this->varying[i] = true;
+				matches &= this->numerical[i];
+			}
+		}
+
+		this->totalWeight += _average.totalWeight;
+		this->count += _average.count;
+
+		return matches;
+	}
+
+	void OutputAverage::Clear()
+	{
+		this->separators.clear();
+		this->tokens.clear();
+		this->sums.clear();
+		this->numerical.clear();
+		this->varying.clear();
+		this->totalWeight = 0.0;
+		this->count = 0;
+	}
+
+	// Tokens that did not change are written as they were, such that e.g. step numbers are not affected by rounding errors
+	std::string OutputAverage::Str() const
+	{
+		std::ostringstream stream;
+		for (unsigned int i = 0; i < this->tokens.size(); i++)
+		{
+			stream << this->separators[i];
+			if (this->varying[i] && this->numerical[i])
+				stream << this->sums[i] / this->totalWeight;
+			else
+				stream << this->tokens[i];
+		}
+
+		if (!this->separators.empty())
+			stream << this->separators.back();
+
+		return stream.str();
+	}
+	// -----------------------------------------------------
+	// Private methods
+	// -----------------------------------------------------
+	// Splits the text into tokens and the whitespace in front of each of them, such that the layout of the text can be reproduced
+	void OutputAverage::Split(const std::string &_text, std::vector<std::string> &_separators, std::vector<std::string> &_tokens)
+	{
+		_separators.clear();
+		_tokens.clear();
+
+		std::string::size_type pos = 0;
+		while (true)
+		{
+			std::string::size_type start = pos;
+			while (pos < _text.size() && std::isspace(static_cast<unsigned char>(_text[pos])))
+				pos++;
+			_separators.push_back(_text.substr(start, pos - start));
+
+			if (pos >= _text.size())
+				break;
+
+			start = pos;
+			while (pos < _text.size() && !std::isspace(static_cast<unsigned char>(_text[pos])))
+				pos++;
+			_tokens.push_back(_text.substr(start, pos - start));
+		}
+	}
+	// -----------------------------------------------------
+}
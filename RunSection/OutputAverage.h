@@ -0,0 +1,55 @@
+/////////////////////////////////////////////////////////////////////////
+// OutputAverage (RunSection module)
+// ------------------
+// Weighted average of the text output that a task produced for several
+// values of its parameters, e.g. for the orientations of an
+// OrientationGrid. The outputs must have the same layout: numbers that
+// differ between the outputs are averaged, while everything else
+// (step numbers, headers, etc.) is kept as it was written.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#ifndef MOD_RunSection_OutputAverage
+#define MOD_RunSection_OutputAverage
+
+#include <string>
+#include <vector>
+
+namespace RunSection
+{
+	class OutputAverage
+	{
+	private:
+		// Implementation
+		std::vector<std::string> separators; // The whitespace before each token, and the trailing whitespace as the last element
+		std::vector<std::string> tokens;	 // The tokens of the first output that was added
+		std::vector<double> sums;			 // Weighted sum of each numerical token
+		std::vector<bool> numerical;		 // Whether the token was a number in all outputs
+		std::vector<bool> varying;			 // Whether the token differed between the outputs
+		double totalWeight;
+		unsigned int count;
+
+		// Private methods
+		static void Split(const std::string &, std::vector<std::string> &, std::vector<std::string> &);
+
+	public:
+		// Constructors / Destructors
+		OutputAverage();						// Normal constructor
+		OutputAverage(const OutputAverage &);	// Copy-constructor
+		~OutputAverage();						// Destructor
+
+		// Operators
+		const OutputAverage &operator=(const OutputAverage &); // Copy-assignment
+
+		// Public methods
+		bool Add(const std::string &, double); // Adds an output with a weight, returns false if the layout does not match the previous outputs
+		bool Add(const OutputAverage &);	   // Combines with another average, e.g. the average over another part of the grid
+		void Clear();
+		bool Empty() const { return this->count == 0; }
+		std::string Str() const; // The averaged output, where the weights are normalised
+	};
+}
+
+#endif
@@ -13,7 +13,8 @@ namespace RunSection
 	// -----------------------------------------------------
 	// Settings Constructors and Destructor
 	// -----------------------------------------------------
-	OutputHandler::OutputHandler() : log(nullptr), data(nullptr), logstream(nullptr), datastream(nullptr), ignored_messages_stream(std::make_shared<std::ostringstream>())
+	OutputHandler::OutputHandler() : log(nullptr), data(nullptr), logstream(nullptr), datastream(nullptr), ignored_messages_stream(std::make_shared<std::ostringstream>()),
+									 notificationLevel(DefaultNotificationLevel)
 	{
 	}
 
@@ -0,0 +1,178 @@
+/////////////////////////////////////////////////////////////////////////
+// PropagationSettings implementation (RunSection module)
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include "PropagationSettings.h"
+#include "ObjectParser.h"
+
+namespace RunSection
+{
+	// Definitions of the static constants, which are needed before C++17 if they are bound to references
+	constexpr int PropagationSettings::DefaultKrylovSize;
+	constexpr int PropagationSettings::DefaultKrylovBlockSize;
+	constexpr double PropagationSettings::DefaultKrylovTolerance;
+	constexpr double PropagationSettings::DefaultChebyshevTolerance;
+
+	// -----------------------------------------------------
+	// PropagationSettings Constructors
+	// -----------------------------------------------------
+	PropagationSettings::PropagationSettings() : method("autoexpm"), precision("single"), krylovSize(DefaultKrylovSize), krylovMaxSize(0), krylovBlockSize(DefaultKrylovBlockSize),
+												 krylovTolerance(DefaultKrylovTolerance), chebyshevTolerance(DefaultChebyshevTolerance)
+	{
+	}
+	// -----------------------------------------------------
+	// Public methods
+	// -----------------------------------------------------
+	void PropagationSettings::Read(const MSDParser::ObjectParser &_properties, bool _symmetric, const std::string &_items, std::ostream &_log)
+	{
+		this->method.clear();
+		this->precision.clear();
+		this->krylovSize = 0;
+		this->krylovMaxSize = 0;
+		this->krylovBlockSize = DefaultKrylovBlockSize;
+		this->krylovTolerance = 0.0;
+		this->chebyshevTolerance = DefaultChebyshevTolerance;
+
+		_properties.Get("propagationmethod", this->method);
+		_properties.Get("precision", this->precision);
+		_properties.Get("krylovsize", this->krylovSize);
+		_properties.Get("krylovmaxsize", this->krylovMaxSize);
+		_properties.Get("krylovblocksize", this->krylovBlockSize);
+		_properties.Get("krylovtol", this->krylovTolerance);
+		_properties.Get("chebyshevtol", this->chebyshevTolerance);
+
+		if (this->krylovBlockSize < 1)
+			this->krylovBlockSize = 1;
+
+		if (this->method == "autoexpm")
+		{
+			_log << "Autoexpm is chosen as the propagation method." << std::endl;
+			if (this->precision == "double")
+			{
+				_log << "Double precision is chosen for the autoexpm method." << std::endl;
+			}
+			else if (this->precision == "single")
+			{
+				_log << "Single precision is chosen for the autoexpm method." << std::endl;
+			}
+			else if (this->precision == "half")
+			{
+				_log << "Half precision is chosen for the autoexpm method." << std::endl;
+			}
+			else
+			{
+				std::cout << "# ERROR: undefined precision. Using single digit precision!" << std::endl;
+				_log << "No precision for autoexpm method was defined. Using single digit precision." << std::endl;
+				this->precision = "single";
+			}
+		}
+		else if (this->method == "krylov")
+		{
+			_log << "Up to " << this->krylovBlockSize << " " << _items << " are propagated together in the krylov subspace method." << std::endl;
+			if (this->krylovSize > 0)
+			{
+				_log << "Krylov basis size is chosen as " << this->krylovSize << "." << std::endl;
+			}
+			else
+			{
+				std::cout << "# ERROR: undefined size of the krylov subspace! Using the default size of " << DefaultKrylovSize << "." << std::endl;
+				_log << "Undefined size of the krylov subspace. Using the default size of " << DefaultKrylovSize << "." << std::endl;
+				this->krylovSize = DefaultKrylovSize;
+			}
+
+			if (this->krylovTolerance > 0)
+			{
+				_log << "Tolerance for krylov propagation is chosen as " << this->krylovTolerance << "." << std::endl;
+			}
+			else
+			{
+				std::cout << "# ERROR: undefined tolerance for krylov subspace propagation! Using the default of " << DefaultKrylovTolerance << "." << std::endl;
+				_log << "Undefined tolerance for the krylov subspace. Using the default of " << DefaultKrylovTolerance << "." << std::endl;
+				this->krylovTolerance = DefaultKrylovTolerance;
+			}
+
+			// The subspace dimension may grow up to twice the given size unless a maximum is specified
+			if (this->krylovMaxSize < this->krylovSize)
+				this->krylovMaxSize = 2 * this->krylovSize;
+			_log << "The krylov subspace dimension is adapted between " << this->krylovSize << " and " << this->krylovMaxSize << " for symmetric propagation." << std::endl;
+		}
+		else if (this->method == "chebyshev" && _symmetric)
+		{
+			if (this->chebyshevTolerance <= 0)
+			{
+				std::cout << "# ERROR: undefined tolerance for chebyshev propagation! Using the default of " << DefaultChebyshevTolerance << "." << std::endl;
+				_log << "Undefined tolerance for the chebyshev expansion. Using the default of " << DefaultChebyshevTolerance << "." << std::endl;
+				this->chebyshevTolerance = DefaultChebyshevTolerance;
+			}
+			_log << "Tolerance for chebyshev propagation is chosen as " << this->chebyshevTolerance << "." << std::endl;
+			_log << "Up to " << this->krylovBlockSize << " " << _items << " are propagated together in the chebyshev method." << std::endl;
+		}
+		else if (this->method == "chebyshev")
+		{
+			// The expansion needs a Hermitian matrix in the exponential, which is not the case with the recombination operator
+			std::cout << "# ERROR: chebyshev propagation requires symmetric recombination, using autoexpm with single accuracy!" << std::endl;
+			_log << "The chebyshev method is only available for symmetric recombination. Using autoexpm with single accuracy." << std::endl;
+			this->method = "autoexpm";
+			this->precision = "single";
+		}
+		else
+		{
+			std::cout << "# ERROR: undefined propagation method, using autoexpm with single accuracy!" << std::endl;
+			_log << "Undefined propagation method, using autoexpm with single accuracy." << std::endl;
+			this->method = "autoexpm";
+			this->precision = "single";
+		}
+	}
+
+	void PropagationSettings::ReadSuperspace(const MSDParser::ObjectParser &_properties, std::ostream &_log)
+	{
+		this->method = "expm";
+		this->krylovSize = DefaultKrylovSize;
+		this->krylovMaxSize = 0;
+		this->krylovTolerance = DefaultKrylovTolerance;
+
+		std::string str;
+		if (_properties.Get("propagationmethod", str))
+		{
+			if (str == "expm" || str == "krylov")
+			{
+				this->method = str;
+				_log << "Setting propagation method to \"" << str << "\"." << std::endl;
+			}
+			else
+			{
+				_log << "Warning: Unknown propagation method \"" << str << "\" specified. Using the dense propagator." << std::endl;
+			}
+		}
+
+		_properties.Get("krylovsize", this->krylovSize);
+		_properties.Get("krylovmaxsize", this->krylovMaxSize);
+		_properties.Get("krylovtol", this->krylovTolerance);
+
+		if (this->krylovSize < 1)
+		{
+			if (this->method == "krylov")
+				_log << "Warning: Invalid size of the krylov subspace. Using the default size of " << DefaultKrylovSize << "." << std::endl;
+			this->krylovSize = DefaultKrylovSize;
+		}
+
+		if (!(this->krylovTolerance > 0))
+		{
+			if (this->method == "krylov")
+				_log << "Warning: Invalid tolerance for krylov subspace propagation. Using the default of " << DefaultKrylovTolerance << "." << std::endl;
+			this->krylovTolerance = DefaultKrylovTolerance;
+		}
+
+		// The subspace dimension may grow up to twice the given size unless a maximum is specified
+		if (this->krylovMaxSize < this->krylovSize)
+			this->krylovMaxSize = 2 * this->krylovSize;
+
+		if (this->method == "krylov")
+			_log << "The krylov subspace dimension is adapted between " << this->krylovSize << " and " << this->krylovMaxSize << ", with a tolerance of " << this->krylovTolerance << "." << std::endl;
+	}
+	// -----------------------------------------------------
+}
@@ -0,0 +1,52 @@
+/////////////////////////////////////////////////////////////////////////
+// PropagationSettings (RunSection module)
+// ------------------
+// The "propagationmethod", "precision", "krylov*" and "chebyshevtol"
+// properties shared by the static Hilbert space tasks and the superspace
+// time-evolution tasks. The values are read, validated and logged in one
+// place, such that all tasks use the same defaults.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#ifndef MOD_RunSection_PropagationSettings
+#define MOD_RunSection_PropagationSettings
+
+#include <ostream>
+#include <string>
+#include "MSDParserfwd.h"
+
+namespace RunSection
+{
+	class PropagationSettings
+	{
+	public:
+		// Defaults used when a property is missing or invalid
+		static constexpr int DefaultKrylovSize = 16;
+		static constexpr int DefaultKrylovBlockSize = 16;
+		static constexpr double DefaultKrylovTolerance = 1e-12;
+		static constexpr double DefaultChebyshevTolerance = 1e-12;
+
+		std::string method;		   // "autoexpm", "krylov" or "chebyshev", or "expm" or "krylov" in superspace
+		std::string precision;	   // Precision of the autoexpm method: "double", "single" or "half"
+		int krylovSize;			   // Smallest and largest dimension of the adaptive krylov subspace
+		int krylovMaxSize;
+		int krylovBlockSize;	   // Number of states propagated together by the block propagators
+		double krylovTolerance;	   // Tolerance of the krylov error estimate
+		double chebyshevTolerance; // Expansion terms with smaller coefficients are not used by the chebyshev propagator
+
+		// Constructors / Destructors
+		PropagationSettings(); // Normal constructor, sets the defaults
+
+		// Reads the properties of the task and writes the chosen settings to the log. The bool tells whether the matrix in the exponential
+		// is Hermitian, which the chebyshev method requires, and the string names what is propagated, e.g. "states" or "samples"
+		void Read(const MSDParser::ObjectParser &, bool, const std::string &, std::ostream &);
+
+		// Reads the properties of the superspace tasks, where the method is "expm" for the dense propagator or "krylov" for the action of
+		// the exponential on the sparse Liouvillian, and writes the chosen settings to the log
+		void ReadSuperspace(const MSDParser::ObjectParser &, std::ostream &);
+	};
+}
+
+#endif
@@ -5,6 +5,7 @@
 // (c) 2019 Quantum Biology and Computational Physics Group.
 // See LICENSE.txt for license information.
 /////////////////////////////////////////////////////////////////////////
+#include <sstream>
 #include "ObjectParser.h"
 #include "Settings.h"
 #include "BasicTask.h"
@@ -28,7 +29,7 @@ namespace RunSection
 	// -----------------------------------------------------
 	// RunSection Constructors and Destructor
 	// -----------------------------------------------------
-	RunSection::RunSection() : tasks(), actions(), outputs(), settings(std::make_shared<Settings>()), systems(), actionScalars(), actionVectors(), overruleAppend(false), noCalculations(false)
+	RunSection::RunSection() : tasks(), actions(), outputs(), settings(std::make_shared<Settings>()), systems(), actionScalars(), actionVectors(), overruleAppend(false), noCalculations(false), bufferOutput(false), bufferPrecision(0), bufferedLogs(), bufferedData()
 	{
 		this->settings->GetActionTargets(this->actionScalars, this->actionVectors);
 	}
@@ -83,6 +84,51 @@ namespace RunSection
 		return true;
 	}
 
+	// Writes the buffered output of the tasks to the tasks with the same position in another RunSection
+	// Used to collect the results of steps that were run in parallel on separate RunSection objects
+	bool RunSection::FlushBufferedOutput(RunSection &_target)
+	{
+		if (!this->bufferOutput || this->tasks.size() != _target.tasks.size())
+			return false;
+
+		std::vector<std::string> logs;
+		std::vector<std::string> data;
+		return this->TakeBufferedOutput(logs, data) && _target.WriteBufferedOutput(logs, data);
+	}
+
+	bool RunSection::TakeBufferedOutput(std::vector<std::string> &_logs, std::vector<std::string> &_data)
+	{
+		if (!this->bufferOutput)
+			return false;
+
+		_logs.resize(this->tasks.size());
+		_data.resize(this->tasks.size());
+		for (unsigned int i = 0; i < this->tasks.size(); i++)
+		{
+			_logs[i] = this->bufferedLogs[i]->str();
+			_data[i] = this->bufferedData[i]->str();
+
+			// Clear the buffers for the next step
+			this->bufferedLogs[i]->str("");
+			this->bufferedLogs[i]->clear();
+			this->bufferedData[i]->str("");
+			this->bufferedData[i]->clear();
+		}
+
+		return true;
+	}
+
+	bool RunSection::WriteBufferedOutput(const std::vector<std::string> &_logs, const std::vector<std::string> &_data)
+	{
+		if (_logs.size() != this->tasks.size() || _data.size() != this->tasks.size())
+			return false;
+
+		for (unsigned int i = 0; i < this->tasks.size(); i++)
+			this->tasks[i]->WriteBufferedOutput(_logs[i], _data[i]);
+
+		return true;
+	}
+
 	// Add a Task or Action to the collections
 	// Objects derived from BasicTask or Action are created here
 	bool RunSection::Add(MSDParser::ObjectType _type, const MSDParser::ObjectParser &_obj)
@@ -115,6 +161,17 @@ namespace RunSection
 			// Allow access to ActionTargets - note that changes made to an ActionTarget within a Task are reverted once the task finishes
 			task->SetActionTargets(this->actionScalars, this->actionVectors);
 
+			// Keep the output of the task in memory if requested
+			if (this->bufferOutput)
+			{
+				this->bufferedLogs.push_back(std::make_shared<std::ostringstream>());
+				this->bufferedData.push_back(std::make_shared<std::ostringstream>());
+				if (this->bufferPrecision > 0)
+					this->bufferedData.back()->precision(this->bufferPrecision);
+				task->SetLogStream(*(this->bufferedLogs.back()));
+				task->SetDataStream(*(this->bufferedData.back()));
+			}
+
 			// Add the task to the collection
 			this->tasks.push_back(task);
 		}
@@ -15,6 +15,7 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <iosfwd>
 #include "MSDParserDefines.h"
 #include "MSDParserfwd.h"
 #include "RunSectionfwd.h"
@@ -42,6 +43,12 @@ namespace RunSection
 		// Commandline options
 		bool overruleAppend; // "--append"/"-a"
 		bool noCalculations; // "--no-calc"/"-z"
+		bool bufferOutput;	 // Used by "--parallel-steps", task output is kept in memory instead of being written to files
+		int bufferPrecision; // Precision of the buffered data streams, or 0 to use the default precision
+
+		// Buffers for the log and data output of each task (only used if bufferOutput is set)
+		std::vector<std::shared_ptr<std::ostringstream>> bufferedLogs;
+		std::vector<std::shared_ptr<std::ostringstream>> bufferedData;
 
 		// Method that creates task objects - add new task classes here
 		// NOTE: Located in the seperate file "RunSection_CreateTask.cpp"
@@ -82,6 +89,17 @@ namespace RunSection
 		// Set the commandline options
 		void SetOverruleAppend(bool _overruleAppend) { this->overruleAppend = _overruleAppend; };	  // "--append"/"-a"
 		void SetNoCalculationsMode(bool _noCalculations) { this->noCalculations = _noCalculations; }; // "--no-calc"/"-z"
+		void SetBufferOutputMode(bool _bufferOutput) { this->bufferOutput = _bufferOutput; };		  // Must be set before the tasks are added
+		void SetBufferPrecision(int _precision) { this->bufferPrecision = _precision; };				  // Must be set before the tasks are added
+
+		// Writes the buffered task output to the corresponding tasks of another RunSection loaded from the same input, and clears the buffers
+		bool FlushBufferedOutput(RunSection &);
+
+		// Moves the buffered log and data output of each task into the vectors, and clears the buffers
+		bool TakeBufferedOutput(std::vector<std::string> &, std::vector<std::string> &);
+
+		// Writes log and data output produced elsewhere (e.g. by a RunSection loaded from the same input) to the tasks, one string per task
+		bool WriteBufferedOutput(const std::vector<std::string> &, const std::vector<std::string> &);
 
 		// Public output object methods
 		bool WriteOutputHeader(std::ostream &) const; // Writes the headers for the output columns
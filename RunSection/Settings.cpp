@@ -23,16 +23,23 @@ namespace RunSection
 						   notificationLevel(DefaultNotificationLevel),
 						   time(0),
 						   trajectoryStep(0),
-						   setTrajectoryStepBeforeTime(true)
+						   setTrajectoryStepBeforeTime(true),
+						   orientationGrid(""),
+						   orientationPoints(0),
+						   orientationGammaPoints(0),
+						   orientationVectors()
 	{
 		// Note: These cannot be initialized in the initializer list as the default values are initialized after the fields (unless header file is reordered)
 		steps = DefaultSteps;
 		time = DefaultTime;
 		trajectoryStep = DefaultTrajectoryStep;
+		orientationPoints = DefaultOrientationPoints;
 	}
 
 	Settings::Settings(const Settings &_settings) : steps(_settings.steps), currentStep(_settings.currentStep), dataDelimiter(_settings.dataDelimiter), notificationLevel(_settings.notificationLevel),
-													time(_settings.time), trajectoryStep(_settings.trajectoryStep), setTrajectoryStepBeforeTime(_settings.setTrajectoryStepBeforeTime)
+													time(_settings.time), trajectoryStep(_settings.trajectoryStep), setTrajectoryStepBeforeTime(_settings.setTrajectoryStepBeforeTime),
+													orientationGrid(_settings.orientationGrid), orientationPoints(_settings.orientationPoints), orientationGammaPoints(_settings.orientationGammaPoints),
+													orientationVectors(_settings.orientationVectors)
 	{
 	}
 
@@ -51,6 +58,10 @@ namespace RunSection
 		this->time = _settings.time;
 		this->trajectoryStep = _settings.trajectoryStep;
 		this->setTrajectoryStepBeforeTime = _settings.setTrajectoryStepBeforeTime;
+		this->orientationGrid = _settings.orientationGrid;
+		this->orientationPoints = _settings.orientationPoints;
+		this->orientationGammaPoints = _settings.orientationGammaPoints;
+		this->orientationVectors = _settings.orientationVectors;
 
 		return (*this);
 	}
@@ -87,6 +98,21 @@ namespace RunSection
 		// Allow the user to give the trajectory step priority over time
 		_settings.Get("trajectorystepbeforetime", this->setTrajectoryStepBeforeTime);
 
+		// Average the output of the tasks over the orientations of a grid, e.g. to obtain the yields of a powder sample
+		std::string grid;
+		if (_settings.Get("orientationgrid", grid) || _settings.Get("orientations", grid))
+		{
+			if (grid.compare("zcw") == 0 || grid.compare("lebedev") == 0)
+				this->orientationGrid = grid;
+			else if (grid.compare("none") == 0)
+				this->orientationGrid = "";
+			else
+				std::cout << "Warning: Unknown orientation grid \"" << grid << "\". Use \"zcw\" or \"lebedev\".\nIgnoring orientation grid specification!" << std::endl;
+		}
+		_settings.Get("orientationpoints", this->orientationPoints);
+		_settings.Get("orientationgammapoints", this->orientationGammaPoints);
+		_settings.GetList("orientationvectors", this->orientationVectors);
+
 		// TODO: Allow the user to specify dataDelimiter
 
 		// If a general notification level was specified, attempt to parse it
@@ -11,6 +11,8 @@
 #ifndef MOD_RunSection_Settings
 #define MOD_RunSection_Settings
 
+#include <string>
+#include <vector>
 #include "MSDParserfwd.h"
 #include "RunSectionDefines.h"
 #include "ActionTarget.h"
@@ -28,6 +30,10 @@ namespace RunSection
 		double time;
 		unsigned int trajectoryStep;
 		bool setTrajectoryStepBeforeTime;
+		std::string orientationGrid;				 // "zcw" or "lebedev" to average the task output over orientations, empty if no averaging should be done
+		unsigned int orientationPoints;				 // Minimum number of points of the orientation grid
+		unsigned int orientationGammaPoints;		 // Number of angles about the first rotated vector for each direction, 0 to choose from the number of vectors
+		std::vector<std::string> orientationVectors; // Names of the ActionVectors to rotate, all writable interaction fields if empty
 
 	public:
 		// Constructors / Destructors
@@ -52,6 +58,10 @@ namespace RunSection
 		double Time() const { return this->time; };
 		unsigned int TrajectoryStep() const { return this->trajectoryStep; };
 		bool SetTrajectoryStepBeforeTime() const { return this->setTrajectoryStepBeforeTime; };
+		const std::string &OrientationGrid() const { return this->orientationGrid; };
+		unsigned int OrientationPoints() const { return this->orientationPoints; };
+		unsigned int OrientationGammaPoints() const { return this->orientationGammaPoints; };
+		const std::vector<std::string> &OrientationVectors() const { return this->orientationVectors; };
 
 		// Method to define ActionTargets for the Settings object
 		void GetActionTargets(std::map<std::string, ActionScalar> &, std::map<std::string, ActionVector> &);
@@ -60,6 +70,8 @@ namespace RunSection
 		const unsigned int DefaultSteps = 1;
 		const double DefaultTime = 0.0;
 		const unsigned int DefaultTrajectoryStep = 0;
+		const unsigned int DefaultOrientationPoints = 110;
+		const unsigned int DefaultOrientationGammaPoints = 8; // Used when several vectors are rotated
 	};
 
 	// Non-member non-friend functions for ActionTarget validation
@@ -22,7 +22,7 @@ namespace RunSection
     // -----------------------------------------------------
     // TaskActionSpectrumHistogram Constructors and Destructor
     // -----------------------------------------------------
-    TaskActionSpectrumHistogram::TaskActionSpectrumHistogram(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection)
+    TaskActionSpectrumHistogram::TaskActionSpectrumHistogram(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), accumulate(false), accumulatedHeights()
     {
     }
 
@@ -35,37 +35,14 @@ namespace RunSection
     // -----------------------------------------------------
     double conversion_factor_to_MHz = 5e2 / arma::datum::pi;
 
-    int GetNumDifferences(int dimension)
+    arma::vec GetEigenstatePopulations(const arma::cx_mat &eigenvectors_matrix, const arma::cx_mat &initial_state)
     {
-        int num_gaps = dimension * (dimension - 1) / 2;
-        return num_gaps;
-    }
-
-    arma::vec GetDifferences(arma::vec values)
-    {
-        int dimension = values.size();
-        int num_gaps = GetNumDifferences(dimension);
-        arma::vec differences(num_gaps);
-        int ind = 0;
-        for (int k = 0; k < dimension - 1; k++)
-        {
-            for (int s = k + 1; s < dimension; s++)
-            {
-                differences(ind) = std::abs(values(k) - values(s));
-                ind++;
-            }
-        }
-        return differences;
-    }
-
-    arma::vec GetEigenstatePopulations(arma::cx_mat eigenvectors_matrix, arma::cx_mat initial_state)
-    {
-        arma::cx_mat eigenbasis_initial_state = eigenvectors_matrix.t() * initial_state * eigenvectors_matrix;
-        arma::vec populations = arma::real(eigenbasis_initial_state.diag());
+        // Only the diagonal of the initial state in the eigenbasis is needed, i.e. v_k^dagger * rho * v_k for each eigenvector
+        arma::vec populations = arma::real(arma::sum(arma::conj(eigenvectors_matrix) % (initial_state * eigenvectors_matrix), 0)).t();
         return populations;
     }
 
-    arma::vec GetPerpendicular3DVector(arma::vec vector, bool normalise)
+    arma::vec GetPerpendicular3DVector(const arma::vec &vector, bool normalise)
     {
         arma::vec perp(3);
         perp.zeros();
@@ -90,27 +67,44 @@ namespace RunSection
         return perp;
     }
 
-    arma::vec GetResonanceEffects(arma::cx_mat eigenvectors_matrix, arma::cx_mat initial_state, arma::cx_mat transition_hamiltonian)
+    // Adds the resonance effect of each pair of eigenstates (k,s) to the bin of their energy gap, without storing the gaps or the effects.
+    // The columns of the transition Hamiltonian are processed in tiles by all threads, each with its own bins that are summed at the end.
+    void AccumulateResonanceEffects(const arma::vec &eigenvalues, const arma::vec &populations, const arma::cx_mat &eigenbasis_transition_hamiltonian, double bin_width, double prefactor, arma::vec &heights)
     {
-        int dim = size(initial_state)(0);
-        int num_resonances = GetNumDifferences(dim);
-        arma::vec resonance_effects(num_resonances);
-        arma::vec eigenstate_populations = GetEigenstatePopulations(eigenvectors_matrix, initial_state);
-        arma::cx_mat eigenbasis_transition_hamiltonian = eigenvectors_matrix.t() * transition_hamiltonian * eigenvectors_matrix;
-
-        // Fill the array of resonance effects one element at the time
-        int ind_resonance = 0;
-        for (int k = 0; k < dim - 1; k++)
+        const int dim = static_cast<int>(eigenvalues.n_elem);
+        const int tile = 64;
+        const int num_tiles = (dim + tile - 1) / tile;
+        const double num_bins = static_cast<double>(heights.n_elem);
+        const double *energies = eigenvalues.memptr();
+        const double *pops = populations.memptr();
+
+#pragma omp parallel
         {
-            for (int s = k + 1; s < dim; s++)
+            arma::vec local_heights(heights.n_elem, arma::fill::zeros);
+
+            // The number of pairs grows with the column index, so the tiles are handed out dynamically
+#pragma omp for schedule(dynamic)
+            for (int t = 0; t < num_tiles; t++)
             {
-                auto sqrt_of_transprob = std::abs(eigenbasis_transition_hamiltonian(k, s));
-                auto value = std::abs(eigenstate_populations(k) - eigenstate_populations(s)) * (sqrt_of_transprob * sqrt_of_transprob);
-                resonance_effects(ind_resonance) = value;
-                ind_resonance++;
+                for (int s = t * tile; s < std::min(dim, (t + 1) * tile); s++)
+                {
+                    const arma::cx_double *column = eigenbasis_transition_hamiltonian.colptr(s);
+                    for (int k = 0; k < s; k++)
+                    {
+                        // Gaps above the upper limit are not part of the histogram
+                        double bin = std::floor(std::abs(energies[k] - energies[s]) * prefactor / bin_width); // only works for uniform bin_width
+                        if (bin >= num_bins)
+                            continue;
+
+                        double transprob = std::norm(column[k]);
+                        local_heights(static_cast<arma::uword>(bin)) += std::abs(pops[k] - pops[s]) * transprob;
+                    }
+                }
             }
+
+#pragma omp critical
+            heights += local_heights;
         }
-        return resonance_effects;
     }
 
     double GetHistogramPrefactor(bool use_MHz_units)
@@ -123,22 +117,6 @@ namespace RunSection
         return prefactor;
     }
 
-    arma::vec GetNormalisedHistogramHeights(arma::vec energy_gaps, arma::vec resonance_effects, double bin_width, int num_bins, bool use_MHz_units)
-    {
-        double prefactor = GetHistogramPrefactor(use_MHz_units);
-        int num_resonances = energy_gaps.size();
-        arma::vec heights(num_bins);
-        heights.zeros();
-        for (int s = 0; s < num_resonances; s++)
-        {
-            auto gap = std::abs(energy_gaps(s)) * prefactor;
-            auto effect = std::abs(resonance_effects(s));
-            auto bin_number = floor(gap / bin_width); // only works for uniform bin_width
-            heights(bin_number) += effect;
-        }
-        return heights / arma::sum(heights);
-    }
-
     bool TaskActionSpectrumHistogram::RunLocal()
     {
         this->Log() << "Running method ActionSpectrumHistogram." << std::endl;
@@ -185,6 +163,7 @@ namespace RunSection
                 else
                     rho0 += tmp_rho0;
             }
+            space.WeightEquivalentSpins(rho0);
             rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
             // ----------------------------------------------------------------
@@ -205,13 +184,13 @@ namespace RunSection
             arma::vec eigenvalues;     // To hold eigenvalues
 
             this->Log() << "Starting diagonalization..." << std::endl;
-            arma::eig_sym(eigenvalues, eigenvectors, H);
+            if (!space.BlockEigenDecomposition(H, eigenvalues, eigenvectors))
+            {
+                this->Log() << "Failed to diagonalize Hamiltonian." << std::endl;
+                continue;
+            }
             this->Log() << "Diagonalization done! Eigenvalues: " << eigenvalues.n_elem << ", eigenvectors: " << eigenvectors.n_cols << std::endl;
             // ----------------------------------------------------------------
-            // GET ARRAY OF ENERGY GAPS, SIMILAR TO THE "domega" matrix
-            // ----------------------------------------------------------------
-            arma::vec energy_gaps = GetDifferences(eigenvalues);
-            // ----------------------------------------------------------------
             // EVALUATE RESONANCE EFFECTS USING EIGENVECTORS OF H0
             // ----------------------------------------------------------------
             // Make transition hamiltonian with copy and pasted code.
@@ -257,9 +236,9 @@ namespace RunSection
                     {
                         if (ignore_tensors)
                         {
-                            space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sx()), (*j), Sx);
-                            space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sy()), (*j), Sy);
-                            space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sz()), (*j), Sz);
+                            space.CreateOperator(SpinAPI::SpinOperatorType::Sx, (*j), Sx);
+                            space.CreateOperator(SpinAPI::SpinOperatorType::Sy, (*j), Sy);
+                            space.CreateOperator(SpinAPI::SpinOperatorType::Sz, (*j), Sz);
                         }
                         else
                         {
@@ -292,19 +271,41 @@ namespace RunSection
                         transition_hamiltonian *= 8.794e+1;
                 }
             }
-            arma::vec resonance_effects = GetResonanceEffects(eigenvectors, rho0, transition_hamiltonian);
             // ----------------------------------------------------------------
             // BINNING PROCESS FOR HISTOGRAM
             // ----------------------------------------------------------------
-            double upper_limit;
-            this->Properties()->Get("upper_limit", upper_limit);
             double bin_width;
             this->Properties()->Get("bin_width", bin_width);
             bool use_MHz;
             this->Properties()->Get("units_in_MHz", use_MHz);
 
-            int num_bins = arma::regspace(bin_width / 2, bin_width, upper_limit).size();
-            auto normalised_heights = GetNormalisedHistogramHeights(energy_gaps, resonance_effects, bin_width, num_bins, use_MHz);
+            // The histogram is accumulated directly from the pairs of eigenstates, without arrays of all energy gaps and resonance effects
+            arma::vec populations = GetEigenstatePopulations(eigenvectors, rho0);
+            arma::cx_mat eigenbasis_transition_hamiltonian = eigenvectors.t() * transition_hamiltonian * eigenvectors;
+            arma::vec heights(bin_centers.n_elem, arma::fill::zeros);
+            AccumulateResonanceEffects(eigenvalues, populations, eigenbasis_transition_hamiltonian, bin_width, GetHistogramPrefactor(use_MHz), heights);
+
+            // Add to the histogram of the previous steps, e.g. other trajectory frames or orientations set by actions
+            if (this->accumulate)
+            {
+                unsigned int index = static_cast<unsigned int>(system - systems.cbegin());
+                if (this->accumulatedHeights.size() <= index)
+                    this->accumulatedHeights.resize(index + 1);
+                if (this->accumulatedHeights[index].n_elem != heights.n_elem)
+                    this->accumulatedHeights[index].zeros(heights.n_elem);
+
+                this->accumulatedHeights[index] += heights;
+                heights = this->accumulatedHeights[index];
+            }
+
+            // An empty histogram, e.g. if all gaps are above the upper limit, is written as zeros rather than divided by zero
+            arma::vec normalised_heights = heights;
+            double total = arma::sum(heights);
+            if (total > 0.0)
+                normalised_heights /= total;
+            else
+                this->Log() << "Warning: No transitions of SpinSystem \"" << (*system)->Name() << "\" were found below the upper limit of the histogram." << std::endl;
+
             this->Data() << this->RunSettings()->CurrentStep() << " ";
             this->Data() << normalised_heights.st(); // already contains endl
         }
@@ -325,6 +326,22 @@ namespace RunSection
     // Validation
     bool TaskActionSpectrumHistogram::Validate()
     {
+        // Sum the histograms of all steps (e.g. trajectory frames), every step writes the histogram accumulated so far
+        this->Properties()->Get("accumulate", this->accumulate);
+
+        // The orientation average runs every step once for each orientation, which would sum the histograms of the orientations and of the steps
+        if (this->accumulate && !this->RunSettings()->OrientationGrid().empty())
+        {
+            this->Log() << "ERROR: \"accumulate\" cannot be used together with the orientation grid of the Settings object, as the histograms are already averaged over the orientations." << std::endl;
+            return false;
+        }
+
+        // With "--parallel-steps", each copy of the task runs only some of the steps and would only sum the histograms of those
+        if (this->accumulate && this->IsOutputBuffered())
+        {
+            this->Log() << "ERROR: \"accumulate\" cannot be used together with \"--parallel-steps\", as the steps are run by separate copies of the task." << std::endl;
+            return false;
+        }
 
         return true;
     }
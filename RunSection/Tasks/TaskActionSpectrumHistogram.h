@@ -11,6 +11,7 @@
 #ifndef MOD_RunSection_TaskActionSpectrumHistogram
 #define MOD_RunSection_TaskActionSpectrumHistogram
 
+#include <vector>
 #include "SpinSpace.h"
 #include "BasicTask.h"
 
@@ -20,6 +21,8 @@ namespace RunSection
 	{
 	private:
 		// Data members
+		bool accumulate;						   // Whether the histogram is summed over the steps
+		std::vector<arma::vec> accumulatedHeights; // The unnormalised histogram of each spin system summed over the steps so far
 
 		// Private methods
 		arma::vec GetHistogramBinCenters();
@@ -34,6 +37,9 @@ namespace RunSection
 		TaskActionSpectrumHistogram(const MSDParser::ObjectParser &, const RunSection &); // Normal constructor
 		~TaskActionSpectrumHistogram();													  // Destructor
 	};
+
+	// Non-member non-friend functions
+	void AccumulateResonanceEffects(const arma::vec &, const arma::vec &, const arma::cx_mat &, double, double, arma::vec &); // Adds the effects of all pairs of eigenstates to the bins of their gaps
 }
 
 #endif
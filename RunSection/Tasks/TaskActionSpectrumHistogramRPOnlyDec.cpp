@@ -169,7 +169,7 @@ namespace RunSection
 				}
 
 				// Diagonalize Hamiltonian
-				if (!arma::eig_sym(eigenvalues[r], eigenvectors[r], H))
+				if (!spaces[r].BlockEigenDecomposition(H, eigenvalues[r], eigenvectors[r]))
 				{
 					this->Log() << "Failed to diagonalize Hamiltonian for radical " << r << "." << std::endl;
 					continue;
@@ -220,9 +220,9 @@ namespace RunSection
 						{
 							if (ignoretensors)
 							{
-								spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sx()), (*j), Sx);
-								spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sy()), (*j), Sy);
-								spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sz()), (*j), Sz);
+								spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sx, (*j), Sx);
+								spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sy, (*j), Sy);
+								spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sz, (*j), Sz);
 							}
 							else
 							{
@@ -477,6 +477,9 @@ namespace RunSection
 	// Validation
 	bool TaskActionSpectrumHistogramRPOnlyDec::Validate()
 	{
+		// The radical Hilbert spaces are used without the multiplicities of groups of equivalent spins
+		if (this->HasEquivalentSpins())
+			return false;
 
 		return true;
 	}
@@ -13,6 +13,7 @@
 #include "State.h"
 #include "SpinSpace.h"
 #include "SpinSystem.h"
+#include "AffineOperator.h"
 #include "ObjectParser.h"
 #include "Spin.h"
 #include "Interaction.h"
@@ -360,6 +361,12 @@ namespace RunSection
 			int krylovsize;
 			this->Properties()->Get("krylovsize", krylovsize);
 
+			// Number of states propagated together by the block krylov propagator
+			int krylovblocksize = 16;
+			this->Properties()->Get("krylovblocksize", krylovblocksize);
+			if (krylovblocksize < 1)
+				krylovblocksize = 1;
+
 			if (propmethod == "autoexpm")
 			{
 				this->Log() << "Autoexpm is chosen as the propagation method." << std::endl;
@@ -384,6 +391,7 @@ namespace RunSection
 			}
 			else if (propmethod == "krylov")
 			{
+				this->Log() << "Up to " << krylovblocksize << " states are propagated together in the krylov subspace method." << std::endl;
 				if (krylovsize > 0)
 				{
 					this->Log() << "Krylov basis size is chosen as " << krylovsize << "." << std::endl;
@@ -403,6 +411,24 @@ namespace RunSection
 				precision = "single";
 			}
 
+			// Integrator for the time-dependent Hamiltonian, the fourth order Magnus integrator allows larger time steps for oscillating fields
+			std::string integrator = "piecewise";
+			this->Properties()->Get("integrator", integrator);
+
+			arma::vec integratorNodes;
+			arma::mat integratorWeights;
+			if (space.IntegratorStages(integrator, integratorNodes, integratorWeights))
+			{
+				this->Log() << "The \"" << integrator << "\" integrator is chosen for the time-dependent Hamiltonian." << std::endl;
+			}
+			else
+			{
+				std::cout << "# ERROR: undefined integrator, using a piecewise constant Hamiltonian!" << std::endl;
+				this->Log() << "Undefined integrator, using a piecewise constant Hamiltonian." << std::endl;
+				integrator = "piecewise";
+				space.IntegratorStages(integrator, integratorNodes, integratorWeights);
+			}
+
 			// Get time-independent Hamiltonian
 			space.SetTime(0.0);
 			arma::sp_cx_mat H;
@@ -413,6 +439,18 @@ namespace RunSection
 				return 1;
 			}
 
+			// The dynamic part of the Hamiltonian is a fixed set of operators with time-dependent coefficients, so the Hamiltonian at each
+			// step is evaluated on a fixed sparsity pattern instead of being assembled. The constant part is set to H before each time loop.
+			SpinAPI::AffineOperator Ht(4 * Z);
+			std::vector<arma::sp_cx_mat> Hstages; // Hamiltonians of the stages of the integrator within a time step
+			arma::vec stageTimes;
+			if (time_dependent_hamiltonian && !space.DynamicHamiltonianTerms(Ht))
+			{
+				this->Log() << "Failed to obtain the time-dependent Hamiltonian in Hilbert Space." << std::endl;
+				std::cout << "# ERROR: Failed to obtain the time-dependent Hamiltonian!" << std::endl;
+				return 1;
+			}
+
 			arma::mat ExptValues;
 			ExptValues.zeros(num_steps, num_transitions);
 			arma::vec Identity(num_steps);
@@ -451,7 +489,7 @@ namespace RunSection
 						for (auto o = transitions.begin(); o != transitions.end(); o++)
 						{
 							double rate = (*o)->Rate();
-							double abs_trace = std::abs(arma::trace(B.t() * Operators[idx] * B));
+							double abs_trace = std::abs(arma::trace(B.t() * Operators.at(idx) * B));
 							double expected_value = abs_trace / Z;
 							ExptValues(k, idx) = rate * expected_value;
 							this->Data() << " " << expected_value;
@@ -478,43 +516,45 @@ namespace RunSection
 					// Propagation using krylov subspace methods
 					// Include the recombination operator K
 					H = H - arma::cx_double(0.0, 1.0) * K;
-					// #pragma omp parallel for
-					for (int itr = 0; itr < Z; itr++)
+					// The samples are propagated one time step at a time, so the time-dependent operators are only constructed once per step
+					for (int k = 0; k < num_steps; k++)
 					{
-						arma::cx_vec prop_state = B.col(itr);
-						for (int k = 0; k < num_steps; k++)
-						{
-							// Set the current time
-							double current_time = k * dt;
-							time(k) = current_time;
+						// Set the current time
+						double current_time = k * dt;
+						time(k) = current_time;
 
-							// Set the currentime for the Dynamic Hamiltonian
-							space.SetTime(current_time);
+						// Set the currentime for the Dynamic Hamiltonian
+						space.SetTime(current_time);
 
-							auto transitions = (*i)->Transitions();
+						auto transitions = (*i)->Transitions();
 
-							int idx = 0;
-							for (auto o = transitions.begin(); o != transitions.end(); o++)
-							{
-								double rate = (*o)->Rate();
-								double expected_value = std::abs(arma::cdot(prop_state, Operators[idx] * prop_state));
-								ExptValues(k, idx) += rate * expected_value;
-								idx++;
-							}
+						int idx = 0;
+						for (auto o = transitions.begin(); o != transitions.end(); o++)
+						{
+							double rate = (*o)->Rate();
+							double expected_value = 0.0;
+#pragma omp parallel for reduction(+ : expected_value)
+							for (int itr = 0; itr < Z; itr++)
+								expected_value += std::abs(arma::cdot(B.col(itr), Operators.at(idx) * B.col(itr)));
+							ExptValues(k, idx) += rate * expected_value;
+							idx++;
+						}
 
-							if (!space.DynamicTotalReactionOperator(dK))
-							{
-								this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
-							}
+						if (!space.DynamicTotalReactionOperator(dK))
+						{
+							this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
+						}
 
-							dK = (-arma::cx_double(0.0, 1.0)) * dK;
+						dK = (-arma::cx_double(0.0, 1.0)) * dK;
 
-							// Update B using Krylov Subspace propagator
-							H = H + dK;
-							prop_state = space.KrylovExpmGeneral(H, prop_state, -arma::cx_double(0.0, 1.0) * dt, krylovsize, 4 * Z);
-							H = H - dK;
+						// Update B using the block Krylov subspace propagator, the blocks of states are independent and propagated in parallel
+						arma::sp_cx_mat Hk = H + dK;
+#pragma omp parallel for schedule(dynamic)
+						for (int first = 0; first < Z; first += krylovblocksize)
+						{
+							int last = std::min(first + krylovblocksize, Z) - 1;
+							B.cols(first, last) = space.KrylovExpmGeneralBlock(Hk, B.cols(first, last), -arma::cx_double(0.0, 1.0) * dt, krylovsize, 4 * Z);
 						}
-						B.col(itr) = prop_state;
 					}
 					
 					ExptValues /= Z;
@@ -537,7 +577,6 @@ namespace RunSection
 			else if (time_dependent_hamiltonian && !time_dependent_transitions)
 			{
 				// Case 2: time_dependent_hamiltonian is true but time_dependent_transitions is false
-				arma::sp_cx_mat dH = arma::sp_cx_mat(4 * Z, 4 * Z);
 				if (propmethod == "autoexpm")
 				{
 					// Propagation using autoexpm for matrix exponential
@@ -545,6 +584,7 @@ namespace RunSection
 					if (symmetric)
 					{
 						// Recombination reaction rates are equal
+						Ht.SetConstant(H);
 						for (int k = 0; k < num_steps; k++)
 						{
 							// Set the current time
@@ -562,22 +602,21 @@ namespace RunSection
 							// Calculate the expected values for each transition operator
 							for (int idx = 0; idx < num_transitions; idx++)
 							{
-								double abs_trace = std::abs(arma::trace(B.t() * Operators[idx] * B));
+								double abs_trace = std::abs(arma::trace(B.t() * Operators.at(idx) * B));
 								double expected_value = std::exp(-kmin * current_time) * abs_trace / Z;
 								ExptValues(k, idx) = expected_value;
 								this->Data() << " " << expected_value;
 							}
 
 							this->Data() << std::endl;
-							if (!space.DynamicHamiltonian(dH))
+							if (!space.StageHamiltonians(Ht, integratorNodes, integratorWeights, current_time, dt, Hstages, stageTimes))
 							{
 								this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
 							}
 
 							// Update B using the Higham propagator
-							H = H + dH;
-							B = space.HighamProp(H, B, -dt * arma::cx_double(0.0, 1.0), precision, M);
-							H = H - dH;
+							for (unsigned int s = 0; s < Hstages.size(); s++)
+								B = space.HighamProp(Hstages[s], B, -stageTimes(s) * arma::cx_double(0.0, 1.0), precision, M);
 						}
 					}
 					else
@@ -585,6 +624,7 @@ namespace RunSection
 						// General Case
 						// Include the recombination operator K
 						H = H - arma::cx_double(0.0, 1.0) * K;
+						Ht.SetConstant(H);
 						for (int k = 0; k < num_steps; k++)
 						{
 							// Set the current time
@@ -602,7 +642,7 @@ namespace RunSection
 							// Calculate the expected values for each transition operator
 							for (int idx = 0; idx < num_transitions; idx++)
 							{
-								double abs_trace = std::abs(arma::trace(B.t() * Operators[idx] * B));
+								double abs_trace = std::abs(arma::trace(B.t() * Operators.at(idx) * B));
 								double expected_value = abs_trace / Z;
 								ExptValues(k, idx) = expected_value;
 								this->Data() << " " << expected_value;
@@ -610,15 +650,14 @@ namespace RunSection
 
 							this->Data() << std::endl;
 
-							if (!space.DynamicHamiltonian(dH))
+							if (!space.StageHamiltonians(Ht, integratorNodes, integratorWeights, current_time, dt, Hstages, stageTimes))
 							{
 								this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
 							}
 
 							// Update B using the Higham propagator
-							H = H + dH;
-							B = space.HighamProp(H, B, -arma::cx_double(0.0, 1.0) * dt, precision, M);
-							H = H - dH;
+							for (unsigned int s = 0; s < Hstages.size(); s++)
+								B = space.HighamProp(Hstages[s], B, -arma::cx_double(0.0, 1.0) * stageTimes(s), precision, M);
 						}
 					}
 				}
@@ -629,37 +668,40 @@ namespace RunSection
 					{
 						// recombination rates are equal
 
-						// #pragma omp parallel for
-						for (int itr = 0; itr < Z; itr++)
+						// The samples are propagated one time step at a time, so the time-dependent operators are only constructed once per step
+						Ht.SetConstant(H);
+						for (int k = 0; k < num_steps; k++)
 						{
-							arma::cx_vec prop_state = B.col(itr);
-							for (int k = 0; k < num_steps; k++)
+							// Set the current time
+							double current_time = k * dt;
+							time(k) = current_time;
+
+							// Set the currentime for the Dynamic Hamiltonian
+							space.SetTime(current_time);
+
+							// Calculate the expected values for each transition operator
+							for (int idx = 0; idx < num_transitions; idx++)
 							{
-								// Set the current time
-								double current_time = k * dt;
-								time(k) = current_time;
-
-								// Set the currentime for the Dynamic Hamiltonian
-								space.SetTime(current_time);
-
-								// Calculate the expected values for each transition operator
-								for (int idx = 0; idx < num_transitions; idx++)
-								{
-									double result = std::exp(-kmin * current_time) * std::abs(arma::cdot(prop_state, Operators[idx] * prop_state));
-									ExptValues(k, idx) += result;
-								}
-
-								if (!space.DynamicHamiltonian(dH))
-								{
-									this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
-								}
-
-								// Update B using Krylov Subspace propagator
-								H = H + dH;
-								prop_state = space.KrylovExpmSymm(H, prop_state, -arma::cx_double(0.0, 1.0) * dt, krylovsize, 4 * Z);
-								H = H - dH;
+								double result = 0.0;
+#pragma omp parallel for reduction(+ : result)
+								for (int itr = 0; itr < Z; itr++)
+									result += std::exp(-kmin * current_time) * std::abs(arma::cdot(B.col(itr), Operators.at(idx) * B.col(itr)));
+								ExptValues(k, idx) += result;
+							}
+
+							if (!space.StageHamiltonians(Ht, integratorNodes, integratorWeights, current_time, dt, Hstages, stageTimes))
+							{
+								this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
+							}
+
+							// Update B using the block Krylov subspace propagator, the blocks of states are independent and propagated in parallel
+#pragma omp parallel for schedule(dynamic)
+							for (int first = 0; first < Z; first += krylovblocksize)
+							{
+								int last = std::min(first + krylovblocksize, Z) - 1;
+								for (unsigned int s = 0; s < Hstages.size(); s++)
+									B.cols(first, last) = space.KrylovExpmSymmBlock(Hstages[s], B.cols(first, last), -arma::cx_double(0.0, 1.0) * stageTimes(s), krylovsize, 4 * Z);
 							}
-							B.col(itr) = prop_state;
 						}
 
 						ExptValues /= Z;
@@ -682,37 +724,40 @@ namespace RunSection
 					{
 						// Include the recombination operator K
 						H = H - arma::cx_double(0.0, 1.0) * K;
-						// #pragma omp parallel for
-						for (int itr = 0; itr < Z; itr++)
+						// The samples are propagated one time step at a time, so the time-dependent operators are only constructed once per step
+						Ht.SetConstant(H);
+						for (int k = 0; k < num_steps; k++)
 						{
-							arma::cx_vec prop_state = B.col(itr);
-							for (int k = 0; k < num_steps; k++)
+							// Set the current time
+							double current_time = k * dt;
+							time(k) = current_time;
+
+							// Set the currentime for the Dynamic Hamiltonian
+							space.SetTime(current_time);
+
+							// Calculate the expected values for each transition operator
+							for (int idx = 0; idx < num_transitions; idx++)
+							{
+								double result = 0.0;
+#pragma omp parallel for reduction(+ : result)
+								for (int itr = 0; itr < Z; itr++)
+									result += std::abs(arma::cdot(B.col(itr), Operators.at(idx) * B.col(itr)));
+								ExptValues(k, idx) += result;
+							}
+
+							if (!space.StageHamiltonians(Ht, integratorNodes, integratorWeights, current_time, dt, Hstages, stageTimes))
+							{
+								this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
+							}
+
+							// Update B using the block Krylov subspace propagator, the blocks of states are independent and propagated in parallel
+#pragma omp parallel for schedule(dynamic)
+							for (int first = 0; first < Z; first += krylovblocksize)
 							{
-								// Set the current time
-								double current_time = k * dt;
-								time(k) = current_time;
-
-								// Set the currentime for the Dynamic Hamiltonian
-								space.SetTime(current_time);
-
-								// Calculate the expected values for each transition operator
-								for (int idx = 0; idx < num_transitions; idx++)
-								{
-									double result = std::abs(arma::cdot(prop_state, Operators[idx] * prop_state));
-									ExptValues(k, idx) += result;
-								}
-
-								if (!space.DynamicHamiltonian(dH))
-								{
-									this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
-								}
-
-								// Update B using Krylov Subspace propagator
-								H = H + dH;
-								prop_state = space.KrylovExpmGeneral(H, prop_state, -arma::cx_double(0.0, 1.0) * dt, krylovsize, 4 * Z);
-								H = H - dH;
+								int last = std::min(first + krylovblocksize, Z) - 1;
+								for (unsigned int s = 0; s < Hstages.size(); s++)
+									B.cols(first, last) = space.KrylovExpmGeneralBlock(Hstages[s], B.cols(first, last), -arma::cx_double(0.0, 1.0) * stageTimes(s), krylovsize, 4 * Z);
 							}
-							B.col(itr) = prop_state;
 						}
 
 						ExptValues /= Z;
@@ -736,8 +781,7 @@ namespace RunSection
 			else if (time_dependent_hamiltonian && time_dependent_transitions)
 			{
 				// Case 3: both time_dependent_hamiltonian and time_dependent_transitions are true
-				arma::sp_cx_mat dK(4 * Z, 4 * Z);
-				arma::sp_cx_mat dH(4 * Z, 4 * Z);
+				std::vector<arma::sp_cx_mat> Kstages; // Time-dependent reaction operators of the stages of the integrator
 				if (propmethod == "autoexpm")
 				{
 					// Propagation using autoexpm for matrix exponential
@@ -747,6 +791,7 @@ namespace RunSection
 
 					// Include the recombination operator K
 					H = H - arma::cx_double(0.0, 1.0) * K;
+					Ht.SetConstant(H);
 					for (int k = 0; k < num_steps; k++)
 					{
 						// Set the current time
@@ -767,7 +812,7 @@ namespace RunSection
 						for (auto o = transitions.begin(); o != transitions.end(); o++)
 						{
 							double rate = (*o)->Rate();
-							double abs_trace = std::abs(arma::trace(B.t() * Operators[idx] * B));
+							double abs_trace = std::abs(arma::trace(B.t() * Operators.at(idx) * B));
 							double expected_value = abs_trace / Z;
 							ExptValues(k, idx) = rate * expected_value;
 							this->Data() << " " << expected_value;
@@ -776,22 +821,23 @@ namespace RunSection
 
 						this->Data() << std::endl;
 
-						if (!space.DynamicTotalReactionOperator(dK))
+						if (!space.StageHamiltonians(Ht, integratorNodes, integratorWeights, current_time, dt, Hstages, stageTimes))
 						{
 							this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
 						}
 
-						dK = (-arma::cx_double(0.0, 1.0)) * dK;
-
-						if (!space.DynamicHamiltonian(dH))
+						// The reaction operator is evaluated at the same nodes as the Hamiltonian, to keep the order of the integrator
+						if (!space.StageReactionOperators(integratorNodes, integratorWeights, current_time, dt, Kstages))
 						{
 							this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
 						}
 
 						// Update B using the Higham propagator
-						H = H + dK + dH;
-						B = space.HighamProp(H, B, -arma::cx_double(0.0, 1.0) * dt, precision, M);
-						H = H - dK - dH;
+						for (unsigned int s = 0; s < Hstages.size(); s++)
+						{
+							Hstages[s] -= arma::cx_double(0.0, 1.0) * Kstages[s];
+							B = space.HighamProp(Hstages[s], B, -arma::cx_double(0.0, 1.0) * stageTimes(s), precision, M);
+						}
 					}
 				}
 				else if (propmethod == "krylov")
@@ -799,48 +845,52 @@ namespace RunSection
 					// Propagation using krylov subspace methods
 					// Include the recombination operator K
 					H = H - arma::cx_double(0.0, 1.0) * K;
-					// #pragma omp parallel for
-					for (int itr = 0; itr < Z; itr++)
+					// The samples are propagated one time step at a time, so the time-dependent operators are only constructed once per step
+					Ht.SetConstant(H);
+					for (int k = 0; k < num_steps; k++)
 					{
-						arma::cx_vec prop_state = B.col(itr);
-						for (int k = 0; k < num_steps; k++)
-						{
-							// Set the current time
-							double current_time = k * dt;
-							time(k) = current_time;
-
-							// Set the currentime for the Dynamic Hamiltonian
-							space.SetTime(current_time);
+						// Set the current time
+						double current_time = k * dt;
+						time(k) = current_time;
 
-							auto transitions = (*i)->Transitions();
+						// Set the currentime for the Dynamic Hamiltonian
+						space.SetTime(current_time);
 
-							int idx = 0;
-							for (auto o = transitions.begin(); o != transitions.end(); o++)
-							{
-								double rate = (*o)->Rate();
-								double expected_value = std::abs(arma::cdot(prop_state, Operators[idx] * prop_state));
-								ExptValues(k, idx) += rate * expected_value;
-								idx++;
-							}
+						auto transitions = (*i)->Transitions();
 
-							if (!space.DynamicTotalReactionOperator(dK))
-							{
-								this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
-							}
+						int idx = 0;
+						for (auto o = transitions.begin(); o != transitions.end(); o++)
+						{
+							double rate = (*o)->Rate();
+							double expected_value = 0.0;
+#pragma omp parallel for reduction(+ : expected_value)
+							for (int itr = 0; itr < Z; itr++)
+								expected_value += std::abs(arma::cdot(B.col(itr), Operators.at(idx) * B.col(itr)));
+							ExptValues(k, idx) += rate * expected_value;
+							idx++;
+						}
 
-							dK = (-arma::cx_double(0.0, 1.0)) * dK;
+						if (!space.StageHamiltonians(Ht, integratorNodes, integratorWeights, current_time, dt, Hstages, stageTimes))
+						{
+							this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
+						}
 
-							if (!space.DynamicHamiltonian(dH))
-							{
-								this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
-							}
+						// The reaction operator is evaluated at the same nodes as the Hamiltonian, to keep the order of the integrator
+						if (!space.StageReactionOperators(integratorNodes, integratorWeights, current_time, dt, Kstages))
+						{
+							this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
+						}
 
-							// Update B using Krylov Subspace propagator
-							H = H + dK + dH;
-							prop_state = space.KrylovExpmGeneral(H, prop_state, -arma::cx_double(0.0, 1.0) * dt, krylovsize, 4 * Z);
-							H = H - dK - dH;
+						// Update B using the block Krylov subspace propagator, the blocks of states are independent and propagated in parallel
+						for (unsigned int s = 0; s < Hstages.size(); s++)
+							Hstages[s] -= arma::cx_double(0.0, 1.0) * Kstages[s];
+#pragma omp parallel for schedule(dynamic)
+						for (int first = 0; first < Z; first += krylovblocksize)
+						{
+							int last = std::min(first + krylovblocksize, Z) - 1;
+							for (unsigned int s = 0; s < Hstages.size(); s++)
+								B.cols(first, last) = space.KrylovExpmGeneralBlock(Hstages[s], B.cols(first, last), -arma::cx_double(0.0, 1.0) * stageTimes(s), krylovsize, 4 * Z);
 						}
-						B.col(itr) = prop_state;
 					}
 
 					ExptValues /= Z;
@@ -917,6 +967,10 @@ namespace RunSection
 
 	bool TaskDynamicHSDirectTimeEvo::Validate()
 	{
+		// The states are sampled from the basis without the multiplicities of groups of equivalent spins
+		if (this->HasEquivalentSpins())
+			return false;
+
 		// Get the reaction operator type
 		std::string str;
 		if (this->Properties()->Get("reactionoperators", str))
@@ -11,6 +11,7 @@
 #include "Settings.h"
 #include "State.h"
 #include "SpinSystem.h"
+#include "AffineOperator.h"
 #include "Interaction.h"
 #include "ObjectParser.h"
 
@@ -65,7 +66,9 @@ namespace RunSection
 			// Get the Hamiltonian
 			arma::cx_mat H;																			// Static part of the Hamiltonian
 			arma::sp_cx_mat dH = arma::sp_cx_mat(space.SpaceDimensions(), space.SpaceDimensions()); // Dynamic part of the Hamiltonian
-			if (!space.StaticHamiltonian(H) || (this->timedependentInteractions && !space.DynamicHamiltonian(dH)))
+			SpinAPI::AffineOperator dHt(space.SpaceDimensions());									// Operators of the dynamic part, only their coefficients change with time
+			arma::cx_vec dHcoefficients;
+			if (!space.StaticHamiltonian(H) || (this->timedependentInteractions && (!space.DynamicHamiltonianTerms(dHt) || !space.DynamicHamiltonianCoefficients(dHcoefficients) || !dHt.Evaluate(dHcoefficients, dH))))
 			{
 				this->Log() << "Failed to obtain the Hamiltonian! Skipping system." << std::endl;
 				continue;
@@ -94,6 +97,7 @@ namespace RunSection
 				else
 					rho0 += tmp_rho0;
 			}
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
 			// Get the number of steps
@@ -134,7 +138,7 @@ namespace RunSection
 
 				// Refresh the Hamiltonian only if "n < steps" AND if there actually is a time-dependence
 				space.SetTime(static_cast<double>(n) * this->timestep);
-				if (n < steps && this->timedependentInteractions && !space.DynamicHamiltonian(dH))
+				if (n < steps && this->timedependentInteractions && (!space.DynamicHamiltonianCoefficients(dHcoefficients) || !dHt.Evaluate(dHcoefficients, dH)))
 				{
 					this->Log() << "Warning: Failed to update the Hamiltonian matrix representation!" << std::endl;
 				}
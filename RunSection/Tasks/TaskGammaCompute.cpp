@@ -6,6 +6,7 @@
 // See LICENSE.txt for license information.
 /////////////////////////////////////////////////////////////////////////
 #include <iostream>
+#include <omp.h>
 #include "TaskGammaCompute.h"
 #include "Transition.h"
 #include "Settings.h"
@@ -19,7 +20,7 @@ namespace RunSection
 	// -----------------------------------------------------
 	// TaskStaticSS Constructors and Destructor
 	// -----------------------------------------------------
-	TaskGammaCompute::TaskGammaCompute(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), steps(100), totaltime(1.0e+4)
+	TaskGammaCompute::TaskGammaCompute(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), steps(100), totaltime(1.0e+4), storePropagators(true)
 	{
 	}
 
@@ -141,6 +142,7 @@ namespace RunSection
 				else
 					rho0 += tmp_rho0;
 			}
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
 			// Get list of states to calculate the quantum yield for
@@ -165,37 +167,59 @@ namespace RunSection
 			double timestep = this->totaltime / static_cast<double>(steps);
 			this->Log() << "Using a timestep of " << timestep << " ns for " << steps << " steps during the period." << std::endl;
 
-			// Prepare matrices
-			arma::cx_mat H;																					 // Hamiltonian
-			std::shared_ptr<arma::cx_mat> A(new arma::cx_mat[steps], std::default_delete<arma::cx_mat[]>()); // Collection of propagators
-
-			// First propagator is the identity
-			A.get()[0] = arma::eye<arma::cx_mat>(size(rho0));
-
-			// Loop over a period
+			// Get the Hamiltonians serially, as SetTime changes the Interaction objects that are shared with other SpinSpaces
+			std::vector<arma::sp_cx_mat> hamiltonians(steps);
 			for (unsigned int j = 1; j < steps; j++)
 			{
 				// Set the time to halfway into the next discretization step
 				space.SetTime(timestep * static_cast<double>(j) - timestep / 2.0);
 
 				// Get the Hamiltonian
-				if (!space.Hamiltonian(H))
+				if (!space.Hamiltonian(hamiltonians[j]))
 				{
 					this->Log() << "ERROR: Failed to obtain the Hamiltonian! Stopping." << std::endl;
 					return false;
 				}
+			}
+
+			// The steps are divided into one contiguous chunk per thread. The propagators are first composed within each chunk
+			// in parallel, and then the chunk products are composed serially (parallel prefix product).
+			unsigned int chunks = std::max(1u, std::min(static_cast<unsigned int>(omp_get_max_threads()), steps));
+			std::vector<unsigned int> chunkStart(chunks + 1);
+			for (unsigned int c = 0; c <= chunks; c++)
+				chunkStart[c] = static_cast<unsigned int>((static_cast<unsigned long>(c) * steps) / chunks);
+
+			arma::cx_mat identity = arma::eye<arma::cx_mat>(size(rho0));
+			std::vector<arma::cx_mat> A(this->storePropagators ? steps : 0); // Propagators relative to the start of their chunk, if they are stored
+			std::vector<arma::cx_mat> chunkOffsets(chunks + 1);				 // Propagators upto the start of each chunk
 
-				// Extend the propagator
-				A.get()[j] = arma::expmat(arma::cx_double(0.0, -1.0) * H * timestep) * A.get()[j - 1];
+#pragma omp parallel for schedule(static, 1)
+			for (int c = 0; c < static_cast<int>(chunks); c++)
+			{
+				// First propagator is the identity
+				arma::cx_mat local = identity;
+				for (unsigned int j = chunkStart[c]; j < chunkStart[c + 1]; j++)
+				{
+					if (j > 0)
+						local = arma::expmat(arma::cx_double(0.0, -1.0) * arma::cx_mat(hamiltonians[j]) * timestep) * local;
+
+					if (this->storePropagators)
+						A[j] = local;
+				}
+				chunkOffsets[c + 1] = local;
 			}
 
+			chunkOffsets[0] = identity;
+			for (unsigned int c = 0; c < chunks; c++)
+				chunkOffsets[c + 1] = chunkOffsets[c + 1] * chunkOffsets[c];
+
 			// -----------------------------------------------------
 			// Diagonalize the final propagator
 			// -----------------------------------------------------
 			// Diagonalize Hamiltonian
 			arma::cx_vec lambda; // To hold eigenvalues
 			arma::cx_mat X;		 // To hold eigenvectors
-			if (!arma::eig_gen(lambda, X, A.get()[steps - 1]))
+			if (!arma::eig_gen(lambda, X, chunkOffsets[chunks]))
 			{
 				this->Log() << "Failed to diagonalize Hamiltonian." << std::endl;
 				continue;
@@ -224,15 +248,30 @@ namespace RunSection
 			arma::mat D = arma::diagmat(arma::real(preOmega));
 			arma::mat L = O * D - D * O;
 
+			// Only the propagators in the eigenbasis, A_j * X, are needed from here on
+			for (unsigned int c = 0; c < chunks; c++)
+				chunkOffsets[c] = chunkOffsets[c] * X;
+
+			if (this->storePropagators)
+			{
+#pragma omp parallel for schedule(static, 1)
+				for (int c = 0; c < static_cast<int>(chunks); c++)
+					for (unsigned int j = chunkStart[c]; j < chunkStart[c + 1]; j++)
+						A[j] = A[j] * chunkOffsets[c];
+			}
+			else
+			{
+				this->Log() << "Propagators are not stored, and will be recomputed for each state." << std::endl;
+			}
+
 			// -----------------------------------------------------
 			// Next steps:
 			// - Form the quantity "g_rs(x)"
 			// - Get "G_rs(x)" using FFT
 			// - Calculate the quantum yield
 			// -----------------------------------------------------
-			// Prepare collection of g-matrices
-			std::shared_ptr<arma::cx_mat> g(new arma::cx_mat[steps], std::default_delete<arma::cx_mat[]>());
-			std::shared_ptr<arma::cx_mat> G(new arma::cx_mat[steps], std::default_delete<arma::cx_mat[]>());
+			// Prepare collection of g-matrices, which are replaced by the G-matrices
+			std::vector<arma::cx_mat> g(steps);
 
 			// Write standard output
 			this->Data() << this->RunSettings()->CurrentStep() << " ";
@@ -241,15 +280,37 @@ namespace RunSection
 			// For the last few steps, loop over all wanted output states
 			for (auto s = states.cbegin(); s != states.cend(); s++)
 			{
+				const arma::cx_mat &P = stateProjections[*s];
 
 				// Use element-wise exponential
-				for (unsigned int j = 0; j < steps; j++)
+#pragma omp parallel for schedule(static, 1)
+				for (int c = 0; c < static_cast<int>(chunks); c++)
 				{
-					g.get()[j] = X.t() * A.get()[j].t() * stateProjections[*s] * A.get()[j] * X;
-					g.get()[j] %= arma::exp(arma::cx_double(0.0, -1.0) * L * timestep * static_cast<double>(j));
+					arma::cx_mat local = identity;
+					arma::cx_mat M;
+					for (unsigned int j = chunkStart[c]; j < chunkStart[c + 1]; j++)
+					{
+						if (this->storePropagators)
+						{
+							M = A[j];
+						}
+						else
+						{
+							if (j > 0)
+								local = arma::expmat(arma::cx_double(0.0, -1.0) * arma::cx_mat(hamiltonians[j]) * timestep) * local;
+							M = local * chunkOffsets[c];
+						}
+
+						g[j] = M.t() * P * M;
+						g[j] %= arma::exp(arma::cx_double(0.0, -1.0) * L * timestep * static_cast<double>(j));
+
+						// Only the products g^T * g enter the correlation function, see below
+						g[j] = g[j].t() * g[j];
+					}
 				}
 
-				// Compute FFT for each j-series of 'g'
+				// The correlation function of the Fourier-transformed g-matrices, G_j = sum_p FFT(g)_p^T * FFT(g)_{j+p mod steps},
+				// equals steps * FFT(g^T * g)_j since the FFT of an FFT reverses the sequence. This avoids steps^2 matrix products.
 				for (unsigned int x = 0; x < L.n_rows; x++)
 				{
 					for (unsigned int y = 0; y < L.n_cols; y++)
@@ -259,29 +320,14 @@ namespace RunSection
 
 						// Fill it with a j-series
 						for (unsigned int j = 0; j < steps; j++)
-							o(j) = g.get()[j](x, y);
+							o(j) = g[j](x, y);
 
 						// Calculate the FFT
 						arma::cx_vec offt = arma::fft(o);
 
 						// Put it back into 'g'
 						for (unsigned int j = 0; j < steps; j++)
-							g.get()[j](x, y) = offt(j);
-					}
-				}
-
-				// Obtain |G|^2 from the Fourier-transformed 'g'
-				for (unsigned int j = 0; j < steps; j++)
-				{
-					// Reset G
-					G.get()[j] = arma::zeros<arma::cx_mat>(size(L));
-
-					// Get the correlation function
-					for (unsigned int p = 0; p < steps; p++)
-					{
-						// Use "x mod n" with x = j+p
-						unsigned int q = (j + p) % steps;
-						G.get()[j] += g.get()[p].t() * g.get()[q];
+							g[j](x, y) = offt(j) * static_cast<double>(steps);
 					}
 				}
 
@@ -296,7 +342,7 @@ namespace RunSection
 					F = L + arma::ones<arma::mat>(size(L)) * w;
 					F.transform([k](double val)
 								{ return 1.0 / (1.0 + val * val / (k * k)); });
-					T += arma::abs(G.get()[j]) % F;
+					T += arma::abs(g[j]) % F;
 				}
 
 				double yield = std::sqrt(2.0 * M_PI) / std::abs(arma::trace(stateProjections[*s]) * static_cast<double>(steps * steps)) * arma::accu(T);
@@ -351,6 +397,9 @@ namespace RunSection
 			}
 		}
 
+		// Propagators can be recomputed for each state rather than stored, which needs less memory for many steps
+		this->Properties()->Get("storepropagators", this->storePropagators);
+
 		// Get totaltime/period
 		if (this->Properties()->Get("totaltime", inputTotaltime) || this->Properties()->Get("period", inputTotaltime))
 		{
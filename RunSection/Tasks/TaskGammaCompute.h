@@ -21,6 +21,7 @@ namespace RunSection
 	private:
 		unsigned int steps;
 		double totaltime;
+		bool storePropagators; // Keep all propagators in memory rather than recomputing them for each state
 
 		// Private methods
 		void WriteHeader(std::ostream &); // Write header for the output file
@@ -6,6 +6,7 @@
 // See LICENSE.txt for license information.
 /////////////////////////////////////////////////////////////////////////
 #include <iostream>
+#include <sstream>
 #include "TaskHamiltonianEigenvalues.h"
 #include "State.h"
 #include "ObjectParser.h"
@@ -21,7 +22,8 @@ namespace RunSection
 	TaskHamiltonianEigenvalues::TaskHamiltonianEigenvalues(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), printEigenvectors(false),
 																																	printHamiltonian(false), useSuperspace(false), separateRealImag(false),
 																																	initialTime(0.0), totalTime(0.0), timestep(1),
-																																	resonanceFrequencies(false), referenceStates(), transitionSpins()
+																																	resonanceFrequencies(false), referenceStates(), transitionSpins(),
+																																	eigensolver("full"), levels(1), highestLevels(false), warmStart(false)
 	{
 	}
 
@@ -42,155 +44,255 @@ namespace RunSection
 		}
 
 		// The calculations can be repeated at different times, but will be done at least once
-		bool isFirstTime = true;
-		for (double time = this->initialTime; (time <= this->totalTime || isFirstTime); time += this->timestep)
-		{
-			isFirstTime = false;
-
-			this->Log() << "---------- Setting time to " << time << " / " << this->totalTime << " ----------" << std::endl;
+		std::vector<double> times;
+		for (double time = this->initialTime; (time <= this->totalTime || times.empty()); time += this->timestep)
+			times.push_back(time);
 
-			// -----------------------------------------------------
-			// General output
-			// -----------------------------------------------------
-			this->Data() << this->RunSettings()->CurrentStep() << " " << time << " ";
-			this->WriteStandardOutput(this->Data());
+		// -----------------------------------------------------
+		// Get a SpinSpace and the reference states for each SpinSystem
+		// -----------------------------------------------------
+		auto systems = this->SpinSystems();
+		std::vector<SpinAPI::SpinSpace> spaces;
+		std::vector<std::vector<arma::cx_mat>> references(systems.size());
+		for (unsigned int s = 0; s < systems.size(); s++)
+		{
+			spaces.push_back(SpinAPI::SpinSpace(*systems[s]));
+			spaces[s].UseSuperoperatorSpace(this->useSuperspace);
 
-			// -----------------------------------------------------
-			// Loop through all SpinSystems
-			// -----------------------------------------------------
-			auto systems = this->SpinSystems();
-			for (auto i = systems.cbegin(); i != systems.cend(); i++)
+			for (auto j = this->referenceStates.cbegin(); j != this->referenceStates.cend(); j++)
 			{
-				this->Log() << "\nStarting with SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
-
-				// -----------------------------------------------------
-				// Get SpinSpace, obtain Hamiltonian, and diagonalize it
-				// -----------------------------------------------------
-				// Obtain a SpinSpace to describe the system
-				SpinAPI::SpinSpace space(*(*i));
-				space.UseSuperoperatorSpace(this->useSuperspace);
-				space.SetTime(time);
-				arma::cx_mat rho0;
-
-				// Get the Hamiltonian
-				arma::cx_mat H;
-				if (!space.Hamiltonian(H))
+				// Check whether the current state is relevant for the current spin system
+				if (!systems[s]->Contains(*j))
 				{
-					this->Log() << "Failed to obtain Hamiltonian." << std::endl;
+					this->Log() << "Skipping state " << (*j)->Name() << " as it does not belong to current spin system." << std::endl;
 					continue;
 				}
 
-				// Diagonalization
-				arma::cx_mat V;	  // To hold eigenvectors
-				arma::vec lambda; // To hold eigenvalues
-				this->Log() << "Starting diagonalization..." << std::endl;
-				arma::eig_sym(lambda, V, H);
-				this->Log() << "Diagonalization done! Eigenvalues: " << lambda.n_elem << ", eigenvectors: " << V.n_cols << std::endl;
-
-				// -----------------------------------------------------
-				// Write the main results to the data file
-				// -----------------------------------------------------
-				// Write the eigenvalues to the data file
-				for (auto j = lambda.cbegin(); j != lambda.cend(); j++)
-					this->Data() << (*j) << " ";
-
-				// Get the reference state
-				for (auto j = this->referenceStates.cbegin(); j != this->referenceStates.cend(); j++)
+				// Get a projection operator onto the state
+				arma::cx_mat R;
+				if (!spaces[s].GetState((*j), R))
 				{
-					// Check whether the current state is relevant for the current spin system
-					if (!(*i)->Contains(*j))
-					{
-						this->Log() << "Skipping state " << (*j)->Name() << " as it does not belong to current spin system." << std::endl;
-						continue;
-					}
+					this->Log() << "Failed to obtain projection matrix onto the reference state \"" << (*j)->Name() << "\" of SpinSystem \"" << systems[s]->Name() << "\"." << std::endl;
+					continue;
+				}
 
-					// Get a projection operator onto the state
-					arma::cx_mat R;
-					if (!space.GetState((*j), R))
-					{
-						this->Log() << "Failed to obtain projection matrix onto the reference state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
-						continue;
-					}
+				// Make sure the dimensions fit
+				if (R.n_rows != spaces[s].SpaceDimensions() || R.n_cols != spaces[s].SpaceDimensions())
+				{
+					this->Log() << "Warning: Problem with the reference state " << (*j)->Name() << ". Reference state ignored." << std::endl;
+					continue;
+				}
 
-					// Make sure the dimensions fit
-					if (R.n_rows != V.n_rows || R.n_cols != V.n_cols)
-					{
-						this->Log() << "Warning: Problem with the reference state " << (*j)->Name() << ". Reference state ignored." << std::endl;
-						continue;
-					}
+				references[s].push_back(R);
+			}
+		}
 
-					// Get vector to hold the projections
-					arma::vec VRVProj = arma::real(arma::diagvec(V.t() * R * V));
+		// -----------------------------------------------------
+		// Loop through the time points in batches
+		// -----------------------------------------------------
+		// The Hamiltonians are obtained one after another, as setting the time changes the interaction objects shared by the spaces, while
+		// the diagonalizations run in parallel. Each thread takes a contiguous range of time points, such that the partial eigensolver can
+		// start from the eigenvectors of the previous time point if "warmstart" is set. Where the ranges start depends on the number of threads,
+		// so the warm start is off by default. The output of each time point is collected and written in order afterwards.
+		const unsigned int batchSize = 64;
+		std::vector<arma::cx_mat> lastEigenvectors(systems.size());
+		for (unsigned int first = 0; first < times.size(); first += batchSize)
+		{
+			int count = static_cast<int>(std::min<size_t>(batchSize, times.size() - first));
 
-					// Print the results
-					for (auto refproj = VRVProj.cbegin(); refproj != VRVProj.cend(); refproj++)
-						this->Data() << (*refproj) << " ";
-				}
-				// -----------------------------------------------------
-				// END of main results
-				// -----------------------------------------------------
-
-				// -----------------------------------------------------
-				// Print Hamiltonian and eigenvectors to log stream
-				// -----------------------------------------------------
-				// Print the eigenvectors if requested
-				if (this->printEigenvectors)
+			std::vector<std::vector<arma::sp_cx_mat>> hamiltonians(count, std::vector<arma::sp_cx_mat>(systems.size()));
+			std::vector<std::vector<char>> obtained(count, std::vector<char>(systems.size(), 0));
+			for (int t = 0; t < count; t++)
+			{
+				for (unsigned int s = 0; s < systems.size(); s++)
 				{
-					this->Log() << "\n------ Printing Eigenvectors (one per column) ------\n";
-					if (this->separateRealImag)
-					{
-						this->Log() << "\n------ Real part\n";
-						arma::real(V).print(this->Log());
-						this->Log() << "\n------ Imaginary part\n";
-						arma::imag(V).print(this->Log());
-					}
-					else
-					{
-						V.print(this->Log());
-					}
-					this->Log() << "\n------ End of Eigenvectors ------\n";
+					spaces[s].SetTime(times[first + t]);
+					obtained[t][s] = spaces[s].Hamiltonian(hamiltonians[t][s]);
 				}
+			}
 
-				// Print the Hamiltonian if requested
-				if (this->printHamiltonian)
+			std::vector<std::ostringstream> data(count);
+			std::vector<std::ostringstream> logs(count);
+			std::vector<arma::cx_mat> batchEigenvectors(systems.size());
+#pragma omp parallel
+			{
+				// Each thread has its own copy of the spaces, as they cache operators
+				std::vector<SpinAPI::SpinSpace> threadSpaces(spaces);
+				std::vector<arma::cx_mat> guesses(lastEigenvectors);
+
+#pragma omp for schedule(static)
+				for (int t = 0; t < count; t++)
 				{
-					this->Log() << "\n------ Printing Hamiltonian operator ------\n";
-					if (this->separateRealImag)
-					{
-						this->Log() << "\n------ Real part\n";
-						arma::real(H).print(this->Log());
-						this->Log() << "\n------ Imaginary part\n";
-						arma::imag(H).print(this->Log());
-					}
-					else
+					logs[t] << "---------- Setting time to " << times[first + t] << " / " << this->totalTime << " ----------" << std::endl;
+
+					for (unsigned int s = 0; s < systems.size(); s++)
 					{
-						H.print(this->Log());
+						logs[t] << "\nStarting with SpinSystem \"" << systems[s]->Name() << "\"." << std::endl;
+
+						if (!obtained[t][s])
+						{
+							logs[t] << "Failed to obtain Hamiltonian." << std::endl;
+							continue;
+						}
+
+						if (!this->AnalyseHamiltonian(systems[s], threadSpaces[s], hamiltonians[t][s], references[s], guesses[s], data[t], logs[t]))
+							continue;
+
+						if (t == count - 1)
+							batchEigenvectors[s] = guesses[s];
+
+						logs[t] << "\nDone with SpinSystem \"" << systems[s]->Name() << "\"." << std::endl;
 					}
-					this->Log() << "\n------ End of Hamiltonian operator ------\n";
 				}
-				// -----------------------------------------------------
-				// END of print Hamiltonian and eigenvectors to log stream
-				// -----------------------------------------------------
-
-				// -----------------------------------------------------
-				// Other analyses to perform
-				// -----------------------------------------------------
-				if (this->resonanceFrequencies)
+			}
+			lastEigenvectors = batchEigenvectors;
+
+			// -----------------------------------------------------
+			// General output
+			// -----------------------------------------------------
+			for (int t = 0; t < count; t++)
+			{
+				this->Log() << logs[t].str();
+
+				this->Data() << this->RunSettings()->CurrentStep() << " " << times[first + t] << " ";
+				this->WriteStandardOutput(this->Data());
+				this->Data() << data[t].str();
+
+				// Terminate the line in the data file after iteration through all spin systems
+				this->Data() << std::endl;
+			}
+		}
+		// -----------------------------------------------------
+		// END loop over different times
+		// -----------------------------------------------------
+
+		return true;
+	}
+
+	// -----------------------------------------------------
+	// Diagonalization and analysis at a single time point
+	// -----------------------------------------------------
+	// Diagonalizes the Hamiltonian and writes the results to the given streams, which only uses the given copy of the SpinSpace such that
+	// time points can be analysed in parallel. _guess holds the eigenvectors used to start the partial eigensolver, and is updated.
+	bool TaskHamiltonianEigenvalues::AnalyseHamiltonian(const SpinAPI::system_ptr &_system, const SpinAPI::SpinSpace &_space, const arma::sp_cx_mat &_H, const std::vector<arma::cx_mat> &_references,
+														arma::cx_mat &_guess, std::ostream &_data, std::ostream &_log)
+	{
+		// Diagonalization
+		arma::cx_mat V;	  // To hold eigenvectors
+		arma::vec lambda; // To hold eigenvalues
+		_log << "Starting diagonalization..." << std::endl;
+
+		bool diagonalized = false;
+		if (this->eigensolver == "eigenvalues")
+		{
+			diagonalized = _space.BlockEigenvalues(_H, lambda);
+		}
+		else if (this->eigensolver == "partial")
+		{
+			unsigned int k = std::min<unsigned int>(this->levels, _H.n_rows);
+			if (this->warmStart)
+				V = _guess;
+			diagonalized = _space.PartialEigenDecomposition(_H, k, !this->highestLevels, lambda, V);
+
+			// Use the same levels from the full spectrum if the partial eigensolver fails
+			if (!diagonalized)
+			{
+				_log << "The partial eigensolver did not converge, using the full diagonalization instead." << std::endl;
+				diagonalized = _space.BlockEigenDecomposition(_H, lambda, V);
+				if (diagonalized)
 				{
-					this->GetResonanceFrequencies(lambda, V, (*i), space);
+					lambda = this->highestLevels ? arma::vec(lambda.tail(k)) : arma::vec(lambda.head(k));
+					V = this->highestLevels ? arma::cx_mat(V.tail_cols(k)) : arma::cx_mat(V.head_cols(k));
 				}
-				// -----------------------------------------------------
-				// END of other analyses to perform
-				// -----------------------------------------------------
+			}
+
+			if (diagonalized)
+				_guess = V;
+		}
+		else
+		{
+			diagonalized = _space.BlockEigenDecomposition(_H, lambda, V);
+		}
+
+		if (!diagonalized)
+		{
+			_log << "Failed to diagonalize Hamiltonian." << std::endl;
+			return false;
+		}
+		_log << "Diagonalization done! Eigenvalues: " << lambda.n_elem << ", eigenvectors: " << V.n_cols << std::endl;
 
-				this->Log() << "\nDone with SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+		// -----------------------------------------------------
+		// Write the main results to the data file
+		// -----------------------------------------------------
+		// Write the eigenvalues to the data file
+		for (auto j = lambda.cbegin(); j != lambda.cend(); j++)
+			_data << (*j) << " ";
+
+		// Get the projections onto the reference states
+		for (auto R = _references.cbegin(); R != _references.cend(); R++)
+		{
+			arma::vec VRVProj = arma::real(arma::diagvec(V.t() * (*R) * V));
+
+			// Print the results
+			for (auto refproj = VRVProj.cbegin(); refproj != VRVProj.cend(); refproj++)
+				_data << (*refproj) << " ";
+		}
+		// -----------------------------------------------------
+		// END of main results
+		// -----------------------------------------------------
+
+		// -----------------------------------------------------
+		// Print Hamiltonian and eigenvectors to log stream
+		// -----------------------------------------------------
+		// Print the eigenvectors if requested
+		if (this->printEigenvectors)
+		{
+			_log << "\n------ Printing Eigenvectors (one per column) ------\n";
+			if (this->separateRealImag)
+			{
+				_log << "\n------ Real part\n";
+				arma::real(V).print(_log);
+				_log << "\n------ Imaginary part\n";
+				arma::imag(V).print(_log);
+			}
+			else
+			{
+				V.print(_log);
 			}
+			_log << "\n------ End of Eigenvectors ------\n";
+		}
 
-			// Terminate the line in the data file after iteration through all spin systems
-			this->Data() << std::endl;
+		// Print the Hamiltonian if requested
+		if (this->printHamiltonian)
+		{
+			arma::cx_mat H(_H);
+			_log << "\n------ Printing Hamiltonian operator ------\n";
+			if (this->separateRealImag)
+			{
+				_log << "\n------ Real part\n";
+				arma::real(H).print(_log);
+				_log << "\n------ Imaginary part\n";
+				arma::imag(H).print(_log);
+			}
+			else
+			{
+				H.print(_log);
+			}
+			_log << "\n------ End of Hamiltonian operator ------\n";
 		}
 		// -----------------------------------------------------
-		// END loop over different times
+		// END of print Hamiltonian and eigenvectors to log stream
+		// -----------------------------------------------------
+
+		// -----------------------------------------------------
+		// Other analyses to perform
+		// -----------------------------------------------------
+		if (this->resonanceFrequencies)
+		{
+			this->GetResonanceFrequencies(lambda, V, _system, _space, _log);
+		}
+		// -----------------------------------------------------
+		// END of other analyses to perform
 		// -----------------------------------------------------
 
 		return true;
@@ -200,10 +302,10 @@ namespace RunSection
 	// Resonance frequency analysis
 	// -----------------------------------------------------
 	// Analysis the eigenvalues to obtain the resonance frequencies of the spin system
-	void TaskHamiltonianEigenvalues::GetResonanceFrequencies(const arma::vec &_e, const arma::cx_mat &_V, const std::shared_ptr<SpinAPI::SpinSystem> &_system, const SpinAPI::SpinSpace &_space)
+	void TaskHamiltonianEigenvalues::GetResonanceFrequencies(const arma::vec &_e, const arma::cx_mat &_V, const std::shared_ptr<SpinAPI::SpinSystem> &_system, const SpinAPI::SpinSpace &_space, std::ostream &_stream)
 	{
 		// Write header
-		this->Log() << "\n------ Resonance frequency analysis ------" << std::endl;
+		_stream << "\n------ Resonance frequency analysis ------" << std::endl;
 
 		// Get a list of spins for calculating the transition frequencies
 		std::vector<std::pair<SpinAPI::spin_ptr, std::vector<arma::cx_mat>>> spins;
@@ -218,13 +320,13 @@ namespace RunSection
 
 				// Obtain the spin operator matrix representation in the full Hilbert space,
 				// and transform by the eigenstates to obtain the transition matrix
-				_space.CreateOperator(arma::conv_to<arma::cx_mat>::from(spin->Sx()), spin, O);
+				_space.CreateOperator(SpinAPI::SpinOperatorType::Sx, spin, O);
 				tmp.push_back(_V.t() * O * _V);
 
-				_space.CreateOperator(arma::conv_to<arma::cx_mat>::from(spin->Sy()), spin, O);
+				_space.CreateOperator(SpinAPI::SpinOperatorType::Sy, spin, O);
 				tmp.push_back(_V.t() * O * _V);
 
-				_space.CreateOperator(arma::conv_to<arma::cx_mat>::from(spin->Sz()), spin, O);
+				_space.CreateOperator(SpinAPI::SpinOperatorType::Sz, spin, O);
 				tmp.push_back(_V.t() * O * _V);
 
 				spins.push_back(std::pair<SpinAPI::spin_ptr, std::vector<arma::cx_mat>>(spin, tmp));
@@ -233,48 +335,48 @@ namespace RunSection
 
 		if (spins.size() > 0)
 		{
-			this->Log() << "\nTransition matrix elements will be calculated for " << spins.size() << " spins found in the SpinSystem " << _system->Name();
-			this->Log() << ", and will be denoted Sx(spinname), Sy(spinname) and Sz(spinname).\n";
+			_stream << "\nTransition matrix elements will be calculated for " << spins.size() << " spins found in the SpinSystem " << _system->Name();
+			_stream << ", and will be denoted Sx(spinname), Sy(spinname) and Sz(spinname).\n";
 		}
 
-		this->Log() << "\nThe table below describes transitions from eigenstate 'i' to eigenstate 'j'.";
-		this->Log() << "\nThe angular frequency (\"omega\") is denoted 'w' and given in rad/ns,";
-		this->Log() << "\nwhile the actual resonance frequency, 'f', is given in MHz.";
-		this->Log() << "\n\ni j w f";
+		_stream << "\nThe table below describes transitions from eigenstate 'i' to eigenstate 'j'.";
+		_stream << "\nThe angular frequency (\"omega\") is denoted 'w' and given in rad/ns,";
+		_stream << "\nwhile the actual resonance frequency, 'f', is given in MHz.";
+		_stream << "\n\ni j w f";
 
 		for (const std::pair<SpinAPI::spin_ptr, std::vector<arma::cx_mat>> &s : spins)
 		{
 			if (this->separateRealImag)
-				this->Log() << " Sx(" << s.first->Name() << ").real Sx(" << s.first->Name() << ").imaginary Sy(" << s.first->Name() << ").real Sy(" << s.first->Name() << ").imaginary Sz(" << s.first->Name() << ").real Sz(" << s.first->Name() << ").imaginary";
+				_stream << " Sx(" << s.first->Name() << ").real Sx(" << s.first->Name() << ").imaginary Sy(" << s.first->Name() << ").real Sy(" << s.first->Name() << ").imaginary Sz(" << s.first->Name() << ").real Sz(" << s.first->Name() << ").imaginary";
 			else
-				this->Log() << " Sx(" << s.first->Name() << ") Sy(" << s.first->Name() << ") Sz(" << s.first->Name() << ")";
+				_stream << " Sx(" << s.first->Name() << ") Sy(" << s.first->Name() << ") Sz(" << s.first->Name() << ")";
 		}
 
-		this->Log() << "\n";
+		_stream << "\n";
 
 		for (unsigned int i = 0; i < _e.n_elem; i++)
 		{
 			for (unsigned int j = i + 1; j < _e.n_elem; j++)
 			{
-				this->Log() << i << " ";
-				this->Log() << j << " ";
-				this->Log() << std::abs(_e[j] - _e[i]) << " ";
-				this->Log() << (std::abs(_e[j] - _e[i]) / (2.0 * M_PI) * 1000.0) << " ";
+				_stream << i << " ";
+				_stream << j << " ";
+				_stream << std::abs(_e[j] - _e[i]) << " ";
+				_stream << (std::abs(_e[j] - _e[i]) / (2.0 * M_PI) * 1000.0) << " ";
 
 				// Transition matrix elements
 				for (const std::pair<SpinAPI::spin_ptr, std::vector<arma::cx_mat>> &s : spins)
 				{
 					if (this->separateRealImag)
-						this->Log() << std::real(s.second[0](i, j)) << " " << std::imag(s.second[0](i, j)) << " " << std::real(s.second[1](i, j)) << " " << std::imag(s.second[1](i, j)) << " " << std::real(s.second[2](i, j)) << " " << std::imag(s.second[2](i, j)) << " ";
+						_stream << std::real(s.second[0](i, j)) << " " << std::imag(s.second[0](i, j)) << " " << std::real(s.second[1](i, j)) << " " << std::imag(s.second[1](i, j)) << " " << std::real(s.second[2](i, j)) << " " << std::imag(s.second[2](i, j)) << " ";
 					else
-						this->Log() << s.second[0](i, j) << " " << s.second[1](i, j) << " " << s.second[2](i, j) << " ";
+						_stream << s.second[0](i, j) << " " << s.second[1](i, j) << " " << s.second[2](i, j) << " ";
 				}
 
-				this->Log() << "\n";
+				_stream << "\n";
 			}
 		}
 
-		this->Log() << "\n------ END of resonance frequency analysis ------" << std::endl;
+		_stream << "\n------ END of resonance frequency analysis ------" << std::endl;
 	}
 
 	// -----------------------------------------------------
@@ -292,13 +394,24 @@ namespace RunSection
 			SpinAPI::SpinSpace space(*(*i));
 			space.UseSuperoperatorSpace(this->useSuperspace);
 
+			// The partial eigensolver only gives some of the levels, which keep their index in the full spectrum
+			unsigned int first = 0;
+			unsigned int last = space.SpaceDimensions();
+			if (this->eigensolver == "partial" && this->levels < last)
+			{
+				if (this->highestLevels)
+					first = last - this->levels;
+				else
+					last = this->levels;
+			}
+
 			// Write the headers for the eigenvalues
-			for (unsigned int j = 0; j < space.SpaceDimensions(); j++)
+			for (unsigned int j = first; j < last; j++)
 				_stream << (*i)->Name() << ".H.lambda" << j << " ";
 
 			// Write headers for the reference states
 			for (auto refstate = this->referenceStates.cbegin(); refstate != this->referenceStates.cend(); refstate++)
-				for (unsigned int j = 0; j < space.SpaceDimensions(); j++)
+				for (unsigned int j = first; j < last; j++)
 					_stream << (*i)->Name() << ".H.ref" << j << "(" << (*refstate)->Name() << ")" << " ";
 		}
 		_stream << std::endl;
@@ -309,6 +422,10 @@ namespace RunSection
 	// -----------------------------------------------------
 	bool TaskHamiltonianEigenvalues::Validate()
 	{
+		// The eigenvalues would be written without the multiplicities of groups of equivalent spins
+		if (this->HasEquivalentSpins())
+			return false;
+
 		// Should we use superspace Hamiltonian instead of normal Hamiltonian?
 		if (this->Properties()->Get("superspace", this->useSuperspace) || this->Properties()->Get("usesuperspace", this->useSuperspace))
 		{
@@ -423,6 +540,44 @@ namespace RunSection
 			}
 		}
 
+		// Choose the eigensolver, which may skip the eigenvectors or only find some of the levels
+		if (this->Properties()->Get("eigensolver", this->eigensolver))
+		{
+			if (this->eigensolver == "sparse")
+				this->eigensolver = "partial";
+
+			if (this->eigensolver != "full" && this->eigensolver != "eigenvalues" && this->eigensolver != "partial")
+			{
+				this->Log(MessageType_Critical | MessageType_Error) << "Task " << this->Name() << ": ERROR: Unknown eigensolver \"" << this->eigensolver << "\"! Using the full diagonalization." << std::endl;
+				this->eigensolver = "full";
+			}
+		}
+
+		// The eigenvectors are needed for the reference states, for printing, and for transition matrix elements
+		if (this->eigensolver == "eigenvalues" && (this->printEigenvectors || !this->referenceStates.empty() || (this->resonanceFrequencies && !this->transitionSpins.empty())))
+		{
+			this->Log(MessageType_Important | MessageType_Warning) << "Task " << this->Name() << ": WARNING: The requested output needs the eigenvectors! Using the full diagonalization." << std::endl;
+			this->eigensolver = "full";
+		}
+
+		if (this->eigensolver == "partial")
+		{
+			if (this->Properties()->Get("levels", this->levels) && this->levels < 1)
+			{
+				this->levels = 1;
+				this->Log(MessageType_Critical | MessageType_Error) << "Task " << this->Name() << ": ERROR: Invalid number of levels specified! Setting levels to " << this->levels << "." << std::endl;
+			}
+
+			std::string spectrum;
+			if (this->Properties()->Get("spectrum", spectrum))
+				this->highestLevels = (spectrum == "highest");
+
+			this->Properties()->Get("warmstart", this->warmStart);
+			this->Log(MessageType_Details) << "Task " << this->Name() << ": Finding the " << this->levels << (this->highestLevels ? " highest" : " lowest") << " levels." << std::endl;
+		}
+
+		this->Log(MessageType_Details) << "Task " << this->Name() << ": Using the " << this->eigensolver << " eigensolver." << std::endl;
+
 		return true;
 	}
 	// -----------------------------------------------------
@@ -29,10 +29,15 @@ namespace RunSection
 		bool resonanceFrequencies;
 		std::vector<SpinAPI::state_ptr> referenceStates;
 		std::vector<std::string> transitionSpins; // Used for transition matrix element calculations
+		std::string eigensolver;				  // "full", "eigenvalues" (no eigenvectors) or "partial" (some of the lowest or highest levels)
+		unsigned int levels;					  // Number of levels obtained by the partial eigensolver
+		bool highestLevels;
+		bool warmStart; // If true, the partial eigensolver also starts from the eigenvectors of the previous time point, which depends on the number of threads
 
 		// Private methods
 		void WriteHeader(std::ostream &); // Write header for the output file
-		void GetResonanceFrequencies(const arma::vec &, const arma::cx_mat &, const std::shared_ptr<SpinAPI::SpinSystem> &, const SpinAPI::SpinSpace &);
+		bool AnalyseHamiltonian(const SpinAPI::system_ptr &, const SpinAPI::SpinSpace &, const arma::sp_cx_mat &, const std::vector<arma::cx_mat> &, arma::cx_mat &, std::ostream &, std::ostream &);
+		void GetResonanceFrequencies(const arma::vec &, const arma::cx_mat &, const std::shared_ptr<SpinAPI::SpinSystem> &, const SpinAPI::SpinSpace &, std::ostream &);
 
 	protected:
 		bool RunLocal() override;
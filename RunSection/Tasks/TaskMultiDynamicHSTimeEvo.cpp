@@ -92,6 +92,7 @@ namespace RunSection
 					else
 						rho0 += tmp_rho0;
 				}
+				i->second->WeightEquivalentSpins(rho0);
 				rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 			}
 
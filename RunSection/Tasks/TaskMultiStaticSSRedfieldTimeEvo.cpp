@@ -100,6 +100,7 @@ namespace RunSection
 					else
 						rho0HS += tmp_rho0;
 				}
+				i->second->WeightEquivalentSpins(rho0HS);
 				rho0HS /= arma::trace(rho0HS); // The density operator should have a trace of 1
 			}
 
@@ -368,17 +369,17 @@ namespace RunSection
 
 											this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-											if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+											if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 											{
 												return false;
 											}
 
-											if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+											if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 											{
 												return false;
 											}
 
-											if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+											if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 											{
 												return false;
 											}
@@ -750,32 +751,32 @@ namespace RunSection
 
 												this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-												if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+												if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 												{
 													return false;
 												}
 
-												if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+												if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 												{
 													return false;
 												}
 
-												if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+												if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 												{
 													return false;
 												}
 
-												if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+												if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 												{
 													return false;
 												}
 
-												if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+												if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 												{
 													return false;
 												}
 
-												if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+												if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 												{
 													return false;
 												}
@@ -1169,17 +1170,17 @@ namespace RunSection
 
 										this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-										if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+										if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 										{
 											return false;
 										}
 
-										if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+										if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 										{
 											return false;
 										}
 
-										if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+										if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 										{
 											return false;
 										}
@@ -1640,32 +1641,32 @@ namespace RunSection
 
 											this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-											if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+											if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 											{
 												return false;
 											}
 
-											if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+											if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 											{
 												return false;
 											}
 
-											if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+											if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 											{
 												return false;
 											}
 
-											if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+											if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 											{
 												return false;
 											}
 
-											if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+											if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 											{
 												return false;
 											}
 
-											if (!i->second->CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+											if (!i->second->CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 											{
 												return false;
 											}
@@ -8,7 +8,9 @@
 // See LICENSE.txt for license information.
 /////////////////////////////////////////////////////////////////////////
 #include <iostream>
+#include <memory>
 #include "TaskMultiStaticSSTimeEvo.h"
+#include "KrylovPropagator.h"
 #include "Transition.h"
 #include "Settings.h"
 #include "State.h"
@@ -43,6 +45,7 @@ namespace RunSection
 		// Loop through all SpinSystems to obtain SpinSpace objects
 		auto systems = this->SpinSystems();
 		std::vector<std::pair<std::shared_ptr<SpinAPI::SpinSystem>, std::shared_ptr<SpinAPI::SpinSpace>>> spaces;
+		std::vector<SpinAPI::ObservableSet> observables; // Projection operators onto the states of each system, in the same order as "spaces"
 		unsigned int dimensions = 0;
 		for (auto i = systems.cbegin(); i != systems.cend(); i++)
 		{
@@ -55,6 +58,17 @@ namespace RunSection
 
 			// Make sure to save the newly created spin space
 			spaces.push_back(std::pair<std::shared_ptr<SpinAPI::SpinSystem>, std::shared_ptr<SpinAPI::SpinSpace>>(*i, space));
+
+			// Collect the projection operators onto the states once, as each step then only needs a single matrix-vector product
+			SpinAPI::ObservableSet observableSet(space->HilbertSpaceDimensions(), true);
+			auto states = (*i)->States();
+			for (auto j = states.cbegin(); j != states.cend(); j++)
+			{
+				arma::sp_cx_mat PState;
+				if (!space->GetState((*j), PState) || !observableSet.Add(PState))
+					this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+			}
+			observables.push_back(observableSet);
 		}
 
 		// Now, create a matrix to hold the Liouvillian superoperator and the initial state
@@ -90,6 +104,7 @@ namespace RunSection
 					else
 						rho0HS += tmp_rho0;
 				}
+				i->second->WeightEquivalentSpins(rho0HS);
 				rho0HS /= arma::trace(rho0HS); // The density operator should have a trace of 1
 			}
 
@@ -164,60 +179,65 @@ namespace RunSection
 		nextDimension = 0;
 		for (auto i = spaces.cbegin(); i != spaces.cend(); i++)
 		{
-			// Get the superspace result vector and convert it back to the native Hilbert space
-			arma::cx_mat rho_result;
+			// Get the results directly from the superspace result vector
 			arma::cx_vec rho_result_vec;
 			rho_result_vec = rho0.rows(nextDimension, nextDimension + i->second->SpaceDimensions() - 1);
-			if (!i->second->OperatorFromSuperspace(rho_result_vec, rho_result))
-			{
-				this->Log() << "ERROR: Failed to convert resulting superspace-vector back to native Hilbert space for spin system \"" << i->first->Name() << "\"!" << std::endl;
-				return false;
-			}
-
-			// Get the results
-			this->GatherResults(rho_result, *(i->first), *(i->second));
+			this->GatherResults(rho_result_vec, observables[i - spaces.cbegin()]);
 
 			// Move on to next spin space
 			nextDimension += i->second->SpaceDimensions();
 		}
 		this->Data() << std::endl;
 
-		// We need the propagator
-		this->Log() << "Calculating the propagator..." << std::endl;
-		arma::cx_mat P = arma::expmat(arma::conv_to<arma::cx_mat>::from(L) * this->timestep);
+		// We need the propagator, or the krylov propagator that only needs the sparse Liouvillian
+		arma::cx_mat P;
+		std::shared_ptr<SpinAPI::KrylovPropagator> krylov = nullptr;
+		if (this->propagation.method == "krylov")
+		{
+			krylov = std::make_shared<SpinAPI::KrylovPropagator>(L, arma::cx_double(1.0, 0.0), false, this->propagation.krylovSize, this->propagation.krylovMaxSize, this->propagation.krylovTolerance);
+			krylov->SetState(rho0);
+		}
+		else
+		{
+			this->Log() << "Calculating the propagator..." << std::endl;
+			P = arma::expmat(arma::conv_to<arma::cx_mat>::from(L) * this->timestep);
+		}
 
 		// Perform the calculation
 		this->Log() << "Ready to perform calculation." << std::endl;
 		unsigned int steps = static_cast<unsigned int>(std::abs(this->totaltime / this->timestep));
 		for (unsigned int n = 1; n <= steps; n++)
 		{
-			// Write first part of the data output
-			this->Data() << this->RunSettings()->CurrentStep() << " ";
-			this->Data() << (static_cast<double>(n) * this->timestep) << " ";
-			this->WriteStandardOutput(this->Data());
-
 			// Propagate (use special scope to be able to dispose of the temporary vector asap)
+			if (krylov != nullptr)
+			{
+				// A failed step would leave a stale state, and all spin systems share the propagated state, so the calculation is aborted
+				if (!krylov->Step(this->timestep))
+				{
+					this->Log() << "Failed to propagate the spin systems at time " << (static_cast<double>(n) * this->timestep) << " ns, no acceptable Krylov step was found. Consider increasing krylovmaxsize or krylovtol." << std::endl;
+					return false;
+				}
+				rho0 = krylov->State();
+			}
+			else
 			{
 				arma::cx_vec tmp = P * rho0;
 				rho0 = tmp;
 			}
 
+			// Write first part of the data output
+			this->Data() << this->RunSettings()->CurrentStep() << " ";
+			this->Data() << (static_cast<double>(n) * this->timestep) << " ";
+			this->WriteStandardOutput(this->Data());
+
 			// Retrieve the resulting density matrix for each spin system and output the results
 			nextDimension = 0;
 			for (auto i = spaces.cbegin(); i != spaces.cend(); i++)
 			{
-				// Get the superspace result vector and convert it back to the native Hilbert space
-				arma::cx_mat rho_result;
+				// Get the results directly from the superspace result vector
 				arma::cx_vec rho_result_vec;
 				rho_result_vec = rho0.rows(nextDimension, nextDimension + i->second->SpaceDimensions() - 1);
-				if (!i->second->OperatorFromSuperspace(rho_result_vec, rho_result))
-				{
-					this->Log() << "ERROR: Failed to convert resulting superspace-vector back to native Hilbert space for spin system \"" << i->first->Name() << "\"!" << std::endl;
-					return false;
-				}
-
-				// Get the results
-				this->GatherResults(rho_result, *(i->first), *(i->second));
+				this->GatherResults(rho_result_vec, observables[i - spaces.cbegin()]);
 
 				// Move on to next spin space
 				nextDimension += i->second->SpaceDimensions();
@@ -232,23 +252,14 @@ namespace RunSection
 		return true;
 	}
 
-	// Gathers and outputs the results from a given time-integrated density operator
-	void TaskMultiStaticSSTimeEvo::GatherResults(const arma::cx_mat &_rho, const SpinAPI::SpinSystem &_system, const SpinAPI::SpinSpace &_space)
+	// Gathers and outputs the results from a given superspace density operator
+	void TaskMultiStaticSSTimeEvo::GatherResults(const arma::cx_vec &_rho, const SpinAPI::ObservableSet &_observables)
 	{
-		// Loop through all states
-		arma::cx_mat P;
-		auto states = _system.States();
-		for (auto j = states.cbegin(); j != states.cend(); j++)
-		{
-			if (!_space.GetState((*j), P))
-			{
-				this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << _system.Name() << "\"." << std::endl;
-				continue;
-			}
-
-			// Return the yield for this state - note that no reaction rates are included here.
-			this->Data() << std::abs(arma::trace(P * _rho)) << " ";
-		}
+		// Return the yield for each state - note that no reaction rates are included here.
+		arma::cx_vec expectations;
+		if (_observables.Evaluate(_rho, expectations))
+			for (unsigned int k = 0; k < expectations.n_elem; k++)
+				this->Data() << std::abs(expectations(k)) << " ";
 	}
 
 	// Writes the header of the data file (but can also be passed to other streams)
@@ -324,6 +335,9 @@ namespace RunSection
 			}
 		}
 
+		// Get the propagation method, the krylov method applies the exponential of the sparse Liouvillian without forming the propagator
+		this->propagation.ReadSuperspace(*this->Properties(), this->Log());
+
 		return true;
 	}
 	// -----------------------------------------------------
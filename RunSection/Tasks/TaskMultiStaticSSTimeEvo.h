@@ -14,9 +14,11 @@
 #define MOD_RunSection_TaskMultiStaticSSTimeEvo
 
 #include "BasicTask.h"
+#include "PropagationSettings.h"
 #include "SpinSpace.h"
 #include "SpinSystem.h"
 #include "SpinAPIDefines.h"
+#include "ObservableSet.h"
 
 namespace RunSection
 {
@@ -26,11 +28,12 @@ namespace RunSection
 		double timestep;
 		double totaltime;
 		SpinAPI::ReactionOperatorType reactionOperators;
+		PropagationSettings propagation; // "expm" for the dense propagator, or "krylov" for the action of the exponential on the sparse Liouvillian
 
 		void WriteHeader(std::ostream &); // Write header for the output file
 
-		// Private method that gathers and outputs the results from a given time-integrated density operator
-		void GatherResults(const arma::cx_mat &, const SpinAPI::SpinSystem &, const SpinAPI::SpinSpace &);
+		// Private method that gathers and outputs the results from a given superspace density operator
+		void GatherResults(const arma::cx_vec &, const SpinAPI::ObservableSet &);
 
 	protected:
 		bool RunLocal() override;
@@ -11,6 +11,7 @@
 #include "Settings.h"
 #include "State.h"
 #include "SpinSystem.h"
+#include "AffineOperator.h"
 #include "Interaction.h"
 #include "ObjectParser.h"
 
@@ -19,7 +20,7 @@ namespace RunSection
 	// -----------------------------------------------------
 	// TaskStaticSS Constructors and Destructor
 	// -----------------------------------------------------
-	TaskPeriodicHSTimeEvo::TaskPeriodicHSTimeEvo(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), timestep(0.01), totaltime(1.0e+4), stepsPerPeriod(50), outputstride(1), modeQuantumYield(false), productYieldsOnly(false), timedependentInteractions(false)
+	TaskPeriodicHSTimeEvo::TaskPeriodicHSTimeEvo(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), timestep(0.01), totaltime(1.0e+4), stepsPerPeriod(50), outputstride(1), modeQuantumYield(false), productYieldsOnly(false), timedependentInteractions(false), floquet(false)
 	{
 	}
 
@@ -88,28 +89,33 @@ namespace RunSection
 				this->Log() << "Warning: Failed to obtain matrix representation of Transitions!" << std::endl;
 			}
 
-			// Get the dynamic part of the Hamiltonian (NOTE: This changes the time of the spinspace)
-			std::vector<arma::sp_cx_mat> dH;
-			for (unsigned int n = 0; n < this->stepsPerPeriod; n++)
+			// Get the operators of the dynamic part of the Hamiltonian, and their coefficients at each step of the period
+			// (NOTE: This changes the time of the spinspace). Only the coefficients are stored, and the dynamic Hamiltonian
+			// of a step is evaluated from them on a fixed sparsity pattern.
+			SpinAPI::AffineOperator dHt(space.SpaceDimensions());
+			if (this->timedependentInteractions && !space.DynamicHamiltonianTerms(dHt))
 			{
-				// If there are no time-dependent interactions, we still need to fill up the list
-				if (!this->timedependentInteractions)
-				{
-					dH.push_back(arma::sp_cx_mat(space.SpaceDimensions(), space.SpaceDimensions()));
-					continue;
-				}
+				this->Log() << "Failed to obtain the Hamiltonian! Skipping system." << std::endl;
+				return false;
+			}
 
-				// Get the dynamic part
-				space.SetTime(static_cast<double>(n) * propagator_stepsize);
-				arma::sp_cx_mat tmpH;
-				if (!space.DynamicHamiltonian(tmpH))
+			std::vector<arma::cx_vec> dHcoefficients;
+			for (unsigned int n = 0; n < this->stepsPerPeriod; n++)
+			{
+				// If there are no time-dependent interactions, there are no terms and we still need to fill up the list
+				arma::cx_vec coefficients;
+				if (this->timedependentInteractions)
 				{
-					this->Log() << "Failed to obtain the Hamiltonian! Skipping system." << std::endl;
-					return false;
+					space.SetTime(static_cast<double>(n) * propagator_stepsize);
+					if (!space.DynamicHamiltonianCoefficients(coefficients))
+					{
+						this->Log() << "Failed to obtain the Hamiltonian! Skipping system." << std::endl;
+						return false;
+					}
 				}
-				dH.push_back(tmpH);
+				dHcoefficients.push_back(coefficients);
 			}
-			this->Log() << "Obtained " << dH.size() << " dynamic Hamiltonians for spin system " << (*i)->Name() << "." << std::endl;
+			this->Log() << "Obtained " << dHcoefficients.size() << " dynamic Hamiltonians with " << dHt.Terms() << " terms for spin system " << (*i)->Name() << "." << std::endl;
 
 			// Get the initial state
 			arma::cx_mat rho0;
@@ -126,6 +132,7 @@ namespace RunSection
 				else
 					rho0 += tmp_rho0;
 			}
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
 			// Get the number of steps
@@ -151,36 +158,131 @@ namespace RunSection
 				}
 			}
 
+			// Collect the projection operators once, either onto the source states of the transitions or onto the states,
+			// as each step then only needs a single matrix-vector product
+			SpinAPI::ObservableSet observables(space.HilbertSpaceDimensions(), false);
+			std::vector<std::string> observableNames;
+			arma::sp_cx_mat PState;
+			if (this->modeQuantumYield && this->productYieldsOnly)
+			{
+				for (auto j = transitions.cbegin(); j != transitions.cend(); j++)
+				{
+					// Make sure that there is a state object
+					if ((*j)->SourceState() == nullptr)
+						continue;
+
+					if (!space.GetState((*j)->SourceState(), PState) || !observables.Add(PState))
+					{
+						this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\"." << std::endl;
+						continue;
+					}
+					observableNames.push_back((*j)->Name());
+				}
+			}
+			else
+			{
+				for (auto j = states.cbegin(); j != states.cend(); j++)
+				{
+					if (!space.GetState((*j), PState) || !observables.Add(PState))
+					{
+						this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\"." << std::endl;
+						continue;
+					}
+					observableNames.push_back((*j)->Name());
+				}
+			}
+
+			// In Floquet mode the exact propagators of the time steps within a period are formed in parallel, and the expectation values of each
+			// step of a period are obtained from the density operator at the start of the period with the observables in the Heisenberg picture
+			unsigned int floquetSteps = this->floquet ? this->FloquetSteps(period) : 0;
+			std::vector<arma::cx_mat> stepPropagators(floquetSteps);
+			std::vector<arma::cx_mat> floquetObservables(floquetSteps);
+			arma::cx_mat floquetPropagator;
+			if (floquetSteps > 0)
+			{
+#pragma omp parallel for schedule(dynamic)
+				for (int r = 0; r < static_cast<int>(floquetSteps); r++)
+				{
+					unsigned int dHIndex = static_cast<unsigned int>(static_cast<double>(r + 1) * this->timestep / propagator_stepsize) % dHcoefficients.size();
+					arma::sp_cx_mat dHr;
+					dHt.Evaluate(dHcoefficients[dHIndex], dHr);
+					stepPropagators[r] = arma::expmat(-(arma::cx_double(0.0, 1.0) * (H + dHr) + K) * this->timestep);
+				}
+
+				// The propagators from the start of the period to each of its steps, ending with the propagator of the whole period
+				floquetPropagator = arma::eye<arma::cx_mat>(arma::size(H));
+				for (unsigned int r = 0; r < floquetSteps; r++)
+				{
+					observables.HeisenbergObservables(floquetPropagator, floquetObservables[r]);
+					floquetPropagator = stepPropagators[r] * floquetPropagator;
+				}
+				this->Log() << "Using Floquet propagation with " << floquetSteps << " time steps per period." << std::endl;
+			}
+
 			// Perform the calculation
 			this->Log() << "Ready to perform calculation." << std::endl;
 
 			// Output results for time 0
 			if (!this->modeQuantumYield)
-				OutputTimeEvolution(space, rho0, 0, states);
+				OutputTimeEvolution(observables, rho0, 0);
 
-			// Run the time integration
-			for (unsigned int n = 1; n <= steps; n++)
+			if (floquetSteps > 0)
 			{
-				// Get the dynamic Hamiltonian index to use
-				unsigned int dHIndex = static_cast<unsigned int>(static_cast<double>(n) * this->timestep / propagator_stepsize) % dH.size();
+				// Advance whole periods, the density operator is only needed at the start of each period
+				arma::cx_vec expectations;
+				for (unsigned int n = 1; n <= steps; n++)
+				{
+					unsigned int r = n % floquetSteps;
+					if (r == 0)
+						rho0 = floquetPropagator * rho0 * floquetPropagator.t();
 
-				// Advance a timestep
-				AdvanceStep_AsyncLeapfrog(H + dH[dHIndex], K, rho0);
+					if (this->modeQuantumYield)
+					{
+						expectations = floquetObservables[r] * arma::vectorise(rho0);
+						GetQuantumYields(observableNames, expectations, n, yields);
+					}
+					else if (n % this->outputstride == 0)
+					{
+						// Set the time (in order to write correct standard output)
+						space.SetTime(static_cast<double>(n) * this->timestep);
 
-				// Should we calculate the quantum yield rather than just the time evolution?
-				if (this->modeQuantumYield)
-				{
-					GetQuantumYields(space, rho0, n, states, transitions, yields);
+						expectations = floquetObservables[r] * arma::vectorise(rho0);
+						OutputTimeEvolution(expectations, n);
+					}
 				}
-				else
+
+				// Bring the density operator from the start of the last period to the last step
+				for (unsigned int r = 0; r < steps % floquetSteps; r++)
+					rho0 = stepPropagators[r] * rho0 * stepPropagators[r].t();
+			}
+			else
+			{
+				// Run the time integration
+				arma::sp_cx_mat dH;
+				for (unsigned int n = 1; n <= steps; n++)
 				{
-					// If not, just output the time evolution
-					if (n % this->outputstride == 0)
+					// Get the dynamic Hamiltonian index to use
+					unsigned int dHIndex = static_cast<unsigned int>(static_cast<double>(n) * this->timestep / propagator_stepsize) % dHcoefficients.size();
+					dHt.Evaluate(dHcoefficients[dHIndex], dH);
+
+					// Advance a timestep
+					AdvanceStep_AsyncLeapfrog(H + dH, K, rho0);
+
+					// Should we calculate the quantum yield rather than just the time evolution?
+					if (this->modeQuantumYield)
 					{
-						// Set the time (in order to write correct standard output)
-						space.SetTime(static_cast<double>(n) * this->timestep);
+						GetQuantumYields(observables, observableNames, rho0, n, yields);
+					}
+					else
+					{
+						// If not, just output the time evolution
+						if (n % this->outputstride == 0)
+						{
+							// Set the time (in order to write correct standard output)
+							space.SetTime(static_cast<double>(n) * this->timestep);
 
-						OutputTimeEvolution(space, rho0, n, states);
+							OutputTimeEvolution(observables, rho0, n);
+						}
 					}
 				}
 			}
@@ -222,23 +324,25 @@ namespace RunSection
 	// -----------------------------------------------------
 	// Writes the output for a timestep
 	// -----------------------------------------------------
-	void TaskPeriodicHSTimeEvo::OutputTimeEvolution(const SpinAPI::SpinSpace &_space, const arma::cx_mat &_rho, const unsigned int _step, const std::vector<SpinAPI::state_ptr> &_states)
+	void TaskPeriodicHSTimeEvo::OutputTimeEvolution(const SpinAPI::ObservableSet &_observables, const arma::cx_mat &_rho, const unsigned int _step)
+	{
+		arma::cx_vec expectations;
+		if (!_observables.Evaluate(_rho, expectations))
+			expectations.reset();
+
+		this->OutputTimeEvolution(expectations, _step);
+	}
+
+	// Writes the output for a timestep from expectation values that were already obtained
+	void TaskPeriodicHSTimeEvo::OutputTimeEvolution(const arma::cx_vec &_expectations, const unsigned int _step)
 	{
 		// Obtain the results
-		arma::cx_mat PState;
 		this->Data() << this->RunSettings()->CurrentStep() << " ";
 		this->Data() << (static_cast<double>(_step) * this->timestep) << " ";
 		this->WriteStandardOutput(this->Data());
-		for (auto j = _states.cbegin(); j != _states.cend(); j++)
-		{
-			if (!_space.GetState((*j), PState))
-			{
-				this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\"." << std::endl;
-				continue;
-			}
 
-			this->Data() << std::abs(arma::trace(PState * _rho)) << " ";
-		}
+		for (unsigned int k = 0; k < _expectations.n_elem; k++)
+			this->Data() << std::abs(_expectations(k)) << " ";
 
 		// Terminate the line in the data file after iteration through all steps
 		this->Data() << std::endl;
@@ -247,42 +351,20 @@ namespace RunSection
 	// -----------------------------------------------------
 	// Get the state projections
 	// -----------------------------------------------------
-	void TaskPeriodicHSTimeEvo::GetQuantumYields(const SpinAPI::SpinSpace &_space, const arma::cx_mat &_rho, const unsigned int _step, const std::vector<SpinAPI::state_ptr> &_states, const std::vector<SpinAPI::transition_ptr> &_transitions, std::map<std::string, arma::vec> &_yields)
+	void TaskPeriodicHSTimeEvo::GetQuantumYields(const SpinAPI::ObservableSet &_observables, const std::vector<std::string> &_names, const arma::cx_mat &_rho, const unsigned int _step, std::map<std::string, arma::vec> &_yields)
 	{
-		// Obtain the state projections
-		arma::cx_mat PState;
-
-		if (this->productYieldsOnly)
-		{
-			for (auto j = _transitions.cbegin(); j != _transitions.cend(); j++)
-			{
-				// Make sure that there is a state object
-				if ((*j)->SourceState() == nullptr)
-					continue;
-
-				if (!_space.GetState((*j)->SourceState(), PState))
-				{
-					this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\"." << std::endl;
-					continue;
-				}
+		// Obtain the state projections, which are either onto the states or onto the source states of the transitions
+		arma::cx_vec expectations;
+		if (!_observables.Evaluate(_rho, expectations))
+			return;
 
-				_yields[(*j)->Name()](_step - 1) = std::abs(arma::trace(PState * _rho));
-			}
-		}
-		else
-		{
-			// Get yields using state projections
-			for (auto j = _states.cbegin(); j != _states.cend(); j++)
-			{
-				if (!_space.GetState((*j), PState))
-				{
-					this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\"." << std::endl;
-					continue;
-				}
+		this->GetQuantumYields(_names, expectations, _step, _yields);
+	}
 
-				_yields[(*j)->Name()](_step - 1) = std::abs(arma::trace(PState * _rho));
-			}
-		}
+	void TaskPeriodicHSTimeEvo::GetQuantumYields(const std::vector<std::string> &_names, const arma::cx_vec &_expectations, const unsigned int _step, std::map<std::string, arma::vec> &_yields)
+	{
+		for (unsigned int k = 0; k < _expectations.n_elem; k++)
+			_yields[_names[k]](_step - 1) = std::abs(_expectations(k));
 	}
 
 	// -----------------------------------------------------
@@ -403,6 +485,22 @@ namespace RunSection
 		return period;
 	}
 
+	// -----------------------------------------------------
+	// Gets the number of time steps in a period for Floquet propagation
+	// -----------------------------------------------------
+	unsigned int TaskPeriodicHSTimeEvo::FloquetSteps(double _period)
+	{
+		// The steps must line up with the period, otherwise the propagators of consecutive periods differ
+		unsigned int steps = static_cast<unsigned int>(std::round(_period / this->timestep));
+		if (steps < 1 || std::abs(steps * this->timestep - _period) > 1e-6 * _period)
+		{
+			this->Log() << "WARNING: The period is not a multiple of the timestep, Floquet propagation is not used!" << std::endl;
+			return 0;
+		}
+
+		return steps;
+	}
+
 	// -----------------------------------------------------
 	// Task validation method
 	// -----------------------------------------------------
@@ -464,6 +562,10 @@ namespace RunSection
 			}
 		}
 
+		// Advance whole periods with the propagator of one period rather than integrating step by step
+		if (this->Properties()->Get("floquet", this->floquet) && this->floquet)
+			this->Log() << "Floquet propagation is turned on, the time steps use exact propagators." << std::endl;
+
 		// Get steps per period
 		if (this->Properties()->Get("steps", inputStepsPerPeriod) || this->Properties()->Get("stepsperperiod", inputStepsPerPeriod))
 		{
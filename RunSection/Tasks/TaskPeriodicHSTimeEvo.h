@@ -10,6 +10,7 @@
 #define MOD_RunSection_TaskPeriodicHSTimeEvo
 
 #include "SpinSpace.h"
+#include "ObservableSet.h"
 #include "BasicTask.h"
 
 namespace RunSection
@@ -26,11 +27,15 @@ namespace RunSection
 								// If false, a quantum yield will be calculated each defined State object
 
 		bool timedependentInteractions;
+		bool floquet; // If true, the propagator of one period is formed once and used to advance whole periods
 
 		// Timestep function
 		void AdvanceStep_AsyncLeapfrog(const arma::cx_mat &, const arma::cx_mat &, arma::cx_mat &);
-		void OutputTimeEvolution(const SpinAPI::SpinSpace &, const arma::cx_mat &, const unsigned int, const std::vector<SpinAPI::state_ptr> &);
-		void GetQuantumYields(const SpinAPI::SpinSpace &, const arma::cx_mat &, const unsigned int, const std::vector<SpinAPI::state_ptr> &, const std::vector<SpinAPI::transition_ptr> &, std::map<std::string, arma::vec> &);
+		void OutputTimeEvolution(const SpinAPI::ObservableSet &, const arma::cx_mat &, const unsigned int);
+		void OutputTimeEvolution(const arma::cx_vec &, const unsigned int);
+		void GetQuantumYields(const SpinAPI::ObservableSet &, const std::vector<std::string> &, const arma::cx_mat &, const unsigned int, std::map<std::string, arma::vec> &);
+		void GetQuantumYields(const std::vector<std::string> &, const arma::cx_vec &, const unsigned int, std::map<std::string, arma::vec> &);
+		unsigned int FloquetSteps(double); // Number of time steps in a period, or zero if Floquet propagation cannot be used
 		void OutputQuantumYields(const SpinAPI::SpinSpace &, std::map<std::string, arma::vec> &, const unsigned int, const std::vector<SpinAPI::state_ptr> &, const std::vector<SpinAPI::transition_ptr> &);
 		double GetPeriod(const SpinAPI::system_ptr &);
 		void WriteHeader(std::ostream &); // Write header for the output file
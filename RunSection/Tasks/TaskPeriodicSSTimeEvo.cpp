@@ -11,6 +11,7 @@
 #include "Settings.h"
 #include "State.h"
 #include "SpinSpace.h"
+#include "ObservableSet.h"
 #include "SpinSystem.h"
 #include "Interaction.h"
 #include "ObjectParser.h"
@@ -21,7 +22,7 @@ namespace RunSection
 	// TaskStaticSS Constructors and Destructor
 	// -----------------------------------------------------
 	TaskPeriodicSSTimeEvo::TaskPeriodicSSTimeEvo(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), timestep(1.0), totaltime(1.0e+4),
-																														  reactionOperators(SpinAPI::ReactionOperatorType::Haberkorn), stepsPerPeriod(50)
+																														  reactionOperators(SpinAPI::ReactionOperatorType::Haberkorn), stepsPerPeriod(50), floquet(false)
 	{
 	}
 
@@ -51,6 +52,12 @@ namespace RunSection
 		SpinAPI::SpinSpace spaces[systems.size()];							  // Keep a SpinSpace object for each spin system
 		float propagator_stepsize[systems.size()];							  // Keep track of the timestep per propagator (this is not the same as the integration timestep)
 
+		// Floquet propagation keeps the state at the start of the current period, the propagator of one period, and the observables
+		// in the Heisenberg picture for each step of a period
+		std::vector<unsigned int> floquetSteps(systems.size(), 0);
+		std::vector<arma::cx_mat> floquetPropagators(systems.size());
+		std::vector<std::vector<arma::cx_mat>> floquetObservables(systems.size());
+
 		// Loop through all SpinSystems
 		int ic = 0; // System counter
 		for (auto i = systems.cbegin(); i != systems.cend(); i++)
@@ -126,6 +133,7 @@ namespace RunSection
 				else
 					rho0 += tmp_rho0;
 			}
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
 			// Convert initial state to superoperator space
@@ -154,22 +162,50 @@ namespace RunSection
 			std::vector<arma::cx_mat> PropagatorList;
 			P[ic] = std::pair<std::vector<arma::cx_mat>, arma::cx_vec>(PropagatorList, rho0vec);
 
-			// Fill in the propagators
+			// Fill in the propagators, the dynamic Hamiltonians are obtained first as they change the time of the spinspace
+			std::vector<arma::cx_mat> dH(this->stepsPerPeriod);
 			for (unsigned int n = 0; n < this->stepsPerPeriod; n++)
 			{
 				// Set the time
 				space.SetTime(static_cast<double>(n) * propagator_stepsize[ic]);
 
 				// Get the dynamic Hamiltonian
-				arma::cx_mat dH;
-				if (!space.DynamicHamiltonian(dH))
+				if (!space.DynamicHamiltonian(dH[n]))
 				{
 					this->Log() << "Failed to obtain dynamic Hamiltonian in superspace." << std::endl;
 					return false;
 				}
+			}
 
-				// Create the propagator
-				P[ic].first.push_back(arma::expmat((arma::cx_double(0.0, -1.0) * (sH + dH) - K) * this->timestep));
+			// Create the propagators in parallel
+			P[ic].first.resize(this->stepsPerPeriod);
+#pragma omp parallel for schedule(dynamic)
+			for (int n = 0; n < static_cast<int>(this->stepsPerPeriod); n++)
+				P[ic].first[n] = arma::expmat((arma::cx_double(0.0, -1.0) * (sH + dH[n]) - K) * this->timestep);
+
+			// In Floquet mode the expectation values of each step of a period are obtained from the state at the start of the period
+			floquetSteps[ic] = this->floquet ? this->FloquetSteps(period) : 0;
+			if (floquetSteps[ic] > 0)
+			{
+				SpinAPI::ObservableSet observables(space.HilbertSpaceDimensions(), true);
+				arma::cx_mat PState;
+				auto states = (*i)->States();
+				for (auto j = states.cbegin(); j != states.cend(); j++)
+				{
+					if (!space.GetState((*j), PState) || !observables.Add(PState))
+						this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+				}
+
+				// The propagators from the start of the period to each of its steps, ending with the propagator of the whole period
+				floquetPropagators[ic] = arma::eye<arma::cx_mat>(arma::size(sH));
+				floquetObservables[ic].resize(floquetSteps[ic]);
+				for (unsigned int r = 0; r < floquetSteps[ic]; r++)
+				{
+					observables.HeisenbergObservables(floquetPropagators[ic], floquetObservables[ic][r]);
+					unsigned int PIndex = static_cast<unsigned int>(static_cast<double>(r + 1) * this->timestep / propagator_stepsize[ic]) % P[ic].first.size();
+					floquetPropagators[ic] = P[ic].first[PIndex] * floquetPropagators[ic];
+				}
+				this->Log() << "Using Floquet propagation with " << floquetSteps[ic] << " time steps per period." << std::endl;
 			}
 
 			// Move on to next system
@@ -217,6 +253,21 @@ namespace RunSection
 			ic = 0;
 			for (auto i = systems.cbegin(); i != systems.cend(); i++)
 			{
+				// Advance whole periods, "second" is then the state at the start of the current period
+				if (floquetSteps[ic] > 0)
+				{
+					unsigned int r = n % floquetSteps[ic];
+					if (r == 0)
+						P[ic].second = floquetPropagators[ic] * P[ic].second;
+
+					arma::cx_vec expectations = floquetObservables[ic][r] * P[ic].second;
+					for (unsigned int k = 0; k < expectations.n_elem; k++)
+						this->Data() << std::abs(expectations(k)) << " ";
+
+					++ic;
+					continue;
+				}
+
 				// Get the propagator index to use
 				unsigned int PIndex = static_cast<unsigned int>(static_cast<double>(n) * this->timestep / propagator_stepsize[ic]) % P[ic].first.size();
 
@@ -257,6 +308,20 @@ namespace RunSection
 		return true;
 	}
 
+	// Gets the number of time steps in a period for Floquet propagation
+	unsigned int TaskPeriodicSSTimeEvo::FloquetSteps(double _period)
+	{
+		// The steps must line up with the period, otherwise the propagators of consecutive periods differ
+		unsigned int steps = static_cast<unsigned int>(std::round(_period / this->timestep));
+		if (steps < 1 || std::abs(steps * this->timestep - _period) > 1e-6 * _period)
+		{
+			this->Log() << "WARNING: The period is not a multiple of the timestep, Floquet propagation is not used!" << std::endl;
+			return 0;
+		}
+
+		return steps;
+	}
+
 	// Writes the header of the data file (but can also be passed to other streams)
 	void TaskPeriodicSSTimeEvo::WriteHeader(std::ostream &_stream)
 	{
@@ -325,6 +390,10 @@ namespace RunSection
 			}
 		}
 
+		// Advance whole periods with the propagator of one period rather than step by step
+		if (this->Properties()->Get("floquet", this->floquet) && this->floquet)
+			this->Log() << "Floquet propagation is turned on." << std::endl;
+
 		// Get the reacton operator type
 		std::string str;
 		if (this->Properties()->Get("reactionoperators", str))
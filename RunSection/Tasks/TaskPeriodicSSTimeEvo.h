@@ -21,8 +21,10 @@ namespace RunSection
 		double totaltime;
 		SpinAPI::ReactionOperatorType reactionOperators;
 		unsigned int stepsPerPeriod;
+		bool floquet; // If true, the propagator of one period is formed once and used to advance whole periods
 
-		void WriteHeader(std::ostream &); // Write header for the output file
+		unsigned int FloquetSteps(double); // Number of time steps in a period, or zero if Floquet propagation cannot be used
+		void WriteHeader(std::ostream &);  // Write header for the output file
 
 	protected:
 		bool RunLocal() override;
@@ -12,6 +12,9 @@
 #include "Settings.h"
 #include "State.h"
 #include "SpinSpace.h"
+#include "KrylovPropagator.h"
+#include "ChebyshevPropagator.h"
+#include "PropagationSettings.h"
 #include "SpinSystem.h"
 #include "ObjectParser.h"
 #include "Spin.h"
@@ -315,79 +318,15 @@ namespace RunSection
 			}
 
 			// Choose Propagation Method and other parameters
-			std::string propmethod;
-			this->Properties()->Get("propagationmethod", propmethod);
-
-			std::string precision;
-			this->Properties()->Get("precision", precision);
-
-			int krylovsize;
-			this->Properties()->Get("krylovsize", krylovsize);
-
-			double krylovtol;
-			this->Properties()->Get("krylovtol", krylovtol);
-			if (propmethod == "autoexpm")
-			{
-				this->Log() << "Autoexpm is chosen as the propagation method." << std::endl;
-				if (precision == "double")
-				{
-					this->Log() << "Double precision is chosen for the autoexpm method." << std::endl;
-				}
-				else if (precision == "single")
-				{
-					this->Log() << "Single precision is chosen for the autoexpm method." << std::endl;
-				}
-				else if (precision == "half")
-				{
-					this->Log() << "Half precision is chosen for the autoexpm method." << std::endl;
-				}
-				else
-				{
-					std::cout << "# ERROR: undefined precision. Using single digit precision!" << std::endl;
-					this->Log() << "No precision for autoexpm method was defined. Using single digit precision." << std::endl;
-					precision = "single";
-				}
-			}
-			else if (propmethod == "krylov")
-			{
-				if (krylovsize > 0)
-				{
-					this->Log() << "Krylov basis size is chosen as " << krylovsize << "." << std::endl;
-					if (krylovtol > 0)
-					{
-						this->Log() << "Tolerance for krylov propagation is chosen as " << krylovtol << "." << std::endl;
-					}
-					else
-					{
-						std::cout << "# ERROR: undefined tolerance for krylov subspace propagation! Using the default of 1e-16." << std::endl;
-						this->Log() << "Undefined tolerance for the krylov subspace. Using the default of 1e-16." << std::endl;
-						krylovtol = 1e-16;
-					}
-				}
-				else
-				{
-					std::cout << "# ERROR: undefined size of the krylov subspace! Using the default size of 16." << std::endl;
-					this->Log() << "Undefined size of the krylov subspace. Using the default size of 16." << std::endl;
-					krylovsize = 16;
-					if (krylovtol > 0)
-					{
-						this->Log() << "Tolerance for krylov propagation is chosen as " << krylovtol << "." << std::endl;
-					}
-					else
-					{
-						std::cout << "# ERROR: undefined tolerance for krylov subspace propagation! Using the default of 1e-16." << std::endl;
-						this->Log() << "Undefined tolerance for the krylov subspace. Using the default of 1e-16." << std::endl;
-						krylovtol = 1e-16;
-					}
-				}
-			}
-			else
-			{
-				std::cout << "# ERROR: undefined propagation method, using autoexpm with single accuracy!" << std::endl;
-				this->Log() << "Undefined propagation method, using autoexpm with single accuracy." << std::endl;
-				propmethod = "autoexpm";
-				precision = "single";
-			}
+			PropagationSettings propagation;
+			propagation.Read(*this->Properties(), symmetric, "states", this->Log());
+			std::string propmethod = propagation.method;
+			std::string precision = propagation.precision;
+			int krylovsize = propagation.krylovSize;
+			int krylovmaxsize = propagation.krylovMaxSize;
+			int krylovblocksize = propagation.krylovBlockSize;
+			double krylovtol = propagation.krylovTolerance;
+			double chebyshevtol = propagation.chebyshevTolerance;
 
 			// Initialize time propagation placeholders
 			arma::mat ExptValues;
@@ -412,7 +351,7 @@ namespace RunSection
 						// Calculate the expected values for each transition operator
 						for (int idx = 0; idx < num_transitions; idx++)
 						{
-							double abs_trace = std::abs(arma::trace(B.t() * Operators[idx] * B));
+							double abs_trace = std::abs(arma::trace(B.t() * Operators.at(idx) * B));
 							double expected_value = std::exp(-kmin * current_time) * abs_trace / Z;
 							ExptValues(k, idx) = expected_value;
 						}
@@ -435,7 +374,7 @@ namespace RunSection
 						// Calculate the expected values for each transition operator
 						for (int idx = 0; idx < num_transitions; idx++)
 						{
-							double abs_trace = std::abs(arma::trace(B.t() * Operators[idx] * B));
+							double abs_trace = std::abs(arma::trace(B.t() * Operators.at(idx) * B));
 							double expected_value = abs_trace / Z;
 							ExptValues(k, idx) = expected_value;
 						}
@@ -452,87 +391,57 @@ namespace RunSection
 				// Symmetric matrix in the exponential
 				if (symmetric)
 				{
-					// #pragma omp parallel for
-					for (int itr = 0; itr < Z; itr++)
-					{
-						arma::cx_vec prop_state = B.col(itr);
-
-						// Set the current time
-						double current_time = 0;
-						time(0) = current_time;
-
-						// Calculate the expected values for each transition operator
-						for (int idx = 0; idx < num_transitions; idx++)
-						{
-							double result = std::exp(-kmin * current_time) * std::abs(arma::cdot(prop_state, Operators[idx] * prop_state));
-							ExptValues(0, idx) += result;
-						}
-
-						arma::cx_mat Hessen; // Upper Hessenberg matrix
-						Hessen.zeros(krylovsize, krylovsize);
-
-						arma::cx_mat KryBasis(4 * Z, krylovsize, arma::fill::zeros); // Orthogonal krylov subspace
-
-						KryBasis.col(0) = prop_state / norm(prop_state);
-
-						double h_mplusone_m;
-						space.LanczosProcess(H, prop_state, KryBasis, Hessen, krylovsize, h_mplusone_m);
-
-						arma::cx_colvec e1;
-						e1.zeros(krylovsize);
-						e1(0) = 1;
-						arma::cx_colvec ek;
-						ek.zeros(krylovsize);
-						ek(krylovsize - 1) = 1;
-
-						arma::cx_vec cx = arma::expmat(-arma::cx_double(0.0, 1.0) * Hessen * dt) * e1;
+					// Set the time points, the same for all states
+					for (int k = 0; k < num_steps; k++)
+						time(k) = k * dt;
 
-						prop_state = norm(prop_state) * KryBasis * cx;
+					// The states are propagated in parallel, and each thread sums up the expectation values of its own states
+					bool stepFailed = false;
+#pragma omp parallel
+					{
+						arma::mat ExptValuesThread(arma::size(ExptValues), arma::fill::zeros);
 
-						int k = 1;
-						int j = 0;
+						// Each thread has its own propagator and workspace, the subspace is reused for as many time steps as the error estimate allows
+						SpinAPI::KrylovPropagator propagator(H, -arma::cx_double(0.0, 1.0), true, krylovsize, krylovmaxsize, krylovtol);
 
-						while (k < num_steps)
+#pragma omp for schedule(dynamic)
+						for (int itr = 0; itr < Z; itr++)
 						{
-							// Set the current time
-							current_time = k * dt;
-							time(k) = current_time;
+							propagator.SetState(B.col(itr));
 
-							// Calculate the expected values for each transition operator
-							for (int idx = 0; idx < num_transitions; idx++)
+							for (int k = 0; k < num_steps; k++)
 							{
-								double result = std::exp(-kmin * current_time) * std::abs(arma::cdot(prop_state, Operators[idx] * prop_state));
-								ExptValues(k, idx) += result;
+								// Set the current time
+								double current_time = k * dt;
+								const arma::cx_vec &prop_state = propagator.State();
+
+								// Calculate the expected values for each transition operator
+								for (int idx = 0; idx < num_transitions; idx++)
+								{
+									double result = std::exp(-kmin * current_time) * std::abs(arma::cdot(prop_state, Operators.at(idx) * prop_state));
+									ExptValuesThread(k, idx) += result;
+								}
+
+								// Propagate the state to the next time step, the states of the last time step are not needed
+								// A failed step would leave a stale state, so the remaining time steps are skipped and the spin system is aborted below
+								if (k < num_steps - 1 && !propagator.Step(dt))
+								{
+#pragma omp atomic write
+									stepFailed = true;
+									break;
+								}
 							}
-
-							// Update Krylov Subspace if the tolerance is reached
-							if (h_mplusone_m * std::abs(arma::cdot(ek, cx)) > krylovtol)
-							{
-								// std::cout << "Restarted after: " << j << " iterations." <<  std::endl;
-								j = 0;
-
-								Hessen.zeros(krylovsize, krylovsize);
-								KryBasis.zeros(4 * Z, krylovsize);
-
-								KryBasis.col(0) = prop_state / norm(prop_state);
-								space.LanczosProcess(H, prop_state, KryBasis, Hessen, krylovsize, h_mplusone_m);
-								cx = arma::expmat(-arma::cx_double(0.0, 1.0) * Hessen * dt) * e1;
-
-								// Update the state using Krylov Subspace propagator
-								prop_state = norm(prop_state) * KryBasis * cx;
-							}
-							else
-							{
-								j = j + 1;
-								cx = arma::expmat(-arma::cx_double(0.0, 1.0) * Hessen * dt) * cx;
-
-								// Update B using Krylov Subspace propagator
-								prop_state = norm(prop_state) * KryBasis * cx;
-							}
-							k++;
 						}
+#pragma omp critical
+						ExptValues += ExptValuesThread;
 					}
 					ExptValues /= Z;
+
+					if (stepFailed)
+					{
+						this->Log() << "Failed to propagate the states of SpinSystem \"" << (*i)->Name() << "\", no acceptable Krylov step was found. Consider increasing krylovmaxsize or krylovtol." << std::endl;
+						continue;
+					}
 				}
 				// Non-symmetric matrix in the exponential
 				else
@@ -540,73 +449,97 @@ namespace RunSection
 					// Include the recombination operator K
 					H = -(H * arma::cx_double(0.0, 1.0) + K);
 
-					// #pragma omp parallel for
-					for (int itr = 0; itr < Z; itr++)
-					{
-						arma::cx_vec prop_state = B.col(itr);
+					// Set the time points, the same for all states
+					for (int k = 0; k < num_steps; k++)
+						time(k) = k * dt;
 
-						// Set the current time
-						double current_time = 0;
-						time(0) = current_time;
+					// The states are propagated in parallel, and each thread sums up the expectation values of its own states
+#pragma omp parallel
+					{
+						arma::mat ExptValuesThread(arma::size(ExptValues), arma::fill::zeros);
 
-						// Calculate the expected values for each transition operator
-						for (int idx = 0; idx < num_transitions; idx++)
+#pragma omp for schedule(dynamic)
+						for (int first = 0; first < Z; first += krylovblocksize)
 						{
-							double result = std::abs(arma::cdot(prop_state, Operators[idx] * prop_state));
-							ExptValues(0, idx) += result;
-						}
-
-						arma::cx_mat Hessen; // Upper Hessenberg matrix
-						Hessen.zeros(krylovsize, krylovsize);
-
-						arma::cx_mat KryBasis(4 * Z, krylovsize, arma::fill::zeros); // Orthogonal krylov subspace
-
-						KryBasis.col(0) = prop_state / norm(prop_state);
+							// The states of a block are propagated together, so that each Krylov iteration needs a single product of H with all of them
+							int last = std::min(first + krylovblocksize, Z) - 1;
+							arma::cx_mat prop_states = B.cols(first, last);
 
-						double h_mplusone_m;
-						space.ArnoldiProcess(H, prop_state, KryBasis, Hessen, krylovsize, h_mplusone_m);
-
-						arma::cx_colvec e1;
-						e1.zeros(krylovsize);
-						e1(0) = 1;
-						arma::cx_colvec ek;
-						ek.zeros(krylovsize);
-						ek(krylovsize - 1) = 1;
+							for (int k = 0; k < num_steps; k++)
+							{
+								// Calculate the expected values for each transition operator
+								for (int idx = 0; idx < num_transitions; idx++)
+								{
+									arma::cx_mat OpStates = Operators.at(idx) * prop_states;
+									for (unsigned int col = 0; col < prop_states.n_cols; col++)
+										ExptValuesThread(k, idx) += std::abs(arma::cdot(prop_states.col(col), OpStates.col(col)));
+								}
+
+								// Update the states using the block Krylov subspace propagator, the states of the last time step are not needed
+								if (k < num_steps - 1)
+									prop_states = space.KrylovExpmGeneralBlock(H, prop_states, dt, krylovsize, 4 * Z);
+							}
+						}
+#pragma omp critical
+						ExptValues += ExptValuesThread;
+					}
+					ExptValues /= Z;
+				}
+			}
+			else if (propmethod == "chebyshev")
+			{
+				// The bounds of the spectrum are computed once, and the expansion coefficients are the same for all time steps
+				double lowerBound = 0.0;
+				double upperBound = 0.0;
+				if (!SpinAPI::SpectralBounds(H, lowerBound, upperBound))
+				{
+					this->Log() << "Failed to obtain the spectral bounds of the Hamiltonian of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+					return false;
+				}
+				SpinAPI::ChebyshevPropagator propagator(H, lowerBound, upperBound, chebyshevtol);
+				if (!propagator.SetTimestep(dt))
+				{
+					this->Log() << "Failed to compute the chebyshev expansion for the time step of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+					return false;
+				}
+				this->Log() << "Spectral bounds [" << lowerBound << ", " << upperBound << "] give a chebyshev expansion of order " << propagator.Order() << "." << std::endl;
 
-						arma::cx_vec cx = arma::expmat(Hessen * dt) * e1;
+				// Set the time points, the same for all states
+				for (int k = 0; k < num_steps; k++)
+					time(k) = k * dt;
 
-						prop_state = norm(prop_state) * KryBasis * cx;
+				// The states are propagated in parallel blocks, and each thread sums up the expectation values of its own states
+#pragma omp parallel
+				{
+					arma::mat ExptValuesThread(arma::size(ExptValues), arma::fill::zeros);
 
-						int k = 1;
+#pragma omp for schedule(dynamic)
+					for (int first = 0; first < Z; first += krylovblocksize)
+					{
+						// The states of a block are propagated together, so that each term of the expansion needs a single product of H with all of them
+						int last = std::min(first + krylovblocksize, Z) - 1;
+						arma::cx_mat prop_states = B.cols(first, last);
 
-						while (k < num_steps)
+						for (int k = 0; k < num_steps; k++)
 						{
-							// Set the current time
-							current_time = k * dt;
-							time(k) = current_time;
-
 							// Calculate the expected values for each transition operator
+							double current_time = k * dt;
 							for (int idx = 0; idx < num_transitions; idx++)
 							{
-								double result = std::abs(arma::cdot(prop_state, Operators[idx] * prop_state));
-								ExptValues(k, idx) += result;
+								arma::cx_mat OpStates = Operators.at(idx) * prop_states;
+								for (unsigned int col = 0; col < prop_states.n_cols; col++)
+									ExptValuesThread(k, idx) += std::exp(-kmin * current_time) * std::abs(arma::cdot(prop_states.col(col), OpStates.col(col)));
 							}
 
-							Hessen.zeros(krylovsize, krylovsize);
-							KryBasis.zeros(4 * Z, krylovsize);
-
-							KryBasis.col(0) = prop_state / norm(prop_state);
-
-							space.ArnoldiProcess(H, prop_state, KryBasis, Hessen, krylovsize, h_mplusone_m);
-							cx = arma::expmat(Hessen * dt) * e1;
-
-							// Update the state using Krylov Subspace propagator
-							prop_state = norm(prop_state) * KryBasis * cx;
-							k++;
+							// Propagate the states to the next time step, the states of the last time step are not needed
+							if (k < num_steps - 1)
+								prop_states = propagator.Propagate(prop_states);
 						}
 					}
-					ExptValues /= Z;
+#pragma omp critical
+					ExptValues += ExptValuesThread;
 				}
+				ExptValues /= Z;
 			}
 
 			arma::mat ans = arma::trapz(time, ExptValues);
@@ -703,6 +636,10 @@ namespace RunSection
 	// Validation
 	bool TaskStaticHSDirectYields::Validate()
 	{
+		// The states are sampled from the basis without the multiplicities of groups of equivalent spins
+		if (this->HasEquivalentSpins())
+			return false;
+
 		this->Properties()->Get("transitionyields", this->productYieldsOnly);
 
 		// Get the reacton operator type
@@ -458,92 +458,11 @@ namespace RunSection
                         // Current step
                         this->WriteStandardOutput(this->Data());
 
-                        // Defining Pauli spin matrices
-                        arma::sp_cx_mat Sx(2, 2); // x pauli matrix
-                        Sx(0, 1) = 0.5;
-                        Sx(1, 0) = 0.5;
-
-                        arma::sp_cx_mat Sy(2, 2); // y pauli matrix
-                        Sy(0, 1) = arma::cx_double(0.0, -0.5);
-                        Sy(1, 0) = arma::cx_double(0.0, 0.5);
-
-                        arma::sp_cx_mat Sz(2, 2); // z pauli matrix
-                        Sz(0, 0) = 0.5;
-                        Sz(1, 1) = -0.5;
-
-                        arma::sp_cx_mat Id1 = arma::speye<arma::sp_cx_mat>(Z1, Z1);
-                        arma::sp_cx_mat Id2 = arma::speye<arma::sp_cx_mat>(Z2, Z2);
-
-                        arma::sp_cx_mat Sx1 = arma::kron(Sx, Id1);
-                        arma::sp_cx_mat Sx2 = arma::kron(Sx, Id2);
-                        arma::sp_cx_mat Sy1 = arma::kron(Sy, Id1);
-                        arma::sp_cx_mat Sy2 = arma::kron(Sy, Id2);
-                        arma::sp_cx_mat Sz1 = arma::kron(Sz, Id1);
-                        arma::sp_cx_mat Sz2 = arma::kron(Sz, Id2);
-
-                        arma::sp_cx_mat Sp1 = Sx1 + arma::cx_double(0.0, 1.0) * Sy1;
-                        arma::sp_cx_mat Sm1 = Sx1 - arma::cx_double(0.0, 1.0) * Sy1;
-                        arma::sp_cx_mat Sp2 = Sx2 + arma::cx_double(0.0, 1.0) * Sy2;
-                        arma::sp_cx_mat Sm2 = Sx2 - arma::cx_double(0.0, 1.0) * Sy2;
-
-                        arma::sp_cx_mat Sp1Sm1 = Sp1 * Sm1;
-                        arma::sp_cx_mat Sm1Sp1 = Sm1 * Sp1;
-                        arma::sp_cx_mat Sp2Sm2 = Sp2 * Sm2;
-                        arma::sp_cx_mat Sm2Sp2 = Sm2 * Sp2;
-
                         arma::mat M1; // used for variable estimation
                         arma::mat M2; // used for variable estimation
 
                         if (InitialState == "singlet")
                         {
-                                arma::cx_vec AlphaKet1(2 * Z1, 1);
-                                arma::cx_vec BetaKet1(2 * Z1, 1);
-                                arma::cx_vec AlphaBra1(1, 2 * Z1);
-                                arma::cx_vec BetaBra1(1, 2 * Z1);
-                                arma::cx_vec AlphaKet2(2 * Z2, 1);
-                                arma::cx_vec BetaKet2(2 * Z2, 1);
-                                arma::cx_vec AlphaBra2(1, 2 * Z2);
-                                arma::cx_vec BetaBra2(1, 2 * Z2);
-
-                                arma::cx_double Sx1AA;
-                                arma::cx_double Sx1AB;
-                                arma::cx_double Sx1BB;
-                                arma::cx_double Sy1AA;
-                                arma::cx_double Sy1AB;
-                                arma::cx_double Sy1BB;
-                                arma::cx_double Sz1AA;
-                                arma::cx_double Sz1AB;
-                                arma::cx_double Sz1BB;
-
-                                arma::cx_double Sx2AA;
-                                arma::cx_double Sx2BA;
-                                arma::cx_double Sx2BB;
-                                arma::cx_double Sy2AA;
-                                arma::cx_double Sy2BA;
-                                arma::cx_double Sy2BB;
-                                arma::cx_double Sz2AA;
-                                arma::cx_double Sz2BA;
-                                arma::cx_double Sz2BB;
-
-                                arma::cx_double Sp1Sm1AA;
-                                arma::cx_double Sp1Sm1BB;
-                                arma::cx_double Sp1Sm1AB;
-                                arma::cx_double Sp2Sm2AA;
-                                arma::cx_double Sp2Sm2BB;
-                                arma::cx_double Sp2Sm2AB;
-
-                                arma::cx_double Sm1Sp1AA;
-                                arma::cx_double Sm1Sp1BB;
-                                arma::cx_double Sm1Sp1AB;
-                                arma::cx_double Sm2Sp2AA;
-                                arma::cx_double Sm2Sp2BB;
-                                arma::cx_double Sm2Sp2AB;
-
-                                arma::cx_mat result(1, 1);
-
-                                arma::cx_mat B1t(2 * mc_samples1, 2 * Z1);
-                                arma::cx_mat B2t(2 * mc_samples2, 2 * Z2);
-
                                 for (int indx = 0; indx < num_steps; indx++)
                                 {
                                         // Set the current time
@@ -551,248 +470,16 @@ namespace RunSection
 
                                         this->Data() << current_time / (1e-3 * gamma_e);
 
-                                        arma::cx_double Ps;
-                                        arma::cx_double Ptplus;
-                                        arma::cx_double Ptzero;
-                                        arma::cx_double Ptminus;
-                                        arma::cx_double temp1;
-                                        arma::cx_double temp2;
-                                        arma::cx_double temp3;
-                                        arma::cx_double temp4;
-                                        B1t = B1.t();
-                                        B2t = B2.t();
-
-                                        if (mc_samples1 < mc_samples2)
-                                        {
-
-                                                for (int it2 = 0; it2 < mc_samples2; it2++)
-                                                {
-
-                                                        AlphaKet2 = B2.col(it2);
-                                                        BetaKet2 = B2.col(it2 + mc_samples2);
-                                                        AlphaBra2 = B2t.row(it2);
-                                                        BetaBra2 = B2t.row(it2 + mc_samples2);
-
-                                                        // For P_S
-                                                        result = AlphaBra2 * Sx2 * AlphaKet2;
-                                                        Sx2AA = result(0, 0);
-                                                        result = BetaBra2 * Sx2 * AlphaKet2;
-                                                        Sx2BA = result(0, 0);
-                                                        result = BetaBra2 * Sx2 * BetaKet2;
-                                                        Sx2BB = result(0, 0);
-
-                                                        result = AlphaBra2 * Sy2 * AlphaKet2;
-                                                        Sy2AA = result(0, 0);
-                                                        result = BetaBra2 * Sy2 * AlphaKet2;
-                                                        Sy2BA = result(0, 0);
-                                                        result = BetaBra2 * Sy2 * BetaKet2;
-                                                        Sy2BB = result(0, 0);
-
-                                                        result = AlphaBra2 * Sz2 * AlphaKet2;
-                                                        Sz2AA = result(0, 0);
-                                                        result = BetaBra2 * Sz2 * AlphaKet2;
-                                                        Sz2BA = result(0, 0);
-                                                        result = BetaBra2 * Sz2 * BetaKet2;
-                                                        Sz2BB = result(0, 0);
-
-                                                        // For P_Tplus
-
-                                                        result = AlphaBra2 * Sp2Sm2 * AlphaKet2;
-                                                        Sp2Sm2AA = result(0, 0);
-                                                        result = BetaBra2 * Sp2Sm2 * BetaKet2;
-                                                        Sp2Sm2BB = result(0, 0);
-                                                        result = AlphaBra2 * Sp2Sm2 * BetaKet2;
-                                                        Sp2Sm2AB = result(0, 0);
-
-                                                        // For P_Tminus
-
-                                                        result = AlphaBra2 * Sm2Sp2 * AlphaKet2;
-                                                        Sm2Sp2AA = result(0, 0);
-                                                        result = BetaBra2 * Sm2Sp2 * BetaKet2;
-                                                        Sm2Sp2BB = result(0, 0);
-                                                        result = AlphaBra2 * Sm2Sp2 * BetaKet2;
-                                                        Sm2Sp2AB = result(0, 0);
-
-                                                        for (int it1 = 0; it1 < mc_samples1; it1++)
-                                                        {
-                                                                AlphaKet1 = B1.col(it1);
-                                                                BetaKet1 = B1.col(it1 + mc_samples1);
-                                                                AlphaBra1 = B1t.row(it1);
-                                                                BetaBra1 = B1t.row(it1 + mc_samples1);
-
-                                                                // P_S
-
-                                                                result = AlphaBra1 * Sx1 * AlphaKet1;
-                                                                Sx1AA = result(0, 0);
-                                                                result = AlphaBra1 * Sx1 * BetaKet1;
-                                                                Sx1AB = result(0, 0);
-                                                                result = BetaBra1 * Sx1 * BetaKet1;
-                                                                Sx1BB = result(0, 0);
-
-                                                                result = AlphaBra1 * Sy1 * AlphaKet1;
-                                                                Sy1AA = result(0, 0);
-                                                                result = AlphaBra1 * Sy1 * BetaKet1;
-                                                                Sy1AB = result(0, 0);
-                                                                result = BetaBra1 * Sy1 * BetaKet1;
-                                                                Sy1BB = result(0, 0);
-
-                                                                result = AlphaBra1 * Sz1 * AlphaKet1;
-                                                                Sz1AA = result(0, 0);
-                                                                result = AlphaBra1 * Sz1 * BetaKet1;
-                                                                Sz1AB = result(0, 0);
-                                                                result = BetaBra1 * Sz1 * BetaKet1;
-                                                                Sz1BB = result(0, 0);
-
-                                                                // For P_Tplus
-
-                                                                result = AlphaBra1 * Sp1Sm1 * AlphaKet1;
-                                                                Sp1Sm1AA = result(0, 0);
-                                                                result = BetaBra1 * Sp1Sm1 * BetaKet1;
-                                                                Sp1Sm1BB = result(0, 0);
-                                                                result = AlphaBra1 * Sp1Sm1 * BetaKet1;
-                                                                Sp1Sm1AB = result(0, 0);
-
-                                                                // For P_Tminus
-
-                                                                result = AlphaBra1 * Sm1Sp1 * AlphaKet1;
-                                                                Sm1Sp1AA = result(0, 0);
-                                                                result = BetaBra1 * Sm1Sp1 * BetaKet1;
-                                                                Sm1Sp1BB = result(0, 0);
-                                                                result = AlphaBra1 * Sm1Sp1 * BetaKet1;
-                                                                Sm1Sp1AB = result(0, 0);
-
-                                                                // Calculating expectation values
-
-                                                                temp1 = arma::cx_double(0.25, 0.0) - arma::cx_double(0.5, 0) * (Sx1AA * Sx2BB - 2 * (Sx1AB * Sx2BA).real() + Sx1BB * Sx2AA + Sy1AA * Sy2BB - 2 * (Sy1AB * Sy2BA).real() + Sy1BB * Sy2AA + Sz1AA * Sz2BB - 2 * (Sz1AB * Sz2BA).real() + Sz1BB * Sz2AA);
-                                                                temp2 = arma::cx_double(0.5, 0.0) * (Sp1Sm1AA * Sp2Sm2BB - 2 * (Sp1Sm1AB * Sp2Sm2AB).real() + Sp1Sm1BB * Sp2Sm2AA);
-                                                                temp3 = arma::cx_double(0.5, 0.0) * (Sm1Sp1AA * Sm2Sp2BB - 2 * (Sm1Sp1AB * Sm2Sp2AB).real() + Sm1Sp1BB * Sm2Sp2AA);
-
-                                                                Ps += temp1;
-                                                                Ptplus += temp2;
-                                                                Ptminus += temp3;
-                                                                Ptzero += arma::cx_double(1.0, 0.0) - temp1 - temp2 - temp3;
-                                                        }
-                                                }
-                                        }
-                                        else
-                                        {
-
-                                                for (int it1 = 0; it1 < mc_samples1; it1++)
-                                                {
-                                                        AlphaKet1 = B1.col(it1);
-                                                        BetaKet1 = B1.col(it1 + mc_samples1);
-                                                        AlphaBra1 = B1t.row(it1);
-                                                        BetaBra1 = B1t.row(it1 + mc_samples1);
-
-                                                        // For P_S
-
-                                                        result = AlphaBra1 * Sx1 * AlphaKet1;
-                                                        Sx1AA = result(0, 0);
-                                                        result = AlphaBra1 * Sx1 * BetaKet1;
-                                                        Sx1AB = result(0, 0);
-                                                        result = BetaBra1 * Sx1 * BetaKet1;
-                                                        Sx1BB = result(0, 0);
-
-                                                        result = AlphaBra1 * Sy1 * AlphaKet1;
-                                                        Sy1AA = result(0, 0);
-                                                        result = AlphaBra1 * Sy1 * BetaKet1;
-                                                        Sy1AB = result(0, 0);
-                                                        result = BetaBra1 * Sy1 * BetaKet1;
-                                                        Sy1BB = result(0, 0);
-
-                                                        result = AlphaBra1 * Sz1 * AlphaKet1;
-                                                        Sz1AA = result(0, 0);
-                                                        result = AlphaBra1 * Sz1 * BetaKet1;
-                                                        Sz1AB = result(0, 0);
-                                                        result = BetaBra1 * Sz1 * BetaKet1;
-                                                        Sz1BB = result(0, 0);
-
-                                                        // For P_Tplus
-
-                                                        result = AlphaBra1 * Sp1Sm1 * AlphaKet1;
-                                                        Sp1Sm1AA = result(0, 0);
-                                                        result = BetaBra1 * Sp1Sm1 * BetaKet1;
-                                                        Sp1Sm1BB = result(0, 0);
-                                                        result = AlphaBra1 * Sp1Sm1 * BetaKet1;
-                                                        Sp1Sm1AB = result(0, 0);
-
-                                                        // For P_Tminus
-
-                                                        result = AlphaBra1 * Sm1Sp1 * AlphaKet1;
-                                                        Sm1Sp1AA = result(0, 0);
-                                                        result = BetaBra1 * Sm1Sp1 * BetaKet1;
-                                                        Sm1Sp1BB = result(0, 0);
-                                                        result = AlphaBra1 * Sm1Sp1 * BetaKet1;
-                                                        Sm1Sp1AB = result(0, 0);
-
-                                                        for (int it2 = 0; it2 < mc_samples2; it2++)
-                                                        {
-                                                                AlphaKet2 = B2.col(it2);
-                                                                BetaKet2 = B2.col(it2 + mc_samples2);
-                                                                AlphaBra2 = B2t.row(it2);
-                                                                BetaBra2 = B2t.row(it2 + mc_samples2);
-
-                                                                // For P_S
-
-                                                                result = AlphaBra2 * Sx2 * AlphaKet2;
-                                                                Sx2AA = result(0, 0);
-                                                                result = BetaBra2 * Sx2 * AlphaKet2;
-                                                                Sx2BA = result(0, 0);
-                                                                result = BetaBra2 * Sx2 * BetaKet2;
-                                                                Sx2BB = result(0, 0);
-
-                                                                result = AlphaBra2 * Sy2 * AlphaKet2;
-                                                                Sy2AA = result(0, 0);
-                                                                result = BetaBra2 * Sy2 * AlphaKet2;
-                                                                Sy2BA = result(0, 0);
-                                                                result = BetaBra2 * Sy2 * BetaKet2;
-                                                                Sy2BB = result(0, 0);
-
-                                                                result = AlphaBra2 * Sz2 * AlphaKet2;
-                                                                Sz2AA = result(0, 0);
-                                                                result = BetaBra2 * Sz2 * AlphaKet2;
-                                                                Sz2BA = result(0, 0);
-                                                                result = BetaBra2 * Sz2 * BetaKet2;
-                                                                Sz2BB = result(0, 0);
-
-                                                                // For P_Tplus
-
-                                                                result = AlphaBra2 * Sp2Sm2 * AlphaKet2;
-                                                                Sp2Sm2AA = result(0, 0);
-                                                                result = BetaBra2 * Sp2Sm2 * BetaKet2;
-                                                                Sp2Sm2BB = result(0, 0);
-                                                                result = AlphaBra2 * Sp2Sm2 * BetaKet2;
-                                                                Sp2Sm2AB = result(0, 0);
-
-                                                                // For P_Tminus
-
-                                                                result = AlphaBra2 * Sm2Sp2 * AlphaKet2;
-                                                                Sm2Sp2AA = result(0, 0);
-                                                                result = BetaBra2 * Sm2Sp2 * BetaKet2;
-                                                                Sm2Sp2BB = result(0, 0);
-                                                                result = AlphaBra2 * Sm2Sp2 * BetaKet2;
-                                                                Sm2Sp2AB = result(0, 0);
-
-                                                                // Calculating expectation values
-
-                                                                temp1 = arma::cx_double(0.25, 0.0) - arma::cx_double(0.5, 0) * (Sx1AA * Sx2BB - 2 * (Sx1AB * Sx2BA).real() + Sx1BB * Sx2AA + Sy1AA * Sy2BB - 2 * (Sy1AB * Sy2BA).real() + Sy1BB * Sy2AA + Sz1AA * Sz2BB - 2 * (Sz1AB * Sz2BA).real() + Sz1BB * Sz2AA);
-                                                                temp2 = arma::cx_double(0.5, 0.0) * (Sp1Sm1AA * Sp2Sm2BB - 2 * (Sp1Sm1AB * Sp2Sm2AB).real() + Sp1Sm1BB * Sp2Sm2AA);
-                                                                temp3 = arma::cx_double(0.5, 0.0) * (Sm1Sp1AA * Sm2Sp2BB - 2 * (Sm1Sp1AB * Sm2Sp2AB).real() + Sm1Sp1BB * Sm2Sp2AA);
-
-                                                                Ps += temp1;
-                                                                Ptplus += temp2;
-                                                                Ptminus += temp3;
-                                                                Ptzero += arma::cx_double(1.0, 0.0) - temp1 - temp2 - temp3;
-                                                        }
-                                                }
-                                        }
+                                        // Sums of the singlet and triplet probabilities over all pairs of wavefunctions of the two radicals
+                                        arma::vec projections;
+                                        spaces[0].UncoupledPairProjections(B1, B2, InitialState, projections);
 
                                         // Calculate the expected value
 
-                                        double expected_value1 = std::exp(-kmin * current_time) * Ps.real() / mc_samples1 / mc_samples2;
-                                        double expected_value2 = std::exp(-kmin * current_time) * Ptplus.real() / mc_samples1 / mc_samples2;
-                                        double expected_value3 = std::exp(-kmin * current_time) * Ptzero.real() / mc_samples1 / mc_samples2;
-                                        double expected_value4 = std::exp(-kmin * current_time) * Ptminus.real() / mc_samples1 / mc_samples2;
+                                        double expected_value1 = std::exp(-kmin * current_time) * projections(0) / mc_samples1 / mc_samples2;
+                                        double expected_value2 = std::exp(-kmin * current_time) * projections(1) / mc_samples1 / mc_samples2;
+                                        double expected_value3 = std::exp(-kmin * current_time) * projections(2) / mc_samples1 / mc_samples2;
+                                        double expected_value4 = std::exp(-kmin * current_time) * projections(3) / mc_samples1 / mc_samples2;
 
                                         this->Data() << " " << expected_value1;
                                         this->Data() << " " << expected_value2;
@@ -807,54 +494,6 @@ namespace RunSection
                         }
                         else if (InitialState == "tripletzero")
                         {
-                                arma::cx_vec AlphaKet1(2 * Z1, 1);
-                                arma::cx_vec BetaKet1(2 * Z1, 1);
-                                arma::cx_vec AlphaBra1(1, 2 * Z1);
-                                arma::cx_vec BetaBra1(1, 2 * Z1);
-                                arma::cx_vec AlphaKet2(2 * Z2, 1);
-                                arma::cx_vec BetaKet2(2 * Z2, 1);
-                                arma::cx_vec AlphaBra2(1, 2 * Z2);
-                                arma::cx_vec BetaBra2(1, 2 * Z2);
-
-                                arma::cx_double Sx1AA;
-                                arma::cx_double Sx1AB;
-                                arma::cx_double Sx1BB;
-                                arma::cx_double Sy1AA;
-                                arma::cx_double Sy1AB;
-                                arma::cx_double Sy1BB;
-                                arma::cx_double Sz1AA;
-                                arma::cx_double Sz1AB;
-                                arma::cx_double Sz1BB;
-
-                                arma::cx_double Sx2AA;
-                                arma::cx_double Sx2BA;
-                                arma::cx_double Sx2BB;
-                                arma::cx_double Sy2AA;
-                                arma::cx_double Sy2BA;
-                                arma::cx_double Sy2BB;
-                                arma::cx_double Sz2AA;
-                                arma::cx_double Sz2BA;
-                                arma::cx_double Sz2BB;
-
-                                arma::cx_double Sp1Sm1AA;
-                                arma::cx_double Sp1Sm1BB;
-                                arma::cx_double Sp1Sm1AB;
-                                arma::cx_double Sp2Sm2AA;
-                                arma::cx_double Sp2Sm2BB;
-                                arma::cx_double Sp2Sm2AB;
-
-                                arma::cx_double Sm1Sp1AA;
-                                arma::cx_double Sm1Sp1BB;
-                                arma::cx_double Sm1Sp1AB;
-                                arma::cx_double Sm2Sp2AA;
-                                arma::cx_double Sm2Sp2BB;
-                                arma::cx_double Sm2Sp2AB;
-
-                                arma::cx_mat result(1, 1);
-
-                                arma::cx_mat B1t(2 * mc_samples1, 2 * Z1);
-                                arma::cx_mat B2t(2 * mc_samples2, 2 * Z2);
-
                                 for (int indx = 0; indx < num_steps; indx++)
                                 {
                                         // Set the current time
@@ -862,241 +501,14 @@ namespace RunSection
 
                                         this->Data() << current_time / (1e-3 * gamma_e);
 
-                                        arma::cx_double Ps;
-                                        arma::cx_double Ptplus;
-                                        arma::cx_double Ptzero;
-                                        arma::cx_double Ptminus;
-                                        arma::cx_double temp1;
-                                        arma::cx_double temp2;
-                                        arma::cx_double temp3;
-                                        arma::cx_double temp4;
-                                        B1t = B1.t();
-                                        B2t = B2.t();
-
-                                        if (mc_samples1 < mc_samples2)
-                                        {
-
-                                                for (int it2 = 0; it2 < mc_samples2; it2++)
-                                                {
+                                        // Sums of the singlet and triplet probabilities over all pairs of wavefunctions of the two radicals
+                                        arma::vec projections;
+                                        spaces[0].UncoupledPairProjections(B1, B2, InitialState, projections);
 
-                                                        AlphaKet2 = B2.col(it2);
-                                                        BetaKet2 = B2.col(it2 + mc_samples2);
-                                                        AlphaBra2 = B2t.row(it2);
-                                                        BetaBra2 = B2t.row(it2 + mc_samples2);
-
-                                                        // For P_S
-                                                        result = AlphaBra2 * Sx2 * AlphaKet2;
-                                                        Sx2AA = result(0, 0);
-                                                        result = BetaBra2 * Sx2 * AlphaKet2;
-                                                        Sx2BA = result(0, 0);
-                                                        result = BetaBra2 * Sx2 * BetaKet2;
-                                                        Sx2BB = result(0, 0);
-
-                                                        result = AlphaBra2 * Sy2 * AlphaKet2;
-                                                        Sy2AA = result(0, 0);
-                                                        result = BetaBra2 * Sy2 * AlphaKet2;
-                                                        Sy2BA = result(0, 0);
-                                                        result = BetaBra2 * Sy2 * BetaKet2;
-                                                        Sy2BB = result(0, 0);
-
-                                                        result = AlphaBra2 * Sz2 * AlphaKet2;
-                                                        Sz2AA = result(0, 0);
-                                                        result = BetaBra2 * Sz2 * AlphaKet2;
-                                                        Sz2BA = result(0, 0);
-                                                        result = BetaBra2 * Sz2 * BetaKet2;
-                                                        Sz2BB = result(0, 0);
-
-                                                        // For P_Tplus
-
-                                                        result = AlphaBra2 * Sp2Sm2 * AlphaKet2;
-                                                        Sp2Sm2AA = result(0, 0);
-                                                        result = BetaBra2 * Sp2Sm2 * BetaKet2;
-                                                        Sp2Sm2BB = result(0, 0);
-                                                        result = AlphaBra2 * Sp2Sm2 * BetaKet2;
-                                                        Sp2Sm2AB = result(0, 0);
-
-                                                        // For P_Tminus
-
-                                                        result = AlphaBra2 * Sm2Sp2 * AlphaKet2;
-                                                        Sm2Sp2AA = result(0, 0);
-                                                        result = BetaBra2 * Sm2Sp2 * BetaKet2;
-                                                        Sm2Sp2BB = result(0, 0);
-                                                        result = AlphaBra2 * Sm2Sp2 * BetaKet2;
-                                                        Sm2Sp2AB = result(0, 0);
-
-                                                        for (int it1 = 0; it1 < mc_samples1; it1++)
-                                                        {
-                                                                AlphaKet1 = B1.col(it1);
-                                                                BetaKet1 = B1.col(it1 + mc_samples1);
-                                                                AlphaBra1 = B1t.row(it1);
-                                                                BetaBra1 = B1t.row(it1 + mc_samples1);
-
-                                                                // P_S
-
-                                                                result = AlphaBra1 * Sx1 * AlphaKet1;
-                                                                Sx1AA = result(0, 0);
-                                                                result = AlphaBra1 * Sx1 * BetaKet1;
-                                                                Sx1AB = result(0, 0);
-                                                                result = BetaBra1 * Sx1 * BetaKet1;
-                                                                Sx1BB = result(0, 0);
-
-                                                                result = AlphaBra1 * Sy1 * AlphaKet1;
-                                                                Sy1AA = result(0, 0);
-                                                                result = AlphaBra1 * Sy1 * BetaKet1;
-                                                                Sy1AB = result(0, 0);
-                                                                result = BetaBra1 * Sy1 * BetaKet1;
-                                                                Sy1BB = result(0, 0);
-
-                                                                result = AlphaBra1 * Sz1 * AlphaKet1;
-                                                                Sz1AA = result(0, 0);
-                                                                result = AlphaBra1 * Sz1 * BetaKet1;
-                                                                Sz1AB = result(0, 0);
-                                                                result = BetaBra1 * Sz1 * BetaKet1;
-                                                                Sz1BB = result(0, 0);
-
-                                                                // For P_Tplus
-
-                                                                result = AlphaBra1 * Sp1Sm1 * AlphaKet1;
-                                                                Sp1Sm1AA = result(0, 0);
-                                                                result = BetaBra1 * Sp1Sm1 * BetaKet1;
-                                                                Sp1Sm1BB = result(0, 0);
-                                                                result = AlphaBra1 * Sp1Sm1 * BetaKet1;
-                                                                Sp1Sm1AB = result(0, 0);
-
-                                                                // For P_Tminus
-
-                                                                result = AlphaBra1 * Sm1Sp1 * AlphaKet1;
-                                                                Sm1Sp1AA = result(0, 0);
-                                                                result = BetaBra1 * Sm1Sp1 * BetaKet1;
-                                                                Sm1Sp1BB = result(0, 0);
-                                                                result = AlphaBra1 * Sm1Sp1 * BetaKet1;
-                                                                Sm1Sp1AB = result(0, 0);
-
-                                                                // Calculating expectation values
-
-                                                                temp1 = arma::cx_double(0.25, 0.0) - arma::cx_double(0.5, 0) * (Sx1AA * Sx2BB + 2 * (Sx1AB * Sx2BA).real() + Sx1BB * Sx2AA + Sy1AA * Sy2BB + 2 * (Sy1AB * Sy2BA).real() + Sy1BB * Sy2AA + Sz1AA * Sz2BB + 2 * (Sz1AB * Sz2BA).real() + Sz1BB * Sz2AA);
-                                                                temp2 = arma::cx_double(0.5, 0.0) * (Sp1Sm1AA * Sp2Sm2BB + 2 * (Sp1Sm1AB * Sp2Sm2AB).real() + Sp1Sm1BB * Sp2Sm2AA);
-                                                                temp3 = arma::cx_double(0.5, 0.0) * (Sm1Sp1AA * Sm2Sp2BB + 2 * (Sm1Sp1AB * Sm2Sp2AB).real() + Sm1Sp1BB * Sm2Sp2AA);
-
-                                                                Ps += temp1;
-                                                                Ptplus += temp2;
-                                                                Ptminus += temp3;
-                                                                Ptzero += arma::cx_double(1.0, 0.0) - temp1 - temp2 - temp3;
-                                                        }
-                                                }
-                                        }
-                                        else
-                                        {
-                                                for (int it1 = 0; it1 < mc_samples1; it1++)
-                                                {
-                                                        AlphaKet1 = B1.col(it1);
-                                                        BetaKet1 = B1.col(it1 + mc_samples1);
-                                                        AlphaBra1 = B1t.row(it1);
-                                                        BetaBra1 = B1t.row(it1 + mc_samples1);
-
-                                                        // For P_S
-                                                        result = AlphaBra1 * Sx1 * AlphaKet1;
-                                                        Sx1AA = result(0, 0);
-                                                        result = AlphaBra1 * Sx1 * BetaKet1;
-                                                        Sx1AB = result(0, 0);
-                                                        result = BetaBra1 * Sx1 * BetaKet1;
-                                                        Sx1BB = result(0, 0);
-
-                                                        result = AlphaBra1 * Sy1 * AlphaKet1;
-                                                        Sy1AA = result(0, 0);
-                                                        result = AlphaBra1 * Sy1 * BetaKet1;
-                                                        Sy1AB = result(0, 0);
-                                                        result = BetaBra1 * Sy1 * BetaKet1;
-                                                        Sy1BB = result(0, 0);
-
-                                                        result = AlphaBra1 * Sz1 * AlphaKet1;
-                                                        Sz1AA = result(0, 0);
-                                                        result = AlphaBra1 * Sz1 * BetaKet1;
-                                                        Sz1AB = result(0, 0);
-                                                        result = BetaBra1 * Sz1 * BetaKet1;
-                                                        Sz1BB = result(0, 0);
-
-                                                        // For P_Tplus
-
-                                                        result = AlphaBra1 * Sp1Sm1 * AlphaKet1;
-                                                        Sp1Sm1AA = result(0, 0);
-                                                        result = BetaBra1 * Sp1Sm1 * BetaKet1;
-                                                        Sp1Sm1BB = result(0, 0);
-                                                        result = AlphaBra1 * Sp1Sm1 * BetaKet1;
-                                                        Sp1Sm1AB = result(0, 0);
-
-                                                        // For P_Tminus
-
-                                                        result = AlphaBra1 * Sm1Sp1 * AlphaKet1;
-                                                        Sm1Sp1AA = result(0, 0);
-                                                        result = BetaBra1 * Sm1Sp1 * BetaKet1;
-                                                        Sm1Sp1BB = result(0, 0);
-                                                        result = AlphaBra1 * Sm1Sp1 * BetaKet1;
-                                                        Sm1Sp1AB = result(0, 0);
-
-                                                        for (int it2 = 0; it2 < mc_samples2; it2++)
-                                                        {
-                                                                AlphaKet2 = B2.col(it2);
-                                                                BetaKet2 = B2.col(it2 + mc_samples2);
-                                                                AlphaBra2 = B2t.row(it2);
-                                                                BetaBra2 = B2t.row(it2 + mc_samples2);
-
-                                                                // For P_S
-
-                                                                result = AlphaBra2 * Sx2 * AlphaKet2;
-                                                                Sx2AA = result(0, 0);
-                                                                result = BetaBra2 * Sx2 * AlphaKet2;
-                                                                Sx2BA = result(0, 0);
-                                                                result = BetaBra2 * Sx2 * BetaKet2;
-                                                                Sx2BB = result(0, 0);
-                                                                result = AlphaBra2 * Sy2 * AlphaKet2;
-                                                                Sy2AA = result(0, 0);
-                                                                result = BetaBra2 * Sy2 * AlphaKet2;
-                                                                Sy2BA = result(0, 0);
-                                                                result = BetaBra2 * Sy2 * BetaKet2;
-                                                                Sy2BB = result(0, 0);
-
-                                                                result = AlphaBra2 * Sz2 * AlphaKet2;
-                                                                Sz2AA = result(0, 0);
-                                                                result = BetaBra2 * Sz2 * AlphaKet2;
-                                                                Sz2BA = result(0, 0);
-                                                                result = BetaBra2 * Sz2 * BetaKet2;
-                                                                Sz2BB = result(0, 0);
-
-                                                                // For P_Tplus
-
-                                                                result = AlphaBra2 * Sp2Sm2 * AlphaKet2;
-                                                                Sp2Sm2AA = result(0, 0);
-                                                                result = BetaBra2 * Sp2Sm2 * BetaKet2;
-                                                                Sp2Sm2BB = result(0, 0);
-                                                                result = AlphaBra2 * Sp2Sm2 * BetaKet2;
-                                                                Sp2Sm2AB = result(0, 0);
-
-                                                                // For P_Tminus
-
-                                                                result = AlphaBra2 * Sm2Sp2 * AlphaKet2;
-                                                                Sm2Sp2AA = result(0, 0);
-                                                                result = BetaBra2 * Sm2Sp2 * BetaKet2;
-                                                                Sm2Sp2BB = result(0, 0);
-                                                                result = AlphaBra2 * Sm2Sp2 * BetaKet2;
-                                                                Sm2Sp2AB = result(0, 0);
-
-                                                                temp1 = arma::cx_double(0.25, 0.0) - arma::cx_double(0.5, 0) * (Sx1AA * Sx2BB + 2 * (Sx1AB * Sx2BA).real() + Sx1BB * Sx2AA + Sy1AA * Sy2BB + 2 * (Sy1AB * Sy2BA).real() + Sy1BB * Sy2AA + Sz1AA * Sz2BB + 2 * (Sz1AB * Sz2BA).real() + Sz1BB * Sz2AA);
-                                                                temp2 = arma::cx_double(0.5, 0.0) * (Sp1Sm1AA * Sp2Sm2BB + 2 * (Sp1Sm1AB * Sp2Sm2AB).real() + Sp1Sm1BB * Sp2Sm2AA);
-                                                                temp3 = arma::cx_double(0.5, 0.0) * (Sm1Sp1AA * Sm2Sp2BB + 2 * (Sm1Sp1AB * Sm2Sp2AB).real() + Sm1Sp1BB * Sm2Sp2AA);
-
-                                                                Ps += temp1;
-                                                                Ptplus += temp2;
-                                                                Ptminus += temp3;
-                                                                Ptzero += arma::cx_double(1.0, 0.0) - temp1 - temp2 - temp3;
-                                                        }
-                                                }
-                                        }
-
-                                        double expected_value1 = std::exp(-kmin * current_time) * Ps.real() / mc_samples1 / mc_samples2;
-                                        double expected_value2 = std::exp(-kmin * current_time) * Ptplus.real() / mc_samples1 / mc_samples2;
-                                        double expected_value3 = std::exp(-kmin * current_time) * Ptzero.real() / mc_samples1 / mc_samples2;
-                                        double expected_value4 = std::exp(-kmin * current_time) * Ptminus.real() / mc_samples1 / mc_samples2;
+                                        double expected_value1 = std::exp(-kmin * current_time) * projections(0) / mc_samples1 / mc_samples2;
+                                        double expected_value2 = std::exp(-kmin * current_time) * projections(1) / mc_samples1 / mc_samples2;
+                                        double expected_value3 = std::exp(-kmin * current_time) * projections(2) / mc_samples1 / mc_samples2;
+                                        double expected_value4 = std::exp(-kmin * current_time) * projections(3) / mc_samples1 / mc_samples2;
 
                                         this->Data() << " " << expected_value1;
                                         this->Data() << " " << expected_value2;
@@ -1111,30 +523,6 @@ namespace RunSection
                         }
                         else if (InitialState == "tripletplus")
                         {
-                                arma::cx_vec AlphaKet1(2 * Z1, 1);
-                                arma::cx_vec AlphaBra1(1, 2 * Z1);
-                                arma::cx_vec AlphaKet2(2 * Z2, 1);
-                                arma::cx_vec AlphaBra2(1, 2 * Z2);
-
-                                arma::cx_double Sx1AA;
-                                arma::cx_double Sy1AA;
-                                arma::cx_double Sz1AA;
-
-                                arma::cx_double Sx2AA;
-                                arma::cx_double Sy2AA;
-                                arma::cx_double Sz2AA;
-
-                                arma::cx_double Sp1Sm1AA;
-                                arma::cx_double Sp2Sm2AA;
-
-                                arma::cx_double Sm1Sp1AA;
-                                arma::cx_double Sm2Sp2AA;
-
-                                arma::cx_mat result(1, 1);
-
-                                arma::cx_mat B1t(mc_samples1, 2 * Z1);
-                                arma::cx_mat B2t(mc_samples2, 2 * Z2);
-
                                 for (int indx = 0; indx < num_steps; indx++)
                                 {
                                         // Set the current time
@@ -1142,147 +530,14 @@ namespace RunSection
 
                                         this->Data() << current_time / (1e-3 * gamma_e);
 
-                                        arma::cx_double Ps;
-                                        arma::cx_double Ptplus;
-                                        arma::cx_double Ptzero;
-                                        arma::cx_double Ptminus;
-                                        arma::cx_double temp1;
-                                        arma::cx_double temp2;
-                                        arma::cx_double temp3;
-                                        arma::cx_double temp4;
-                                        B1t = B1.t();
-                                        B2t = B2.t();
-
-                                        if (mc_samples1 < mc_samples2)
-                                        {
-
-                                                for (int it2 = 0; it2 < mc_samples2; it2++)
-                                                {
-
-                                                        AlphaKet2 = B2.col(it2);
-                                                        AlphaBra2 = B2t.row(it2);
-
-                                                        // For P_S
-                                                        result = AlphaBra2 * Sx2 * AlphaKet2;
-                                                        Sx2AA = result(0, 0);
-                                                        result = AlphaBra2 * Sy2 * AlphaKet2;
-                                                        Sy2AA = result(0, 0);
-                                                        result = AlphaBra2 * Sz2 * AlphaKet2;
-                                                        Sz2AA = result(0, 0);
-
-                                                        // For P_Tplus
-
-                                                        result = AlphaBra2 * Sp2Sm2 * AlphaKet2;
-                                                        Sp2Sm2AA = result(0, 0);
-
-                                                        // For P_Tminus
-
-                                                        result = AlphaBra2 * Sm2Sp2 * AlphaKet2;
-                                                        Sm2Sp2AA = result(0, 0);
-
-                                                        for (int it1 = 0; it1 < mc_samples1; it1++)
-                                                        {
-                                                                AlphaKet1 = B1.col(it1);
-                                                                AlphaBra1 = B1t.row(it1);
-
-                                                                // P_S
-
-                                                                result = AlphaBra1 * Sx1 * AlphaKet1;
-                                                                Sx1AA = result(0, 0);
-                                                                result = AlphaBra1 * Sy1 * AlphaKet1;
-                                                                Sy1AA = result(0, 0);
-                                                                result = AlphaBra1 * Sz1 * AlphaKet1;
-                                                                Sz1AA = result(0, 0);
-
-                                                                // For P_Tplus
-
-                                                                result = AlphaBra1 * Sp1Sm1 * AlphaKet1;
-                                                                Sp1Sm1AA = result(0, 0);
-
-                                                                // For P_Tminus
-
-                                                                result = AlphaBra1 * Sm1Sp1 * AlphaKet1;
-                                                                Sm1Sp1AA = result(0, 0);
-
-                                                                // Calculating expectation values
-
-                                                                temp1 = arma::cx_double(0.25, 0.0) - (Sx1AA * Sx2AA + Sy1AA * Sy2AA + Sz1AA * Sz2AA);
-                                                                temp2 = Sp1Sm1AA * Sp2Sm2AA;
-                                                                temp3 = Sm1Sp1AA * Sm2Sp2AA;
-
-                                                                Ps += temp1;
-                                                                Ptplus += temp2;
-                                                                Ptminus += temp3;
-                                                                Ptzero += arma::cx_double(1.0, 0.0) - temp1 - temp2 - temp3;
-                                                        }
-                                                }
-                                        }
-                                        else
-                                        {
-                                                for (int it1 = 0; it1 < mc_samples1; it1++)
-                                                {
-                                                        AlphaKet1 = B1.col(it1);
-                                                        AlphaBra1 = B1t.row(it1);
-
-                                                        // P_S
-
-                                                        result = AlphaBra1 * Sx1 * AlphaKet1;
-                                                        Sx1AA = result(0, 0);
-                                                        result = AlphaBra1 * Sy1 * AlphaKet1;
-                                                        Sy1AA = result(0, 0);
-                                                        result = AlphaBra1 * Sz1 * AlphaKet1;
-                                                        Sz1AA = result(0, 0);
-
-                                                        // For P_Tplus
-
-                                                        result = AlphaBra1 * Sp1Sm1 * AlphaKet1;
-                                                        Sp1Sm1AA = result(0, 0);
-
-                                                        // For P_Tminus
+                                        // Sums of the singlet and triplet probabilities over all pairs of wavefunctions of the two radicals
+                                        arma::vec projections;
+                                        spaces[0].UncoupledPairProjections(B1, B2, InitialState, projections);
 
-                                                        result = AlphaBra1 * Sm1Sp1 * AlphaKet1;
-                                                        Sm1Sp1AA = result(0, 0);
-                                                        for (int it2 = 0; it2 < mc_samples2; it2++)
-                                                        {
-                                                                AlphaKet2 = B2.col(it2);
-                                                                AlphaBra2 = B2t.row(it2);
-
-                                                                // For P_S
-                                                                result = AlphaBra2 * Sx2 * AlphaKet2;
-                                                                Sx2AA = result(0, 0);
-                                                                result = AlphaBra2 * Sy2 * AlphaKet2;
-                                                                Sy2AA = result(0, 0);
-                                                                result = AlphaBra2 * Sz2 * AlphaKet2;
-                                                                Sz2AA = result(0, 0);
-
-                                                                // For P_Tplus
-
-                                                                result = AlphaBra2 * Sp2Sm2 * AlphaKet2;
-                                                                Sp2Sm2AA = result(0, 0);
-
-                                                                // For P_Tminus
-
-                                                                result = AlphaBra2 * Sm2Sp2 * AlphaKet2;
-                                                                Sm2Sp2AA = result(0, 0);
-
-                                                                // Calculating expectation values
-
-                                                                temp1 = arma::cx_double(0.25, 0.0) - (Sx1AA * Sx2AA + Sy1AA * Sy2AA + Sz1AA * Sz2AA);
-                                                                temp2 = Sp1Sm1AA * Sp2Sm2AA;
-                                                                temp3 = Sm1Sp1AA * Sm2Sp2AA;
-
-                                                                Ps += temp1;
-                                                                Ptplus += temp2;
-                                                                Ptminus += temp3;
-                                                                Ptzero += arma::cx_double(1.0, 0.0) - temp1 - temp2 - temp3;
-                                                        }
-                                                }
-                                        }
-
-                                        double expected_value1 = std::exp(-kmin * current_time) * Ps.real() / mc_samples1 / mc_samples2;
-                                        double expected_value2 = std::exp(-kmin * current_time) * Ptplus.real() / mc_samples1 / mc_samples2;
-                                        double expected_value3 = std::exp(-kmin * current_time) * Ptzero.real() / mc_samples1 / mc_samples2;
-                                        double expected_value4 = std::exp(-kmin * current_time) * Ptminus.real() / mc_samples1 / mc_samples2;
+                                        double expected_value1 = std::exp(-kmin * current_time) * projections(0) / mc_samples1 / mc_samples2;
+                                        double expected_value2 = std::exp(-kmin * current_time) * projections(1) / mc_samples1 / mc_samples2;
+                                        double expected_value3 = std::exp(-kmin * current_time) * projections(2) / mc_samples1 / mc_samples2;
+                                        double expected_value4 = std::exp(-kmin * current_time) * projections(3) / mc_samples1 / mc_samples2;
 
                                         this->Data() << " " << expected_value1;
                                         this->Data() << " " << expected_value2;
@@ -1297,30 +552,6 @@ namespace RunSection
                         }
                         else if (InitialState == "tripletminus")
                         {
-                                arma::cx_vec BetaKet1(2 * Z1, 1);
-                                arma::cx_vec BetaBra1(1, 2 * Z1);
-                                arma::cx_vec BetaKet2(2 * Z2, 1);
-                                arma::cx_vec BetaBra2(1, 2 * Z2);
-
-                                arma::cx_double Sx1BB;
-                                arma::cx_double Sy1BB;
-                                arma::cx_double Sz1BB;
-
-                                arma::cx_double Sx2BB;
-                                arma::cx_double Sy2BB;
-                                arma::cx_double Sz2BB;
-
-                                arma::cx_double Sp1Sm1BB;
-                                arma::cx_double Sp2Sm2BB;
-
-                                arma::cx_double Sm1Sp1BB;
-                                arma::cx_double Sm2Sp2BB;
-
-                                arma::cx_mat result(1, 1);
-
-                                arma::cx_mat B1t(mc_samples1, 2 * Z1);
-                                arma::cx_mat B2t(mc_samples2, 2 * Z2);
-
                                 for (int indx = 0; indx < num_steps; indx++)
                                 {
                                         // Set the current time
@@ -1328,146 +559,14 @@ namespace RunSection
 
                                         this->Data() << current_time / (1e-3 * gamma_e);
 
-                                        arma::cx_double Ps;
-                                        arma::cx_double Ptplus;
-                                        arma::cx_double Ptzero;
-                                        arma::cx_double Ptminus;
-                                        arma::cx_double temp1;
-                                        arma::cx_double temp2;
-                                        arma::cx_double temp3;
-                                        arma::cx_double temp4;
-                                        B1t = B1.t();
-                                        B2t = B2.t();
-                                        if (mc_samples1 < mc_samples2)
-                                        {
-
-                                                for (int it2 = 0; it2 < mc_samples2; it2++)
-                                                {
-                                                        BetaKet2 = B2.col(it2);
-                                                        BetaBra2 = B2t.row(it2);
-
-                                                        // For P_S
-                                                        result = BetaBra2 * Sx2 * BetaKet2;
-                                                        Sx2BB = result(0, 0);
-                                                        result = BetaBra2 * Sy2 * BetaKet2;
-                                                        Sy2BB = result(0, 0);
-                                                        result = BetaBra2 * Sz2 * BetaKet2;
-                                                        Sz2BB = result(0, 0);
-
-                                                        // For P_Tplus
-
-                                                        result = BetaBra2 * Sp2Sm2 * BetaKet2;
-                                                        Sp2Sm2BB = result(0, 0);
-
-                                                        // For P_Tminus
-
-                                                        result = BetaBra2 * Sm2Sp2 * BetaKet2;
-                                                        Sm2Sp2BB = result(0, 0);
-
-                                                        for (int it1 = 0; it1 < mc_samples1; it1++)
-                                                        {
-                                                                BetaKet1 = B1.col(it1);
-                                                                BetaBra1 = B1t.row(it1);
-
-                                                                // P_S
-
-                                                                result = BetaBra1 * Sx1 * BetaKet1;
-                                                                Sx1BB = result(0, 0);
-                                                                result = BetaBra1 * Sy1 * BetaKet1;
-                                                                Sy1BB = result(0, 0);
-                                                                result = BetaBra1 * Sz1 * BetaKet1;
-                                                                Sz1BB = result(0, 0);
+                                        // Sums of the singlet and triplet probabilities over all pairs of wavefunctions of the two radicals
+                                        arma::vec projections;
+                                        spaces[0].UncoupledPairProjections(B1, B2, InitialState, projections);
 
-                                                                // For P_Tplus
-
-                                                                result = BetaBra1 * Sp1Sm1 * BetaKet1;
-                                                                Sp1Sm1BB = result(0, 0);
-
-                                                                // For P_Tminus
-
-                                                                result = BetaBra1 * Sm1Sp1 * BetaKet1;
-                                                                Sm1Sp1BB = result(0, 0);
-
-                                                                // Calculating expectation values
-
-                                                                temp1 = arma::cx_double(0.25, 0.0) - (Sx1BB * Sx2BB + Sy1BB * Sy2BB + Sz1BB * Sz2BB);
-                                                                temp2 = Sp1Sm1BB * Sp2Sm2BB;
-                                                                temp3 = Sm1Sp1BB * Sm2Sp2BB;
-
-                                                                Ps += temp1;
-                                                                Ptplus += temp2;
-                                                                Ptminus += temp3;
-                                                                Ptzero += arma::cx_double(1.0, 0.0) - temp1 - temp2 - temp3;
-                                                        }
-                                                }
-                                        }
-                                        else
-                                        {
-                                                for (int it1 = 0; it1 < mc_samples1; it1++)
-                                                {
-                                                        BetaKet1 = B1.col(it1);
-                                                        BetaBra1 = B1t.row(it1);
-
-                                                        // P_S
-
-                                                        result = BetaBra1 * Sx1 * BetaKet1;
-                                                        Sx1BB = result(0, 0);
-                                                        result = BetaBra1 * Sy1 * BetaKet1;
-                                                        Sy1BB = result(0, 0);
-                                                        result = BetaBra1 * Sz1 * BetaKet1;
-                                                        Sz1BB = result(0, 0);
-
-                                                        // For P_Tplus
-
-                                                        result = BetaBra1 * Sp1Sm1 * BetaKet1;
-                                                        Sp1Sm1BB = result(0, 0);
-
-                                                        // For P_Tminus
-
-                                                        result = BetaBra1 * Sm1Sp1 * BetaKet1;
-                                                        Sm1Sp1BB = result(0, 0);
-
-                                                        for (int it2 = 0; it2 < mc_samples2; it2++)
-                                                        {
-                                                                BetaKet2 = B2.col(it2);
-                                                                BetaBra2 = B2t.row(it2);
-
-                                                                // For P_S
-                                                                result = BetaBra2 * Sx2 * BetaKet2;
-                                                                Sx2BB = result(0, 0);
-                                                                result = BetaBra2 * Sy2 * BetaKet2;
-                                                                Sy2BB = result(0, 0);
-                                                                result = BetaBra2 * Sz2 * BetaKet2;
-                                                                Sz2BB = result(0, 0);
-
-                                                                // For P_Tplus
-
-                                                                result = BetaBra2 * Sp2Sm2 * BetaKet2;
-                                                                Sp2Sm2BB = result(0, 0);
-
-                                                                // For P_Tminus
-
-                                                                result = BetaBra2 * Sm2Sp2 * BetaKet2;
-                                                                Sm2Sp2BB = result(0, 0);
-
-                                                                // Calculating expectation values
-
-                                                                temp1 = arma::cx_double(0.25, 0.0) - (Sx1BB * Sx2BB + Sy1BB * Sy2BB + Sz1BB * Sz2BB);
-                                                                temp2 = Sp1Sm1BB * Sp2Sm2BB;
-                                                                temp3 = Sm1Sp1BB * Sm2Sp2BB;
-
-                                                                Ps += temp1;
-                                                                Ptplus += temp2;
-                                                                Ptminus += temp3;
-                                                                Ptzero += arma::cx_double(1.0, 0.0) - temp1 - temp2 - temp3;
-                                                        }
-                                                }
-                                        }
-
-                                        double expected_value1 = std::exp(-kmin * current_time) * Ps.real() / mc_samples1 / mc_samples2;
-                                        double expected_value2 = std::exp(-kmin * current_time) * Ptplus.real() / mc_samples1 / mc_samples2;
-                                        double expected_value3 = std::exp(-kmin * current_time) * Ptzero.real() / mc_samples1 / mc_samples2;
-                                        double expected_value4 = std::exp(-kmin * current_time) * Ptminus.real() / mc_samples1 / mc_samples2;
+                                        double expected_value1 = std::exp(-kmin * current_time) * projections(0) / mc_samples1 / mc_samples2;
+                                        double expected_value2 = std::exp(-kmin * current_time) * projections(1) / mc_samples1 / mc_samples2;
+                                        double expected_value3 = std::exp(-kmin * current_time) * projections(2) / mc_samples1 / mc_samples2;
+                                        double expected_value4 = std::exp(-kmin * current_time) * projections(3) / mc_samples1 / mc_samples2;
 
                                         // Obtain results
                                         // this->Data() << this->RunSettings()->CurrentStep() << " ";
@@ -1502,6 +601,10 @@ namespace RunSection
         // Validation
         bool TaskStaticHSStochTimeEvoSymmUncoupled::Validate()
         {
+                // The states are sampled from the basis without the multiplicities of groups of equivalent spins
+                if (this->HasEquivalentSpins())
+                        return false;
+
                 this->Properties()->Get("transitionyields", this->productYieldsOnly);
 
                 // Get the reacton operator type
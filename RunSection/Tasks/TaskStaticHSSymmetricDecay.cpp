@@ -13,6 +13,7 @@
 #include "ObjectParser.h"
 #include "Settings.h"
 #include "SpinSystem.h"
+#include "ObservableSet.h"
 
 namespace RunSection
 {
@@ -103,10 +104,11 @@ namespace RunSection
 				else
 					rho0 += tmp_rho0;
 			}
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
-			// Get the Hamiltonian
-			arma::cx_mat H;
+			// Get the Hamiltonian, as a sparse matrix to find its block structure
+			arma::sp_cx_mat H;
 			if (!space.Hamiltonian(H))
 			{
 				this->Log() << "Failed to obtain Hamiltonian." << std::endl;
@@ -118,20 +120,29 @@ namespace RunSection
 			arma::cx_mat V;	  // To hold eigenvectors
 			arma::vec lambda; // To hold eigenvalues
 			this->Log() << "Starting diagonalization..." << std::endl;
-			arma::eig_sym(lambda, V, H);
+			if (!space.BlockEigenDecomposition(H, lambda, V))
+			{
+				this->Log() << "Failed to diagonalize Hamiltonian." << std::endl;
+				continue;
+			}
 			this->Log() << "Diagonalization done! Eigenvalues: " << lambda.n_elem << ", eigenvectors: " << V.n_cols << std::endl;
-			arma::mat O = arma::ones<arma::mat>(V.n_rows, V.n_cols);
-			arma::mat D = arma::diagmat(lambda);
-			arma::mat L = O * D - D * O;
+			// f(w) for all pairs of eigenvalues, where w = lambda_g - lambda_h
+			arma::mat L = arma::repmat(lambda.t(), lambda.n_elem, 1);
+			L.each_col() -= lambda;
 			L.transform([ksq](double val)
 						{ return 1.0 / (1.0 + val * val / ksq); });
 			this->Log() << "Done preparing f(w) = k^2 / (k^2 + w^2)." << std::endl;
-			arma::cx_mat QS;
-			arma::cx_mat QStmp = rho0 * V;
 
-			// Loop through all the State objects defined on the SpinSystem
-			arma::cx_mat P;
-			double result;
+			// The yield of a state is the sum over g,h of (V' * P * V)(g,h) * (V' * rho0 * V)(h,g) * f(w_gh), where ' is the conjugate transpose.
+			// This equals tr(P * M) with M = V * ((V' * rho0 * V) % f) * V', which does not depend on the state and only takes a few matrix products.
+			// No transpose is needed as f is symmetric, while (V' * rho0 * V) must keep its orientation when the Hamiltonian is complex.
+			arma::cx_mat M = V.t() * rho0 * V;
+			M = M % L;
+			M = V * M * V.t();
+
+			// Collect the projection operators onto all the State objects defined on the SpinSystem, and evaluate them in one pass
+			SpinAPI::ObservableSet observables(space.HilbertSpaceDimensions(), false);
+			arma::sp_cx_mat P;
 			auto states = (*i)->States();
 			for (auto j = states.cbegin(); j != states.cend(); j++)
 			{
@@ -141,20 +152,20 @@ namespace RunSection
 					this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
 					continue;
 				}
+				observables.Add(P);
+			}
 
-				// Calculate the yield for the state
-				result = 0.0;
-				for (unsigned int h = 0; h < V.n_rows; h++)
-				{
-					QS = P * V.col(h) * QStmp.col(h).t();
-					for (unsigned int g = 0; g < V.n_cols; g++)
-						result += std::real(cdot(V.col(g), QS * V.col(g)) * L(h, g));
-				}
-
-				// Output the result
-				this->Data() << result << " ";
+			arma::cx_vec yields;
+			if (!observables.Evaluate(M, yields))
+			{
+				this->Log() << "Failed to calculate the yields for SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+				continue;
 			}
 
+			// Output the results
+			for (unsigned int j = 0; j < yields.n_elem; j++)
+				this->Data() << std::real(yields(j)) << " ";
+
 			this->Log() << "\nDone with SpinSystem \"" << (*i)->Name() << "\"" << std::endl;
 		}
 
@@ -206,19 +206,19 @@ namespace RunSection
 
 				// Get electronic spin operators
 				arma::sp_cx_mat J;
-				if (!spaces[r].CreateOperator(radical[r]->Sx(), radical[r], J))
+				if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sx, radical[r], J))
 				{
 					this->Log() << "Failed to obtain spin operators for radical " << r << "." << std::endl;
 					continue;
 				}
 				S[r * 3 + 0] = V.t() * J * V;
-				if (!spaces[r].CreateOperator(radical[r]->Sy(), radical[r], J))
+				if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sy, radical[r], J))
 				{
 					this->Log() << "Failed to obtain spin operators for radical " << r << "." << std::endl;
 					continue;
 				}
 				S[r * 3 + 1] = V.t() * J * V;
-				if (!spaces[r].CreateOperator(radical[r]->Sz(), radical[r], J))
+				if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sz, radical[r], J))
 				{
 					this->Log() << "Failed to obtain spin operators for radical " << r << "." << std::endl;
 					continue;
@@ -301,6 +301,10 @@ namespace RunSection
 	// Validation
 	bool TaskStaticRPOnlyHSSymDec::Validate()
 	{
+		// The radical Hilbert spaces are used without the multiplicities of groups of equivalent spins
+		if (this->HasEquivalentSpins())
+			return false;
+
 		return true;
 	}
 	// -----------------------------------------------------
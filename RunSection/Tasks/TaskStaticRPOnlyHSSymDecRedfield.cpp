@@ -370,17 +370,17 @@ namespace RunSection
 
 											this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-											if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+											if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 											{
 												return false;
 											}
 
-											if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+											if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 											{
 												return false;
 											}
 
-											if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+											if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 											{
 												return false;
 											}
@@ -637,32 +637,32 @@ namespace RunSection
 
 												this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-												if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+												if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 												{
 													return false;
 												}
 
-												if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+												if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 												{
 													return false;
 												}
 
-												if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+												if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 												{
 													return false;
 												}
 
-												if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+												if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 												{
 													return false;
 												}
 
-												if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+												if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 												{
 													return false;
 												}
 
-												if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+												if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 												{
 													return false;
 												}
@@ -975,17 +975,17 @@ namespace RunSection
 
 										this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-										if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+										if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 										{
 											return false;
 										}
 
-										if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+										if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 										{
 											return false;
 										}
 
-										if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+										if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 										{
 											return false;
 										}
@@ -1422,32 +1422,32 @@ namespace RunSection
 
 											this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-											if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+											if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 											{
 												return false;
 											}
 
-											if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+											if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 											{
 												return false;
 											}
 
-											if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+											if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 											{
 												return false;
 											}
 
-											if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+											if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 											{
 												return false;
 											}
 
-											if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+											if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 											{
 												return false;
 											}
 
-											if (!spaces[r].CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+											if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 											{
 												return false;
 											}
@@ -1775,7 +1775,7 @@ namespace RunSection
 				arma::sp_cx_mat J;
 				arma::cx_vec J_flattend;
 
-				if (!spaces[r].CreateOperator(radical[r]->Sx(), radical[r], J))
+				if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sx, radical[r], J))
 				{
 					this->Log() << "Failed to obtain spin operators for radical " << r << "." << std::endl;
 					continue;
@@ -1791,7 +1791,7 @@ namespace RunSection
 
 				S_flattend[r * 3 + 0] = J_flattend;
 
-				if (!spaces[r].CreateOperator(radical[r]->Sy(), radical[r], J))
+				if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sy, radical[r], J))
 				{
 					this->Log() << "Failed to obtain spin operators for radical " << r << "." << std::endl;
 					continue;
@@ -1807,7 +1807,7 @@ namespace RunSection
 
 				S_flattend[r * 3 + 1] = J_flattend;
 
-				if (!spaces[r].CreateOperator(radical[r]->Sz(), radical[r], J))
+				if (!spaces[r].CreateOperator(SpinAPI::SpinOperatorType::Sz, radical[r], J))
 				{
 					this->Log() << "Failed to obtain spin operators for radical " << r << "." << std::endl;
 					continue;
@@ -2156,6 +2156,10 @@ namespace RunSection
 	// Validation
 	bool TaskStaticRPOnlyHSSymDecRedfield::Validate()
 	{
+		// The radical Hilbert spaces are used without the multiplicities of groups of equivalent spins
+		if (this->HasEquivalentSpins())
+			return false;
+
 		double inputTimestep = 0.0;
 		double inputTotaltime = 0.0;
 
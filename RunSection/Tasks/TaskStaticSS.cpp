@@ -14,6 +14,7 @@
 #include "SpinSpace.h"
 #include "SpinSystem.h"
 #include "ObjectParser.h"
+#include "ObservableSet.h"
 
 namespace RunSection
 {
@@ -21,7 +22,7 @@ namespace RunSection
 	// TaskStaticSS Constructors and Destructor
 	// -----------------------------------------------------
 	TaskStaticSS::TaskStaticSS(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), reactionOperators(SpinAPI::ReactionOperatorType::Haberkorn),
-																										productYieldsOnly(false)
+																										productYieldsOnly(false), solver("dense"), solverTolerance(1e-10), solverRestart(50), solverMaxIterations(1000), initialStateYields(false)
 	{
 	}
 
@@ -61,7 +62,8 @@ namespace RunSection
 			space.UseSuperoperatorSpace(true);
 			space.SetReactionOperatorType(this->reactionOperators);
 
-			// Get the initial state
+			// Get the initial state, or one density operator per initial state if their yields are requested separately
+			std::vector<arma::cx_mat> rho0s;
 			for (auto j = initial_states.cbegin(); j != initial_states.cend(); j++)
 			{
 				arma::cx_mat tmp_rho0;
@@ -70,74 +72,23 @@ namespace RunSection
 					this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\", initial state of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
 					continue;
 				}
-				if (j == initial_states.cbegin())
-					rho0 = tmp_rho0;
+				if (this->initialStateYields || rho0s.empty())
+					rho0s.push_back(tmp_rho0);
 				else
-					rho0 += tmp_rho0;
+					rho0s.back() += tmp_rho0;
 			}
-			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
-
-			// Convert initial state to superoperator space
-			arma::cx_vec rho0vec;
-			if (!space.OperatorToSuperspace(rho0, rho0vec))
-			{
-				this->Log() << "Failed to convert initial state density operator to superspace." << std::endl;
-				continue;
-			}
-
-			// Get the Hamiltonian
-			arma::sp_cx_mat H;
-			if (!space.Hamiltonian(H))
-			{
-				this->Log() << "Failed to obtain Hamiltonian in superspace." << std::endl;
-				continue;
-			}
-
-			// Get a matrix to collect all the terms (the total Liouvillian)
-			arma::sp_cx_mat A = arma::cx_double(0.0, -1.0) * H;
-
-			// Get the reaction operators, and add them to "A"
-			arma::sp_cx_mat K;
-			if (!space.TotalReactionOperator(K))
-			{
-				this->Log() << "Warning: Failed to obtain matrix representation of the reaction operators!" << std::endl;
-			}
-			A -= K;
-
-			// Get the relaxation terms, assuming that they can just be added to the Liouvillian superoperator
-			arma::sp_cx_mat R;
-			for (auto j = (*i)->operators_cbegin(); j != (*i)->operators_cend(); j++)
-			{
-				if (space.RelaxationOperator((*j), R))
-				{
-					A += R;
-					this->Log() << "Added relaxation operator \"" << (*j)->Name() << "\" to the Liouvillian.\n";
-				}
-			}
-
-			// Perform the calculation
-			this->Log() << "Ready to perform calculation." << std::endl;
-			arma::cx_vec result = solve(arma::conv_to<arma::cx_mat>::from(A), rho0vec);
-			this->Log() << "Done with calculation." << std::endl;
-
-			// Convert the resulting density operator back to its Hilbert space representation
-			if (!space.OperatorFromSuperspace(result, rho0))
+			for (auto j = rho0s.begin(); j != rho0s.end(); j++)
 			{
-				this->Log() << "Failed to convert resulting superspace-vector back to native Hilbert space." << std::endl;
-				continue;
+				space.WeightEquivalentSpins(*j);
+				(*j) /= arma::trace(*j); // The density operator should have a trace of 1
 			}
 
-			// Obtain the results
-			arma::cx_mat P;
-			double sum_yield;
-
-			this->Data() << this->RunSettings()->CurrentStep() << " ";
-			this->WriteStandardOutput(this->Data());
-
-			// There are two result modes - either write results per transition or for each defined state
+			// Collect the projection operators onto the states (or onto the source states of the transitions) that define the yields
+			SpinAPI::ObservableSet observables(space.HilbertSpaceDimensions(), true);
+			std::vector<double> rates;
+			arma::sp_cx_mat P;
 			if (this->productYieldsOnly)
 			{
-				// Loop through all defind transitions
 				auto transitions = (*i)->Transitions();
 				for (auto j = transitions.cbegin(); j != transitions.cend(); j++)
 				{
@@ -150,16 +101,12 @@ namespace RunSection
 						this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
 						continue;
 					}
-					sum_yield += (*j)->Rate() * std::abs(arma::trace(P * rho0));
-					// Return the yield for this transition
-					this->Data() << (*j)->Rate() * std::abs(arma::trace(P * rho0)) << " ";
+					observables.Add(P);
+					rates.push_back((*j)->Rate());
 				}
-				this->Data() << sum_yield << " ";
-				sum_yield *= 0.0;
 			}
 			else
 			{
-				// Loop through all states
 				auto states = (*i)->States();
 				for (auto j = states.cbegin(); j != states.cend(); j++)
 				{
@@ -168,12 +115,133 @@ namespace RunSection
 						this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
 						continue;
 					}
+					observables.Add(P); // Note that no reaction rates are included here
+					rates.push_back(1.0);
+				}
+			}
+
+			// The yields, one column per initial state
+			arma::cx_mat yields(observables.Size(), rho0s.size());
+			arma::cx_vec rhovec;
+			arma::cx_vec column;
 
-					// Return the yield for this state - note that no reaction rates are included here.
-					this->Data() << std::abs(arma::trace(P * rho0)) << " ";
+			// With Haberkorn reaction operators and without relaxation, the equation can be solved in the Hilbert space
+			bool solved = false;
+			if (this->solver.compare("sylvester") == 0)
+			{
+				if (!space.HasOnlyHaberkornReactionOperators() || (*i)->operators_cbegin() != (*i)->operators_cend())
+				{
+					this->Log() << "The Sylvester solver requires Haberkorn reaction operators and no relaxation operators. Using the dense Liouville-space solver instead." << std::endl;
+				}
+				else
+				{
+					this->Log() << "Ready to perform calculation in the Hilbert space." << std::endl;
+					arma::cx_mat rho;
+					space.UseSuperoperatorSpace(false);
+					solved = true;
+					for (unsigned int c = 0; c < rho0s.size() && solved; c++)
+					{
+						solved = space.SolveHaberkornSteadyState(rho0s[c], rho) && space.OperatorToSuperspace(rho, rhovec) && observables.Evaluate(rhovec, column);
+						if (solved)
+							yields.col(c) = column;
+					}
+					space.UseSuperoperatorSpace(true);
+
+					if (solved)
+						this->Log() << "Done with calculation." << std::endl;
+					else
+						this->Log() << "Warning: The Sylvester solver failed. Using the dense Liouville-space solver instead." << std::endl;
 				}
 			}
 
+			if (!solved)
+			{
+				// Convert initial states to superoperator space
+				arma::cx_mat B(space.SpaceDimensions(), rho0s.size());
+				bool converted = true;
+				for (unsigned int c = 0; c < rho0s.size() && converted; c++)
+				{
+					converted = space.OperatorToSuperspace(rho0s[c], rhovec);
+					if (converted)
+						B.col(c) = rhovec;
+				}
+				if (!converted)
+				{
+					this->Log() << "Failed to convert initial state density operator to superspace." << std::endl;
+					continue;
+				}
+
+				// Get the Hamiltonian
+				arma::sp_cx_mat H;
+				if (!space.Hamiltonian(H))
+				{
+					this->Log() << "Failed to obtain Hamiltonian in superspace." << std::endl;
+					continue;
+				}
+
+				// Get a matrix to collect all the terms (the total Liouvillian)
+				arma::sp_cx_mat A = arma::cx_double(0.0, -1.0) * H;
+
+				// Get the reaction operators, and add them to "A"
+				arma::sp_cx_mat K;
+				if (!space.TotalReactionOperator(K))
+				{
+					this->Log() << "Warning: Failed to obtain matrix representation of the reaction operators!" << std::endl;
+				}
+				A -= K;
+
+				// Get the relaxation terms, assuming that they can just be added to the Liouvillian superoperator
+				arma::sp_cx_mat R;
+				for (auto j = (*i)->operators_cbegin(); j != (*i)->operators_cend(); j++)
+				{
+					if (space.RelaxationOperator((*j), R))
+					{
+						A += R;
+						this->Log() << "Added relaxation operator \"" << (*j)->Name() << "\" to the Liouvillian.\n";
+					}
+				}
+
+				// Perform the calculation
+				this->Log() << "Ready to perform calculation." << std::endl;
+				if (this->solver.compare("dense") == 0 || this->solver.compare("sylvester") == 0)
+				{
+					// A single factorization for all initial states and observables
+					solved = space.SolveYields(A, B, observables, yields);
+				}
+				else
+				{
+					solved = true;
+					for (unsigned int c = 0; c < rho0s.size() && solved; c++)
+					{
+						solved = this->SolveLiouvillian(space, A, B.col(c), rhovec) && observables.Evaluate(rhovec, column);
+						if (solved)
+							yields.col(c) = column;
+					}
+				}
+
+				if (!solved)
+				{
+					this->Log() << "Failed to solve the Liouville-space equation for SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+					continue;
+				}
+				this->Log() << "Done with calculation." << std::endl;
+			}
+
+			// Write the results, either per transition (multiplied by the rate constant) or for each defined state
+			this->Data() << this->RunSettings()->CurrentStep() << " ";
+			this->WriteStandardOutput(this->Data());
+			for (unsigned int c = 0; c < yields.n_cols; c++)
+			{
+				double sum_yield = 0.0;
+				for (unsigned int k = 0; k < yields.n_rows; k++)
+				{
+					sum_yield += rates[k] * std::abs(yields(k, c));
+					this->Data() << rates[k] * std::abs(yields(k, c)) << " ";
+				}
+				if (this->productYieldsOnly)
+					this->Data() << sum_yield << " ";
+			}
+
 			this->Log() << "\nDone with SpinSystem \"" << (*i)->Name() << "\"" << std::endl;
 		}
 
@@ -183,6 +251,50 @@ namespace RunSection
 		return true;
 	}
 
+	// Solves A*x = b using the solver selected in the task properties
+	bool TaskStaticSS::SolveLiouvillian(const SpinAPI::SpinSpace &_space, const arma::sp_cx_mat &_A, const arma::cx_vec &_b, arma::cx_vec &_x)
+	{
+		// The iterative solvers work directly on the sparse matrix
+		if (this->solver.compare("gmres") == 0 || this->solver.compare("bicgstab") == 0)
+		{
+			unsigned int iterations = 0;
+			double residual = 0.0;
+			bool converged;
+
+			if (this->solver.compare("gmres") == 0)
+				converged = _space.SolveGMRES(_A, _b, _x, this->solverTolerance, this->solverRestart, this->solverMaxIterations, iterations, residual);
+			else
+				converged = _space.SolveBiCGSTAB(_A, _b, _x, this->solverTolerance, this->solverMaxIterations, iterations, residual);
+
+			this->Log() << "Iterative solver \"" << this->solver << "\" finished after " << iterations << " iterations with relative residual " << residual << "." << std::endl;
+			if (!converged)
+			{
+				// An unconverged solution would be written as if it were a valid yield, so the caller has to treat it as a failure
+				this->Log() << "ERROR: The iterative solver did not reach the requested tolerance of " << this->solverTolerance << "! Increase solvermaxiterations or solverrestart, or use another solver." << std::endl;
+				return false;
+			}
+
+			return true;
+		}
+
+		// Sparse direct solver, falls back to the dense solver if SuperLU is not available
+		if (this->solver.compare("superlu") == 0)
+		{
+			if (_space.SolveSparseLU(_A, _b, _x))
+				return true;
+
+			this->Log() << "Warning: The sparse direct solver failed (Armadillo may be built without SuperLU). Using the dense solver instead." << std::endl;
+		}
+
+		// The dense solver works on the blocks of a block-diagonal Liouvillian independently
+		arma::cx_mat x;
+		if (!_space.BlockSolve(_A, _b, x))
+			return false;
+
+		_x = x.col(0);
+		return true;
+	}
+
 	// Writes the header of the data file (but can also be passed to other streams)
 	void TaskStaticSS::WriteHeader(std::ostream &_stream)
 	{
@@ -193,20 +305,37 @@ namespace RunSection
 		auto systems = this->SpinSystems();
 		for (auto i = systems.cbegin(); i != systems.cend(); i++)
 		{
-			// Should yields be written per transition or per defined state?
-			if (this->productYieldsOnly)
+			// With separate initial states, the yields of each initial state are prefixed by its name
+			std::vector<std::string> prefixes;
+			if (this->initialStateYields)
 			{
-				// Write each transition name
-				auto transitions = (*i)->Transitions();
-				for (auto j = transitions.cbegin(); j != transitions.cend(); j++)
-					_stream << (*i)->Name() << "." << (*j)->Name() << ".yield ";
+				auto initial_states = (*i)->InitialState();
+				for (auto j = initial_states.cbegin(); j != initial_states.cend(); j++)
+					prefixes.push_back((*i)->Name() + "." + (*j)->Name() + ".");
 			}
 			else
 			{
-				// Write each state name
-				auto states = (*i)->States();
-				for (auto j = states.cbegin(); j != states.cend(); j++)
-					_stream << (*i)->Name() << "." << (*j)->Name() << " ";
+				prefixes.push_back((*i)->Name() + ".");
+			}
+
+			for (auto p = prefixes.cbegin(); p != prefixes.cend(); p++)
+			{
+				// Should yields be written per transition or per defined state?
+				if (this->productYieldsOnly)
+				{
+					// Write each transition name
+					auto transitions = (*i)->Transitions();
+					for (auto j = transitions.cbegin(); j != transitions.cend(); j++)
+						_stream << (*p) << (*j)->Name() << ".yield ";
+					_stream << (*p) << "yield.sum ";
+				}
+				else
+				{
+					// Write each state name
+					auto states = (*i)->States();
+					for (auto j = states.cbegin(); j != states.cend(); j++)
+						_stream << (*p) << (*j)->Name() << " ";
+				}
 			}
 		}
 		_stream << std::endl;
@@ -237,6 +366,31 @@ namespace RunSection
 			}
 		}
 
+		// Get the solver used for the Liouville-space equation
+		if (this->Properties()->Get("solver", str))
+		{
+			if (str.compare("dense") == 0 || str.compare("superlu") == 0 || str.compare("gmres") == 0 || str.compare("bicgstab") == 0 || str.compare("sylvester") == 0)
+			{
+				this->solver = str;
+				this->Log() << "Setting solver to \"" << str << "\"." << std::endl;
+			}
+			else
+			{
+				this->Log() << "Warning: Unknown solver \"" << str << "\" specified. Using the dense solver." << std::endl;
+			}
+		}
+
+		// Settings for the iterative solvers
+		this->Properties()->Get("solvertolerance", this->solverTolerance);
+		this->Properties()->Get("solverrestart", this->solverRestart);
+		this->Properties()->Get("solvermaxiterations", this->solverMaxIterations);
+
+		if (this->solverRestart < 1)
+			this->solverRestart = 50;
+
+		// Solve for each initial state separately rather than for their sum, sharing the factorization of the Liouvillian
+		this->Properties()->Get("initialstateyields", this->initialStateYields);
+
 		return true;
 	}
 	// -----------------------------------------------------
@@ -14,6 +14,7 @@
 
 #include "BasicTask.h"
 #include "SpinAPIDefines.h"
+#include "SpinSpace.h"
 
 namespace RunSection
 {
@@ -23,8 +24,14 @@ namespace RunSection
 		SpinAPI::ReactionOperatorType reactionOperators;
 		bool productYieldsOnly; // If true, a quantum yield will be calculated from each Transition object and multiplied by the rate constant
 								// If false, a quantum yield will be calculated each defined State object
+		std::string solver;				  // Method used to solve the Liouville-space equation: "dense", "superlu", "gmres", "bicgstab" or "sylvester" (Hilbert space)
+		double solverTolerance;			  // Relative residual at which the iterative solvers are considered converged
+		unsigned int solverRestart;		  // Size of the Krylov subspace before GMRES is restarted
+		unsigned int solverMaxIterations; // Maximum number of iterations for the iterative solvers
+		bool initialStateYields;		  // If true, the yields are calculated for each initial state separately instead of for the sum of the initial states
 
-		void WriteHeader(std::ostream &); // Write header for the output file
+		void WriteHeader(std::ostream &);																		   // Write header for the output file
+		bool SolveLiouvillian(const SpinAPI::SpinSpace &, const arma::sp_cx_mat &, const arma::cx_vec &, arma::cx_vec &); // Solves A*x = b with the selected solver
 
 	protected:
 		bool RunLocal() override;
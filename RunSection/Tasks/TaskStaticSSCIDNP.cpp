@@ -16,6 +16,7 @@
 #include "Interaction.h"
 #include "ObjectParser.h"
 #include "Operator.h"
+#include "ObservableSet.h"
 
 namespace RunSection
 {
@@ -23,7 +24,7 @@ namespace RunSection
 	// TaskStaticSSCIDNP Constructors and Destructor
 	// -----------------------------------------------------
 	TaskStaticSSCIDNP::TaskStaticSSCIDNP(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), reactionOperators(SpinAPI::ReactionOperatorType::Haberkorn),
-																												  productYieldsOnly(false)
+																												  productYieldsOnly(false), solver("dense")
 	{
 	}
 
@@ -124,186 +125,189 @@ namespace RunSection
 				}
 			}
 
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
-			// Convert initial state to superoperator space
-			arma::cx_vec rho0vec;
-			if (!space.OperatorToSuperspace(rho0, rho0vec))
-			{
-				this->Log() << "Failed to convert initial state density operator to superspace." << std::endl;
-				continue;
-			}
-
-			// Get the Hamiltonian
-			arma::sp_cx_mat H;
-			if (!space.Hamiltonian(H))
+			// Get nuclei of interest for CIDNP spectrum
+			std::vector<std::string> nuclei_list;
+			if (!this->Properties()->GetList("nuclei_list", nuclei_list, ','))
 			{
-				this->Log() << "Failed to obtain Hamiltonian in superspace." << std::endl;
+				this->Data() << this->RunSettings()->CurrentStep() << " ";
+				this->WriteStandardOutput(this->Data());
+				this->Log() << "No nucleus was specified for projection" << std::endl;
 				continue;
 			}
 
-			// Get a matrix to collect all the terms (the total Liouvillian)
-			arma::sp_cx_mat A = arma::cx_double(0.0, -1.0) * H;
-
-			// Get the reaction operators, and add them to "A"
-			arma::sp_cx_mat K;
-			if (!space.TotalReactionOperator(K))
-			{
-				this->Log() << "Warning: Failed to obtain matrix representation of the reaction operators!" << std::endl;
-			}
-			A -= K;
+			bool Dnp = false;
+			if (!this->productYieldsOnly)
+				this->Properties()->Get("dnp", Dnp);
 
-			// Get the relaxation terms, assuming that they can just be added to the Liouvillian superoperator
-			arma::sp_cx_mat R;
-			for (auto j = (*i)->operators_cbegin(); j != (*i)->operators_cend(); j++)
+			if (this->productYieldsOnly)
+				std::cout << "Perfoming CIDSP calculation." << std::endl;
+			else if (Dnp)
+				std::cout << "Perfoming DNP calculation." << std::endl;
+			else
+				std::cout << "Perfoming Double-Projection calculation." << std::endl;
+
+			// Collect the observables Ix, Iy and Iz of the nuclei, projected onto the states (or the source states of the transitions), in the order of the output
+			SpinAPI::ObservableSet observables(space.HilbertSpaceDimensions(), true);
+			arma::sp_cx_mat Iproj[3];
+			arma::sp_cx_mat P;
+			bool hasOperators = true;
+			for (auto l = (*i)->spins_cbegin(); l != (*i)->spins_cend() && hasOperators; l++)
 			{
-				if (space.RelaxationOperator((*j), R))
+				for (unsigned int m = 0; m < nuclei_list.size(); m++)
 				{
-					A += R;
-					this->Log() << "Added relaxation operator \"" << (*j)->Name() << "\" to the Liouvillian.\n";
-				}
-			}
+					if ((*l)->Name() != nuclei_list[m])
+						continue;
 
-			// Perform the calculation
-			// Here it could be a problem of the right sign
-			this->Log() << "Ready to perform calculation." << std::endl;
-			arma::cx_vec result = solve(-1 * arma::conv_to<arma::cx_mat>::from(A), rho0vec);
-			this->Log() << "Done with calculation." << std::endl;
+					std::cout << (*l)->Name() << std::endl;
+					if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, (*l), Iproj[0]) || !space.CreateOperator(SpinAPI::SpinOperatorType::Sy, (*l), Iproj[1]) || !space.CreateOperator(SpinAPI::SpinOperatorType::Sz, (*l), Iproj[2]))
+					{
+						hasOperators = false;
+						break;
+					}
 
-			// Convert the resulting density operator back to its Hilbert space representation
-			if (!space.OperatorFromSuperspace(result, rho0))
-			{
-				this->Log() << "Failed to convert resulting superspace-vector back to native Hilbert space." << std::endl;
-				continue;
-			}
+					if (this->productYieldsOnly)
+					{
+						// Loop through all defind transitions
+						auto transitions = (*i)->Transitions();
+						for (auto j = transitions.cbegin(); j != transitions.cend(); j++)
+						{
+							// Make sure that there is a state object
+							if ((*j)->SourceState() == nullptr)
+								continue;
 
-			// Get nuclei of interest for CIDNP spectrum
+							if (!space.GetState((*j)->SourceState(), P))
+							{
+								this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+								continue;
+							}
+
+							for (unsigned int c = 0; c < 3; c++)
+								observables.Add(arma::sp_cx_mat((*j)->Rate() * Iproj[c] * P));
+						}
+					}
+					else if (Dnp)
+					{
+						this->Log() << "Just using the projection operator of " << (*l)->Name() << " and not doing CIDNP." << std::endl;
+						for (unsigned int c = 0; c < 3; c++)
+							observables.Add(Iproj[c]);
+					}
+					else
+					{
+						// Loop through all states
+						auto states = (*i)->States();
+						for (auto j = states.cbegin(); j != states.cend(); j++)
+						{
+							if (!space.GetState((*j), P))
+							{
+								this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+								continue;
+							}
 
-			arma::cx_mat Iprojx;
-			arma::cx_mat Iprojy;
-			arma::cx_mat Iprojz;
+							// Note that no reaction rates are included here
+							for (unsigned int c = 0; c < 3; c++)
+								observables.Add(arma::sp_cx_mat(Iproj[c] * P));
+						}
+					}
+				}
+			}
 
-			std::vector<std::string> nuclei_list;
-			bool Dnp = false;
-			int m;
+			if (!hasOperators)
+				return false;
 
-			this->Data() << this->RunSettings()->CurrentStep() << " ";
-			this->WriteStandardOutput(this->Data());
+			arma::cx_vec yields;
 
-			if (this->Properties()->GetList("nuclei_list", nuclei_list, ','))
+			// With Haberkorn reaction operators and without relaxation, the equation can be solved in the Hilbert space
+			bool solved = false;
+			if (this->solver.compare("sylvester") == 0)
 			{
-				for (auto l = (*i)->spins_cbegin(); l != (*i)->spins_cend(); l++)
+				if (!space.HasOnlyHaberkornReactionOperators() || (*i)->operators_cbegin() != (*i)->operators_cend())
 				{
-					for (m = 0; m < (int)nuclei_list.size(); m++)
-					{
-						std::string spintype;
-						(*l)->Properties()->Get("type", spintype);
-
-						if (spintype != "electron")
-						{
-							std::cout << spintype << std::endl;
-						}
+					this->Log() << "The Sylvester solver requires Haberkorn reaction operators and no relaxation operators. Using the dense Liouville-space solver instead." << std::endl;
+				}
+				else
+				{
+					this->Log() << "Ready to perform calculation in the Hilbert space." << std::endl;
+					arma::cx_mat rho;
+					space.UseSuperoperatorSpace(false);
+					solved = space.SolveHaberkornSteadyState(rho0, rho);
+					space.UseSuperoperatorSpace(true);
+
+					// The Liouville-space path below solves with the negative Liouvillian
+					arma::cx_vec rhovec;
+					solved = solved && space.OperatorToSuperspace(-rho, rhovec) && observables.Evaluate(rhovec, yields);
+					if (solved)
+						this->Log() << "Done with calculation." << std::endl;
+					else
+						this->Log() << "Warning: The Sylvester solver failed. Using the dense Liouville-space solver instead." << std::endl;
+				}
+			}
 
-						if ((*l)->Name() == nuclei_list[m])
-						{
-							std::cout << (*l)->Name() << std::endl;
-							if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*l)->Sx()), (*l), Iprojx))
-							{
-								return false;
-							}
+			if (!solved)
+			{
+				// Convert initial state to superoperator space
+				arma::cx_vec rho0vec;
+				if (!space.OperatorToSuperspace(rho0, rho0vec))
+				{
+					this->Log() << "Failed to convert initial state density operator to superspace." << std::endl;
+					continue;
+				}
 
-							if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*l)->Sy()), (*l), Iprojy))
-							{
-								return false;
-							}
+				// Get the Hamiltonian
+				arma::sp_cx_mat H;
+				if (!space.Hamiltonian(H))
+				{
+					this->Log() << "Failed to obtain Hamiltonian in superspace." << std::endl;
+					continue;
+				}
 
-							if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*l)->Sz()), (*l), Iprojz))
-							{
-								return false;
-							}
+				// Get a matrix to collect all the terms (the total Liouvillian)
+				arma::sp_cx_mat A = arma::cx_double(0.0, -1.0) * H;
 
-							arma::cx_mat P;
+				// Get the reaction operators, and add them to "A"
+				arma::sp_cx_mat K;
+				if (!space.TotalReactionOperator(K))
+				{
+					this->Log() << "Warning: Failed to obtain matrix representation of the reaction operators!" << std::endl;
+				}
+				A -= K;
 
-							// There are two result modes - either write results per transition or for each defined state
-							if (this->productYieldsOnly && Dnp == false)
-							{
-								std::cout << "Perfoming CIDSP calculation." << std::endl;
-								// Loop through all defind transitions
-								auto transitions = (*i)->Transitions();
-								for (auto j = transitions.cbegin(); j != transitions.cend(); j++)
-								{
-									// Make sure that there is a state object
-									if ((*j)->SourceState() == nullptr)
-										continue;
-
-									if (!space.GetState((*j)->SourceState(), P))
-									{
-										this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
-										continue;
-									}
-
-									std::cout << "Ix:" << std::real(arma::trace(Iprojx * (*j)->Rate() * P * rho0)) << std::endl;
-									std::cout << "Iy:" << std::real(arma::trace(Iprojy * (*j)->Rate() * P * rho0)) << std::endl;
-									std::cout << "Iz:" << std::real(arma::trace(Iprojz * (*j)->Rate() * P * rho0)) << std::endl;
-
-									// Return the yield for this transition
-									this->Data() << std::real(arma::trace(Iprojx * (*j)->Rate() * P * rho0)) << " ";
-									this->Data() << std::real(arma::trace(Iprojy * (*j)->Rate() * P * rho0)) << " ";
-									this->Data() << std::real(arma::trace(Iprojz * (*j)->Rate() * P * rho0)) << " ";
-								}
-							}
-							else if (this->Properties()->Get("dnp", Dnp) && Dnp == true)
-							{
-								std::cout << "Perfoming DNP calculation." << std::endl;
-								this->Log() << "Just using the projection operator of " << (*l)->Name() << " and not doing CIDNP." << std::endl;
-
-								std::cout << "rho: " << rho0 << std::endl;
-								std::cout << "Ix:" << std::real(arma::trace(Iprojx * rho0)) << std::endl;
-								std::cout << "Ix:" << Iprojx << std::endl;
-								std::cout << "KE" << Iprojy * rho0 << std::endl;
-								std::cout << "Iy:" << std::real(arma::trace(Iprojy * rho0)) << std::endl;
-								std::cout << "Iy:" << Iprojy << std::endl;
-								std::cout << "Iz:" << std::real(arma::trace(Iprojz * rho0)) << std::endl;
-								std::cout << "Iz:" << Iprojz << std::endl;
-								// Return the yield for this state - note that no reaction rates are included here.
-								this->Data() << std::real(arma::trace(Iprojx * rho0)) << " ";
-								this->Data() << std::real(arma::trace(Iprojy * rho0)) << " ";
-								this->Data() << std::real(arma::trace(Iprojz * rho0)) << " ";
-							}
-							else
-							{
-								std::cout << "Perfoming Double-Projection calculation." << std::endl;
-								// Loop through all states
-								auto states = (*i)->States();
-								for (auto j = states.cbegin(); j != states.cend(); j++)
-								{
-									if (!space.GetState((*j), P))
-									{
-										this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
-										continue;
-									}
-
-									std::cout << "Ix:" << std::real(arma::trace(Iprojx * P * rho0)) << std::endl;
-									std::cout << "Iy:" << std::real(arma::trace(Iprojy * P * rho0)) << std::endl;
-									std::cout << "Iz:" << std::real(arma::trace(Iprojz * P * rho0)) << std::endl;
-
-									// Return the yield for this state - note that no reaction rates are included here.
-									this->Data() << std::real(arma::trace(Iprojx * P * rho0)) << " ";
-									this->Data() << std::real(arma::trace(Iprojy * P * rho0)) << " ";
-									this->Data() << std::real(arma::trace(Iprojz * P * rho0)) << " ";
-								}
-							}
-						}
+				// Get the relaxation terms, assuming that they can just be added to the Liouvillian superoperator
+				arma::sp_cx_mat R;
+				for (auto j = (*i)->operators_cbegin(); j != (*i)->operators_cend(); j++)
+				{
+					if (space.RelaxationOperator((*j), R))
+					{
+						A += R;
+						this->Log() << "Added relaxation operator \"" << (*j)->Name() << "\" to the Liouvillian.\n";
 					}
 				}
 
-				this->Log() << "\nDone with SpinSystem \"" << (*i)->Name() << "\"" << std::endl;
+				// Perform the calculation, with a single factorization for all observables
+				// Here it could be a problem of the right sign
+				this->Log() << "Ready to perform calculation." << std::endl;
+				arma::cx_mat result;
+				if (!space.SolveYields(arma::sp_cx_mat(-A), arma::cx_mat(rho0vec), observables, result))
+				{
+					this->Log() << "Failed to solve the Liouville-space equation for SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+					continue;
+				}
+				yields = result.col(0);
+				this->Log() << "Done with calculation." << std::endl;
 			}
-			else
+
+			// Write the results, three values (Ix, Iy and Iz) per nucleus and state or transition
+			this->Data() << this->RunSettings()->CurrentStep() << " ";
+			this->WriteStandardOutput(this->Data());
+			for (unsigned int k = 0; k < yields.n_elem; k++)
 			{
-				this->Log() << "No nucleus was specified for projection" << std::endl;
-				continue;
+				std::cout << (k % 3 == 0 ? "Ix:" : (k % 3 == 1 ? "Iy:" : "Iz:")) << std::real(yields(k)) << std::endl;
+				this->Data() << std::real(yields(k)) << " ";
 			}
+
+			this->Log() << "\nDone with SpinSystem \"" << (*i)->Name() << "\"" << std::endl;
 		}
 
 		// Terminate the line in the data file after iteration through all spin systems
@@ -387,6 +391,20 @@ namespace RunSection
 			}
 		}
 
+		// Get the solver used for the steady-state equation
+		if (this->Properties()->Get("solver", str))
+		{
+			if (str.compare("dense") == 0 || str.compare("sylvester") == 0)
+			{
+				this->solver = str;
+				this->Log() << "Setting solver to \"" << str << "\"." << std::endl;
+			}
+			else
+			{
+				this->Log() << "Warning: Unknown solver \"" << str << "\" specified. Using the dense solver." << std::endl;
+			}
+		}
+
 		return true;
 	}
 	// -----------------------------------------------------
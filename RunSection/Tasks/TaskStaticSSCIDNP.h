@@ -23,6 +23,7 @@ namespace RunSection
 		SpinAPI::ReactionOperatorType reactionOperators;
 		bool productYieldsOnly; // If true, a quantum yield will be calculated from each Transition object and multiplied by the rate constant
 								// If false, a quantum yield will be calculated each defined State object
+		std::string solver;		// Method used to solve the steady-state equation: "dense" (Liouville space) or "sylvester" (Hilbert space)
 
 		void WriteHeader(std::ostream &); // Write header for the output file
 
@@ -84,6 +84,7 @@ namespace RunSection
 					rho0 += tmp_rho0;
 			}
 
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
 			// ----------------------------------------------------------------
@@ -285,17 +286,17 @@ namespace RunSection
 
 										this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 										{
 											return false;
 										}
@@ -612,32 +613,32 @@ namespace RunSection
 
 											this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 											{
 												return false;
 											}
@@ -975,17 +976,17 @@ namespace RunSection
 
 									this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-									if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+									if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 									{
 										return false;
 									}
 
-									if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+									if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 									{
 										return false;
 									}
 
-									if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+									if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 									{
 										return false;
 									}
@@ -1347,32 +1348,32 @@ namespace RunSection
 
 										this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 										{
 											return false;
 										}
@@ -20,7 +20,7 @@ namespace RunSection
 	// -----------------------------------------------------
 	// TaskStaticSS Constructors and Destructor
 	// -----------------------------------------------------
-	TaskStaticSSPump::TaskStaticSSPump(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), timestep(1.0), totaltime(1.0e+4), reactionOperators(SpinAPI::ReactionOperatorType::Haberkorn)
+	TaskStaticSSPump::TaskStaticSSPump(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), timestep(1.0), totaltime(1.0e+4), reactionOperators(SpinAPI::ReactionOperatorType::Haberkorn), hilbertSpace(false)
 	{
 	}
 
@@ -48,6 +48,7 @@ namespace RunSection
 		auto systems = this->SpinSystems();
 		std::pair<arma::cx_mat, arma::cx_vec> P[systems.size()]; // Create array containing a propagator and the current state of each system
 		SpinAPI::SpinSpace spaces[systems.size()];				 // Keep a SpinSpace object for each spin system
+		std::vector<bool> useHilbertSpace(systems.size(), false); // Whether the propagator of a system acts in the Hilbert space
 
 		// Loop through all SpinSystems
 		int ic = 0; // System counter
@@ -81,8 +82,38 @@ namespace RunSection
 				else
 					rho0 += tmp_rho0;
 			}
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
+			// With Haberkorn reaction operators and without relaxation, the propagator U = exp((-iH - K) * dt) acts on the
+			// density operator as U * rho * U^dagger (the conjugate transpose), which needs N^2 rather than N^4 elements
+			if (this->hilbertSpace)
+			{
+				if (!space.HasOnlyHaberkornReactionOperators() || (*i)->operators_cbegin() != (*i)->operators_cend())
+				{
+					this->Log() << "Propagation in the Hilbert space requires Haberkorn reaction operators and no relaxation operators. Using the superspace for SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+				}
+				else
+				{
+					arma::cx_mat H;
+					arma::cx_mat K;
+					space.UseSuperoperatorSpace(false);
+					bool hasOperators = space.Hamiltonian(H) && space.TotalReactionOperator(K);
+					space.UseSuperoperatorSpace(true);
+
+					if (hasOperators)
+					{
+						// The current state is kept as a vectorized Hilbert space density operator
+						P[ic] = std::pair<arma::cx_mat, arma::cx_vec>(arma::expmat((arma::cx_double(0.0, -1.0) * H - K) * this->timestep), arma::vectorise(rho0));
+						useHilbertSpace[ic] = true;
+						++ic;
+						continue;
+					}
+
+					this->Log() << "Warning: Failed to obtain the Hilbert space operators. Using the superspace for SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+				}
+			}
+
 			// Convert initial state to superoperator space
 			if (!space.OperatorToSuperspace(rho0, rho0vec))
 			{
@@ -163,14 +194,23 @@ namespace RunSection
 			for (auto i = systems.cbegin(); i != systems.cend(); i++)
 			{
 				// Take a step "first" is propagator and "second" is current state
-				rho0vec = P[ic].first * P[ic].second;
-				P[ic].second = rho0vec;
-
-				// Convert the resulting density operator back to its Hilbert space representation
-				if (!spaces[ic].OperatorFromSuperspace(rho0vec, rho0))
+				if (useHilbertSpace[ic])
 				{
-					this->Log() << "Failed to convert resulting superspace-vector back to native Hilbert space." << std::endl;
-					continue;
+					const arma::cx_mat &U = P[ic].first;
+					rho0 = U * arma::reshape(P[ic].second, U.n_rows, U.n_cols) * U.t();
+					P[ic].second = arma::vectorise(rho0);
+				}
+				else
+				{
+					rho0vec = P[ic].first * P[ic].second;
+					P[ic].second = rho0vec;
+
+					// Convert the resulting density operator back to its Hilbert space representation
+					if (!spaces[ic].OperatorFromSuperspace(rho0vec, rho0))
+					{
+						this->Log() << "Failed to convert resulting superspace-vector back to native Hilbert space." << std::endl;
+						continue;
+					}
 				}
 
 				// Obtain the results
@@ -272,6 +312,9 @@ namespace RunSection
 			}
 		}
 
+		// Propagate in the Hilbert space rather than the superspace where possible
+		this->Properties()->Get("hilbertspace", this->hilbertSpace);
+
 		return true;
 	}
 	// -----------------------------------------------------
@@ -20,6 +20,7 @@ namespace RunSection
 		double timestep;
 		double totaltime;
 		SpinAPI::ReactionOperatorType reactionOperators;
+		bool hilbertSpace; // Propagate in the Hilbert space when possible (Haberkorn reaction operators and no relaxation)
 
 		void WriteHeader(std::ostream &); // Write header for the output file
 
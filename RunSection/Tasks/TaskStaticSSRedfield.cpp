@@ -24,7 +24,8 @@ namespace RunSection
 	// -----------------------------------------------------
 	// TaskStaticSSRedfield Constructors and Destructor
 	// -----------------------------------------------------
-	TaskStaticSSRedfield::TaskStaticSSRedfield(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), reactionOperators(SpinAPI::ReactionOperatorType::Haberkorn), productYieldsOnly(false)
+	TaskStaticSSRedfield::TaskStaticSSRedfield(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), reactionOperators(SpinAPI::ReactionOperatorType::Haberkorn), productYieldsOnly(false),
+																														matrixFree(false), redfieldTerms(), solver("gmres"), solverTolerance(1e-10), solverRestart(50), solverMaxIterations(1000)
 	{
 	}
 
@@ -84,6 +85,7 @@ namespace RunSection
 					rho0 += tmp_rho0;
 			}
 
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
 			// ----------------------------------------------------------------
@@ -132,14 +134,16 @@ namespace RunSection
 			// ---------------------------------------------------------------
 
 			// Redfield tensor
+			// In matrix-free mode the tensor is never stored, only its terms in operator form (see AddRedfieldTerm)
 			arma::cx_mat R;
-			R.set_size(size(kron(H, H)));
-			R.zeros();
+			arma::cx_mat tmp_R; // Temporary Redfield tensor
+			this->redfieldTerms.clear();
 
-			// Temporary Redfield tensor
-			arma::cx_mat tmp_R;
-			tmp_R.set_size(size(kron(H, H)));
-			tmp_R.zeros();
+			if (!this->matrixFree)
+			{
+				R.zeros(H.n_rows * H.n_rows, H.n_cols * H.n_cols);
+				tmp_R.zeros(H.n_rows * H.n_rows, H.n_cols * H.n_cols);
+			}
 
 			// R Tensor array pointer for parallelization
 			arma::cx_mat **ptr_R = NULL;
@@ -289,17 +293,17 @@ namespace RunSection
 
 										this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 										{
 											return false;
 										}
@@ -537,27 +541,19 @@ namespace RunSection
 													// CONSTRUCTING R MATRIX
 													// -----------------------------------------------------------------
 
-													tmp_R *= 0.0;
-
-													if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[s]), *ptr_SpecDens[m], tmp_R))
+													if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[s]), *ptr_SpecDens[m], tmp_R, R))
 													{
 														this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 														continue;
 													}
 
-													R += tmp_R;
-
 													if (k != s)
 													{
-														tmp_R *= 0.0;
-
-														if (!Redfieldtensor((*ptr_Tensors[s]), (*ptr_Tensors[k]), *ptr_SpecDens[m], tmp_R))
+														if (!this->AddRedfieldTerm((*ptr_Tensors[s]), (*ptr_Tensors[k]), *ptr_SpecDens[m], tmp_R, R))
 														{
 															this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 															continue;
 														}
-
-														R += tmp_R;
 													}
 												}
 
@@ -624,15 +620,11 @@ namespace RunSection
 												// CONSTRUCTING R MATRIX
 												// -----------------------------------------------------------------
 
-												tmp_R *= 0.0;
-
-												if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[k]), *ptr_SpecDens[m], tmp_R))
+												if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[k]), *ptr_SpecDens[m], tmp_R, R))
 												{
 													this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 													continue;
 												}
-
-												R += tmp_R;
 											}
 
 											m = m + 1;
@@ -664,32 +656,32 @@ namespace RunSection
 
 											this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 											{
 												return false;
 											}
@@ -916,27 +908,19 @@ namespace RunSection
 														// CONSTRUCTING R MATRIX
 														// -----------------------------------------------------------------
 
-														tmp_R *= 0.0;
-
-														if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[s]), *ptr_SpecDens[m], tmp_R))
+														if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[s]), *ptr_SpecDens[m], tmp_R, R))
 														{
 															this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 															continue;
 														}
 
-														R += tmp_R;
-
 														if (k != s)
 														{
-															tmp_R *= 0.0;
-
-															if (!Redfieldtensor((*ptr_Tensors[s]), (*ptr_Tensors[k]), *ptr_SpecDens[m], tmp_R))
+															if (!this->AddRedfieldTerm((*ptr_Tensors[s]), (*ptr_Tensors[k]), *ptr_SpecDens[m], tmp_R, R))
 															{
 																this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 																continue;
 															}
-
-															R += tmp_R;
 														}
 													}
 
@@ -1004,15 +988,11 @@ namespace RunSection
 													// CONSTRUCTING R MATRIX
 													// -----------------------------------------------------------------
 
-													tmp_R *= 0.0;
-
-													if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[k]), *ptr_SpecDens[m], tmp_R))
+													if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[k]), *ptr_SpecDens[m], tmp_R, R))
 													{
 														this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 														continue;
 													}
-
-													R += tmp_R;
 												}
 
 												m = m + 1;
@@ -1078,17 +1058,17 @@ namespace RunSection
 
 									this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-									if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+									if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 									{
 										return false;
 									}
 
-									if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+									if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 									{
 										return false;
 									}
 
-									if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+									if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 									{
 										return false;
 									}
@@ -1294,15 +1274,11 @@ namespace RunSection
 											// CONSTRUCTING R MATRIX
 											// -----------------------------------------------------------------
 
-											tmp_R *= 0.0;
-
-											if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[k]), SpecDens, tmp_R))
+											if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[k]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 											{
 												this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 												continue;
 											}
-
-											*ptr_R[omp_get_thread_num()] += tmp_R;
 										}
 									}
 									else
@@ -1351,15 +1327,11 @@ namespace RunSection
 											// CONSTRUCTING R MATRIX
 											// -----------------------------------------------------------------
 
-											tmp_R *= 0.0;
-
-											if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[k]), SpecDens, tmp_R))
+											if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[k]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 											{
 												this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 												continue;
 											}
-
-											*ptr_R[omp_get_thread_num()] += tmp_R;
 										}
 									}
 								}
@@ -1415,27 +1387,19 @@ namespace RunSection
 												// CONSTRUCTING R MATRIX
 												// ----------------------------------------------------------------
 
-												tmp_R *= 0.0;
-
-												if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[s]), SpecDens, tmp_R))
+												if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[s]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 												{
 													this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 													continue;
 												}
 
-												*ptr_R[omp_get_thread_num()] += tmp_R;
-
 												if (k != s)
 												{
-													tmp_R *= 0.0;
-
-													if (!Redfieldtensor((*ptr_Tensors[s]), (*ptr_Tensors[k]), SpecDens, tmp_R))
+													if (!this->AddRedfieldTerm((*ptr_Tensors[s]), (*ptr_Tensors[k]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 													{
 														this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 														continue;
 													}
-
-													*ptr_R[omp_get_thread_num()] += tmp_R;
 												}
 											}
 										}
@@ -1488,26 +1452,19 @@ namespace RunSection
 												// CONSTRUCTING R MATRIX
 												// ----------------------------------------------------------------
 
-												tmp_R *= 0.0;
-
-												if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[s]), SpecDens, tmp_R))
+												if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[s]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 												{
 													this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 													continue;
 												}
 
-												*ptr_R[omp_get_thread_num()] += tmp_R;
-
 												if (k != s)
 												{
-													tmp_R *= 0.0;
-
-													if (!Redfieldtensor((*ptr_Tensors[s]), (*ptr_Tensors[k]), SpecDens, tmp_R))
+													if (!this->AddRedfieldTerm((*ptr_Tensors[s]), (*ptr_Tensors[k]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 													{
 														this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 														continue;
 													}
-													*ptr_R[omp_get_thread_num()] += tmp_R;
 												}
 											}
 										}
@@ -1542,32 +1499,32 @@ namespace RunSection
 
 										this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 										{
 											return false;
 										}
@@ -1780,15 +1737,11 @@ namespace RunSection
 												// CONSTRUCTING R MATRIX
 												// -----------------------------------------------------------------
 
-												tmp_R *= 0.0;
-
-												if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[k]), SpecDens, tmp_R))
+												if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[k]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 												{
 													this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 													continue;
 												}
-
-												*ptr_R[omp_get_thread_num()] += tmp_R;
 											}
 										}
 										else
@@ -1837,15 +1790,11 @@ namespace RunSection
 												// CONSTRUCTING R MATRIX
 												// -----------------------------------------------------------------
 
-												tmp_R *= 0.0;
-
-												if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[k]), SpecDens, tmp_R))
+												if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[k]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 												{
 													this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 													continue;
 												}
-
-												*ptr_R[omp_get_thread_num()] += tmp_R;
 											}
 										}
 									}
@@ -1901,27 +1850,19 @@ namespace RunSection
 													// CONSTRUCTING R MATRIX
 													// ----------------------------------------------------------------
 
-													tmp_R *= 0.0;
-
-													if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[s]), SpecDens, tmp_R))
+													if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[s]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 													{
 														this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 														continue;
 													}
 
-													*ptr_R[omp_get_thread_num()] += tmp_R;
-
 													if (k != s)
 													{
-														tmp_R *= 0.0;
-
-														if (!Redfieldtensor((*ptr_Tensors[s]), (*ptr_Tensors[k]), SpecDens, tmp_R))
+														if (!this->AddRedfieldTerm((*ptr_Tensors[s]), (*ptr_Tensors[k]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 														{
 															this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 															continue;
 														}
-
-														*ptr_R[omp_get_thread_num()] += tmp_R;
 													}
 												}
 											}
@@ -1974,26 +1915,19 @@ namespace RunSection
 													// CONSTRUCTING R MATRIX
 													// ----------------------------------------------------------------
 
-													tmp_R *= 0.0;
-
-													if (!Redfieldtensor((*ptr_Tensors[k]), (*ptr_Tensors[s]), SpecDens, tmp_R))
+													if (!this->AddRedfieldTerm((*ptr_Tensors[k]), (*ptr_Tensors[s]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 													{
 														this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 														continue;
 													}
 
-													*ptr_R[omp_get_thread_num()] += tmp_R;
-
 													if (k != s)
 													{
-														tmp_R *= 0.0;
-
-														if (!Redfieldtensor((*ptr_Tensors[s]), (*ptr_Tensors[k]), SpecDens, tmp_R))
+														if (!this->AddRedfieldTerm((*ptr_Tensors[s]), (*ptr_Tensors[k]), SpecDens, tmp_R, *ptr_R[omp_get_thread_num()]))
 														{
 															this->Log() << "There are problems with the construction of the Redfield tensor - Please check your input." << std::endl;
 															continue;
 														}
-														*ptr_R[omp_get_thread_num()] += tmp_R;
 													}
 												}
 											}
@@ -2034,144 +1968,161 @@ namespace RunSection
 			}
 			delete[] ptr_Tensors;
 
-			// ---------------------------------------------------------------
-			// SETUP COMPLETE HAMILTONIAN
-			// ---------------------------------------------------------------
-			// Transform  H0 into superspace
-			arma::cx_mat lhs;
-			arma::cx_mat rhs;
-			arma::cx_mat H_SS;
-
-			// Transforming into superspace
-			space.SuperoperatorFromLeftOperator(eig_val_mat, lhs);
-			space.SuperoperatorFromRightOperator(eig_val_mat, rhs);
+			arma::cx_vec result;
+			if (this->matrixFree)
+			{
+				// ---------------------------------------------------------------
+				// SOLVE WITHOUT CONSTRUCTING SUPEROPERATORS
+				// ---------------------------------------------------------------
+				this->Log() << "Ready to perform calculation (matrix-free, " << this->redfieldTerms.size() << " Redfield terms)." << std::endl;
+				if (!this->SolveMatrixFree(space, *i, eig_val_mat, eigen_vec, rho0, result))
+				{
+					this->Log() << "Failed to solve the Liouville-space equation for SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+					continue;
+				}
+				this->Log() << "Done with calculation." << std::endl;
+			}
+			else
+			{
+				// ---------------------------------------------------------------
+				// SETUP COMPLETE HAMILTONIAN
+				// ---------------------------------------------------------------
+				// Transform  H0 into superspace
+				arma::cx_mat lhs;
+				arma::cx_mat rhs;
+				arma::cx_mat H_SS;
 
-			H_SS = lhs - rhs;
+				// Transforming into superspace
+				space.SuperoperatorFromLeftOperator(eig_val_mat, lhs);
+				space.SuperoperatorFromRightOperator(eig_val_mat, rhs);
 
-			// Get a matrix to collect all the terms (the total Liouvillian)
-			arma::cx_mat A = arma::cx_double(0.0, -1.0) * H_SS;
+				H_SS = lhs - rhs;
 
-			// Get the reaction operators, and add them to "A"
-			arma::cx_mat K;
+				// Get a matrix to collect all the terms (the total Liouvillian)
+				arma::cx_mat A = arma::cx_double(0.0, -1.0) * H_SS;
 
-			if (!space.TotalReactionOperator(K))
-			{
-				this->Log() << "Warning: Failed to obtain matrix representation of the reaction operators!" << std::endl;
-			}
+				// Get the reaction operators, and add them to "A"
+				arma::cx_mat K;
 
-			// Rotation into eigenbasis of H0
-			K = eigen_vec.t() * K * eigen_vec;
+				if (!space.TotalReactionOperator(K))
+				{
+					this->Log() << "Warning: Failed to obtain matrix representation of the reaction operators!" << std::endl;
+				}
 
-			// Transform ReactionOperator into superspace
-			arma::cx_mat Klhs;
-			arma::cx_mat Krhs;
-			arma::cx_mat K_SS;
+				// Rotation into eigenbasis of H0
+				K = eigen_vec.t() * K * eigen_vec;
 
-			space.SuperoperatorFromLeftOperator(K, Klhs);
-			space.SuperoperatorFromRightOperator(K, Krhs);
+				// Transform ReactionOperator into superspace
+				arma::cx_mat Klhs;
+				arma::cx_mat Krhs;
+				arma::cx_mat K_SS;
 
-			K_SS = Klhs + Krhs;
+				space.SuperoperatorFromLeftOperator(K, Klhs);
+				space.SuperoperatorFromRightOperator(K, Krhs);
 
-			A -= K_SS;
+				K_SS = Klhs + Krhs;
 
-			// Get the relaxation terms of other relaxation operators, assuming that they can just be added
-			arma::cx_mat O_SS;
+				A -= K_SS;
 
-			for (auto t = (*i)->operators_cbegin(); t != (*i)->operators_cend(); t++)
-			{
-				space.UseSuperoperatorSpace(true);
+				// Get the relaxation terms of other relaxation operators, assuming that they can just be added
+				arma::cx_mat O_SS;
 
-				if (space.RelaxationOperatorFrameChange((*t), eigen_vec, O_SS))
+				for (auto t = (*i)->operators_cbegin(); t != (*i)->operators_cend(); t++)
 				{
+					space.UseSuperoperatorSpace(true);
 
-					A += O_SS;
+					if (space.RelaxationOperatorFrameChange((*t), eigen_vec, O_SS))
+					{
 
-					space.UseSuperoperatorSpace(false);
-					this->Log() << "Added other relaxation operator \"" << (*t)->Name() << "\" to the Liouvillian.\n";
-				}
-				else
-				{
-					this->Log() << "There is a problem with operator \"" << (*t)->Name() << ". Please check.\n";
-					space.UseSuperoperatorSpace(false);
+						A += O_SS;
+
+						space.UseSuperoperatorSpace(false);
+						this->Log() << "Added other relaxation operator \"" << (*t)->Name() << "\" to the Liouvillian.\n";
+					}
+					else
+					{
+						this->Log() << "There is a problem with operator \"" << (*t)->Name() << ". Please check.\n";
+						space.UseSuperoperatorSpace(false);
+					}
 				}
-			}
 
-			int secular = 0;
-			this->Properties()->Get("secular", secular);
+				int secular = 0;
+				this->Properties()->Get("secular", secular);
 
-			if (secular == 1)
-			{
-				this->Log() << "Secular approximation is USED." << std::endl;
+				if (secular == 1)
+				{
+					this->Log() << "Secular approximation is USED." << std::endl;
 
-				double cutoff = 0.0;
-				this->Properties()->Get("cutoff", cutoff);
-				this->Log() << "Cutoff set to: " << cutoff << std::endl;
+					double cutoff = 0.0;
+					this->Properties()->Get("cutoff", cutoff);
+					this->Log() << "Cutoff set to: " << cutoff << std::endl;
 
-				int nn = domega.n_rows;
+					int nn = domega.n_rows;
 
-				std::cout << domega << std::endl;
+					std::cout << domega << std::endl;
 
-				std::cout << "Elements of domega: " << nn << std::endl;
-				std::cout << "Elements of R.n_col: " << R.n_cols << std::endl;
-				std::cout << "Elements of R.n_row: " << R.n_rows << std::endl;
+					std::cout << "Elements of domega: " << nn << std::endl;
+					std::cout << "Elements of R.n_col: " << R.n_cols << std::endl;
+					std::cout << "Elements of R.n_row: " << R.n_rows << std::endl;
 
-				int ra = 0;
-				int rb = 0;
-				int rc = 0;
-				int rd = 0;
-				int ii = 0;
-				int jj = 0;
-				int counter = 0;
+					int ra = 0;
+					int rb = 0;
+					int rc = 0;
+					int rd = 0;
+					int ii = 0;
+					int jj = 0;
+					int counter = 0;
 
-				for (ra = 0; ra < nn; ra++)
-				{
-					for (rb = 0; rb < nn; rb++)
+					for (ra = 0; ra < nn; ra++)
 					{
-						ii = ra * nn + rb;
-
-						for (rc = 0; rc < nn; rc++)
+						for (rb = 0; rb < nn; rb++)
 						{
-							for (rd = 0; rd < nn; rd++)
-							{
-								jj = rc * nn + rd;
+							ii = ra * nn + rb;
 
-								if (std::abs((domega(ra, rb) - domega(rc, rd))) >= cutoff)
-								{
-									R(ii, jj) *= 0.0;
-									counter += 1;
-								}
-								else
+							for (rc = 0; rc < nn; rc++)
+							{
+								for (rd = 0; rd < nn; rd++)
 								{
-									std::cout << "domega(ra,rb): " << domega(ra, rb) << std::endl;
-									std::cout << "domega(rc,rd): " << domega(rc, rd) << std::endl;
+									jj = rc * nn + rd;
+
+									if (std::abs((domega(ra, rb) - domega(rc, rd))) >= cutoff)
+									{
+										R(ii, jj) *= 0.0;
+										counter += 1;
+									}
+									else
+									{
+										std::cout << "domega(ra,rb): " << domega(ra, rb) << std::endl;
+										std::cout << "domega(rc,rd): " << domega(rc, rd) << std::endl;
+									}
 								}
 							}
 						}
 					}
+					std::cout << "counter: " << counter << std::endl;
 				}
-				std::cout << "counter: " << counter << std::endl;
-			}
 
-			// Adding R tensor to whole hamiltonian
-			A += R;
+				// Adding R tensor to whole hamiltonian
+				A += R;
 
-			// Transform density operator into superspace
-			arma::cx_vec rho0vec;
-			rho0vec *= 0.0;
+				// Transform density operator into superspace
+				arma::cx_vec rho0vec;
+				rho0vec *= 0.0;
 
-			if (!space.OperatorToSuperspace(rho0, rho0vec))
-			{
-				this->Log() << "Failed to convert initial state density operator to superspace." << std::endl;
-				continue;
-			}
+				if (!space.OperatorToSuperspace(rho0, rho0vec))
+				{
+					this->Log() << "Failed to convert initial state density operator to superspace." << std::endl;
+					continue;
+				}
 
-			// ---------------------------------------------------------------
-			// DO PROPAGATION OF DENSITY OPERATOR
-			// ---------------------------------------------------------------
-			// Perform the calculation
-			this->Log() << "Ready to perform calculation." << std::endl;
-			arma::cx_vec result = solve(arma::conv_to<arma::cx_mat>::from(A), rho0vec);
-			this->Log() << "Done with calculation." << std::endl;
+				// ---------------------------------------------------------------
+				// DO PROPAGATION OF DENSITY OPERATOR
+				// ---------------------------------------------------------------
+				// Perform the calculation
+				this->Log() << "Ready to perform calculation." << std::endl;
+				result = solve(arma::conv_to<arma::cx_mat>::from(A), rho0vec);
+				this->Log() << "Done with calculation." << std::endl;
+			}
 
 			// Convert the resulting density operator back to its Hilbert space representation
 			if (!space.OperatorFromSuperspace(result, rho0))
@@ -2251,12 +2202,9 @@ namespace RunSection
 
 				// Clean every variable just to be sure
 				R *= 0.0;
-				A *= 0.0;
 				H *= 0.0;
 				P *= 0.0;
 				domega *= 0.0;
-				H_SS *= 0.0;
-				K_SS *= 0.0;
 				eig_val_mat *= 0.0;
 				eigen_val *= 0.0;
 				eigen_vec *= 0.0;
@@ -2306,6 +2254,36 @@ namespace RunSection
 	{
 		this->Properties()->Get("transitionyields", this->productYieldsOnly);
 
+		// Matrix-free mode, where the Redfield tensor is never stored
+		this->Properties()->Get("matrixfree", this->matrixFree);
+
+		if (this->matrixFree)
+		{
+			int secular = 0;
+			if (this->Properties()->Get("secular", secular) && secular == 1)
+			{
+				this->Log() << "Warning: The secular approximation cannot be used in matrix-free mode. Constructing the full Redfield tensor instead." << std::endl;
+				this->matrixFree = false;
+			}
+		}
+
+		// Get the iterative solver used in matrix-free mode
+		std::string str;
+		if (this->Properties()->Get("solver", str))
+		{
+			if (str.compare("gmres") == 0 || str.compare("bicgstab") == 0)
+				this->solver = str;
+			else
+				this->Log() << "Warning: Unknown solver \"" << str << "\" specified. Using GMRES." << std::endl;
+		}
+
+		this->Properties()->Get("solvertolerance", this->solverTolerance);
+		this->Properties()->Get("solverrestart", this->solverRestart);
+		this->Properties()->Get("solvermaxiterations", this->solverMaxIterations);
+
+		if (this->solverRestart < 1)
+			this->solverRestart = 50;
+
 		return true;
 	}
 
@@ -2335,6 +2313,136 @@ namespace RunSection
 		return true;
 	}
 
+	// Adds the contribution from a pair of operators to the Redfield tensor
+	// In matrix-free mode, the term is instead stored in operator form, using only N^2 memory per term
+	bool TaskStaticSSRedfield::AddRedfieldTerm(const arma::cx_mat &_op1, const arma::cx_mat &_op2, const arma::cx_mat &_specdens, arma::cx_mat &_tmp, arma::cx_mat &_redfieldtensor)
+	{
+		if (this->matrixFree)
+		{
+			RedfieldTerm term;
+			term.op1 = _op1;
+			term.B = (_op2).t() % (_specdens).st();
+
+#pragma omp critical(redfieldterms)
+			this->redfieldTerms.push_back(term);
+
+			return true;
+		}
+
+		_tmp.zeros();
+		if (!this->Redfieldtensor(_op1, _op2, _specdens, _tmp))
+			return false;
+
+		_redfieldtensor += _tmp;
+		return true;
+	}
+
+	// Solves (-i[H0,.] - {K,.} + R + O) rho = -rho0 for the steady state, where the Liouvillian is only applied to vectors
+	// All operators are given in the eigenbasis of H0, and R is described by the terms in redfieldTerms
+	bool TaskStaticSSRedfield::SolveMatrixFree(SpinAPI::SpinSpace &_space, const SpinAPI::system_ptr &_system, const arma::cx_mat &_eig_val_mat, const arma::cx_mat &_eigen_vec, const arma::cx_mat &_rho0, arma::cx_vec &_result)
+	{
+		const unsigned int dim = _rho0.n_rows;
+
+		// Get the reaction operators and rotate them into the eigenbasis of H0
+		arma::cx_mat K;
+		if (!_space.TotalReactionOperator(K))
+		{
+			this->Log() << "Warning: Failed to obtain matrix representation of the reaction operators!" << std::endl;
+			K.zeros(dim, dim);
+		}
+		K = _eigen_vec.t() * K * _eigen_vec;
+
+		// Collect all terms acting from only one side, i.e. left * rho + rho * right
+		arma::cx_mat left = arma::cx_double(0.0, -1.0) * _eig_val_mat - K;
+		arma::cx_mat right = arma::cx_double(0.0, 1.0) * _eig_val_mat - K;
+		std::vector<std::pair<arma::cx_mat, arma::cx_mat>> products; // Terms of the form first * rho * second
+		products.reserve(2 * this->redfieldTerms.size());
+
+		for (auto t = this->redfieldTerms.cbegin(); t != this->redfieldTerms.cend(); t++)
+		{
+			arma::cx_mat C = t->op1 * t->B;
+			left -= C;
+			right -= C.t();
+			products.push_back(std::pair<arma::cx_mat, arma::cx_mat>(t->op1.t(), t->B.t()));
+			products.push_back(std::pair<arma::cx_mat, arma::cx_mat>(t->B, t->op1));
+		}
+
+		// Other relaxation operators are only available as superoperators, which are kept sparse
+		arma::sp_cx_mat O(dim * dim, dim * dim);
+		_space.UseSuperoperatorSpace(true);
+		for (auto t = _system->operators_cbegin(); t != _system->operators_cend(); t++)
+		{
+			arma::sp_cx_mat O_SS;
+			if (_space.RelaxationOperatorFrameChange((*t), _eigen_vec, O_SS))
+			{
+				O += O_SS;
+				this->Log() << "Added other relaxation operator \"" << (*t)->Name() << "\" to the Liouvillian.\n";
+			}
+			else
+			{
+				this->Log() << "There is a problem with operator \"" << (*t)->Name() << ". Please check.\n";
+			}
+		}
+		_space.UseSuperoperatorSpace(false);
+		bool hasOtherOperators = (O.n_nonzero > 0);
+
+		// Application of the Liouvillian to a superspace vector
+		auto liouvillian = [&](const arma::cx_vec &_v) -> arma::cx_vec {
+			arma::cx_mat rho;
+			_space.OperatorFromSuperspace(_v, rho);
+
+			arma::cx_mat out = left * rho + rho * right;
+			for (auto p = products.cbegin(); p != products.cend(); p++)
+				out += p->first * rho * p->second;
+
+			arma::cx_vec outvec;
+			_space.OperatorToSuperspace(out, outvec);
+			if (hasOtherOperators)
+				outvec += O * _v;
+
+			return outvec;
+		};
+
+		// The diagonal of the Liouvillian in operator form, element (a,b) is the coefficient of rho(a,b) in the output element (a,b)
+		arma::cx_mat diagonal = arma::diagvec(left) * arma::ones<arma::cx_rowvec>(dim) + arma::ones<arma::cx_vec>(dim) * arma::diagvec(right).st();
+		for (auto p = products.cbegin(); p != products.cend(); p++)
+			diagonal += arma::diagvec(p->first) * arma::diagvec(p->second).st();
+
+		arma::cx_vec preconditioner;
+		_space.OperatorToSuperspace(diagonal, preconditioner);
+		if (hasOtherOperators)
+			preconditioner += arma::cx_vec(arma::diagvec(O));
+
+		for (unsigned int k = 0; k < preconditioner.n_elem; k++)
+			preconditioner(k) = (std::abs(preconditioner(k)) > 0.0) ? 1.0 / preconditioner(k) : arma::cx_double(1.0, 0.0);
+
+		// The right-hand side is the initial state, as A*x = rho0 with A = -i[H0,.] - K + R, same as in the dense version
+		arma::cx_vec rho0vec;
+		if (!_space.OperatorToSuperspace(_rho0, rho0vec))
+		{
+			this->Log() << "Failed to convert initial state density operator to superspace." << std::endl;
+			return false;
+		}
+
+		unsigned int iterations = 0;
+		double residual = 0.0;
+		bool converged;
+
+		if (this->solver.compare("bicgstab") == 0)
+			converged = _space.SolveBiCGSTAB(liouvillian, preconditioner, rho0vec, _result, this->solverTolerance, this->solverMaxIterations, iterations, residual);
+		else
+			converged = _space.SolveGMRES(liouvillian, preconditioner, rho0vec, _result, this->solverTolerance, this->solverRestart, this->solverMaxIterations, iterations, residual);
+
+		this->Log() << "Iterative solver \"" << this->solver << "\" finished after " << iterations << " iterations with relative residual " << residual << "." << std::endl;
+		if (!converged)
+		{
+			this->Log() << "ERROR: The iterative solver did not reach the requested tolerance of " << this->solverTolerance << "! Increase solvermaxiterations or solverrestart, or use another solver." << std::endl;
+			return false;
+		}
+
+		return (_result.n_elem == rho0vec.n_elem);
+	}
+
 	bool TaskStaticSSRedfield::ConstructSpecDensGeneral(const int &_spectral_function, const std::vector<double> &_ampl_list, const std::vector<double> &_tau_c_list, const arma::cx_mat &_domega, arma::cx_mat &_specdens)
 	{
 		if (_spectral_function == 1)
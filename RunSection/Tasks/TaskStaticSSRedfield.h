@@ -10,6 +10,7 @@
 
 #include "BasicTask.h"
 #include "SpinAPIDefines.h"
+#include "SpinSpace.h"
 
 namespace RunSection
 {
@@ -20,10 +21,27 @@ namespace RunSection
 		bool productYieldsOnly; // If true, a quantum yield will be calculated from each Transition object and multiplied by the rate constant
 								// If false, a quantum yield will be calculated each defined State object
 
+		// Matrix-free mode: The Redfield tensor is stored in operator form and the steady state is found with an iterative solver
+		// A term is R(rho) = op1^dagger * rho * B^dagger + B * rho * op1 - C * rho - rho * C^dagger, where B = op2^dagger % S^T and C = op1 * B
+		struct RedfieldTerm
+		{
+			arma::cx_mat op1;
+			arma::cx_mat B;
+		};
+
+		bool matrixFree;
+		std::vector<RedfieldTerm> redfieldTerms;
+		std::string solver; // "gmres" or "bicgstab"
+		double solverTolerance;
+		unsigned int solverRestart;
+		unsigned int solverMaxIterations;
+
 		void WriteHeader(std::ostream &);																																								   // Write header for the output file
 		bool Redfieldtensor(const arma::cx_mat &_op1, const arma::cx_mat &_op2, const arma::cx_mat &_specdens, arma::cx_mat &_redfieldtensor);															   // Contruction of Redfieldtensor with operator basis
 		bool ConstructSpecDensGeneral(const int &_spectral_function, const std::vector<double> &_ampl_list, const std::vector<double> &_tau_c_list, const arma::cx_mat &_domega, arma::cx_mat &_specdens); // Construction of Spectral Density
 		bool ConstructSpecDensSpecific(const int &_spectral_function, const std::complex<double> &_ampl, const std::complex<double> &_tau_c, const arma::cx_mat &_domega, arma::cx_mat &_specdens);
+		bool AddRedfieldTerm(const arma::cx_mat &_op1, const arma::cx_mat &_op2, const arma::cx_mat &_specdens, arma::cx_mat &_tmp, arma::cx_mat &_redfieldtensor);																	   // Adds a term to the Redfield tensor (or stores it in operator form in matrix-free mode)
+		bool SolveMatrixFree(SpinAPI::SpinSpace &, const SpinAPI::system_ptr &, const arma::cx_mat &, const arma::cx_mat &, const arma::cx_mat &, arma::cx_vec &);												   // Solves for the steady state without constructing superoperators
 		bool Slippage(arma::cx_mat **_ptr_Tensors, const int &_num_op, const arma::cx_mat &_eig_val_mat, const arma::cx_mat &_domega, const arma::cx_mat &_rho0, const std::complex<double> &_tau_c, arma::cx_mat &_rho0_new);
 
 	protected:
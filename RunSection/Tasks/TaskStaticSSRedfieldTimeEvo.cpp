@@ -9,6 +9,8 @@
 #include <omp.h>
 #include <memory>
 #include "TaskStaticSSRedfieldTimeEvo.h"
+#include "KrylovPropagator.h"
+#include "ObservableSet.h"
 #include "Transition.h"
 #include "Operator.h"
 #include "Settings.h"
@@ -55,9 +57,9 @@ namespace RunSection
 		// Obtain spin systems
 		auto systems = this->SpinSystems();
 		std::pair<arma::cx_mat, arma::cx_vec> P[systems.size()]; // Create array containing a propagator and the current state of each system
-		SpinAPI::SpinSpace spaces[systems.size()];				 // Keep a SpinSpace object for each spin system
-
-		arma::cx_mat *ptr_eigen_vec[systems.size()];
+		std::vector<std::shared_ptr<SpinAPI::KrylovPropagator>> krylov(systems.size()); // Used instead of the propagator in "P" with the krylov propagation method
+		std::vector<bool> failed(systems.size(), false); // Spin systems where a krylov step failed
+		std::vector<SpinAPI::ObservableSet> observables(systems.size());				 // Projection operators onto the states of each system in the eigenbasis of H0
 
 		// Loop through all SpinSystems
 		int ic = 0; // System counter
@@ -75,7 +77,6 @@ namespace RunSection
 			SpinAPI::SpinSpace space(*(*i));
 			space.UseSuperoperatorSpace(false);
 			space.SetReactionOperatorType(this->reactionOperators);
-			spaces[ic] = space;
 
 			// Get the initial state
 			for (auto j = initial_states.cbegin(); j < initial_states.cend(); j++)
@@ -91,6 +92,7 @@ namespace RunSection
 				else
 					rho0 += tmp_rho0;
 			}
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
 			// ----------------------------------------------------------------
@@ -113,8 +115,15 @@ namespace RunSection
 			arma::eig_sym(eigen_val, eigen_vec, H);
 			this->Log() << "Diagonalization done! Eigenvalues: " << eigen_val.n_elem << ", eigenvectors: " << eigen_vec.n_cols << std::endl;
 
-			// Put eigenbasis on pointer to sue for PState (projection operator) in final calculation
-			ptr_eigen_vec[ic] = {&eigen_vec};
+			// Transform the projection operators onto the states into the eigenbasis of H0 once, as each step then only needs a single matrix-vector product
+			observables[ic] = SpinAPI::ObservableSet(space.HilbertSpaceDimensions(), true);
+			auto states = (*i)->States();
+			for (auto j = states.cbegin(); j < states.cend(); j++)
+			{
+				arma::cx_mat PState;
+				if (!space.GetState((*j), PState) || !observables[ic].Add(arma::cx_mat(eigen_vec.t() * PState * eigen_vec)))
+					this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+			}
 
 			// ----------------------------------------------------------------
 			// CONSTRUCTING TRANSITION MATRIX "domega" OUT OF EIGENVALUES OF H0
@@ -299,17 +308,17 @@ namespace RunSection
 
 										this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 										{
 											return false;
 										}
@@ -675,32 +684,32 @@ namespace RunSection
 
 											this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 											{
 												return false;
 											}
 
-											if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+											if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 											{
 												return false;
 											}
@@ -1087,17 +1096,17 @@ namespace RunSection
 
 									this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-									if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+									if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 									{
 										return false;
 									}
 
-									if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+									if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 									{
 										return false;
 									}
 
-									if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+									if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 									{
 										return false;
 									}
@@ -1551,32 +1560,32 @@ namespace RunSection
 
 										this->Log() << "Sx, Sy and Sz operator basis was chosen - ops == 1" << std::endl;
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sz()), *s1, *Sz1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s1, *Sz1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sx()), *s1, *Sx1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s1, *Sx1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s1)->Sy()), *s1, *Sy1))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s1, *Sy1))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sz()), *s2, *Sz2))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sz, *s2, *Sz2))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sx()), *s2, *Sx2))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, *s2, *Sx2))
 										{
 											return false;
 										}
 
-										if (!space.CreateOperator(arma::conv_to<arma::cx_mat>::from((*s2)->Sy()), *s2, *Sy2))
+										if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sy, *s2, *Sy2))
 										{
 											return false;
 										}
@@ -2118,8 +2127,17 @@ namespace RunSection
 			// ---------------------------------------------------------------
 			// DO PROPAGATION OF DENSITY OPERATOR
 			// ---------------------------------------------------------------
-			// Get the propagator and put it into the array together with the initial state
-			P[ic] = std::pair<arma::cx_mat, arma::cx_vec>(arma::expmat(A * this->timestep), rho0vec); //* this->timestep)
+			// Get the propagator and put it into the array together with the initial state, the krylov propagator only needs the sparse Liouvillian
+			if (this->propagation.method == "krylov")
+			{
+				krylov[ic] = std::make_shared<SpinAPI::KrylovPropagator>(arma::sp_cx_mat(A), arma::cx_double(1.0, 0.0), false, this->propagation.krylovSize, this->propagation.krylovMaxSize, this->propagation.krylovTolerance);
+				krylov[ic]->SetState(rho0vec);
+				P[ic] = std::pair<arma::cx_mat, arma::cx_vec>(arma::cx_mat(), rho0vec);
+			}
+			else
+			{
+				P[ic] = std::pair<arma::cx_mat, arma::cx_vec>(arma::expmat(A * this->timestep), rho0vec);
+			}
 			++ic;
 		}
 
@@ -2129,23 +2147,12 @@ namespace RunSection
 			this->Data() << this->RunSettings()->CurrentStep() << " 0 "; // "0" refers to the time
 			this->WriteStandardOutput(this->Data());
 			ic = 0;
+			arma::cx_vec expectations;
 			for (auto i = systems.cbegin(); i < systems.cend(); i++)
 			{
-				arma::cx_mat PState;
-				auto states = (*i)->States();
-
-				for (auto j = states.cbegin(); j < states.cend(); j++)
-				{
-					if (!spaces[ic].GetState((*j), PState))
-					{
-						this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
-						continue;
-					}
-
-					// Transform into eigenbasis of H0
-					PState = ((*ptr_eigen_vec[ic]).t() * PState * (*ptr_eigen_vec[ic]));
-					this->Data() << std::abs(arma::trace(PState * rho0)) << " ";
-				}
+				if (observables[ic].Evaluate(P[ic].second, expectations))
+					for (unsigned int k = 0; k < expectations.n_elem; k++)
+						this->Data() << std::abs(expectations(k)) << " ";
 
 				++ic;
 			}
@@ -2165,32 +2172,36 @@ namespace RunSection
 				ic = 0;
 				for (auto i = systems.cbegin(); i < systems.cend(); i++)
 				{
-					// Take a step "first" is propagator and "second" is current state
-					rho0vec = P[ic].first * P[ic].second;
-					P[ic].second = rho0vec;
-
-					// Convert the resulting density operator back to its Hilbert space representation
-					if (!spaces[ic].OperatorFromSuperspace(rho0vec, rho0))
+					// A spin system that failed to propagate is not written anymore
+					if (failed[ic])
 					{
-						this->Log() << "Failed to convert resulting superspace-vector back to native Hilbert space." << std::endl;
+						++ic;
 						continue;
 					}
 
-					// Obtain the results
-					arma::cx_mat PState;
-					auto states = (*i)->States();
-					for (auto j = states.cbegin(); j < states.cend(); j++)
+					// Take a step "first" is propagator and "second" is current state
+					if (krylov[ic] != nullptr)
 					{
-						if (!spaces[ic].GetState((*j), PState))
+						// A failed step would leave a stale state, so the spin system is aborted
+						if (!krylov[ic]->Step(this->timestep))
 						{
-							this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+							this->Log() << "Failed to propagate SpinSystem \"" << (*i)->Name() << "\" at time " << (static_cast<double>(n) * this->timestep) << " ns, no acceptable Krylov step was found. Consider increasing krylovmaxsize or krylovtol. No further results are written for this SpinSystem." << std::endl;
+							failed[ic] = true;
+							++ic;
 							continue;
 						}
-
-						// Transform into eigenbasis of H0
-						PState = ((*ptr_eigen_vec[ic]).t() * PState * (*ptr_eigen_vec[ic]));
-						this->Data() << std::abs(arma::trace(PState * rho0)) << " ";
+						rho0vec = krylov[ic]->State();
+					}
+					else
+					{
+						rho0vec = P[ic].first * P[ic].second;
 					}
+					P[ic].second = rho0vec;
+
+					// Obtain the results directly from the superspace vector in the eigenbasis
+					if (observables[ic].Evaluate(rho0vec, expectations))
+						for (unsigned int k = 0; k < expectations.n_elem; k++)
+							this->Data() << std::abs(expectations(k)) << " ";
 
 					++ic;
 				}
@@ -2259,6 +2270,9 @@ namespace RunSection
 			}
 		}
 
+		// Get the propagation method, the krylov method applies the exponential of the sparse Liouvillian without forming the propagator
+		this->propagation.ReadSuperspace(*this->Properties(), this->Log());
+
 		return true;
 	}
 
@@ -9,6 +9,7 @@
 #define MOD_RunSection_TaskStaticSSRedfieldTimeEvo
 
 #include "BasicTask.h"
+#include "PropagationSettings.h"
 #include "SpinAPIDefines.h"
 
 namespace RunSection
@@ -19,6 +20,7 @@ namespace RunSection
 		double timestep;
 		double totaltime;
 		SpinAPI::ReactionOperatorType reactionOperators;
+		PropagationSettings propagation; // "expm" for the dense propagator, or "krylov" for the action of the exponential on the sparse Liouvillian
 
 		void WriteHeader(std::ostream &);																											  // Write header for the output file
 		bool RedfieldtensorTimeEvo(const arma::cx_mat &_op1, const arma::cx_mat &_op2, const arma::cx_mat &_specdens, arma::cx_mat &_redfieldtensor); // Contruction of Redfieldtensor with operator basis
@@ -12,13 +12,14 @@
 #include "SpinSystem.h"
 #include "Spin.h"
 #include "ObjectParser.h"
+#include "ObservableSet.h"
 
 namespace RunSection
 {
 	// -----------------------------------------------------
 	// TaskStaticSSRelaxation Constructors and Destructor
 	// -----------------------------------------------------
-	TaskStaticSSRelaxation::TaskStaticSSRelaxation(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), relaxationRate(0.0), relaxingSpins(), productYieldsOnly(false)
+	TaskStaticSSRelaxation::TaskStaticSSRelaxation(const MSDParser::ObjectParser &_parser, const RunSection &_runsection) : BasicTask(_parser, _runsection), relaxationRate(0.0), relaxingSpins(), productYieldsOnly(false), initialStateYields(false)
 	{
 	}
 
@@ -54,10 +55,10 @@ namespace RunSection
 
 			// Obtain a SpinSpace to describe the system
 			SpinAPI::SpinSpace space(*(*i));
-			arma::cx_mat rho0;
 			space.UseSuperoperatorSpace(true);
 
-			// Get the initial state
+			// Get the initial state, or one density operator per initial state if their yields are requested separately
+			std::vector<arma::cx_mat> rho0s;
 			for (auto j = initial_states.cbegin(); j != initial_states.cend(); j++)
 			{
 				arma::cx_mat tmp_rho0;
@@ -66,16 +67,25 @@ namespace RunSection
 					this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\", initial state of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
 					continue;
 				}
-				if (j == initial_states.cbegin())
-					rho0 = tmp_rho0;
+				if (this->initialStateYields || rho0s.empty())
+					rho0s.push_back(tmp_rho0);
 				else
-					rho0 += tmp_rho0;
+					rho0s.back() += tmp_rho0;
 			}
-			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
-			// Convert initial state to superoperator space
+			// Convert initial states to superoperator space
+			arma::cx_mat B(space.SpaceDimensions(), rho0s.size());
 			arma::cx_vec rho0vec;
-			if (!space.OperatorToSuperspace(rho0, rho0vec))
+			bool converted = true;
+			for (unsigned int c = 0; c < rho0s.size() && converted; c++)
+			{
+				space.WeightEquivalentSpins(rho0s[c]);
+				rho0s[c] /= arma::trace(rho0s[c]); // The density operator should have a trace of 1
+				converted = space.OperatorToSuperspace(rho0s[c], rho0vec);
+				if (converted)
+					B.col(c) = rho0vec;
+			}
+			if (!converted)
 			{
 				this->Log() << "Failed to convert initial state density operator to superspace." << std::endl;
 				continue;
@@ -114,7 +124,7 @@ namespace RunSection
 				arma::sp_cx_mat Sx;
 				arma::sp_cx_mat Sy;
 				arma::sp_cx_mat Sz;
-				if (!space.CreateOperator(spin->Sx(), spin, Sx) || !space.CreateOperator(spin->Sy(), spin, Sy) || !space.CreateOperator(spin->Sz(), spin, Sz))
+				if (!space.CreateOperator(SpinAPI::SpinOperatorType::Sx, spin, Sx) || !space.CreateOperator(SpinAPI::SpinOperatorType::Sy, spin, Sy) || !space.CreateOperator(SpinAPI::SpinOperatorType::Sz, spin, Sz))
 				{
 					this->Log() << "Failed to obtain spin operators for spin \"" << (*j) << "\"." << std::endl;
 					continue;
@@ -141,27 +151,12 @@ namespace RunSection
 			}
 			// ----------------------------------------------------------------
 
-			// Perform the calculation
-			this->Log() << "Ready to perform calculation." << std::endl;
-			arma::cx_vec result = solve(arma::conv_to<arma::cx_mat>::from(A), rho0vec);
-			this->Log() << "Done with calculation." << std::endl;
-
-			// Convert the resulting density operator back to its Hilbert space representation
-			if (!space.OperatorFromSuperspace(result, rho0))
-			{
-				this->Log() << "Failed to convert resulting superspace-vector back to native Hilbert space." << std::endl;
-				continue;
-			}
-
-			// Obtain the results
-			arma::cx_mat P;
-			this->Data() << this->RunSettings()->CurrentStep() << " ";
-			this->WriteStandardOutput(this->Data());
-
-			// There are two result modes - either write results per transition or for each defined state
+			// Collect the projection operators onto the states (or onto the source states of the transitions) that define the yields
+			SpinAPI::ObservableSet observables(space.HilbertSpaceDimensions(), true);
+			std::vector<double> rates;
+			arma::sp_cx_mat P;
 			if (this->productYieldsOnly)
 			{
-				// Loop through all defind transitions
 				auto transitions = (*i)->Transitions();
 				for (auto j = transitions.cbegin(); j != transitions.cend(); j++)
 				{
@@ -174,14 +169,12 @@ namespace RunSection
 						this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
 						continue;
 					}
-
-					// Return the yield for this transition
-					this->Data() << (*j)->Rate() * std::abs(arma::trace(P * rho0)) << " ";
+					observables.Add(P);
+					rates.push_back((*j)->Rate());
 				}
 			}
 			else
 			{
-				// Loop through all states
 				auto states = (*i)->States();
 				for (auto j = states.cbegin(); j != states.cend(); j++)
 				{
@@ -190,12 +183,28 @@ namespace RunSection
 						this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
 						continue;
 					}
-
-					// Return the yield for this state - note that no reaction rates are included here.
-					this->Data() << std::abs(arma::trace(P * rho0)) << " ";
+					observables.Add(P); // Note that no reaction rates are included here
+					rates.push_back(1.0);
 				}
 			}
 
+			// Perform the calculation, with a single factorization for all initial states and observables
+			this->Log() << "Ready to perform calculation." << std::endl;
+			arma::cx_mat yields;
+			if (!space.SolveYields(A, B, observables, yields))
+			{
+				this->Log() << "Failed to solve the Liouville-space equation for SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+				continue;
+			}
+			this->Log() << "Done with calculation." << std::endl;
+
+			// Write the results, one set of yields per initial state
+			this->Data() << this->RunSettings()->CurrentStep() << " ";
+			this->WriteStandardOutput(this->Data());
+			for (unsigned int c = 0; c < yields.n_cols; c++)
+				for (unsigned int k = 0; k < yields.n_rows; k++)
+					this->Data() << rates[k] * std::abs(yields(k, c)) << " ";
+
 			this->Log() << "\nDone with SpinSystem \"" << (*i)->Name() << "\"" << std::endl;
 		}
 
@@ -215,20 +224,36 @@ namespace RunSection
 		auto systems = this->SpinSystems();
 		for (auto i = systems.cbegin(); i != systems.cend(); i++)
 		{
-			// Should yields be written per transition or per defined state?
-			if (this->productYieldsOnly)
+			// With separate initial states, the yields of each initial state are prefixed by its name
+			std::vector<std::string> prefixes;
+			if (this->initialStateYields)
 			{
-				// Write each transition name
-				auto transitions = (*i)->Transitions();
-				for (auto j = transitions.cbegin(); j != transitions.cend(); j++)
-					_stream << (*i)->Name() << "." << (*j)->Name() << ".yield ";
+				auto initial_states = (*i)->InitialState();
+				for (auto j = initial_states.cbegin(); j != initial_states.cend(); j++)
+					prefixes.push_back((*i)->Name() + "." + (*j)->Name() + ".");
 			}
 			else
 			{
-				// Write each state name
-				auto states = (*i)->States();
-				for (auto j = states.cbegin(); j != states.cend(); j++)
-					_stream << (*i)->Name() << "." << (*j)->Name() << " ";
+				prefixes.push_back((*i)->Name() + ".");
+			}
+
+			for (auto p = prefixes.cbegin(); p != prefixes.cend(); p++)
+			{
+				// Should yields be written per transition or per defined state?
+				if (this->productYieldsOnly)
+				{
+					// Write each transition name
+					auto transitions = (*i)->Transitions();
+					for (auto j = transitions.cbegin(); j != transitions.cend(); j++)
+						_stream << (*p) << (*j)->Name() << ".yield ";
+				}
+				else
+				{
+					// Write each state name
+					auto states = (*i)->States();
+					for (auto j = states.cbegin(); j != states.cend(); j++)
+						_stream << (*p) << (*j)->Name() << " ";
+				}
 			}
 		}
 		_stream << std::endl;
@@ -243,6 +268,9 @@ namespace RunSection
 
 		this->Properties()->GetList("relaxingspins", this->relaxingSpins);
 
+		// Solve for each initial state separately rather than for their sum, sharing the factorization of the Liouvillian
+		this->Properties()->Get("initialstateyields", this->initialStateYields);
+
 		return true;
 	}
 	// -----------------------------------------------------
@@ -21,6 +21,7 @@ namespace RunSection
 		std::vector<std::string> relaxingSpins;
 		bool productYieldsOnly; // If true, a quantum yield will be calculated from each Transition object and multiplied by the rate constant
 								// If false, a quantum yield will be calculated each defined State object
+		bool initialStateYields; // If true, the yields are calculated for each initial state separately instead of for the sum of the initial states
 
 		void WriteHeader(std::ostream &); // Write header for the output file
 
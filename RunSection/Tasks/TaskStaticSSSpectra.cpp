@@ -6,7 +6,10 @@
 // See LICENSE.txt for license information.
 //////////////////////////////////////////////////////////////////////////////
 #include <iostream>
+#include <memory>
 #include "TaskStaticSSSpectra.h"
+#include "KrylovPropagator.h"
+#include "ObservableSet.h"
 #include "Transition.h"
 #include "Operator.h"
 #include "Settings.h"
@@ -48,7 +51,9 @@ namespace RunSection
 		// Obtain spin systems
 		auto systems = this->SpinSystems();
 		std::pair<arma::cx_mat, arma::cx_vec> P[systems.size()]; // Create array containing a propagator and the current state of each system
-		SpinAPI::SpinSpace spaces[systems.size()];				 // Keep a SpinSpace object for each spin system
+		std::vector<std::shared_ptr<SpinAPI::KrylovPropagator>> krylov(systems.size()); // Used instead of the propagator in "P" with the krylov propagation method
+		std::vector<bool> failed(systems.size(), false); // Spin systems where a krylov step failed
+		std::vector<SpinAPI::ObservableSet> observables(systems.size());				 // Projection operators onto the states of each system, evaluated at every step
 
 		// Loop through all SpinSystems
 		int ic = 0; // System counter
@@ -66,7 +71,16 @@ namespace RunSection
 			SpinAPI::SpinSpace space(*(*i));
 			space.UseSuperoperatorSpace(true);
 			space.SetReactionOperatorType(this->reactionOperators);
-			spaces[ic] = space;
+
+			// Collect the projection operators onto the states once, as each step then only needs a single matrix-vector product
+			observables[ic] = SpinAPI::ObservableSet(space.HilbertSpaceDimensions(), true);
+			auto states = (*i)->States();
+			for (auto j = states.cbegin(); j != states.cend(); j++)
+			{
+				arma::sp_cx_mat PState;
+				if (!space.GetState((*j), PState) || !observables[ic].Add(PState))
+					this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+			}
 
 			// Get the initial state
 			for (auto j = initial_states.cbegin(); j != initial_states.cend(); j++)
@@ -82,6 +96,7 @@ namespace RunSection
 				else
 					rho0 += tmp_rho0;
 			}
+			space.WeightEquivalentSpins(rho0);
 			rho0 /= arma::trace(rho0); // The density operator should have a trace of 1
 
 			// Convert initial state to superoperator space
@@ -92,7 +107,7 @@ namespace RunSection
 			}
 
 			// Get the Hamiltonian
-			arma::cx_mat H;
+			arma::sp_cx_mat H;
 			if (!space.Hamiltonian(H))
 			{
 				this->Log() << "Failed to obtain Hamiltonian in superspace." << std::endl;
@@ -100,10 +115,10 @@ namespace RunSection
 			}
 
 			// Get a matrix to collect all the terms (the total Liouvillian)
-			arma::cx_mat A = arma::cx_double(0.0, -1.0) * H;
+			arma::sp_cx_mat A = arma::cx_double(0.0, -1.0) * H;
 
 			// Get the reaction operators, and add them to "A"
-			arma::cx_mat K;
+			arma::sp_cx_mat K;
 			if (!space.TotalReactionOperator(K))
 			{
 				this->Log() << "Warning: Failed to obtain matrix representation of the reaction operators!" << std::endl;
@@ -121,8 +136,17 @@ namespace RunSection
 				}
 			}
 
-			// Get the propagator and put it into the array together with the initial state
-			P[ic] = std::pair<arma::cx_mat, arma::cx_vec>(arma::expmat(A * this->timestep), rho0vec);
+			// Get the propagator and put it into the array together with the initial state, the krylov propagator only needs the sparse Liouvillian
+			if (this->propagation.method == "krylov")
+			{
+				krylov[ic] = std::make_shared<SpinAPI::KrylovPropagator>(A, arma::cx_double(1.0, 0.0), false, this->propagation.krylovSize, this->propagation.krylovMaxSize, this->propagation.krylovTolerance);
+				krylov[ic]->SetState(rho0vec);
+				P[ic] = std::pair<arma::cx_mat, arma::cx_vec>(arma::cx_mat(), rho0vec);
+			}
+			else
+			{
+				P[ic] = std::pair<arma::cx_mat, arma::cx_vec>(arma::expmat(arma::cx_mat(A) * this->timestep), rho0vec);
+			}
 			++ic;
 		}
 
@@ -130,20 +154,12 @@ namespace RunSection
 		this->Data() << this->RunSettings()->CurrentStep() << " 0 "; // "0" refers to the time
 		this->WriteStandardOutput(this->Data());
 		ic = 0;
+		arma::cx_vec expectations;
 		for (auto i = systems.cbegin(); i != systems.cend(); i++)
 		{
-			arma::cx_mat PState;
-			auto states = (*i)->States();
-			for (auto j = states.cbegin(); j != states.cend(); j++)
-			{
-				if (!spaces[ic].GetState((*j), PState))
-				{
-					this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
-					continue;
-				}
-
-				this->Data() << std::abs(arma::trace(PState * rho0)) << " ";
-			}
+			if (observables[ic].Evaluate(P[ic].second, expectations))
+				for (unsigned int k = 0; k < expectations.n_elem; k++)
+					this->Data() << std::abs(expectations(k)) << " ";
 
 			++ic;
 		}
@@ -163,30 +179,36 @@ namespace RunSection
 			ic = 0;
 			for (auto i = systems.cbegin(); i != systems.cend(); i++)
 			{
-				// Take a step "first" is propagator and "second" is current state
-				rho0vec = P[ic].first * P[ic].second;
-				P[ic].second = rho0vec;
-
-				// Convert the resulting density operator back to its Hilbert space representation
-				if (!spaces[ic].OperatorFromSuperspace(rho0vec, rho0))
+				// A spin system that failed to propagate is not written anymore
+				if (failed[ic])
 				{
-					this->Log() << "Failed to convert resulting superspace-vector back to native Hilbert space." << std::endl;
+					++ic;
 					continue;
 				}
 
-				// Obtain the results
-				arma::cx_mat PState;
-				auto states = (*i)->States();
-				for (auto j = states.cbegin(); j != states.cend(); j++)
+				// Take a step "first" is propagator and "second" is current state
+				if (krylov[ic] != nullptr)
 				{
-					if (!spaces[ic].GetState((*j), PState))
+					// A failed step would leave a stale state, so the spin system is aborted
+					if (!krylov[ic]->Step(this->timestep))
 					{
-						this->Log() << "Failed to obtain projection matrix onto state \"" << (*j)->Name() << "\" of SpinSystem \"" << (*i)->Name() << "\"." << std::endl;
+						this->Log() << "Failed to propagate SpinSystem \"" << (*i)->Name() << "\" at time " << (static_cast<double>(n) * this->timestep) << " ns, no acceptable Krylov step was found. Consider increasing krylovmaxsize or krylovtol. No further results are written for this SpinSystem." << std::endl;
+						failed[ic] = true;
+						++ic;
 						continue;
 					}
-
-					this->Data() << std::abs(arma::trace(PState * rho0)) << " ";
+					rho0vec = krylov[ic]->State();
+				}
+				else
+				{
+					rho0vec = P[ic].first * P[ic].second;
 				}
+				P[ic].second = rho0vec;
+
+				// Obtain the results directly from the superspace vector
+				if (observables[ic].Evaluate(rho0vec, expectations))
+					for (unsigned int k = 0; k < expectations.n_elem; k++)
+						this->Data() << std::abs(expectations(k)) << " ";
 
 				++ic;
 			}
@@ -273,6 +295,9 @@ namespace RunSection
 			}
 		}
 
+		// Get the propagation method, the krylov method applies the exponential of the sparse Liouvillian without forming the propagator
+		this->propagation.ReadSuperspace(*this->Properties(), this->Log());
+
 		return true;
 	}
 	// -----------------------------------------------------
@@ -9,6 +9,7 @@
 #define MOD_RunSection_TaskStaticSSSpectra
 
 #include "BasicTask.h"
+#include "PropagationSettings.h"
 #include "SpinAPIDefines.h"
 
 namespace RunSection
@@ -19,6 +20,7 @@ namespace RunSection
 		double timestep;
 		double totaltime;
 		SpinAPI::ReactionOperatorType reactionOperators;
+		PropagationSettings propagation; // "expm" for the dense propagator, or "krylov" for the action of the exponential on the sparse Liouvillian
 
 		void WriteHeader(std::ostream &); // Write header for the output file
 
@@ -10,6 +10,7 @@
 #define MOD_RunSection_TaskStaticSSTimeEvo
 
 #include "BasicTask.h"
+#include "PropagationSettings.h"
 #include "SpinAPIDefines.h"
 
 namespace RunSection
@@ -20,6 +21,7 @@ namespace RunSection
 		double timestep;
 		double totaltime;
 		SpinAPI::ReactionOperatorType reactionOperators;
+		PropagationSettings propagation; // "expm" for the dense propagator, or "krylov" for the action of the exponential on the sparse Liouvillian
 
 		void WriteHeader(std::ostream &); // Write header for the output file
 
@@ -0,0 +1,113 @@
+/////////////////////////////////////////////////////////////////////////
+// AffineOperator class (SpinAPI Module)
+// ------------------
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include "AffineOperator.h"
+
+namespace SpinAPI
+{
+	// -----------------------------------------------------
+	// AffineOperator Constructors and Destructor
+	// -----------------------------------------------------
+	AffineOperator::AffineOperator() : dimension(0), operators(1), rowIndices(), columnPointers(), values()
+	{
+		this->Rebuild();
+	}
+
+	AffineOperator::AffineOperator(unsigned int _dimension) : dimension(_dimension), operators(1, arma::sp_cx_mat(_dimension, _dimension)), rowIndices(), columnPointers(), values()
+	{
+		this->Rebuild();
+	}
+
+	AffineOperator::AffineOperator(const AffineOperator &_operator) : dimension(_operator.dimension), operators(_operator.operators), rowIndices(_operator.rowIndices),
+																	  columnPointers(_operator.columnPointers), values(_operator.values)
+	{
+	}
+
+	AffineOperator::~AffineOperator()
+	{
+	}
+	// -----------------------------------------------------
+	// Operators
+	// -----------------------------------------------------
+	const AffineOperator &AffineOperator::operator=(const AffineOperator &_operator)
+	{
+		this->dimension = _operator.dimension;
+		this->operators = _operator.operators;
+		this->rowIndices = _operator.rowIndices;
+		this->columnPointers = _operator.columnPointers;
+		this->values = _operator.values;
+
+		return (*this);
+	}
+	// -----------------------------------------------------
+	// Public methods
+	// -----------------------------------------------------
+	bool AffineOperator::SetConstant(const arma::sp_cx_mat &_operator)
+	{
+		if (_operator.n_rows != this->dimension || _operator.n_cols != this->dimension)
+			return false;
+
+		this->operators[0] = _operator;
+		this->Rebuild();
+		return true;
+	}
+
+	bool AffineOperator::AddTerm(const arma::sp_cx_mat &_operator)
+	{
+		if (_operator.n_rows != this->dimension || _operator.n_cols != this->dimension)
+			return false;
+
+		this->operators.push_back(_operator);
+		this->Rebuild();
+		return true;
+	}
+
+	// The values on the merged pattern are a linear combination of the columns of the value matrix, and the
+	// batch constructor only copies the pattern, i.e. no sorting or merging of elements is needed
+	bool AffineOperator::Evaluate(const arma::cx_vec &_coefficients, arma::sp_cx_mat &_out) const
+	{
+		if (_coefficients.n_elem != this->Terms())
+			return false;
+
+		arma::cx_vec coefficients(this->operators.size());
+		coefficients(0) = 1.0;
+		if (_coefficients.n_elem > 0)
+			coefficients.tail(_coefficients.n_elem) = _coefficients;
+
+		arma::cx_vec result = this->values * coefficients;
+		_out = arma::sp_cx_mat(this->rowIndices, this->columnPointers, result, this->dimension, this->dimension);
+		return true;
+	}
+	// -----------------------------------------------------
+	// Private methods
+	// -----------------------------------------------------
+	void AffineOperator::Rebuild()
+	{
+		// The union of the patterns, no elements can cancel as all the entries are positive
+		arma::sp_mat pattern(this->dimension, this->dimension);
+		for (auto i = this->operators.cbegin(); i != this->operators.cend(); i++)
+			pattern += arma::spones(arma::abs(*i));
+		pattern.sync();
+
+		this->rowIndices = arma::uvec(pattern.row_indices, pattern.n_nonzero);
+		this->columnPointers = arma::uvec(pattern.col_ptrs, pattern.n_cols + 1);
+
+		// Find the position of each element in the merged pattern, the row indices are sorted within each column
+		this->values.zeros(pattern.n_nonzero, this->operators.size());
+		for (unsigned int k = 0; k < this->operators.size(); k++)
+		{
+			for (auto i = this->operators[k].begin(); i != this->operators[k].end(); ++i)
+			{
+				const arma::uword *first = this->rowIndices.memptr() + this->columnPointers(i.col());
+				const arma::uword *last = this->rowIndices.memptr() + this->columnPointers(i.col() + 1);
+				this->values(std::lower_bound(first, last, i.row()) - this->rowIndices.memptr(), k) = (*i);
+			}
+		}
+	}
+}
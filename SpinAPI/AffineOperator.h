@@ -0,0 +1,59 @@
+/////////////////////////////////////////////////////////////////////////
+// AffineOperator class (SpinAPI Module)
+// ------------------
+// An operator of the form A(c) = A0 + sum_k c_k * A_k, where the sparse
+// matrices A0 and A_k are fixed and only the scalar coefficients c_k
+// change, e.g. the Hamiltonian of a time-dependent field. The matrices
+// are stored on their merged sparsity pattern, such that A(c) is
+// obtained from a single dense matrix-vector product on the non-zero
+// values, without assembling and adding sparse matrices.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#ifndef MOD_SpinAPI_AffineOperator
+#define MOD_SpinAPI_AffineOperator
+
+#include <vector>
+#include <armadillo>
+
+namespace SpinAPI
+{
+	class AffineOperator
+	{
+	private:
+		// Implementation details
+		unsigned int dimension;
+		std::vector<arma::sp_cx_mat> operators; // The constant part followed by the terms
+
+		// The merged sparsity pattern in compressed sparse column format, and the values of each operator on the pattern (one column per operator)
+		arma::uvec rowIndices;
+		arma::uvec columnPointers;
+		arma::cx_mat values;
+
+		// Private methods
+		void Rebuild(); // Merges the sparsity patterns and collects the values
+
+	public:
+		// Constructors / Destructors
+		AffineOperator();						// Default constructor
+		explicit AffineOperator(unsigned int);	// Normal constructor, the constant part is zero
+		AffineOperator(const AffineOperator &); // Copy-constructor
+		~AffineOperator();						// Destructor
+
+		// Operators
+		const AffineOperator &operator=(const AffineOperator &); // Copy-assignment
+
+		// Public methods
+		bool SetConstant(const arma::sp_cx_mat &); // Sets A0
+		bool AddTerm(const arma::sp_cx_mat &);	   // Adds A_k as the next term
+		unsigned int Terms() const { return static_cast<unsigned int>(this->operators.size() - 1); }
+		unsigned int Dimension() const { return this->dimension; }
+		unsigned int NonZeros() const { return static_cast<unsigned int>(this->rowIndices.n_elem); }
+
+		bool Evaluate(const arma::cx_vec &, arma::sp_cx_mat &) const; // A(c) for the coefficients c, in the order the terms were added
+	};
+}
+
+#endif
@@ -0,0 +1,152 @@
+/////////////////////////////////////////////////////////////////////////
+// ChebyshevPropagator class (SpinAPI Module)
+// ------------------
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cmath>
+#include "ChebyshevPropagator.h"
+
+namespace SpinAPI
+{
+	// -----------------------------------------------------
+	// ChebyshevPropagator Constructors and Destructor
+	// -----------------------------------------------------
+	// The bounds must contain the whole spectrum of _H, otherwise the expansion diverges, see SpectralBounds
+	ChebyshevPropagator::ChebyshevPropagator(const arma::sp_cx_mat &_H, double _lowerBound, double _upperBound, double _tolerance)
+		: H(_H), lowerBound(std::min(_lowerBound, _upperBound)), upperBound(std::max(_lowerBound, _upperBound)), tolerance(_tolerance), timestep(0.0), coefficients(1, arma::fill::ones)
+	{
+	}
+
+	ChebyshevPropagator::~ChebyshevPropagator()
+	{
+	}
+	// -----------------------------------------------------
+	// Public methods
+	// -----------------------------------------------------
+	// exp(-i*H*dt) = exp(-i*c*dt) * [J_0(r*dt) + 2 * sum_k (-i)^k * J_k(r*dt) * T_k((H - c)/r)], where c is the centre and r the half width
+	// of the spectrum. The Bessel functions decay faster than exponentially once k exceeds r*dt, which sets the order of the expansion.
+	bool ChebyshevPropagator::SetTimestep(double _timestep)
+	{
+		if (!std::isfinite(_timestep))
+			return false;
+
+		double centre = 0.5 * (this->upperBound + this->lowerBound);
+		double halfWidth = 0.5 * (this->upperBound - this->lowerBound);
+		double x = halfWidth * std::abs(_timestep);
+
+		// The Bessel functions are computed a bit beyond the order that is needed for the tolerance
+		arma::vec J = this->BesselJ(x, static_cast<unsigned int>(std::ceil(1.5 * x)) + 50);
+		unsigned int order = 0;
+		for (unsigned int k = 0; k < J.n_elem; k++)
+			if (std::abs(J(k)) > this->tolerance)
+				order = k;
+
+		// Negative time steps use the complex conjugate of the coefficients
+		arma::cx_double phase = std::exp(arma::cx_double(0.0, -centre * _timestep));
+		arma::cx_double minusI = (_timestep < 0.0) ? arma::cx_double(0.0, 1.0) : arma::cx_double(0.0, -1.0);
+		arma::cx_double power = 1.0;
+		this->coefficients.set_size(order + 1);
+		for (unsigned int k = 0; k <= order; k++)
+		{
+			this->coefficients(k) = (k == 0 ? 1.0 : 2.0) * power * J(k) * phase;
+			power *= minusI;
+		}
+
+		this->timestep = _timestep;
+		return true;
+	}
+
+	// The three-term recurrence T_k+1 = 2 * X * T_k - T_k-1 acts on all columns at once, such that each term needs a single sparse-dense product
+	arma::cx_mat ChebyshevPropagator::Propagate(const arma::cx_mat &_B) const
+	{
+		double centre = 0.5 * (this->upperBound + this->lowerBound);
+		double halfWidth = 0.5 * (this->upperBound - this->lowerBound);
+
+		arma::cx_mat result = this->coefficients(0) * _B;
+		if (this->coefficients.n_elem < 2 || halfWidth <= 0.0)
+			return result;
+
+		arma::cx_mat T0 = _B;
+		arma::cx_mat T1 = (this->H * T0 - centre * T0) / halfWidth;
+		arma::cx_mat T2;
+		result += this->coefficients(1) * T1;
+		for (unsigned int k = 2; k < this->coefficients.n_elem; k++)
+		{
+			T2 = (2.0 / halfWidth) * (this->H * T1 - centre * T1) - T0;
+			result += this->coefficients(k) * T2;
+			T0.swap(T1);
+			T1.swap(T2);
+		}
+
+		return result;
+	}
+	// -----------------------------------------------------
+	// Private methods
+	// -----------------------------------------------------
+	// Miller's backward recurrence J_k-1 = 2k/x * J_k - J_k+1, normalized with J_0 + 2 * sum_k J_2k = 1. The recurrence is stable in the
+	// backward direction, and the values are rescaled whenever they grow too large, which happens for small arguments.
+	arma::vec ChebyshevPropagator::BesselJ(double _x, unsigned int _n) const
+	{
+		arma::vec J = arma::zeros<arma::vec>(_n + 1);
+		if (_x == 0.0)
+		{
+			J(0) = 1.0;
+			return J;
+		}
+
+		unsigned int start = _n + 30 + static_cast<unsigned int>(std::sqrt(40.0 * (_n + 1)));
+		arma::vec values = arma::zeros<arma::vec>(start + 2);
+		values(start) = 1.0;
+		for (unsigned int k = start; k > 0; k--)
+		{
+			values(k - 1) = 2.0 * k / _x * values(k) - values(k + 1);
+			if (std::abs(values(k - 1)) > 1e+250)
+				values.subvec(k - 1, start + 1) *= 1e-250;
+		}
+
+		double norm = values(0);
+		for (unsigned int k = 2; k <= start; k += 2)
+			norm += 2.0 * values(k);
+
+		return values.head(_n + 1) / norm;
+	}
+	// -----------------------------------------------------
+	// Non-member non-friend functions
+	// -----------------------------------------------------
+	// Bounds of the spectrum of the Hermitian matrix that are guaranteed to contain all eigenvalues, as the expansion diverges outside the bounds.
+	// The Gershgorin discs are intersected with the interval around the mean c of the diagonal that is given by the Frobenius norm of H - c,
+	// as the squares of the eigenvalues of H - c sum to the square of its Frobenius norm. Estimates of the extremal eigenvalues from a few
+	// Lanczos steps are not used, as their residuals only bound the distance to some eigenvalue and not to the extremal ones.
+	bool SpectralBounds(const arma::sp_cx_mat &_H, double &_lowerBound, double &_upperBound)
+	{
+		if (!_H.is_square() || _H.n_rows < 1)
+			return false;
+
+		// Gershgorin bounds, using the real part of the diagonal as the matrix is Hermitian
+		arma::uword n = _H.n_rows;
+		arma::vec diagonal = arma::real(arma::cx_vec(_H.diag()));
+		arma::vec radius = arma::zeros<arma::vec>(n);
+		double offdiagonal = 0.0;
+		for (auto i = _H.begin(); i != _H.end(); ++i)
+		{
+			if (i.row() != i.col())
+			{
+				radius(i.row()) += std::abs(*i);
+				offdiagonal += std::norm(*i);
+			}
+		}
+
+		// Frobenius norm of H - c
+		double centre = arma::mean(diagonal);
+		double frobenius = std::sqrt(offdiagonal + arma::accu(arma::square(diagonal - centre)));
+
+		_lowerBound = std::max(arma::min(diagonal - radius), centre - frobenius);
+		_upperBound = std::min(arma::max(diagonal + radius), centre + frobenius);
+
+		return std::isfinite(_lowerBound) && std::isfinite(_upperBound);
+	}
+}
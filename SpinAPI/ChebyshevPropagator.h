@@ -0,0 +1,54 @@
+/////////////////////////////////////////////////////////////////////////
+// ChebyshevPropagator class (SpinAPI Module)
+// ------------------
+// Propagates states with exp(-i * H * dt) for a sparse Hermitian matrix
+// H with a known bound on its spectrum, using the Chebyshev expansion
+// of the exponential. Each term of the expansion only needs a product
+// of H with the states in the three-term recurrence of the Chebyshev
+// polynomials, and the expansion coefficients are computed once for
+// the time step.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#ifndef MOD_SpinAPI_ChebyshevPropagator
+#define MOD_SpinAPI_ChebyshevPropagator
+
+#include <armadillo>
+
+namespace SpinAPI
+{
+	class ChebyshevPropagator
+	{
+	private:
+		// Implementation details
+		arma::sp_cx_mat H;		   // The Hermitian matrix in the exponential
+		double lowerBound;		   // Bounds of the spectrum of H
+		double upperBound;
+		double tolerance;		   // Expansion terms with coefficients below the tolerance are not used
+		double timestep;		   // The time step the coefficients were computed for
+		arma::cx_vec coefficients; // Expansion coefficients, including the phase from the centre of the spectrum
+
+		// Private methods
+		arma::vec BesselJ(double, unsigned int) const; // Bessel functions of the first kind J_0 to J_n
+
+	public:
+		// Constructors / Destructors
+		ChebyshevPropagator(const arma::sp_cx_mat &, double, double, double); // Normal constructor
+		~ChebyshevPropagator();												  // Destructor
+
+		// Public methods
+		bool SetTimestep(double);						  // Computes the expansion coefficients for the time step
+		arma::cx_mat Propagate(const arma::cx_mat &) const; // Propagates all columns by the time step
+		unsigned int Order() const { return static_cast<unsigned int>(this->coefficients.n_elem) - 1; }
+		double LowerBound() const { return this->lowerBound; }
+		double UpperBound() const { return this->upperBound; }
+		double Timestep() const { return this->timestep; }
+	};
+
+	// Non-member non-friend functions
+	bool SpectralBounds(const arma::sp_cx_mat &, double &, double &); // Bounds that contain the whole spectrum of a Hermitian matrix
+}
+
+#endif
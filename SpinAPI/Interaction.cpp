@@ -23,7 +23,8 @@ namespace SpinAPI
 	Interaction::Interaction(std::string _name, std::string _contents) : properties(std::make_shared<MSDParser::ObjectParser>(_name, _contents)), couplingTensor(nullptr),
 																		 field({0, 0, 0}), dvalue(0.0), evalue(0.0), group1(), group2(), type(InteractionType::Undefined), fieldType(InteractionFieldType::Static), prefactor(1.0), addCommonPrefactor(true), ignoreTensors(false),
 																		 trjHasTime(false), trjHasField(false), trjHasPrefactor(false), trjTime(0), trjFieldX(0), trjFieldY(0), trjFieldZ(0), trjPrefactor(0),
-																		 tdFrequency(1.0), tdPhase(0.0), tdAxis("0 0 1"), tdPerpendicularOscillation(false), tdInitialField({0, 0, 0})
+																		 tdFrequency(1.0), tdPhase(0.0), tdAxis("0 0 1"), tdPerpendicularOscillation(false), tdInitialField({0, 0, 0}),
+																		 operatorCache(), operatorCacheHits(0)
 	{
 		// Is a trajectory specified?
 		std::string str;
@@ -38,7 +39,10 @@ namespace SpinAPI
 			}
 
 			// Load the trajectory, and check whether something was loaded
-			if (this->trajectory.Load(directory + str))
+			// With "binarytrajectory", the file is converted to the binary format on the first load, which is faster to load in subsequent runs
+			bool binaryTrajectory = false;
+			this->properties->Get("binarytrajectory", binaryTrajectory);
+			if (binaryTrajectory ? this->trajectory.LoadConverted(directory + str) : this->trajectory.Load(directory + str))
 			{
 				if (this->trajectory.Length() > 0)
 				{
@@ -155,7 +159,8 @@ namespace SpinAPI
 																trjHasTime(_interaction.trjHasTime), trjHasField(_interaction.trjHasField), trjHasPrefactor(_interaction.trjHasPrefactor),
 																trjTime(_interaction.trjTime), trjFieldX(_interaction.trjFieldX), trjFieldY(_interaction.trjFieldY), trjFieldZ(_interaction.trjFieldZ),
 																trjPrefactor(_interaction.trjPrefactor), tdFrequency(_interaction.tdFrequency), tdPhase(_interaction.tdPhase), tdAxis(_interaction.tdAxis),
-																tdPerpendicularOscillation(_interaction.tdPerpendicularOscillation), tdInitialField(_interaction.tdInitialField)
+																tdPerpendicularOscillation(_interaction.tdPerpendicularOscillation), tdInitialField(_interaction.tdInitialField),
+																operatorCache(), operatorCacheHits(0)
 	{
 	}
 
@@ -193,6 +198,9 @@ namespace SpinAPI
 		this->tdPerpendicularOscillation = _interaction.tdPerpendicularOscillation;
 		this->tdInitialField = _interaction.tdInitialField;
 
+		this->operatorCache.clear();
+		this->operatorCacheHits = 0;
+
 		return (*this);
 	}
 	// -----------------------------------------------------
@@ -367,6 +375,38 @@ namespace SpinAPI
 		return true;
 	}
 
+	// -----------------------------------------------------
+	// Cache of the sparse operator
+	// -----------------------------------------------------
+	// Adds the cached operator for the given layout of the spin space to _result, if it was created from the given parameters
+	bool Interaction::AddCachedOperator(const std::vector<double> &_layout, const std::vector<double> &_parameters, arma::sp_cx_mat &_result) const
+	{
+		bool found = false;
+#pragma omp critical(interaction_operatorcache)
+		{
+			auto i = this->operatorCache.find(_layout);
+			if (i != this->operatorCache.end() && i->second.parameters == _parameters)
+			{
+				_result += i->second.op;
+				this->operatorCacheHits++;
+				found = true;
+			}
+		}
+
+		return found;
+	}
+
+	// Stores the operator for the given layout of the spin space, replacing the operator that was created from other parameters
+	void Interaction::StoreCachedOperator(const std::vector<double> &_layout, const std::vector<double> &_parameters, const arma::sp_cx_mat &_op) const
+	{
+#pragma omp critical(interaction_operatorcache)
+		{
+			auto &cached = this->operatorCache[_layout];
+			cached.parameters = _parameters;
+			cached.op = _op;
+		}
+	}
+
 	// -----------------------------------------------------
 	// Access to custom properties
 	// -----------------------------------------------------
@@ -11,6 +11,7 @@
 #define MOD_SpinAPI_Interaction
 
 #include <vector>
+#include <map>
 #include <memory>
 #include <armadillo>
 #include "SpinAPIDefines.h"
@@ -56,6 +57,16 @@ namespace SpinAPI
 		bool tdPerpendicularOscillation;
 		arma::vec tdInitialField; // Time-dependent fields will have readonly ActionTargets, so we can save the initial state
 
+		// Sparse operators of the interaction, one for each layout of the spin spaces it was used in, together with the parameters they were created from.
+		// The cache is kept here, as the tasks create new SpinSpace objects in each step (see SpinSpace::AddInteractionOperator)
+		struct CachedOperator
+		{
+			std::vector<double> parameters;
+			arma::sp_cx_mat op;
+		};
+		mutable std::map<std::vector<double>, CachedOperator> operatorCache;
+		mutable unsigned int operatorCacheHits;
+
 		// Private methods to create ActionTargets
 		std::vector<RunSection::NamedActionVector> CreateActionVectors(const std::string &);
 		std::vector<RunSection::NamedActionScalar> CreateActionScalars(const std::string &);
@@ -106,6 +117,11 @@ namespace SpinAPI
 		bool SetTrajectoryStep(unsigned int);  // Set parameters from trajectory based on step number
 		bool SetTime(double);				   // Set parameters from trajectory or time-dependence function based on time
 
+		// Cache of the sparse operator of the interaction, used by SpinSpace. The first argument is the layout of the spin space, the second the parameters of the interaction
+		bool AddCachedOperator(const std::vector<double> &, const std::vector<double> &, arma::sp_cx_mat &) const;	 // Adds the cached operator if it was created from the same parameters
+		void StoreCachedOperator(const std::vector<double> &, const std::vector<double> &, const arma::sp_cx_mat &) const; // Replaces the cached operator for the layout
+		unsigned int CachedOperatorHits() const { return this->operatorCacheHits; };										 // Number of times a cached operator was used
+
 		// Allow access to custom properties to be used for custom tasks
 		std::shared_ptr<const MSDParser::ObjectParser> Properties() const;
 
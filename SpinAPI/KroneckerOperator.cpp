@@ -0,0 +1,74 @@
+/////////////////////////////////////////////////////////////////////////
+// KroneckerOperator class (SpinAPI Module)
+// ------------------
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#include "KroneckerOperator.h"
+
+namespace SpinAPI
+{
+	// -----------------------------------------------------
+	// KroneckerOperator Constructors and Destructor
+	// -----------------------------------------------------
+	KroneckerOperator::KroneckerOperator() : op(), left(1), right(1)
+	{
+	}
+
+	KroneckerOperator::KroneckerOperator(const arma::cx_mat &_op, unsigned int _left, unsigned int _right) : op(_op), left(_left), right(_right)
+	{
+	}
+
+	KroneckerOperator::KroneckerOperator(const KroneckerOperator &_op) : op(_op.op), left(_op.left), right(_op.right)
+	{
+	}
+
+	KroneckerOperator::~KroneckerOperator()
+	{
+	}
+	// -----------------------------------------------------
+	// Operators
+	// -----------------------------------------------------
+	const KroneckerOperator &KroneckerOperator::operator=(const KroneckerOperator &_op)
+	{
+		this->op = _op.op;
+		this->left = _op.left;
+		this->right = _op.right;
+
+		return (*this);
+	}
+	// -----------------------------------------------------
+	// Public methods
+	// -----------------------------------------------------
+	// The basis index of the space is (l * d + s) * right + r, with s the index of the spin. Each column is therefore viewed as a
+	// right x (d * left) matrix X, such that the operator acts as X * op^T on each right x d block, i.e. once for every l.
+	arma::cx_mat KroneckerOperator::Apply(const arma::cx_mat &_in) const
+	{
+		const unsigned int d = this->op.n_rows;
+		arma::cx_mat result(arma::size(_in));
+		if (_in.n_rows != this->Dimension())
+			return result.zeros();
+
+		const arma::cx_mat opT = this->op.st();
+		for (unsigned int col = 0; col < _in.n_cols; col++)
+		{
+			// Views of the column memory, without copying
+			const arma::cx_mat X(const_cast<arma::cx_double *>(_in.colptr(col)), this->right, d * this->left, false, true);
+			arma::cx_mat Y(result.colptr(col), this->right, d * this->left, false, true);
+
+			for (unsigned int l = 0; l < this->left; l++)
+				Y.cols(l * d, (l + 1) * d - 1) = X.cols(l * d, (l + 1) * d - 1) * opT;
+		}
+
+		return result;
+	}
+
+	arma::sp_cx_mat KroneckerOperator::Materialize() const
+	{
+		arma::sp_cx_mat op_sparse(this->op);
+		arma::sp_cx_mat result = arma::kron(arma::speye<arma::sp_cx_mat>(this->left, this->left), op_sparse);
+		return arma::sp_cx_mat(arma::kron(result, arma::speye<arma::sp_cx_mat>(this->right, this->right)));
+	}
+}
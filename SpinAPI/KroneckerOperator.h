@@ -0,0 +1,45 @@
+/////////////////////////////////////////////////////////////////////////
+// KroneckerOperator class (SpinAPI Module)
+// ------------------
+// A single-spin operator embedded in a spin space, i.e. the product
+// I (x) ... (x) S (x) ... (x) I, that is applied to vectors without ever
+// forming the full matrix. Only the single-spin matrix and the
+// dimensions of the identities on either side are stored.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#ifndef MOD_SpinAPI_KroneckerOperator
+#define MOD_SpinAPI_KroneckerOperator
+
+#include <armadillo>
+
+namespace SpinAPI
+{
+	class KroneckerOperator
+	{
+	private:
+		// Implementation details
+		arma::cx_mat op;	// The single-spin operator
+		unsigned int left;	// Dimension of the identity before the spin
+		unsigned int right; // Dimension of the identity after the spin
+
+	public:
+		// Constructors / Destructors
+		KroneckerOperator();												// Default constructor, creates an empty operator
+		KroneckerOperator(const arma::cx_mat &, unsigned int, unsigned int); // Normal constructor
+		KroneckerOperator(const KroneckerOperator &);						// Copy-constructor
+		~KroneckerOperator();												// Destructor
+
+		// Operators
+		const KroneckerOperator &operator=(const KroneckerOperator &); // Copy-assignment
+
+		// Public methods
+		unsigned int Dimension() const { return this->left * this->op.n_rows * this->right; }
+		arma::cx_mat Apply(const arma::cx_mat &) const; // Applies the operator to each column of the matrix
+		arma::sp_cx_mat Materialize() const;			// Returns the full sparse matrix, as created by SpinSpace::CreateOperator
+	};
+}
+
+#endif
@@ -0,0 +1,185 @@
+/////////////////////////////////////////////////////////////////////////
+// KrylovPropagator class (SpinAPI Module)
+// ------------------
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cmath>
+#include "KrylovPropagator.h"
+
+namespace SpinAPI
+{
+	// -----------------------------------------------------
+	// KrylovPropagator Constructors and Destructor
+	// -----------------------------------------------------
+	// The subspace dimension starts at _dimension and may grow up to _maxDimension, but never beyond the size of H
+	KrylovPropagator::KrylovPropagator(const arma::sp_cx_mat &_H, const arma::cx_double &_factor, bool _symmetric, unsigned int _dimension, unsigned int _maxDimension, double _tolerance)
+		: H(_H), factor(_factor), symmetric(_symmetric), minDimension(1), maxDimension(1), dimension(1), tolerance(_tolerance), KryBasis(), Hessen(), cx(), state(),
+		  beta(0.0), h_mplusone_m(0.0), size(0), valid(false), rebuilds(0), substeps(0)
+	{
+		unsigned int n = std::max(static_cast<unsigned int>(_H.n_rows), 1u);
+		this->maxDimension = std::min(std::max(std::max(_maxDimension, _dimension), 1u), n);
+		this->dimension = std::min(std::max(_dimension, 1u), this->maxDimension);
+		this->minDimension = this->dimension;
+
+		this->KryBasis.zeros(_H.n_rows, this->maxDimension);
+		this->Hessen.zeros(this->maxDimension, this->maxDimension);
+		this->state.zeros(_H.n_rows);
+	}
+
+	KrylovPropagator::~KrylovPropagator()
+	{
+	}
+	// -----------------------------------------------------
+	// Public methods
+	// -----------------------------------------------------
+	// Replaces the matrix, e.g. for a time-dependent Hamiltonian, the current state is kept
+	void KrylovPropagator::SetMatrix(const arma::sp_cx_mat &_H)
+	{
+		this->H = _H;
+		this->valid = false;
+	}
+
+	void KrylovPropagator::SetState(const arma::cx_vec &_state)
+	{
+		this->state = _state;
+		this->valid = false;
+	}
+
+	// Propagates the state by _dt. The current subspace is used as long as the error estimate stays below the tolerance,
+	// otherwise it is rebuilt from the current state, first increasing the dimension and then dividing the step into substeps.
+	bool KrylovPropagator::Step(double _dt)
+	{
+		double remaining = _dt;
+		while (remaining > 0.0)
+		{
+			// Continue in the current subspace if possible, which only needs the exponential of the small Hessenberg matrix
+			if (this->valid)
+			{
+				arma::cx_vec next = this->Coefficients(this->cx, remaining);
+				if (this->ErrorEstimate(next) <= this->tolerance)
+				{
+					this->cx = next;
+					break;
+				}
+			}
+
+			// Rebuild the subspace from the current state, and enlarge it while the remaining time cannot be covered
+			this->Build();
+			arma::cx_vec next = this->Coefficients(this->cx, remaining);
+			double error = this->ErrorEstimate(next);
+			while (error > this->tolerance && this->size == this->dimension && this->dimension < this->maxDimension)
+			{
+				this->dimension = std::min(2 * this->dimension, this->maxDimension);
+				this->Build();
+				next = this->Coefficients(this->cx, remaining);
+				error = this->ErrorEstimate(next);
+			}
+
+			// Take a shorter substep if the largest subspace is not enough, the error estimate scales roughly as tau^size
+			double tau = remaining;
+			while (error > this->tolerance)
+			{
+				tau *= std::min(0.5, 0.9 * std::pow(this->tolerance / error, 1.0 / this->size));
+				if (tau <= remaining * 1e-12)
+					return false;
+
+				next = this->Coefficients(this->cx, tau);
+				error = this->ErrorEstimate(next);
+			}
+
+			if (tau < remaining)
+			{
+				this->substeps++;
+			}
+			else if (error < 1e-3 * this->tolerance && this->dimension > this->minDimension)
+			{
+				// The subspace is larger than needed, so use a smaller one for the next rebuild
+				this->dimension = std::max(this->minDimension, this->dimension - std::max(this->dimension / 4, 1u));
+			}
+
+			this->cx = next;
+			remaining -= tau;
+
+			// The state is needed for a rebuild if the step is not finished yet
+			if (remaining > 0.0)
+				this->state = this->beta * this->KryBasis.cols(0, this->size - 1) * this->cx;
+		}
+
+		this->state = this->beta * this->KryBasis.cols(0, this->size - 1) * this->cx;
+		return true;
+	}
+	// -----------------------------------------------------
+	// Private methods
+	// -----------------------------------------------------
+	// Builds the subspace with the Arnoldi or Lanczos process, reusing the preallocated workspace
+	void KrylovPropagator::Build()
+	{
+		unsigned int m = this->dimension;
+		this->Hessen.zeros();
+		this->h_mplusone_m = 0.0;
+		this->size = m;
+		this->beta = arma::norm(this->state);
+		this->rebuilds++;
+		this->valid = true;
+
+		// A vanishing state stays zero, which is exact in a one-dimensional subspace
+		if (this->beta == 0.0)
+		{
+			this->KryBasis.col(0).zeros();
+			this->size = 1;
+			this->cx.zeros(1);
+			this->cx(0) = 1.0;
+			return;
+		}
+
+		this->KryBasis.col(0) = this->state / this->beta;
+		for (unsigned int it1 = 0; it1 < m; it1++)
+		{
+			// Compute the matrix-vector product
+			arma::cx_vec z = this->H * this->KryBasis.col(it1);
+
+			// Compute the elements of the Hessenberg matrix, the Lanczos process only needs the two latest basis vectors
+			unsigned int first = (this->symmetric && it1 > 0) ? it1 - 1 : 0;
+			for (unsigned int it2 = first; it2 <= it1; it2++)
+			{
+				this->Hessen(it2, it1) = arma::cdot(this->KryBasis.col(it2), z);
+				z -= this->Hessen(it2, it1) * this->KryBasis.col(it2);
+			}
+
+			double znorm = arma::norm(z);
+			if (it1 + 1 == m)
+			{
+				this->h_mplusone_m = znorm;
+				break;
+			}
+
+			// After a breakdown the subspace is invariant, and the propagation within it is exact
+			if (znorm < 1e-14)
+			{
+				this->size = it1 + 1;
+				break;
+			}
+
+			this->Hessen(it1 + 1, it1) = znorm;
+			this->KryBasis.col(it1 + 1) = z / znorm;
+		}
+
+		this->cx.zeros(this->size);
+		this->cx(0) = 1.0;
+	}
+
+	arma::cx_vec KrylovPropagator::Coefficients(const arma::cx_vec &_cx, double _t) const
+	{
+		return arma::expmat(this->factor * _t * this->Hessen.submat(0, 0, this->size - 1, this->size - 1)) * _cx;
+	}
+
+	// Uses the last coefficient times the residual norm, i.e. the contribution leaving the subspace
+	double KrylovPropagator::ErrorEstimate(const arma::cx_vec &_cx) const
+	{
+		return this->h_mplusone_m * std::abs(_cx(this->size - 1));
+	}
+}
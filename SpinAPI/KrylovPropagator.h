@@ -0,0 +1,68 @@
+/////////////////////////////////////////////////////////////////////////
+// KrylovPropagator class (SpinAPI Module)
+// ------------------
+// Propagates a state vector with the action of exp(factor * H * t) for a
+// sparse matrix H, using a Krylov subspace that is kept between steps.
+// The subspace is only rebuilt once the a posteriori error estimate
+// exceeds the tolerance, and the subspace dimension and the substep size
+// are adapted to keep the estimate below the tolerance.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#ifndef MOD_SpinAPI_KrylovPropagator
+#define MOD_SpinAPI_KrylovPropagator
+
+#include <armadillo>
+
+namespace SpinAPI
+{
+	class KrylovPropagator
+	{
+	private:
+		// Implementation details
+		arma::sp_cx_mat H;		   // The matrix in the exponential
+		arma::cx_double factor;	   // Scalar factor in the exponential, e.g. -i for the Schrodinger equation
+		bool symmetric;			   // Use the Lanczos process instead of the Arnoldi process
+		unsigned int minDimension; // Smallest and largest allowed subspace dimension
+		unsigned int maxDimension;
+		unsigned int dimension; // Subspace dimension used for the next rebuild
+		double tolerance;		// Tolerance for the error estimate per unit norm of the state
+
+		// Workspace, allocated once for the largest allowed dimension
+		arma::cx_mat KryBasis;	// Orthogonal krylov subspace
+		arma::cx_mat Hessen;	// Upper Hessenberg matrix
+		arma::cx_vec cx;		// Coefficients of the current state in the subspace
+		arma::cx_vec state;		// The current state
+		double beta;			// Norm of the state the subspace was built from
+		double h_mplusone_m;	// Norm of the residual of the last basis vector, used for the error estimate
+		unsigned int size;		// Dimension of the current subspace, smaller than dimension after a breakdown
+		bool valid;				// Whether the current subspace can be used
+		unsigned int rebuilds;	// Number of times the subspace was built
+		unsigned int substeps;	// Number of substeps that were needed in addition to the requested steps
+
+		// Private methods
+		void Build();									// Builds the subspace from the current state
+		arma::cx_vec Coefficients(const arma::cx_vec &, double) const; // Propagates subspace coefficients by a time
+		double ErrorEstimate(const arma::cx_vec &) const;				// A posteriori error estimate of propagated coefficients
+
+	public:
+		// Constructors / Destructors
+		KrylovPropagator(const arma::sp_cx_mat &, const arma::cx_double &, bool, unsigned int, unsigned int, double); // Normal constructor
+		~KrylovPropagator();																						  // Destructor
+
+		// Public methods
+		void SetMatrix(const arma::sp_cx_mat &); // Replaces H, invalidating the subspace
+		void SetState(const arma::cx_vec &);	 // Sets a new state, invalidating the subspace
+		bool Step(double);						 // Propagates the current state by the given time, returns false if no acceptable substep was found
+		const arma::cx_vec &State() const { return this->state; }
+
+		// Statistics
+		unsigned int Dimension() const { return this->dimension; }
+		unsigned int Rebuilds() const { return this->rebuilds; }
+		unsigned int Substeps() const { return this->substeps; }
+	};
+}
+
+#endif
@@ -0,0 +1,148 @@
+/////////////////////////////////////////////////////////////////////////
+// ObservableSet class (SpinAPI Module)
+// ------------------
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#include "ObservableSet.h"
+
+namespace SpinAPI
+{
+	// -----------------------------------------------------
+	// ObservableSet Constructors and Destructor
+	// -----------------------------------------------------
+	ObservableSet::ObservableSet() : dimension(0), superspace(false), observables(), rowIndices(), columnIndices(), values()
+	{
+	}
+
+	ObservableSet::ObservableSet(unsigned int _dimension, bool _superspace) : dimension(_dimension), superspace(_superspace), observables(0, _dimension * _dimension),
+																			  rowIndices(), columnIndices(), values()
+	{
+	}
+
+	ObservableSet::ObservableSet(const ObservableSet &_set) : dimension(_set.dimension), superspace(_set.superspace), observables(_set.observables),
+															  rowIndices(_set.rowIndices), columnIndices(_set.columnIndices), values(_set.values)
+	{
+	}
+
+	ObservableSet::~ObservableSet()
+	{
+	}
+	// -----------------------------------------------------
+	// Operators
+	// -----------------------------------------------------
+	const ObservableSet &ObservableSet::operator=(const ObservableSet &_set)
+	{
+		this->dimension = _set.dimension;
+		this->superspace = _set.superspace;
+		this->observables = _set.observables;
+		this->rowIndices = _set.rowIndices;
+		this->columnIndices = _set.columnIndices;
+		this->values = _set.values;
+
+		return (*this);
+	}
+	// -----------------------------------------------------
+	// Public methods
+	// -----------------------------------------------------
+	// Adds the observable as a new row, with the element P(a,b) at the position of rho(b,a) such that the row times rho gives tr(P * rho)
+	bool ObservableSet::Add(const arma::sp_cx_mat &_observable)
+	{
+		if (_observable.n_rows != this->dimension || _observable.n_cols != this->dimension)
+			return false;
+
+		arma::uword row = this->observables.n_rows;
+		for (auto i = _observable.begin(); i != _observable.end(); ++i)
+		{
+			this->rowIndices.push_back(row);
+			this->columnIndices.push_back(this->Index(i.col(), i.row()));
+			this->values.push_back(*i);
+		}
+
+		// Rebuild the sparse matrix with batch insertion, which is much faster than inserting a row into an existing matrix
+		arma::umat locations(2, this->values.size());
+		for (unsigned int k = 0; k < this->values.size(); k++)
+		{
+			locations(0, k) = this->rowIndices[k];
+			locations(1, k) = this->columnIndices[k];
+		}
+		this->observables = arma::sp_cx_mat(locations, arma::cx_vec(this->values), row + 1, this->dimension * this->dimension);
+
+		return true;
+	}
+
+	// Dense version, only the non-zero elements are stored
+	bool ObservableSet::Add(const arma::cx_mat &_observable)
+	{
+		return this->Add(arma::sp_cx_mat(_observable));
+	}
+
+	void ObservableSet::Clear()
+	{
+		this->observables.set_size(0, this->dimension * this->dimension);
+		this->rowIndices.clear();
+		this->columnIndices.clear();
+		this->values.clear();
+	}
+
+	// Evaluates all observables with a single sparse matrix-vector product
+	bool ObservableSet::Evaluate(const arma::cx_vec &_rho, arma::cx_vec &_result) const
+	{
+		if (!this->superspace || _rho.n_elem != this->observables.n_cols)
+			return false;
+
+		_result = this->observables * _rho;
+		return true;
+	}
+
+	// The matrix is used as a column-major vector without copying it
+	bool ObservableSet::Evaluate(const arma::cx_mat &_rho, arma::cx_vec &_result) const
+	{
+		if (this->superspace || _rho.n_elem != this->observables.n_cols)
+			return false;
+
+		const arma::cx_vec rhovec(const_cast<arma::cx_double *>(_rho.memptr()), _rho.n_elem, false, true);
+		_result = this->observables * rhovec;
+		return true;
+	}
+
+	// The rows of the result are the observables in the Heisenberg picture, which lets periodic propagation evaluate the expectation values
+	// within a period from the state at the start of the period. In Hilbert space the rows hold P^T, which transforms into U^T * P^T * conj(U).
+	bool ObservableSet::HeisenbergObservables(const arma::cx_mat &_U, arma::cx_mat &_result) const
+	{
+		arma::cx_mat observables(this->observables);
+		if (this->superspace)
+		{
+			if (_U.n_rows != observables.n_cols || _U.n_cols != observables.n_cols)
+				return false;
+
+			_result = observables * _U;
+			return true;
+		}
+
+		if (_U.n_rows != this->dimension || _U.n_cols != this->dimension)
+			return false;
+
+		_result.set_size(observables.n_rows, observables.n_cols);
+		for (arma::uword k = 0; k < observables.n_rows; k++)
+		{
+			arma::cx_mat transposed = arma::reshape(observables.row(k).st(), this->dimension, this->dimension);
+			_result.row(k) = arma::vectorise(_U.st() * transposed * arma::conj(_U)).st();
+		}
+
+		return true;
+	}
+	// -----------------------------------------------------
+	// Private methods
+	// -----------------------------------------------------
+	// SpinSpace::OperatorToSuperspace stores the rows of the density operator one after another, while Armadillo matrices store the columns
+	arma::uword ObservableSet::Index(arma::uword _row, arma::uword _col) const
+	{
+		if (this->superspace)
+			return _row * this->dimension + _col;
+
+		return _row + _col * this->dimension;
+	}
+}
@@ -0,0 +1,66 @@
+/////////////////////////////////////////////////////////////////////////
+// ObservableSet class (SpinAPI Module)
+// ------------------
+// A set of observables, e.g. state projection operators, that is built
+// once and evaluated for many density operators. The observables are
+// stored as rows of a sparse matrix that is arranged to match the
+// layout of the density operator, such that all expectation values
+// tr(P * rho) are obtained from a single matrix-vector product.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+#ifndef MOD_SpinAPI_ObservableSet
+#define MOD_SpinAPI_ObservableSet
+
+#include <vector>
+#include <armadillo>
+
+namespace SpinAPI
+{
+	class ObservableSet
+	{
+	private:
+		// Implementation details
+		unsigned int dimension; // Hilbert space dimension of the observables
+		bool superspace;		// Whether the density operators are superspace vectors (see SpinSpace::OperatorToSuperspace) or Hilbert space matrices
+		arma::sp_cx_mat observables;
+
+		// The elements of all observables, used to rebuild the sparse matrix in one go when an observable is added
+		std::vector<arma::uword> rowIndices;
+		std::vector<arma::uword> columnIndices;
+		std::vector<arma::cx_double> values;
+
+		// Private methods
+		arma::uword Index(arma::uword, arma::uword) const; // Position of an element of an observable in the vectorized density operator
+
+	public:
+		// Constructors / Destructors
+		ObservableSet();						  // Default constructor, creates an empty set for Hilbert space density operators
+		ObservableSet(unsigned int, bool);		  // Normal constructor
+		ObservableSet(const ObservableSet &);	  // Copy-constructor
+		~ObservableSet();						  // Destructor
+
+		// Operators
+		const ObservableSet &operator=(const ObservableSet &); // Copy-assignment
+
+		// Public methods
+		bool Add(const arma::sp_cx_mat &); // Adds an observable given as a Hilbert space operator
+		bool Add(const arma::cx_mat &);
+		void Clear();
+		unsigned int Size() const { return static_cast<unsigned int>(this->observables.n_rows); }
+		unsigned int Dimension() const { return this->dimension; }
+		bool IsSuperspace() const { return this->superspace; }
+		const arma::sp_cx_mat &Observables() const { return this->observables; } // One row per observable, in the layout of the vectorized density operator
+
+		// Expectation values of all observables, in the order they were added
+		bool Evaluate(const arma::cx_vec &, arma::cx_vec &) const; // The density operator as a superspace vector
+		bool Evaluate(const arma::cx_mat &, arma::cx_vec &) const; // The density operator as a Hilbert space matrix
+
+		// Rows giving the expectation values after propagation with U, i.e. for U * rho * U^dagger (Hilbert space) or U * rho (superspace)
+		bool HeisenbergObservables(const arma::cx_mat &, arma::cx_mat &) const;
+	};
+}
+
+#endif
@@ -17,7 +17,7 @@ namespace SpinAPI
 	// -----------------------------------------------------
 	// Spin Constructors and Destructor
 	// -----------------------------------------------------
-	Spin::Spin(std::string _name, std::string _contents) : tensor(2.0), type(SpinType::NotSpecified), properties(std::make_shared<MSDParser::ObjectParser>(_name, _contents)), s(1),
+	Spin::Spin(std::string _name, std::string _contents) : tensor(2.0), type(SpinType::NotSpecified), properties(std::make_shared<MSDParser::ObjectParser>(_name, _contents)), s(1), equivalent(1), totalSpins(), dimension(2),
 														   quantizationAxis1({1.0, 0.0, 0.0}), quantizationAxis2({0.0, 1.0, 0.0}), quantizationAxis3({0.0, 0.0, 1.0}), trajectory(),
 														   trjHasTime(false), trjHasQAxis1(false), trjHasQAxis2(false), trjHasQAxis3(false), trjTime(0),
 														   trjQAxis1X(0), trjQAxis1Y(0), trjQAxis1Z(0), trjQAxis2X(0), trjQAxis2Y(0), trjQAxis2Z(0), trjQAxis3X(0), trjQAxis3Y(0), trjQAxis3Z(0)
@@ -32,6 +32,10 @@ namespace SpinAPI
 				s = 0;
 		}
 
+		// A group of magnetically equivalent spins is represented by the distinct total spins of the group
+		this->properties->Get("equivalent", this->equivalent);
+		this->CoupleEquivalentSpins();
+
 		// See if a tensor is specified
 		this->properties->Get("tensor", this->tensor);
 
@@ -54,7 +58,10 @@ namespace SpinAPI
 			}
 
 			// Load the trajectory, and check whether something was loaded
-			if (this->trajectory.Load(directory + str))
+			// With "binarytrajectory", the file is converted to the binary format on the first load, which is faster to load in subsequent runs
+			bool binaryTrajectory = false;
+			this->properties->Get("binarytrajectory", binaryTrajectory);
+			if (binaryTrajectory ? this->trajectory.LoadConverted(directory + str) : this->trajectory.Load(directory + str))
 			{
 				if (this->trajectory.Length() > 0)
 				{
@@ -88,6 +95,7 @@ namespace SpinAPI
 	}
 
 	Spin::Spin(const Spin &_spin) : tensor(_spin.tensor), type(_spin.type), properties(std::make_shared<MSDParser::ObjectParser>(*(this->properties))), s(_spin.s),
+									equivalent(_spin.equivalent), totalSpins(_spin.totalSpins), dimension(_spin.dimension),
 									quantizationAxis1(_spin.quantizationAxis1), quantizationAxis2(_spin.quantizationAxis2), quantizationAxis3(_spin.quantizationAxis3),
 									trajectory(_spin.trajectory), trjHasTime(_spin.trjHasTime), trjHasQAxis1(_spin.trjHasQAxis1), trjHasQAxis2(_spin.trjHasQAxis2),
 									trjHasQAxis3(_spin.trjHasQAxis3), trjTime(_spin.trjTime), trjQAxis1X(_spin.trjQAxis1X), trjQAxis1Y(_spin.trjQAxis1Y),
@@ -109,6 +117,9 @@ namespace SpinAPI
 		this->type = _spin.type;
 		this->properties = std::make_shared<MSDParser::ObjectParser>(*(_spin.properties));
 		this->s = _spin.s;
+		this->equivalent = _spin.equivalent;
+		this->totalSpins = _spin.totalSpins;
+		this->dimension = _spin.dimension;
 		this->quantizationAxis1 = _spin.quantizationAxis1;
 		this->quantizationAxis2 = _spin.quantizationAxis2;
 		this->quantizationAxis3 = _spin.quantizationAxis3;
@@ -150,6 +161,53 @@ namespace SpinAPI
 		this->quantizationAxis2 /= arma::norm(this->quantizationAxis2);
 		this->quantizationAxis3 /= arma::norm(this->quantizationAxis3);
 	}
+
+	// Couples the equivalent spins one at a time, i.e. S x s = |S-s| + ... + (S+s), and counts how often each total spin occurs.
+	// Only one copy of each total spin is kept in the spin space, as the Hamiltonian acts identically on all copies.
+	void Spin::CoupleEquivalentSpins()
+	{
+		this->totalSpins.clear();
+		this->dimension = this->s + 1;
+		if (this->equivalent < 2)
+		{
+			this->totalSpins.push_back(std::pair<unsigned int, unsigned int>(this->s, 1));
+			return;
+		}
+
+		std::map<unsigned int, unsigned int> coupled;
+		coupled[this->s] = 1;
+		for (unsigned int n = 1; n < this->equivalent; n++)
+		{
+			std::map<unsigned int, unsigned int> next;
+			for (auto i = coupled.cbegin(); i != coupled.cend(); i++)
+				for (unsigned int j = (i->first > this->s ? i->first - this->s : this->s - i->first); j <= i->first + this->s; j += 2)
+					next[j] += i->second;
+			coupled = next;
+		}
+
+		// Use the largest total spin first
+		this->dimension = 0;
+		for (auto i = coupled.crbegin(); i != coupled.crend(); i++)
+		{
+			this->totalSpins.push_back(*i);
+			this->dimension += i->first + 1;
+		}
+	}
+
+	// Puts the spin matrix of each distinct total spin on the diagonal, a total spin of zero only contributes a zero
+	arma::sp_cx_mat Spin::GroupMatrix(std::shared_ptr<arma::sp_cx_mat> (*_collection)(unsigned int)) const
+	{
+		arma::sp_cx_mat result(this->dimension, this->dimension);
+		unsigned int offset = 0;
+		for (auto i = this->totalSpins.cbegin(); i != this->totalSpins.cend(); i++)
+		{
+			if (i->first > 0)
+				result.submat(offset, offset, offset + i->first, offset + i->first) = *(_collection(i->first));
+			offset += i->first + 1;
+		}
+
+		return result;
+	}
 	// -----------------------------------------------------
 	// Name and validation
 	// -----------------------------------------------------
@@ -162,7 +220,7 @@ namespace SpinAPI
 	// A spin-0 is not allowed as it would not make sense (it has no spin-space dynamics)
 	bool Spin::IsValid()
 	{
-		if (s == 0)
+		if (s == 0 || this->equivalent < 1)
 			return false;
 
 		return true;
@@ -316,33 +374,62 @@ namespace SpinAPI
 	// Returns the Sx matrix for the spin
 	const arma::sp_cx_mat Spin::Sx() const
 	{
+		if (this->equivalent > 1)
+			return this->GroupMatrix(&Spin::SxFromCollection);
+
 		return (*(SxFromCollection(this->s)));
 	}
 
 	// And similarly for the Sy spin matrix
 	const arma::sp_cx_mat Spin::Sy() const
 	{
+		if (this->equivalent > 1)
+			return this->GroupMatrix(&Spin::SyFromCollection);
+
 		return (*(SyFromCollection(this->s)));
 	}
 
 	// And the Sz spin matrix
 	const arma::sp_cx_mat Spin::Sz() const
 	{
+		if (this->equivalent > 1)
+			return this->GroupMatrix(&Spin::SzFromCollection);
+
 		return (*(SzFromCollection(this->s)));
 	}
 
 	// The S+ spin ladder operator
 	const arma::sp_cx_mat Spin::Sp() const
 	{
+		if (this->equivalent > 1)
+			return this->GroupMatrix(&Spin::SpFromCollection);
+
 		return (*(SpFromCollection(this->s)));
 	}
 
 	// The S- spin ladder operator
 	const arma::sp_cx_mat Spin::Sm() const
 	{
+		if (this->equivalent > 1)
+			return this->GroupMatrix(&Spin::SmFromCollection);
+
 		return (*(SmFromCollection(this->s)));
 	}
 
+	// Returns the multiplicity of the total spin of each basis state, such that a trace over the spin space of the group equals the trace over the full space
+	arma::vec Spin::Weights() const
+	{
+		arma::vec weights(this->dimension);
+		unsigned int offset = 0;
+		for (auto i = this->totalSpins.cbegin(); i != this->totalSpins.cend(); i++)
+		{
+			weights.subvec(offset, offset + i->first).fill(static_cast<double>(i->second));
+			offset += i->first + 1;
+		}
+
+		return weights;
+	}
+
 	// Returns the transformed magnetic moment; (Sx,Sy,Sz)-vector multiplied by the tensor
 	const arma::sp_cx_mat Spin::Tx() const
 	{
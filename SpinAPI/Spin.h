@@ -11,6 +11,8 @@
 #define MOD_SpinAPI_Spin
 
 #include <map>
+#include <vector>
+#include <utility>
 #include <memory>
 #include <armadillo>
 #include "Tensor.h"
@@ -28,6 +30,9 @@ namespace SpinAPI
 		SpinType type;
 		std::shared_ptr<MSDParser::ObjectParser> properties; // Use a pointer to the object to minimize compilation dependencies
 		unsigned int s;										 // Spin quantum number in units of 1/2*hbar, i.e. 1 for an electron or proton
+		unsigned int equivalent;							 // Number of magnetically equivalent spins represented by the object, e.g. 3 for a methyl group
+		std::vector<std::pair<unsigned int, unsigned int>> totalSpins; // Total spin quantum numbers (in units of 1/2*hbar) of the group of equivalent spins, and their multiplicities
+		unsigned int dimension;								 // Dimension of the spin space, i.e. the sum of the dimensions of the distinct total spins
 		arma::vec quantizationAxis1;						 // The quantization axes of the spin
 		arma::vec quantizationAxis2;
 		arma::vec quantizationAxis3;
@@ -49,7 +54,9 @@ namespace SpinAPI
 		unsigned int trjQAxis3Z;
 
 		// Private methods
-		void OrthonormalizeQAxes(); // Makes axes orthonormal
+		void OrthonormalizeQAxes();	   // Makes axes orthonormal
+		void CoupleEquivalentSpins(); // Decomposes the group of equivalent spins into total spins (Clebsch-Gordan series)
+		arma::sp_cx_mat GroupMatrix(std::shared_ptr<arma::sp_cx_mat> (*)(unsigned int)) const; // Direct sum of a spin matrix over the distinct total spins
 
 		// Collections of spin matrices (such that they are only created once)
 		static std::map<unsigned int, std::shared_ptr<arma::sp_cx_mat>> SxCollection;
@@ -80,8 +87,11 @@ namespace SpinAPI
 
 		// Public methods
 		SpinType Type() const { return this->type; }
-		int Multiplicity() const { return (this->s + 1); };		  // Spin multiplicity (2s + 1)
-		int S() const { return static_cast<int>(this->s); };	  // Spin quantum number in units of 1/2*hbar
+		int Multiplicity() const { return static_cast<int>(this->dimension); }; // Spin multiplicity (2s + 1), or the dimension of the distinct total spins of a group
+		int S() const { return static_cast<int>(this->s); };					 // Spin quantum number in units of 1/2*hbar
+		unsigned int Equivalent() const { return this->equivalent; };			 // Number of magnetically equivalent spins represented by the object
+		const std::vector<std::pair<unsigned int, unsigned int>> &TotalSpins() const { return this->totalSpins; };
+		arma::vec Weights() const;												 // Multiplicity of the total spin that each basis state belongs to (ones for a single spin)
 		const Tensor &GetTensor() const { return this->tensor; }; // Get G-tensor
 		bool SetTrajectoryStep(unsigned int);					  // Updates g-tensor from its trajectory (if any)
 		bool SetTime(double);									  // Updates g-tensor from its trajectory (if any)
@@ -72,6 +72,16 @@ namespace SpinAPI
 		RelaxationT2,
 	};
 
+	// Single-spin matrices that SpinAPI::SpinSpace can embed in the space and cache
+	enum class SpinOperatorType
+	{
+		Sx,
+		Sy,
+		Sz,
+		Sp,
+		Sm,
+	};
+
 	// The types of special operators defined in SpinAPI::Operator objects
 	enum class PulseType
 	{
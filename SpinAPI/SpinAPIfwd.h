@@ -55,6 +55,14 @@ namespace SpinAPI
 	class Tensor;
 #endif
 
+#ifndef MOD_SpinAPI_ObservableSet
+	class ObservableSet;
+#endif
+
+#ifndef MOD_SpinAPI_AffineOperator
+	class AffineOperator;
+#endif
+
 #ifndef MOD_SpinAPI_StandardOutput
 	class StandardOutput;
 	using output_ptr = std::shared_ptr<StandardOutput>;
@@ -17,6 +17,8 @@
 #include "Pulse.h"
 #include "SpinSpace.h"
 #include "SpinSystem.h"
+#include "ObservableSet.h"
+#include "AffineOperator.h"
 
 // Include additional source files
 #include "SpinSpace/SpinSpace_management.cpp"
@@ -26,6 +28,8 @@
 #include "SpinSpace/SpinSpace_transitions.cpp"
 #include "SpinSpace/SpinSpace_relaxation.cpp"
 #include "SpinSpace/SpinSpace_pulses.cpp"
+#include "SpinSpace/SpinSpace_solvers.cpp"
+#include "SpinSpace/SpinSpace_blocks.cpp"
 
 namespace SpinAPI
 {
@@ -61,7 +65,7 @@ namespace SpinAPI
 
 	SpinSpace::SpinSpace(const SpinSpace &_space) : useSuperspace(_space.useSuperspace), spins(_space.spins), interactions(_space.interactions), transitions(_space.transitions), pulses(_space.pulses),
 													time(_space.time), trajectoryStep(_space.trajectoryStep), useTrajectoryStep(_space.useTrajectoryStep),
-													reactionOperators(ReactionOperatorType::Haberkorn)
+													reactionOperators(ReactionOperatorType::Haberkorn), operatorCache(_space.operatorCache)
 	{
 	}
 
@@ -83,6 +87,7 @@ namespace SpinAPI
 		this->trajectoryStep = _space.trajectoryStep;
 		this->useTrajectoryStep = _space.useTrajectoryStep;
 		this->reactionOperators = _space.reactionOperators;
+		this->operatorCache = _space.operatorCache;
 
 		return (*this);
 	}
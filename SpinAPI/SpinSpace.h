@@ -23,10 +23,14 @@
 #define MOD_SpinAPI_SpinSpace
 
 #include <vector>
+#include <map>
+#include <utility>
 #include <memory>
+#include <functional>
 #include <armadillo>
 #include "SpinAPIDefines.h"
 #include "SpinAPIfwd.h"
+#include "KroneckerOperator.h"
 
 namespace SpinAPI
 {
@@ -43,6 +47,24 @@ namespace SpinAPI
 		unsigned int trajectoryStep; // The current trajectory step to use
 		bool useTrajectoryStep;		 // Set to true if trajectories should be used instead of time, where available
 		ReactionOperatorType reactionOperators;
+		mutable std::map<std::pair<spin_ptr, SpinOperatorType>, arma::sp_cx_mat> operatorCache; // Embedded spin matrices, cleared whenever the spins of the space change
+
+		// Helper methods for the incremental Hamiltonian assembly (SpinSpace_hamiltonians.cpp)
+		std::vector<double> InteractionSignature(const interaction_ptr &) const;	   // Values of the interaction parameters that determine its operator
+		std::vector<double> InteractionLayout(const interaction_ptr &) const;		   // Values of the spin space that determine the operator of the interaction
+		bool AddInteractionOperator(const interaction_ptr &, arma::sp_cx_mat &) const; // Adds the interaction operator, rebuilding it only if its signature changed
+
+		// Helper methods for the affine decomposition of the dynamic Hamiltonian (SpinSpace_hamiltonians.cpp)
+		bool InteractionTerms(const interaction_ptr &, std::vector<arma::sp_cx_mat> &) const;		  // Appends the constant operators of the interaction
+		bool InteractionCoefficients(const interaction_ptr &, std::vector<arma::cx_double> &) const; // Appends the current coefficients of these operators
+		double InteractionPrefactor(const interaction_ptr &) const;									  // Prefactor including the common prefactor
+		bool HasMovingSpins(const interaction_ptr &) const;											  // Whether the magnetic moment operators follow a trajectory
+		arma::mat MagneticMomentTensor(const spin_ptr &) const;										  // Tensor that gives (Tx,Ty,Tz) from (Sx,Sy,Sz)
+
+		// Helper methods for the block Krylov propagation (SpinSpace_operators.cpp)
+		void KrylovBlockInitialize(const arma::cx_mat &, std::vector<arma::cx_mat> &, arma::cx_cube &, int, arma::vec &) const;
+		void KrylovBlockExtend(const arma::cx_mat &, std::vector<arma::cx_mat> &, arma::cx_cube &, int, int, arma::vec &) const;
+		arma::cx_mat KrylovBlockCombine(const arma::cx_mat &, const std::vector<arma::cx_mat> &, const arma::cx_cube &, const arma::cx_double, int) const;
 
 	public:
 		// Constructors / Destructors
@@ -112,12 +134,13 @@ namespace SpinAPI
 		// ------------------------------------------------
 		// Spin state representations in the Hilbert space (SpinSpace_states.cpp)
 		// ------------------------------------------------
-		arma::cx_mat GetSingleSpinState(const spin_ptr &, int) const;									 // Returns the projection matrix
+		bool GetSingleSpinState(const spin_ptr &, int, arma::cx_mat &) const;							 // Sets the projection matrix, fails for groups of equivalent spins
 		bool GetState(const CompleteState &, arma::cx_vec &, bool _useFullBasis = true) const;			 // Vector representing the state
 		bool GetState(const state_ptr &, arma::cx_vec &) const;											 // Vector representing the state
 		bool GetState(const state_ptr &, arma::cx_mat &) const;											 // Projection operator onto the state (dense matrix)
 		bool GetState(const state_ptr &, arma::sp_cx_mat &) const;										 // Projection operator onto the state (sparse matrix)
 		bool GetThermalState(SpinAPI::SpinSpace &_space, double _Temperature, arma::cx_mat &_mat) const; // Projection operator onto the thermal equilibrium state (dense matrix) [created by Pedro Alvarez]
+		bool WeightEquivalentSpins(arma::cx_mat &) const;												 // Weights an initial density operator by the multiplicities of the total spins of groups of equivalent spins
 
 		// ------------------------------------------------
 		// Operators in the spin space (SpinSpace_operators.cpp)
@@ -137,6 +160,14 @@ namespace SpinAPI
 		bool SuperoperatorFromLeftOperator(const arma::sp_cx_mat &, arma::sp_cx_mat &) const;
 		bool SuperoperatorFromRightOperator(const arma::sp_cx_mat &, arma::sp_cx_mat &) const;
 
+		// Spin matrices embedded in the Hilbert space, cached until the spins of the space change
+		bool CreateOperator(SpinOperatorType, const spin_ptr &, arma::cx_mat &) const;
+		bool CreateOperator(SpinOperatorType, const spin_ptr &, arma::sp_cx_mat &) const;
+
+		// Embedded operators that are applied to vectors without forming the matrix of the Hilbert space
+		bool CreateKroneckerOperator(const arma::cx_mat &, const spin_ptr &, KroneckerOperator &) const;
+		bool CreateKroneckerOperator(SpinOperatorType, const spin_ptr &, KroneckerOperator &) const;
+
 		// Re-ordering of the spins, used by the GetState methods when working with entangled states
 		// TODO: Consider making non-member non-friend functions, or making such equivalents
 		bool ReorderBasis(arma::cx_vec &, const std::vector<spin_ptr> &) const;
@@ -189,7 +220,7 @@ namespace SpinAPI
 		// ------------------------------------------------
 
 		arma::cx_colvec SUZstate(const int &spinmult, std::mt19937 &generator);																					 // returns stochastically determined SU(Z) state
-		arma::cx_colvec CoherentState(std::vector<SpinAPI::system_ptr>::const_iterator i, std::mt19937 &generator);												 // returns stochastically determined coherent state
+		bool CoherentState(std::vector<SpinAPI::system_ptr>::const_iterator i, std::mt19937 &generator, arma::cx_colvec &_state);									 // sets a stochastically determined coherent state, fails for groups of equivalent spins
 		arma::cx_mat HighamProp(arma::sp_cx_mat &H, arma::cx_mat &B, const std::complex<double> t, const std::string precision, arma::mat &M);					 // Propagation method using: https://doi.org/10.1137/100788860
 		arma::mat SelectTaylorDegree(const arma::sp_cx_mat &H, const std::string precision, const int lengthB);													 // Precision of Taylor series used for HighamProp
 		double normAmEst(const arma::sp_cx_mat &H, double m, std::mt19937 &generator);																			 // Used in SelectTaylorDegree to normalize
@@ -197,6 +228,36 @@ namespace SpinAPI
 		arma::cx_colvec KrylovExpmSymm(const arma::sp_cx_mat &H, const arma::cx_colvec &b, const arma::cx_double dt, int KryDim, int HilbSize);					 // Krylov subspace method for symmetric decay
 		void ArnoldiProcess(const arma::sp_cx_mat &H, const arma::cx_colvec &b, arma::cx_mat &KryBasis, arma::cx_mat &Hessen, int KryDim, double &h_mplusone_m); // Arnoldi process for propagation using Krylov subsspace
 		void LanczosProcess(const arma::sp_cx_mat &H, const arma::cx_colvec &b, arma::cx_mat &KryBasis, arma::cx_mat &Hessen, int KryDim, double &h_mplusone_m); // Lanczos process for propagation using Krylov subsspace
+		arma::cx_mat KrylovExpmGeneralBlock(const arma::sp_cx_mat &H, const arma::cx_mat &B, const arma::cx_double dt, int KryDim, int HilbSize);											 // Krylov subspace method for all columns of B at once
+		arma::cx_mat KrylovExpmSymmBlock(const arma::sp_cx_mat &H, const arma::cx_mat &B, const arma::cx_double dt, int KryDim, int HilbSize);												 // Krylov subspace method for symmetric decay, for all columns of B at once
+		void ArnoldiProcessBlock(const arma::sp_cx_mat &H, const arma::cx_mat &B, std::vector<arma::cx_mat> &KryBasis, arma::cx_cube &Hessen, int KryDim, arma::vec &h_mplusone_m); // Arnoldi process for each column of B, using one sparse-dense product per iteration
+		void LanczosProcessBlock(const arma::sp_cx_mat &H, const arma::cx_mat &B, std::vector<arma::cx_mat> &KryBasis, arma::cx_cube &Hessen, int KryDim, arma::vec &h_mplusone_m); // Lanczos process for each column of B, using one sparse-dense product per iteration
+		bool UncoupledPairProjections(const arma::cx_mat &_B1, const arma::cx_mat &_B2, const std::string &_initialState, arma::vec &_projections) const;					 // Singlet and triplet probabilities summed over all pairs of wavefunctions of two uncoupled radicals
+
+		// ------------------------------------------------
+		// Linear solvers for sparse or matrix-free operators on the space (SpinSpace_solvers.cpp)
+		// ------------------------------------------------
+		arma::cx_vec JacobiPreconditioner(const arma::sp_cx_mat &) const;																															// Inverse of the diagonal, used to precondition the iterative solvers
+		bool SolveGMRES(const arma::sp_cx_mat &_A, const arma::cx_vec &_b, arma::cx_vec &_x, double _tolerance, unsigned int _restart, unsigned int _maxIterations, unsigned int &_iterations, double &_residual) const; // Restarted GMRES, solves A*x = b
+		bool SolveBiCGSTAB(const arma::sp_cx_mat &_A, const arma::cx_vec &_b, arma::cx_vec &_x, double _tolerance, unsigned int _maxIterations, unsigned int &_iterations, double &_residual) const;					 // BiCGSTAB, solves A*x = b
+		bool SolveGMRES(const std::function<arma::cx_vec(const arma::cx_vec &)> &_A, const arma::cx_vec &_preconditioner, const arma::cx_vec &_b, arma::cx_vec &_x, double _tolerance, unsigned int _restart, unsigned int _maxIterations, unsigned int &_iterations, double &_residual) const; // Matrix-free GMRES, _A returns A*v
+		bool SolveBiCGSTAB(const std::function<arma::cx_vec(const arma::cx_vec &)> &_A, const arma::cx_vec &_preconditioner, const arma::cx_vec &_b, arma::cx_vec &_x, double _tolerance, unsigned int _maxIterations, unsigned int &_iterations, double &_residual) const;					// Matrix-free BiCGSTAB, _A returns A*v
+		bool SolveSparseLU(const arma::sp_cx_mat &_A, const arma::cx_vec &_b, arma::cx_vec &_x) const;																								 // Sparse direct solver (requires Armadillo with SuperLU)
+		bool SolveSylvester(const arma::cx_mat &_A, const arma::cx_mat &_B, const arma::cx_mat &_C, arma::cx_mat &_X) const;	// Bartels-Stewart, solves A*X + X*B = C
+		bool SolveHaberkornSteadyState(const arma::cx_mat &_rho0, arma::cx_mat &_rho) const;								// Solves -i[H, rho] - {K, rho} = rho0 in the Hilbert space (Haberkorn reaction operators only)
+		bool SolveYields(const arma::sp_cx_mat &_A, const arma::cx_mat &_B, const ObservableSet &_observables, arma::cx_mat &_yields) const;					// Expectation values of the solutions of A*X = B, with a single factorization of A
+
+		// ------------------------------------------------
+		// Block structure of operators on the space (SpinSpace_blocks.cpp)
+		// ------------------------------------------------
+		bool BlockStructure(const arma::sp_cx_mat &_A, arma::uvec &_permutation, std::vector<arma::uword> &_blockOffsets) const; // Connected components of the sparsity pattern, i.e. the basis reordering that makes _A block-diagonal
+		bool BlockMatrices(const arma::sp_cx_mat &_A, const arma::uvec &_permutation, const std::vector<arma::uword> &_blockOffsets, std::vector<arma::cx_mat> &_blocks) const; // Extracts the blocks found by BlockStructure as dense matrices
+		bool BlockEigenDecomposition(const arma::sp_cx_mat &_H, arma::vec &_eigenvalues, arma::cx_mat &_eigenvectors) const;	 // Same result as arma::eig_sym, but diagonalizes the blocks independently and in parallel
+		bool BlockEigenDecomposition(const arma::cx_mat &_H, arma::vec &_eigenvalues, arma::cx_mat &_eigenvectors) const;
+		bool BlockEigenvalues(const arma::sp_cx_mat &_H, arma::vec &_eigenvalues) const;										 // Eigenvalues only, block by block
+		bool BlockSolve(const arma::sp_cx_mat &_A, const arma::cx_mat &_B, arma::cx_mat &_X) const;							 // Same result as arma::solve, but solves the blocks independently and in parallel
+		bool BlockExponential(const arma::sp_cx_mat &_A, const arma::cx_double &_factor, arma::cx_mat &_U) const;				 // Same result as arma::expmat(_factor * _A), block by block
+		bool PartialEigenDecomposition(const arma::sp_cx_mat &_H, unsigned int _k, bool _lowest, arma::vec &_eigenvalues, arma::cx_mat &_eigenvectors, double _tolerance = 1e-10) const; // The _k lowest or highest eigenpairs
 
 		// ------------------------------------------------
 		// Hamiltonian representations in the space (SpinSpace_hamiltonians.cpp)
@@ -209,6 +270,11 @@ namespace SpinAPI
 		bool StaticHamiltonian(arma::sp_cx_mat &) const;							// Time-independent part of the Hamiltonian operator (sparse matrix)
 		bool DynamicHamiltonian(arma::cx_mat &) const;								// Time-dependent part of the Hamiltonian operator (dense matrix)
 		bool DynamicHamiltonian(arma::sp_cx_mat &) const;							// Time-dependent part of the Hamiltonian operator (sparse matrix)
+		bool DynamicHamiltonianTerms(AffineOperator &) const;						// Adds the constant operators H_k of the time-dependent part of the Hamiltonian, sum_k c_k(t) * H_k
+		bool DynamicHamiltonianCoefficients(arma::cx_vec &) const;					// The coefficients c_k at the current time or trajectory step
+		bool IntegratorStages(const std::string &, arma::vec &, arma::mat &) const;	// Nodes and weights of the stages of a time step, for "piecewise" or "magnus4"
+		bool StageHamiltonians(const AffineOperator &, const arma::vec &, const arma::mat &, double, double, std::vector<arma::sp_cx_mat> &, arma::vec &); // Hamiltonians and durations of the stages of a time step
+		bool StageReactionOperators(const arma::vec &, const arma::mat &, double, double, std::vector<arma::sp_cx_mat> &);									// Time-dependent reaction operators of the same stages
 
 		// ------------------------------------------------
 		// Transitions/decay operators (SpinSpace_transitions.cpp)
@@ -225,6 +291,7 @@ namespace SpinAPI
 		bool DynamicTotalReactionOperator(arma::cx_mat &, const ReactionOperatorType &_forcedReactionOperatorType = ReactionOperatorType::Unspecified) const;				 // Time-dependent part of the total reaction operator (dense matrix)
 		bool DynamicTotalReactionOperator(arma::sp_cx_mat &, const ReactionOperatorType &_forcedReactionOperatorType = ReactionOperatorType::Unspecified) const;			 // Time-dependent part of the total reaction operator (sparse matrix)
 		ReactionOperatorType GetReactionOperatorType() const;																												 // Returns the reaction operator type used by the SpinSpace (superspace only)
+		bool HasOnlyHaberkornReactionOperators() const;																													 // Whether all transitions use the Haberkorn form, i.e. the dynamics can be written in the Hilbert space
 
 		// Methods to create reaction operators in the target spin system (i.e. for creation), where the 'double' describes the amount of source state in the source system
 		bool ReactionTargetOperator(const transition_ptr &, double, arma::cx_mat &) const;
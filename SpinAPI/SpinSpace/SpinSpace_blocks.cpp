@@ -0,0 +1,382 @@
+/////////////////////////////////////////////////////////////////////////
+// SpinSpace class (SpinAPI Module)
+// ------------------
+// This source file contains methods for finding the block structure of
+// operators on the spin space, e.g. the sectors of a Hamiltonian with a
+// conserved total Mz, and for working on the blocks independently, as
+// well as methods for parts of the spectrum of a Hamiltonian.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+namespace SpinAPI
+{
+	// -----------------------------------------------------
+	// Block structure
+	// -----------------------------------------------------
+	// Finds the connected components of the sparsity pattern of the matrix (treating the pattern as symmetric), such that the matrix is block-diagonal
+	// after reordering the basis. _permutation lists the basis indices block by block, and block b consists of the entries _blockOffsets[b] to
+	// _blockOffsets[b+1]-1. The blocks are ordered by their first basis index, and the indices within each block are ascending.
+	bool SpinSpace::BlockStructure(const arma::sp_cx_mat &_A, arma::uvec &_permutation, std::vector<arma::uword> &_blockOffsets) const
+	{
+		if (!_A.is_square())
+			return false;
+
+		// Union-find on the basis indices, where the root of each component is its smallest index
+		arma::uword n = _A.n_rows;
+		std::vector<arma::uword> parent(n);
+		for (arma::uword k = 0; k < n; k++)
+			parent[k] = k;
+
+		auto find = [&parent](arma::uword _k) -> arma::uword {
+			while (parent[_k] != _k)
+			{
+				parent[_k] = parent[parent[_k]];
+				_k = parent[_k];
+			}
+			return _k;
+		};
+
+		for (auto i = _A.begin(); i != _A.end(); ++i)
+		{
+			arma::uword a = find(i.row());
+			arma::uword b = find(i.col());
+			if (a < b)
+				parent[b] = a;
+			else if (b < a)
+				parent[a] = b;
+		}
+
+		// Number the blocks in the order of their smallest index
+		std::vector<arma::uword> block(n);
+		std::vector<arma::uword> sizes;
+		for (arma::uword k = 0; k < n; k++)
+		{
+			arma::uword root = find(k);
+			if (root == k)
+			{
+				block[k] = sizes.size();
+				sizes.push_back(0);
+			}
+			else
+			{
+				block[k] = block[root];
+			}
+			sizes[block[k]]++;
+		}
+
+		_blockOffsets.assign(sizes.size() + 1, 0);
+		for (unsigned int b = 0; b < sizes.size(); b++)
+			_blockOffsets[b + 1] = _blockOffsets[b] + sizes[b];
+
+		// Collect the indices, which keeps them ascending within each block
+		std::vector<arma::uword> next(_blockOffsets.begin(), _blockOffsets.end() - 1);
+		_permutation.set_size(n);
+		for (arma::uword k = 0; k < n; k++)
+			_permutation(next[block[k]]++) = k;
+
+		return true;
+	}
+
+	// Reorders the basis so that the blocks are contiguous, and extracts each block as a dense matrix
+	bool SpinSpace::BlockMatrices(const arma::sp_cx_mat &_A, const arma::uvec &_permutation, const std::vector<arma::uword> &_blockOffsets, std::vector<arma::cx_mat> &_blocks) const
+	{
+		if (!_A.is_square() || _permutation.n_elem != _A.n_rows || _blockOffsets.size() < 1 || _blockOffsets.back() != _A.n_rows)
+			return false;
+
+		arma::uvec inverse(_permutation.n_elem);
+		inverse(_permutation) = arma::regspace<arma::uvec>(0, _permutation.n_elem - 1);
+		arma::umat locations(2, _A.n_nonzero);
+		arma::cx_vec values(_A.n_nonzero);
+		arma::uword k = 0;
+		for (auto i = _A.begin(); i != _A.end(); ++i, ++k)
+		{
+			locations(0, k) = inverse(i.row());
+			locations(1, k) = inverse(i.col());
+			values(k) = (*i);
+		}
+		arma::sp_cx_mat reordered(locations, values, _A.n_rows, _A.n_cols);
+
+		_blocks.resize(_blockOffsets.size() - 1);
+		for (unsigned int b = 0; b + 1 < _blockOffsets.size(); b++)
+			_blocks[b] = arma::cx_mat(reordered.submat(_blockOffsets[b], _blockOffsets[b], _blockOffsets[b + 1] - 1, _blockOffsets[b + 1] - 1));
+
+		return true;
+	}
+
+	// Diagonalizes a Hermitian matrix block by block, running the blocks in parallel. The result is the same as that of arma::eig_sym,
+	// i.e. the eigenvalues are in ascending order, but each eigenvector only has non-zero elements within its own block.
+	bool SpinSpace::BlockEigenDecomposition(const arma::sp_cx_mat &_H, arma::vec &_eigenvalues, arma::cx_mat &_eigenvectors) const
+	{
+		arma::uvec permutation;
+		std::vector<arma::uword> offsets;
+		if (!this->BlockStructure(_H, permutation, offsets))
+			return false;
+
+		// Nothing to gain from a single block
+		unsigned int blocks = offsets.size() - 1;
+		if (blocks < 2)
+			return arma::eig_sym(_eigenvalues, _eigenvectors, arma::cx_mat(_H));
+
+		// Extract the blocks as dense matrices before the parallel part
+		std::vector<arma::cx_mat> matrices;
+		if (!this->BlockMatrices(_H, permutation, offsets, matrices))
+			return false;
+
+		arma::vec eigenvalues(_H.n_rows);
+		arma::cx_mat eigenvectors = arma::zeros<arma::cx_mat>(_H.n_rows, _H.n_cols);
+		std::vector<char> diagonalized(blocks, 0);
+
+#pragma omp parallel for schedule(dynamic)
+		for (unsigned int b = 0; b < blocks; b++)
+		{
+			arma::vec lambda;
+			arma::cx_mat V;
+			if (!arma::eig_sym(lambda, V, matrices[b]))
+				continue;
+
+			// Each block writes to its own rows and columns, so no synchronization is needed
+			arma::uvec indices = permutation.subvec(offsets[b], offsets[b + 1] - 1);
+			eigenvalues.subvec(offsets[b], offsets[b + 1] - 1) = lambda;
+			eigenvectors.submat(indices, arma::regspace<arma::uvec>(offsets[b], offsets[b + 1] - 1)) = V;
+			diagonalized[b] = 1;
+		}
+
+		for (auto i = diagonalized.cbegin(); i != diagonalized.cend(); i++)
+			if (!(*i))
+				return false;
+
+		// Sort the eigenpairs as eig_sym would
+		arma::uvec order = arma::stable_sort_index(eigenvalues);
+		_eigenvalues = eigenvalues(order);
+		_eigenvectors = eigenvectors.cols(order);
+
+		return true;
+	}
+
+	// Dense version, the block structure is found from the non-zero elements
+	bool SpinSpace::BlockEigenDecomposition(const arma::cx_mat &_H, arma::vec &_eigenvalues, arma::cx_mat &_eigenvectors) const
+	{
+		return this->BlockEigenDecomposition(arma::sp_cx_mat(_H), _eigenvalues, _eigenvectors);
+	}
+
+	// Eigenvalues without eigenvectors, which lets LAPACK skip the back-transformation of the tridiagonal problem
+	bool SpinSpace::BlockEigenvalues(const arma::sp_cx_mat &_H, arma::vec &_eigenvalues) const
+	{
+		arma::uvec permutation;
+		std::vector<arma::uword> offsets;
+		if (!this->BlockStructure(_H, permutation, offsets))
+			return false;
+
+		unsigned int blocks = offsets.size() - 1;
+		if (blocks < 2)
+			return arma::eig_sym(_eigenvalues, arma::cx_mat(_H));
+
+		std::vector<arma::cx_mat> matrices;
+		if (!this->BlockMatrices(_H, permutation, offsets, matrices))
+			return false;
+
+		arma::vec eigenvalues(_H.n_rows);
+		std::vector<char> diagonalized(blocks, 0);
+
+#pragma omp parallel for schedule(dynamic)
+		for (unsigned int b = 0; b < blocks; b++)
+		{
+			arma::vec lambda;
+			if (!arma::eig_sym(lambda, matrices[b]))
+				continue;
+
+			eigenvalues.subvec(offsets[b], offsets[b + 1] - 1) = lambda;
+			diagonalized[b] = 1;
+		}
+
+		for (auto i = diagonalized.cbegin(); i != diagonalized.cend(); i++)
+			if (!(*i))
+				return false;
+
+		_eigenvalues = arma::sort(eigenvalues);
+		return true;
+	}
+	// -----------------------------------------------------
+	// Block-wise solves and propagators
+	// -----------------------------------------------------
+	// Solves _A * _X = _B block by block, where the blocks are those of BlockStructure and are solved in parallel. The result is the same as that
+	// of arma::solve, but a Liouvillian with a conserved quantity costs the sum of the cubes of the block dimensions rather than the cube of the total.
+	bool SpinSpace::BlockSolve(const arma::sp_cx_mat &_A, const arma::cx_mat &_B, arma::cx_mat &_X) const
+	{
+		if (_B.n_rows != _A.n_rows)
+			return false;
+
+		arma::uvec permutation;
+		std::vector<arma::uword> offsets;
+		if (!this->BlockStructure(_A, permutation, offsets))
+			return false;
+
+		unsigned int blocks = offsets.size() - 1;
+		if (blocks < 2)
+			return arma::solve(_X, arma::cx_mat(_A), _B);
+
+		std::vector<arma::cx_mat> matrices;
+		if (!this->BlockMatrices(_A, permutation, offsets, matrices))
+			return false;
+
+		arma::cx_mat X(_B.n_rows, _B.n_cols);
+		std::vector<char> solved(blocks, 0);
+
+#pragma omp parallel for schedule(dynamic)
+		for (unsigned int b = 0; b < blocks; b++)
+		{
+			// Each block reads and writes its own rows only
+			arma::uvec indices = permutation.subvec(offsets[b], offsets[b + 1] - 1);
+			arma::cx_mat Xb;
+			if (!arma::solve(Xb, matrices[b], arma::cx_mat(_B.rows(indices))))
+				continue;
+
+			X.rows(indices) = Xb;
+			solved[b] = 1;
+		}
+
+		for (auto i = solved.cbegin(); i != solved.cend(); i++)
+			if (!(*i))
+				return false;
+
+		_X = X;
+		return true;
+	}
+
+	// Sets _U = exp(_factor * _A) by exponentiating each block of BlockStructure in parallel. The elements between different blocks are zero,
+	// so the result is the same as that of arma::expmat for the full matrix, which is used directly if there is only one block.
+	bool SpinSpace::BlockExponential(const arma::sp_cx_mat &_A, const arma::cx_double &_factor, arma::cx_mat &_U) const
+	{
+		arma::uvec permutation;
+		std::vector<arma::uword> offsets;
+		if (!this->BlockStructure(_A, permutation, offsets))
+			return false;
+
+		unsigned int blocks = offsets.size() - 1;
+		if (blocks < 2)
+			return arma::expmat(_U, arma::cx_mat(_A) * _factor);
+
+		std::vector<arma::cx_mat> matrices;
+		if (!this->BlockMatrices(_A, permutation, offsets, matrices))
+			return false;
+
+		arma::cx_mat U = arma::zeros<arma::cx_mat>(_A.n_rows, _A.n_cols);
+		std::vector<char> exponentiated(blocks, 0);
+
+#pragma omp parallel for schedule(dynamic)
+		for (unsigned int b = 0; b < blocks; b++)
+		{
+			arma::uvec indices = permutation.subvec(offsets[b], offsets[b + 1] - 1);
+			arma::cx_mat Ub;
+			if (!arma::expmat(Ub, matrices[b] * _factor))
+				continue;
+
+			U.submat(indices, indices) = Ub;
+			exponentiated[b] = 1;
+		}
+
+		for (auto i = exponentiated.cbegin(); i != exponentiated.cend(); i++)
+			if (!(*i))
+				return false;
+
+		_U = U;
+		return true;
+	}
+	// -----------------------------------------------------
+	// Partial spectra
+	// -----------------------------------------------------
+	// Finds the _k lowest or highest eigenpairs of a Hermitian matrix with a restarted block Krylov method: a block of vectors is extended by
+	// repeated products with _H, and the Rayleigh-Ritz procedure on the resulting subspace gives the next block. If _eigenvectors holds _k vectors
+	// of the right dimension on input, e.g. the eigenvectors at a nearby time or field, they are used in the starting block together with the
+	// fixed starting vectors. The guess alone only spans the symmetry sectors of its own levels, so levels of other sectors that cross into the
+	// wanted part of the spectrum would never be found. The eigenvalues are in ascending order as for arma::eig_sym, and the method fails if the
+	// residuals are not below _tolerance relative to the spectral radius.
+	bool SpinSpace::PartialEigenDecomposition(const arma::sp_cx_mat &_H, unsigned int _k, bool _lowest, arma::vec &_eigenvalues, arma::cx_mat &_eigenvectors, double _tolerance) const
+	{
+		if (!_H.is_square() || _k < 1 || _k > _H.n_rows)
+			return false;
+
+		// Small problems, or a large part of the spectrum, are solved densely
+		arma::uword n = _H.n_rows;
+		unsigned int blocks = std::max(3u, (30 + _k - 1) / _k);
+		if (2 * _k * blocks >= n)
+		{
+			arma::vec lambda;
+			arma::cx_mat V;
+			if (!arma::eig_sym(lambda, V, arma::cx_mat(_H)))
+				return false;
+
+			_eigenvalues = _lowest ? arma::vec(lambda.head(_k)) : arma::vec(lambda.tail(_k));
+			_eigenvectors = _lowest ? arma::cx_mat(V.head_cols(_k)) : arma::cx_mat(V.tail_cols(_k));
+			return true;
+		}
+
+		// The fixed starting vectors make the results reproducible, and a guess doubles the width of the block
+		bool guess = (_eigenvectors.n_rows == n && _eigenvectors.n_cols == _k);
+		const unsigned int width = guess ? 2 * _k : _k;
+		arma::cx_mat X(n, width);
+		for (arma::uword r = 0; r < n; r++)
+			for (unsigned int c = 0; c < _k; c++)
+				X(r, c) = arma::cx_double(std::sin(1.0 + r + 7.0 * c), 0.5 * std::cos(3.0 * r - c));
+		if (guess)
+			X.tail_cols(_k) = _eigenvectors;
+
+		arma::cx_mat Q;
+		arma::cx_mat R;
+		if (!arma::qr_econ(Q, R, X))
+			return false;
+
+		for (unsigned int iteration = 0; iteration < 1000; iteration++)
+		{
+			// Extend the block by products with _H, orthogonalizing each new block against the previous ones
+			arma::cx_mat S(n, width * blocks);
+			S.head_cols(width) = Q;
+			for (unsigned int b = 1; b < blocks; b++)
+			{
+				arma::cx_mat W = _H * S.cols((b - 1) * width, b * width - 1);
+				W -= S.head_cols(b * width) * (S.head_cols(b * width).t() * W);
+				W -= S.head_cols(b * width) * (S.head_cols(b * width).t() * W);
+				if (!arma::qr_econ(Q, R, W))
+					return false;
+				S.cols(b * width, (b + 1) * width - 1) = Q;
+			}
+
+			// Directions lost to an invariant subspace are removed, such that the basis is orthonormal
+			S = arma::orth(S);
+			if (S.n_cols < width)
+				return false;
+
+			// Rayleigh-Ritz on the subspace, keeping as many Ritz vectors as the width of the block for the next iteration
+			arma::cx_mat HS = _H * S;
+			arma::cx_mat T = S.t() * HS;
+			arma::vec theta;
+			arma::cx_mat Y;
+			if (!arma::eig_sym(theta, Y, arma::cx_mat(0.5 * (T + T.t()))))
+				return false;
+
+			arma::uvec kept = _lowest ? arma::regspace<arma::uvec>(0, width - 1) : arma::regspace<arma::uvec>(theta.n_elem - width, theta.n_elem - 1);
+			arma::uvec wanted = _lowest ? arma::uvec(kept.head(_k)) : arma::uvec(kept.tail(_k));
+			Q = S * Y.cols(kept);
+			arma::cx_mat V = S * Y.cols(wanted);
+			arma::vec lambda = theta(wanted);
+
+			// Converged when all residuals of the wanted levels are small compared to the largest Ritz value
+			arma::cx_mat residual = HS * Y.cols(wanted) - V * arma::diagmat(lambda);
+			double scale = std::max(arma::abs(theta).max(), 1e-300);
+			bool converged = true;
+			for (unsigned int c = 0; c < _k && converged; c++)
+				converged = (arma::norm(residual.col(c)) <= _tolerance * scale);
+
+			if (converged)
+			{
+				_eigenvalues = lambda;
+				_eigenvectors = V;
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
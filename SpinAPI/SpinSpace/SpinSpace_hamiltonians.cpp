@@ -43,9 +43,9 @@ namespace SpinAPI
 			{
 				if (_interaction->IgnoreTensors())
 				{
-					this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-					this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-					this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+					this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+					this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+					this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 				}
 				else
 				{
@@ -88,12 +88,12 @@ namespace SpinAPI
 					// Obtain the magnetic moment operators within the Hilbert space
 					if (_interaction->IgnoreTensors())
 					{
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), S1x);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), S1y);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), S1z);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sx()), (*j), S2x);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sy()), (*j), S2y);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sz()), (*j), S2z);
+						this->CreateOperator(SpinOperatorType::Sx, (*i), S1x);
+						this->CreateOperator(SpinOperatorType::Sy, (*i), S1y);
+						this->CreateOperator(SpinOperatorType::Sz, (*i), S1z);
+						this->CreateOperator(SpinOperatorType::Sx, (*j), S2x);
+						this->CreateOperator(SpinOperatorType::Sy, (*j), S2y);
+						this->CreateOperator(SpinOperatorType::Sz, (*j), S2z);
 					}
 					else
 					{
@@ -141,12 +141,12 @@ namespace SpinAPI
 					// Obtain the magnetic moment operators within the Hilbert space
 					if (_interaction->IgnoreTensors())
 					{
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), S1x);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), S1y);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), S1z);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sx()), (*j), S2x);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sy()), (*j), S2y);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sz()), (*j), S2z);
+						this->CreateOperator(SpinOperatorType::Sx, (*i), S1x);
+						this->CreateOperator(SpinOperatorType::Sy, (*i), S1y);
+						this->CreateOperator(SpinOperatorType::Sz, (*i), S1z);
+						this->CreateOperator(SpinOperatorType::Sx, (*j), S2x);
+						this->CreateOperator(SpinOperatorType::Sy, (*j), S2y);
+						this->CreateOperator(SpinOperatorType::Sz, (*j), S2z);
 					}
 					else
 					{
@@ -196,9 +196,9 @@ namespace SpinAPI
 				// Obtain the magnetic moment operators within the Hilbert space
 				if (_interaction->IgnoreTensors())
 				{
-					this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-					this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-					this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+					this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+					this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+					this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 				}
 				else
 				{
@@ -291,9 +291,9 @@ namespace SpinAPI
 			{
 				if (_interaction->IgnoreTensors())
 				{
-					this->CreateOperator((*i)->Sx(), (*i), Sx);
-					this->CreateOperator((*i)->Sy(), (*i), Sy);
-					this->CreateOperator((*i)->Sz(), (*i), Sz);
+					this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+					this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+					this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 				}
 				else
 				{
@@ -337,12 +337,12 @@ namespace SpinAPI
 					if (_interaction->IgnoreTensors())
 					{
 
-						this->CreateOperator((*i)->Sx(), (*i), S1x);
-						this->CreateOperator((*i)->Sy(), (*i), S1y);
-						this->CreateOperator((*i)->Sz(), (*i), S1z);
-						this->CreateOperator((*j)->Sx(), (*j), S2x);
-						this->CreateOperator((*j)->Sy(), (*j), S2y);
-						this->CreateOperator((*j)->Sz(), (*j), S2z);
+						this->CreateOperator(SpinOperatorType::Sx, (*i), S1x);
+						this->CreateOperator(SpinOperatorType::Sy, (*i), S1y);
+						this->CreateOperator(SpinOperatorType::Sz, (*i), S1z);
+						this->CreateOperator(SpinOperatorType::Sx, (*j), S2x);
+						this->CreateOperator(SpinOperatorType::Sy, (*j), S2y);
+						this->CreateOperator(SpinOperatorType::Sz, (*j), S2z);
 					}
 					else
 					{
@@ -391,12 +391,12 @@ namespace SpinAPI
 					// Obtain the magnetic moment operators within the Hilbert space
 					if (_interaction->IgnoreTensors())
 					{
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), S1x);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), S1y);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), S1z);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sx()), (*j), S2x);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sy()), (*j), S2y);
-						this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*j)->Sz()), (*j), S2z);
+						this->CreateOperator(SpinOperatorType::Sx, (*i), S1x);
+						this->CreateOperator(SpinOperatorType::Sy, (*i), S1y);
+						this->CreateOperator(SpinOperatorType::Sz, (*i), S1z);
+						this->CreateOperator(SpinOperatorType::Sx, (*j), S2x);
+						this->CreateOperator(SpinOperatorType::Sy, (*j), S2y);
+						this->CreateOperator(SpinOperatorType::Sz, (*j), S2z);
 					}
 					else
 					{
@@ -448,9 +448,9 @@ namespace SpinAPI
 				// Obtain the magnetic moment operators within the Hilbert space
 				if (_interaction->IgnoreTensors())
 				{
-					this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-					this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-					this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+					this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+					this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+					this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 				}
 				else
 				{
@@ -550,32 +550,17 @@ namespace SpinAPI
 	}
 
 	// Sets the sparse matrix to the Hamiltonian at the given time or trajectory step
+	// Only the interactions that changed since the last call are rebuilt, see AddInteractionOperator
 	bool SpinSpace::Hamiltonian(arma::sp_cx_mat &_out) const
 	{
-		// If we don't have any interactions, the Hamiltonian is zero
-		if (this->interactions.size() < 1)
-		{
-			_out = arma::sp_cx_mat(this->SpaceDimensions(), this->SpaceDimensions());
-			return true;
-		}
+		arma::sp_cx_mat result(this->SpaceDimensions(), this->SpaceDimensions());
 
-		// Get the first interaction contribution
-		auto i = this->interactions.cbegin();
-		arma::sp_cx_mat tmp;
-		arma::sp_cx_mat result;
-		if (!this->InteractionOperator((*i), result))
-			return false;
-
-		// We have already used the first interaction
-		i++;
-
-		// Loop through the rest
-		for (; i != this->interactions.cend(); i++)
+		// Loop through the interactions, if there are none the Hamiltonian is zero
+		for (auto i = this->interactions.cbegin(); i != this->interactions.cend(); i++)
 		{
-			// Attempt to get the matrix representing the Interaction object in the spin space
-			if (!this->InteractionOperator((*i), tmp))
+			// Attempt to add the matrix representing the Interaction object in the spin space
+			if (!this->AddInteractionOperator((*i), result))
 				return false;
-			result += tmp;
 		}
 
 		_out = result;
@@ -622,18 +607,15 @@ namespace SpinAPI
 			return true;
 		}
 
-		arma::sp_cx_mat tmp;
 		for (auto i = this->interactions.cbegin(); i != this->interactions.cend(); i++)
 		{
 			// Skip any dynamic interactions (time-dependent or with a trajectory)
 			if (!IsStatic(*(*i)))
 				continue;
 
-			// Attempt to get the matrix representing the Interaction object in the spin space
-			if (!this->InteractionOperator((*i), tmp))
+			// Attempt to add the matrix representing the Interaction object in the spin space
+			if (!this->AddInteractionOperator((*i), result))
 				return false;
-
-			result += tmp;
 		}
 
 		_out = result;
@@ -680,21 +662,524 @@ namespace SpinAPI
 			return true;
 		}
 
-		arma::sp_cx_mat tmp;
 		for (auto i = this->interactions.cbegin(); i != this->interactions.cend(); i++)
 		{
 			// Skip static interactions
 			if (IsStatic(*(*i)))
 				continue;
 
-			// Attempt to get the matrix representing the Interaction object in the spin space
-			if (!this->InteractionOperator((*i), tmp))
+			// Attempt to add the matrix representing the Interaction object in the spin space
+			if (!this->AddInteractionOperator((*i), result))
 				return false;
-
-			result += tmp;
 		}
 
 		_out = result;
 		return true;
 	}
+
+	// -----------------------------------------------------
+	// Incremental assembly of the sparse Hamiltonian
+	// -----------------------------------------------------
+	// Returns the values that the operator of the interaction is created from, i.e. the field, the tensors and the prefactors.
+	// A sweep usually changes only a few of these between steps, e.g. the field of a single Zeeman interaction.
+	std::vector<double> SpinSpace::InteractionSignature(const interaction_ptr &_interaction) const
+	{
+		std::vector<double> signature;
+		signature.push_back(static_cast<double>(_interaction->Type()));
+		signature.push_back(_interaction->Prefactor());
+		signature.push_back(_interaction->AddCommonPrefactor() ? 1.0 : 0.0);
+		signature.push_back(_interaction->IgnoreTensors() ? 1.0 : 0.0);
+
+		if (_interaction->Type() == InteractionType::SingleSpin)
+		{
+			arma::vec field = _interaction->Field();
+			signature.insert(signature.end(), field.begin(), field.end());
+		}
+		else if (_interaction->Type() == InteractionType::Zfs)
+		{
+			signature.push_back(_interaction->Dvalue());
+			signature.push_back(_interaction->Evalue());
+		}
+
+		auto ATensor = _interaction->CouplingTensor();
+		if (ATensor != nullptr)
+		{
+			arma::mat A = ATensor->LabFrame();
+			signature.push_back(ATensor->Isotropic());
+			signature.insert(signature.end(), A.begin(), A.end());
+		}
+
+		// The magnetic moment operators depend on the tensors and quantization axes of the spins, unless the interaction ignores them
+		if (!_interaction->IgnoreTensors())
+		{
+			auto spins = _interaction->Group1();
+			auto spins2 = _interaction->Group2();
+			spins.insert(spins.end(), spins2.cbegin(), spins2.cend());
+			for (auto i = spins.cbegin(); i != spins.cend(); i++)
+			{
+				arma::mat M = this->MagneticMomentTensor(*i);
+				signature.insert(signature.end(), M.begin(), M.end());
+			}
+		}
+
+		return signature;
+	}
+
+	// Returns the values that describe the spin space as seen by the interaction, i.e. the dimensions of all spins and the positions of the interacting spins
+	std::vector<double> SpinSpace::InteractionLayout(const interaction_ptr &_interaction) const
+	{
+		std::vector<double> layout;
+		layout.push_back(this->useSuperspace ? 1.0 : 0.0);
+
+		for (auto i = this->spins.cbegin(); i != this->spins.cend(); i++)
+		{
+			layout.push_back(static_cast<double>((*i)->S()));
+			layout.push_back(static_cast<double>((*i)->Multiplicity()));
+			layout.push_back(static_cast<double>((*i)->Equivalent()));
+		}
+
+		auto spins = _interaction->Group1();
+		auto spins2 = _interaction->Group2();
+		spins.insert(spins.end(), spins2.cbegin(), spins2.cend());
+		for (auto i = spins.cbegin(); i != spins.cend(); i++)
+		{
+			auto j = std::find(this->spins.cbegin(), this->spins.cend(), (*i));
+			layout.push_back(static_cast<double>(j - this->spins.cbegin()));
+		}
+
+		return layout;
+	}
+
+	// Adds the sparse operator of the interaction to _result. The operator is cached on the Interaction object, such that it persists across
+	// the SpinSpace objects that the tasks create in each step. It is only created by InteractionOperator if the space or the signature changed.
+	bool SpinSpace::AddInteractionOperator(const interaction_ptr &_interaction, arma::sp_cx_mat &_result) const
+	{
+		if (_interaction == nullptr)
+			return false;
+
+		std::vector<double> layout = this->InteractionLayout(_interaction);
+		std::vector<double> signature = this->InteractionSignature(_interaction);
+		if (_interaction->AddCachedOperator(layout, signature, _result))
+			return true;
+
+		// The interaction is new, has changed or is used in another space
+		arma::sp_cx_mat op;
+		if (!this->InteractionOperator(_interaction, op))
+			return false;
+
+		_result += op;
+		_interaction->StoreCachedOperator(layout, signature, op);
+
+		return true;
+	}
+
+	// -----------------------------------------------------
+	// Affine decomposition of the dynamic Hamiltonian
+	// -----------------------------------------------------
+	// The operator of an interaction is linear in its field, tensor and prefactor, so the time-dependent part of the Hamiltonian can be written as
+	// sum_k c_k(t) * H_k, where the operators H_k only depend on the spins. For each dynamic interaction, InteractionTerms creates the operators H_k
+	// and InteractionCoefficients the current values of c_k, in the same order:
+	// - SingleSpin: H_a = sum_i S_ia, with c_a = (A * B)_a, i.e. three terms
+	// - DoubleSpin: H_ab = sum_ij S_ia * S_jb, with c_ab = A_ab, i.e. nine terms
+	// - Exchange: as DoubleSpin with a factor of 2, and a tenth term with the identity operator
+	// - Zfs: the operator itself, as only the prefactor can change
+	// A is the lab frame tensor, or the isotropic value times the identity matrix, and all coefficients include the prefactors.
+	// The magnetic moment operators T_i = M_i * S_i contain the tensors and quantization axes of the spins, which change with the
+	// trajectories of the spins. For such interactions, the terms use the plain spin operators of each spin (or pair of spins), and the
+	// tensors M_i are moved to the coefficients, e.g. H_iab = S_ia * S_jb with c_iab = (M_i^T * A * M_j)_ab for DoubleSpin.
+	// The Zfs operator is quadratic in T, so its terms are the nine products S_a * S_b and the remaining constant operator.
+	bool SpinSpace::InteractionTerms(const interaction_ptr &_interaction, std::vector<arma::sp_cx_mat> &_out) const
+	{
+		if (_interaction == nullptr)
+			return false;
+
+		std::vector<arma::sp_cx_mat> terms;
+		auto spins1 = _interaction->Group1();
+		auto spins2 = _interaction->Group2();
+		arma::sp_cx_mat S1[3];
+		arma::sp_cx_mat S2[3];
+
+		bool moving = this->HasMovingSpins(_interaction);
+
+		// Obtain the magnetic moment operators within the Hilbert space, or the spin operators if the tensors are in the coefficients
+		auto createOperators = [this, &_interaction, moving](const spin_ptr &_spin, arma::sp_cx_mat *_S) {
+			if (_interaction->IgnoreTensors() || moving)
+			{
+				this->CreateOperator(SpinOperatorType::Sx, _spin, _S[0]);
+				this->CreateOperator(SpinOperatorType::Sy, _spin, _S[1]);
+				this->CreateOperator(SpinOperatorType::Sz, _spin, _S[2]);
+			}
+			else
+			{
+				this->CreateOperator(_spin->Tx(), _spin, _S[0]);
+				this->CreateOperator(_spin->Ty(), _spin, _S[1]);
+				this->CreateOperator(_spin->Tz(), _spin, _S[2]);
+			}
+		};
+
+		if (_interaction->Type() == InteractionType::SingleSpin)
+		{
+			// Three terms for all spins together, or for each of the spins
+			terms.assign(moving ? 3 * spins1.size() : 3, arma::sp_cx_mat(this->HilbertSpaceDimensions(), this->HilbertSpaceDimensions()));
+			unsigned int offset = 0;
+			for (auto i = spins1.cbegin(); i != spins1.cend(); i++)
+			{
+				createOperators(*i, S1);
+				for (unsigned int a = 0; a < 3; a++)
+					terms[offset + a] += S1[a];
+
+				if (moving)
+					offset += 3;
+			}
+		}
+		else if (_interaction->Type() == InteractionType::DoubleSpin || _interaction->Type() == InteractionType::Exchange)
+		{
+			double factor = (_interaction->Type() == InteractionType::Exchange) ? 2.0 : 1.0;
+			// Nine terms for all pairs of spins together, or for each of the pairs
+			terms.assign(moving ? 9 * spins1.size() * spins2.size() : 9, arma::sp_cx_mat(this->HilbertSpaceDimensions(), this->HilbertSpaceDimensions()));
+			unsigned int offset = 0;
+			for (auto i = spins1.cbegin(); i != spins1.cend(); i++)
+			{
+				createOperators(*i, S1);
+				for (auto j = spins2.cbegin(); j != spins2.cend(); j++)
+				{
+					createOperators(*j, S2);
+					for (unsigned int a = 0; a < 3; a++)
+						for (unsigned int b = 0; b < 3; b++)
+							terms[offset + 3 * a + b] += factor * S1[a] * S2[b];
+
+					if (moving)
+						offset += 9;
+				}
+			}
+
+			// The exchange interaction adds half the identity for each pair of spins
+			if (_interaction->Type() == InteractionType::Exchange)
+				terms.push_back(0.5 * static_cast<double>(spins1.size() * spins2.size()) * arma::speye<arma::sp_cx_mat>(this->HilbertSpaceDimensions(), this->HilbertSpaceDimensions()));
+		}
+		else if (_interaction->Type() == InteractionType::Zfs)
+		{
+			arma::cx_double coefficient = this->InteractionPrefactor(_interaction);
+			if (coefficient == 0.0 || spins1.empty())
+				return false;
+
+			// Remove the prefactors from the current operator, which also takes care of the superspace
+			if (!moving)
+			{
+				arma::sp_cx_mat op;
+				if (!this->InteractionOperator(_interaction, op))
+					return false;
+
+				_out.push_back(op / coefficient);
+				return true;
+			}
+
+			// The products of the spin operators of the last spin, which is the one that InteractionOperator keeps
+			createOperators(spins1.back(), S1);
+			for (unsigned int a = 0; a < 3; a++)
+				for (unsigned int b = 0; b < 3; b++)
+					terms.push_back(S1[a] * S1[b]);
+		}
+		else
+		{
+			// The interaction type was not recognized
+			return false;
+		}
+
+		// Convert the operators to commutators in the superspace
+		unsigned int first = _out.size();
+		for (auto i = terms.cbegin(); i != terms.cend(); i++)
+		{
+			if (this->useSuperspace)
+			{
+				arma::sp_cx_mat lhs;
+				arma::sp_cx_mat rhs;
+				if (!this->SuperoperatorFromLeftOperator(*i, lhs) || !this->SuperoperatorFromRightOperator(*i, rhs))
+					return false;
+				_out.push_back(lhs - rhs);
+			}
+			else
+			{
+				_out.push_back(*i);
+			}
+		}
+
+		// The constant part of the Zfs operator is what remains after subtracting the products at the current time
+		if (_interaction->Type() == InteractionType::Zfs)
+		{
+			std::vector<arma::cx_double> coefficients;
+			if (!this->InteractionCoefficients(_interaction, coefficients) || coefficients.size() != 10)
+				return false;
+
+			arma::sp_cx_mat op;
+			if (!this->InteractionOperator(_interaction, op))
+				return false;
+
+			for (unsigned int k = 0; k < 9; k++)
+				op -= coefficients[k] * _out[first + k];
+			_out.push_back(op / coefficients[9]);
+		}
+
+		return true;
+	}
+
+	// The coefficients of the operators from InteractionTerms at the current time or trajectory step
+	bool SpinSpace::InteractionCoefficients(const interaction_ptr &_interaction, std::vector<arma::cx_double> &_out) const
+	{
+		if (_interaction == nullptr)
+			return false;
+
+		double prefactor = this->InteractionPrefactor(_interaction);
+
+		// The effective tensor, see InteractionOperator
+		arma::mat A = arma::eye<arma::mat>(3, 3);
+		auto ATensor = _interaction->CouplingTensor();
+		if (ATensor != nullptr && IsIsotropic(*ATensor))
+			A *= ATensor->Isotropic();
+		else if (ATensor != nullptr)
+			A = ATensor->LabFrame();
+
+		// The tensors of the spins are part of the coefficients if they follow a trajectory, see InteractionTerms
+		bool moving = this->HasMovingSpins(_interaction);
+		auto spins1 = _interaction->Group1();
+		auto spins2 = _interaction->Group2();
+
+		if (_interaction->Type() == InteractionType::SingleSpin)
+		{
+			arma::vec c = A * _interaction->Field();
+			if (!moving)
+			{
+				for (unsigned int a = 0; a < 3; a++)
+					_out.push_back(prefactor * c(a));
+			}
+			else
+			{
+				for (auto i = spins1.cbegin(); i != spins1.cend(); i++)
+				{
+					arma::vec ci = this->MagneticMomentTensor(*i).t() * c;
+					for (unsigned int a = 0; a < 3; a++)
+						_out.push_back(prefactor * ci(a));
+				}
+			}
+		}
+		else if (_interaction->Type() == InteractionType::DoubleSpin || _interaction->Type() == InteractionType::Exchange)
+		{
+			if (!moving)
+			{
+				for (unsigned int a = 0; a < 3; a++)
+					for (unsigned int b = 0; b < 3; b++)
+						_out.push_back(prefactor * A(a, b));
+			}
+			else
+			{
+				for (auto i = spins1.cbegin(); i != spins1.cend(); i++)
+				{
+					arma::mat M1A = this->MagneticMomentTensor(*i).t() * A;
+					for (auto j = spins2.cbegin(); j != spins2.cend(); j++)
+					{
+						arma::mat Aij = M1A * this->MagneticMomentTensor(*j);
+						for (unsigned int a = 0; a < 3; a++)
+							for (unsigned int b = 0; b < 3; b++)
+								_out.push_back(prefactor * Aij(a, b));
+					}
+				}
+			}
+
+			// Only an isotropic tensor scales the identity term
+			if (_interaction->Type() == InteractionType::Exchange)
+				_out.push_back((ATensor != nullptr && IsIsotropic(*ATensor)) ? prefactor * ATensor->Isotropic() : prefactor);
+		}
+		else if (_interaction->Type() == InteractionType::Zfs)
+		{
+			// D * Tz * Tz + E * (Tx * Tx - Ty * Ty) in terms of the products of the spin operators, followed by the constant operator
+			if (moving && !spins1.empty())
+			{
+				arma::mat M = this->MagneticMomentTensor(spins1.back());
+				double D = _interaction->Dvalue();
+				double E = _interaction->Evalue();
+				for (unsigned int a = 0; a < 3; a++)
+					for (unsigned int b = 0; b < 3; b++)
+						_out.push_back(prefactor * (D * M(2, a) * M(2, b) + E * (M(0, a) * M(0, b) - M(1, a) * M(1, b))));
+			}
+
+			_out.push_back(prefactor);
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	// The prefactor of the interaction together with the common prefactor, see InteractionOperator
+	double SpinSpace::InteractionPrefactor(const interaction_ptr &_interaction) const
+	{
+		double prefactor = _interaction->Prefactor();
+		if (_interaction->AddCommonPrefactor())
+			prefactor *= 8.794e+1;
+
+		return prefactor;
+	}
+
+	// Whether a spin of the interaction follows a trajectory, such that its magnetic moment operators change with time or trajectory step
+	bool SpinSpace::HasMovingSpins(const interaction_ptr &_interaction) const
+	{
+		if (_interaction->IgnoreTensors())
+			return false;
+
+		auto spins = _interaction->Group1();
+		auto spins2 = _interaction->Group2();
+		spins.insert(spins.end(), spins2.cbegin(), spins2.cend());
+		for (auto i = spins.cbegin(); i != spins.cend(); i++)
+			if (HasTrajectory(*(*i)))
+				return true;
+
+		return false;
+	}
+
+	// The matrix M such that (Tx, Ty, Tz) = M * (Sx, Sy, Sz) for the current tensor and quantization axes of the spin, see Spin::Tx
+	arma::mat SpinSpace::MagneticMomentTensor(const spin_ptr &_spin) const
+	{
+		arma::mat Q = arma::join_cols(arma::join_cols(_spin->QuantizationAxis1().t(), _spin->QuantizationAxis2().t()), _spin->QuantizationAxis3().t());
+
+		if (IsIsotropic(*_spin))
+			return _spin->GetTensor().Isotropic() * Q;
+
+		return _spin->GetTensor().LabFrame() * Q;
+	}
+
+	// Adds the operators H_k of all dynamic interactions as terms of the AffineOperator, which must have the dimensions of the space.
+	// The operators do not depend on time, so this is only needed once, and the dynamic Hamiltonian at a given time is then
+	// obtained by evaluating the AffineOperator with the coefficients from DynamicHamiltonianCoefficients.
+	bool SpinSpace::DynamicHamiltonianTerms(AffineOperator &_out) const
+	{
+		if (_out.Dimension() != this->SpaceDimensions())
+			return false;
+
+		std::vector<arma::sp_cx_mat> terms;
+		for (auto i = this->interactions.cbegin(); i != this->interactions.cend(); i++)
+		{
+			// Skip static interactions
+			if (IsStatic(*(*i)))
+				continue;
+
+			if (!this->InteractionTerms((*i), terms))
+				return false;
+		}
+
+		for (auto i = terms.cbegin(); i != terms.cend(); i++)
+			if (!_out.AddTerm(*i))
+				return false;
+
+		return true;
+	}
+
+	// Sets the vector to the coefficients of the terms from DynamicHamiltonianTerms at the current time or trajectory step
+	bool SpinSpace::DynamicHamiltonianCoefficients(arma::cx_vec &_out) const
+	{
+		std::vector<arma::cx_double> coefficients;
+		for (auto i = this->interactions.cbegin(); i != this->interactions.cend(); i++)
+		{
+			// Skip static interactions
+			if (IsStatic(*(*i)))
+				continue;
+
+			if (!this->InteractionCoefficients((*i), coefficients))
+				return false;
+		}
+
+		_out = arma::cx_vec(coefficients);
+		return true;
+	}
+
+	// -----------------------------------------------------
+	// Integrators for time-dependent Hamiltonians
+	// -----------------------------------------------------
+	// Sets the stages of a time step for the integrator. Stage s propagates with the Hamiltonian sum_j w(s,j) * H(t + c(j) * dt) / sum_j w(s,j)
+	// for the time sum_j w(s,j) * dt, where c are the nodes and w the weights, and the stages are applied in the order of the rows:
+	// - "piecewise": A single stage with the Hamiltonian at the start of the step, which is first order
+	// - "magnus4": The fourth order commutator-free Magnus integrator with two exponentials at the Gauss-Legendre nodes (Blanes and Moan, 2006)
+	bool SpinSpace::IntegratorStages(const std::string &_integrator, arma::vec &_nodes, arma::mat &_weights) const
+	{
+		if (_integrator.compare("piecewise") == 0)
+		{
+			_nodes = {0.0};
+			_weights = {{1.0}};
+		}
+		else if (_integrator.compare("magnus4") == 0)
+		{
+			double c = std::sqrt(3.0) / 6.0;
+			double a1 = (3.0 - 2.0 * std::sqrt(3.0)) / 12.0;
+			double a2 = (3.0 + 2.0 * std::sqrt(3.0)) / 12.0;
+			_nodes = {0.5 - c, 0.5 + c};
+			_weights = {{a2, a1}, {a1, a2}};
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	// Sets the Hamiltonians and durations of the stages of the time step from _time to _time + _timestep, see IntegratorStages.
+	// _H must have the terms from DynamicHamiltonianTerms, and its constant part is included in each stage.
+	// Since the Hamiltonian is affine in the coefficients, each stage only needs the weighted coefficients at the nodes.
+	// NOTE: This changes the time of the spinspace.
+	bool SpinSpace::StageHamiltonians(const AffineOperator &_H, const arma::vec &_nodes, const arma::mat &_weights, double _time, double _timestep, std::vector<arma::sp_cx_mat> &_hamiltonians, arma::vec &_durations)
+	{
+		if (_weights.n_cols != _nodes.n_elem)
+			return false;
+
+		arma::cx_mat coefficients(_H.Terms(), _nodes.n_elem);
+		arma::cx_vec c;
+		for (unsigned int j = 0; j < _nodes.n_elem; j++)
+		{
+			this->SetTime(_time + _nodes(j) * _timestep);
+			if (!this->DynamicHamiltonianCoefficients(c) || c.n_elem != _H.Terms())
+				return false;
+			coefficients.col(j) = c;
+		}
+
+		_hamiltonians.resize(_weights.n_rows);
+		_durations.set_size(_weights.n_rows);
+		for (unsigned int s = 0; s < _weights.n_rows; s++)
+		{
+			double total = arma::accu(_weights.row(s));
+			arma::vec w = _weights.row(s).t() / total;
+			_durations(s) = total * _timestep;
+			if (!_H.Evaluate(coefficients * arma::cx_vec(w, arma::zeros<arma::vec>(w.n_elem)), _hamiltonians[s]))
+				return false;
+		}
+
+		return true;
+	}
+
+	// Sets the time-dependent parts of the total reaction operator for the stages of the time step, which are averaged over the nodes
+	// with the same weights as the Hamiltonians from StageHamiltonians. The operators are zero if they could not be obtained.
+	// NOTE: This changes the time of the spinspace.
+	bool SpinSpace::StageReactionOperators(const arma::vec &_nodes, const arma::mat &_weights, double _time, double _timestep, std::vector<arma::sp_cx_mat> &_operators)
+	{
+		_operators.assign(_weights.n_rows, arma::sp_cx_mat(this->SpaceDimensions(), this->SpaceDimensions()));
+		if (_weights.n_cols != _nodes.n_elem)
+			return false;
+
+		std::vector<arma::sp_cx_mat> K(_nodes.n_elem);
+		for (unsigned int j = 0; j < _nodes.n_elem; j++)
+		{
+			this->SetTime(_time + _nodes(j) * _timestep);
+			if (!this->DynamicTotalReactionOperator(K[j]))
+				return false;
+		}
+
+		for (unsigned int s = 0; s < _weights.n_rows; s++)
+		{
+			double total = arma::accu(_weights.row(s));
+			for (unsigned int j = 0; j < _nodes.n_elem; j++)
+				_operators[s] += (_weights(s, j) / total) * K[j];
+		}
+
+		return true;
+	}
 }
@@ -21,6 +21,7 @@ namespace SpinAPI
 			return false;
 
 		this->spins.push_back(_spin);
+		this->operatorCache.clear();
 		return true;
 	}
 
@@ -42,6 +43,7 @@ namespace SpinAPI
 		if (tmpvec.size() > this->spins.size())
 		{
 			this->spins = tmpvec;
+			this->operatorCache.clear();
 			return true;
 		}
 
@@ -85,6 +87,7 @@ namespace SpinAPI
 		if (i != this->spins.cend())
 		{
 			this->spins.erase(i);
+			this->operatorCache.clear();
 			return true;
 		}
 
@@ -133,6 +136,7 @@ namespace SpinAPI
 	void SpinSpace::ClearSpins()
 	{
 		this->spins.clear();
+		this->operatorCache.clear();
 	}
 	// -----------------------------------------------------
 	// Spin Management: Contains-methods
@@ -104,6 +104,132 @@ namespace SpinAPI
 		return true;
 	}
 
+	// Create the embedded spin matrix of the given type. The sparse operator is cached, since the same operators are requested many times
+	// when the Hamiltonian and relaxation operators are set up, and is only created by CreateOperator the first time.
+	bool SpinSpace::CreateOperator(SpinOperatorType _type, const spin_ptr &_spin, arma::sp_cx_mat &_out) const
+	{
+		// Validate the input
+		if (_spin == nullptr)
+			return false;
+
+		// The identity for spins outside the space depends on whether the superspace is used, so it is not cached
+		if (!this->Contains(_spin))
+		{
+			_out = arma::speye<arma::sp_cx_mat>(this->SpaceDimensions(), this->SpaceDimensions());
+			return true;
+		}
+
+		auto key = std::make_pair(_spin, _type);
+		bool found = false;
+#pragma omp critical(spinspace_operatorcache)
+		{
+			auto i = this->operatorCache.find(key);
+			if (i != this->operatorCache.end())
+			{
+				_out = i->second;
+				found = true;
+			}
+		}
+
+		if (found)
+			return true;
+
+		// Get the single-spin matrix
+		arma::sp_cx_mat op;
+		switch (_type)
+		{
+		case SpinOperatorType::Sx:
+			op = _spin->Sx();
+			break;
+		case SpinOperatorType::Sy:
+			op = _spin->Sy();
+			break;
+		case SpinOperatorType::Sz:
+			op = _spin->Sz();
+			break;
+		case SpinOperatorType::Sp:
+			op = _spin->Sp();
+			break;
+		case SpinOperatorType::Sm:
+			op = _spin->Sm();
+			break;
+		}
+
+		if (!this->CreateOperator(op, _spin, _out))
+			return false;
+
+#pragma omp critical(spinspace_operatorcache)
+		this->operatorCache[key] = _out;
+
+		return true;
+	}
+
+	// Dense version of the cached spin matrices, only the sparse operator is kept in the cache
+	bool SpinSpace::CreateOperator(SpinOperatorType _type, const spin_ptr &_spin, arma::cx_mat &_out) const
+	{
+		arma::sp_cx_mat tmp;
+		if (!this->CreateOperator(_type, _spin, tmp))
+			return false;
+
+		_out = arma::conv_to<arma::cx_mat>::from(tmp);
+		return true;
+	}
+
+	// Creates an embedded operator that is applied without forming the full matrix, see KroneckerOperator
+	bool SpinSpace::CreateKroneckerOperator(const arma::cx_mat &_operator, const spin_ptr &_spin, KroneckerOperator &_out) const
+	{
+		// Validate the input
+		if (_spin == nullptr)
+			return false;
+
+		// Check that the given operator is valid
+		if (_operator.n_rows != static_cast<unsigned int>(_spin->Multiplicity()) || _operator.n_cols != static_cast<unsigned int>(_spin->Multiplicity()))
+			return false;
+
+		// The Kronecker structure is only defined for spins in the space
+		if (!this->Contains(_spin))
+			return false;
+
+		// Get the dimensions of the spins before and after the given spin
+		unsigned int left = 1;
+		unsigned int right = 1;
+		bool after = false;
+		for (auto i = this->spins.cbegin(); i != this->spins.cend(); i++)
+		{
+			if ((*i) == _spin)
+				after = true;
+			else if (after)
+				right *= static_cast<unsigned int>((*i)->Multiplicity());
+			else
+				left *= static_cast<unsigned int>((*i)->Multiplicity());
+		}
+
+		_out = KroneckerOperator(_operator, left, right);
+		return true;
+	}
+
+	bool SpinSpace::CreateKroneckerOperator(SpinOperatorType _type, const spin_ptr &_spin, KroneckerOperator &_out) const
+	{
+		if (_spin == nullptr)
+			return false;
+
+		switch (_type)
+		{
+		case SpinOperatorType::Sx:
+			return this->CreateKroneckerOperator(arma::conv_to<arma::cx_mat>::from(_spin->Sx()), _spin, _out);
+		case SpinOperatorType::Sy:
+			return this->CreateKroneckerOperator(arma::conv_to<arma::cx_mat>::from(_spin->Sy()), _spin, _out);
+		case SpinOperatorType::Sz:
+			return this->CreateKroneckerOperator(arma::conv_to<arma::cx_mat>::from(_spin->Sz()), _spin, _out);
+		case SpinOperatorType::Sp:
+			return this->CreateKroneckerOperator(arma::conv_to<arma::cx_mat>::from(_spin->Sp()), _spin, _out);
+		case SpinOperatorType::Sm:
+			return this->CreateKroneckerOperator(arma::conv_to<arma::cx_mat>::from(_spin->Sm()), _spin, _out);
+		}
+
+		return false;
+	}
+
 	// Converts an operator to a superspace-vector
 	bool SpinSpace::OperatorToSuperspace(const arma::cx_mat &_in, arma::cx_vec &_out) const // TODO: Check matrix dimensions
 	{
@@ -362,7 +488,7 @@ namespace SpinAPI
 		arma::cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -383,7 +509,7 @@ namespace SpinAPI
 		arma::cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -405,7 +531,7 @@ namespace SpinAPI
 		arma::cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -428,7 +554,7 @@ namespace SpinAPI
 		arma::cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -446,7 +572,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -464,7 +590,7 @@ namespace SpinAPI
 		arma::cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -484,7 +610,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -503,7 +629,7 @@ namespace SpinAPI
 		arma::cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -522,7 +648,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -541,7 +667,7 @@ namespace SpinAPI
 		arma::cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -560,7 +686,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -579,7 +705,7 @@ namespace SpinAPI
 		arma::cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -598,7 +724,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -617,7 +743,7 @@ namespace SpinAPI
 		arma::cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -636,7 +762,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S1z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z))
 		{
 			return false;
 		}
@@ -662,7 +788,7 @@ namespace SpinAPI
 		arma::cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -683,7 +809,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -704,7 +830,7 @@ namespace SpinAPI
 		arma::cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -726,7 +852,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -748,7 +874,7 @@ namespace SpinAPI
 		arma::cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -770,7 +896,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -792,7 +918,7 @@ namespace SpinAPI
 		arma::cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -814,7 +940,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -836,7 +962,7 @@ namespace SpinAPI
 		arma::cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -858,7 +984,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -880,7 +1006,7 @@ namespace SpinAPI
 		arma::cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -902,7 +1028,7 @@ namespace SpinAPI
 		arma::sp_cx_mat S2z;
 
 		// We need all of these operators
-		if (!this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sx()), _spin1, S1x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sy()), _spin1, S1y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin1->Sz()), _spin1, S1z) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sx()), _spin2, S2x) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sy()), _spin2, S2y) || !this->CreateOperator(arma::conv_to<arma::sp_cx_mat>::from(_spin2->Sz()), _spin2, S2z))
+		if (!this->CreateOperator(SpinOperatorType::Sx, _spin1, S1x) || !this->CreateOperator(SpinOperatorType::Sy, _spin1, S1y) || !this->CreateOperator(SpinOperatorType::Sz, _spin1, S1z) || !this->CreateOperator(SpinOperatorType::Sx, _spin2, S2x) || !this->CreateOperator(SpinOperatorType::Sy, _spin2, S2y) || !this->CreateOperator(SpinOperatorType::Sz, _spin2, S2z))
 		{
 			return false;
 		}
@@ -928,7 +1054,8 @@ namespace SpinAPI
 		return state;
 	}
 	// Creates a Coherent spin state
-	arma::cx_colvec SpinSpace::CoherentState(std::vector<SpinAPI::system_ptr>::const_iterator i, std::mt19937 &generator)
+	// Returns false for groups of equivalent spins, as the coherent state of a single spin is not defined in their basis of total spins
+	bool SpinSpace::CoherentState(std::vector<SpinAPI::system_ptr>::const_iterator i, std::mt19937 &generator, arma::cx_colvec &_state)
 	{
 		arma::cx_colvec coherentstate(1);
 		coherentstate(0, 0) = 1;
@@ -941,6 +1068,9 @@ namespace SpinAPI
 			(*l)->Properties()->Get("type", spintype);
 			if (spintype != "electron")
 			{
+				if ((*l)->Equivalent() > 1)
+					return false;
+
 				double theta = M_PI * distr(generator);
 				double phi = M_PI * distr(generator);
 				arma::cx_colvec tempstate;
@@ -953,7 +1083,8 @@ namespace SpinAPI
 			}
 		}
 
-		return coherentstate;
+		_state = coherentstate;
+		return true;
 	}
 
 	arma::cx_mat SpinSpace::HighamProp(arma::sp_cx_mat &H, arma::cx_mat &B, const std::complex<double> t, const std::string precision, arma::mat &M)
@@ -1293,4 +1424,225 @@ namespace SpinAPI
 		}
 	}
 
+	// Returns the action of the matrix exponential of sparse general complex matrix H onto each column of complex matrix B, with krylov subspace dimension of KryDim.
+	// The columns are propagated together, such that each Krylov iteration only needs a single sparse matrix times dense block product.
+	arma::cx_mat SpinSpace::KrylovExpmGeneralBlock(const arma::sp_cx_mat &H, const arma::cx_mat &B, const arma::cx_double dt, int KryDim, int HilbSize)
+	{
+		std::vector<arma::cx_mat> KryBasis; // Orthogonal krylov subspaces, one matrix per iteration with one column per column of B
+		arma::cx_cube Hessen;				// Upper Hessenberg matrices, one slice per column of B
+		arma::vec h_mplusone_m;
+
+		// Compute upper Hessenberg matrices and krylov bases using the Arnoldi process
+		ArnoldiProcessBlock(H, B, KryBasis, Hessen, KryDim, h_mplusone_m);
+
+		// Compute the matrix exponential action
+		return KrylovBlockCombine(B, KryBasis, Hessen, dt, HilbSize);
+	}
+
+	// Returns the action of the matrix exponential of sparse symmetric complex matrix H onto each column of complex matrix B, with krylov subspace dimension of KryDim.
+	arma::cx_mat SpinSpace::KrylovExpmSymmBlock(const arma::sp_cx_mat &H, const arma::cx_mat &B, const arma::cx_double dt, int KryDim, int HilbSize)
+	{
+		std::vector<arma::cx_mat> KryBasis;
+		arma::cx_cube Hessen;
+		arma::vec h_mplusone_m;
+
+		// Compute upper Hessenberg matrices and krylov bases using the Lanczos process
+		LanczosProcessBlock(H, B, KryBasis, Hessen, KryDim, h_mplusone_m);
+
+		// Compute the matrix exponential action
+		return KrylovBlockCombine(B, KryBasis, Hessen, dt, HilbSize);
+	}
+
+	// Compute the Arnoldi process for each column of B independently, but with the products of H with the current basis vectors of all columns done at once.
+	// The first basis vectors are set from the normalised columns of B, and the basis of a column is no longer extended after a breakdown.
+	void SpinSpace::ArnoldiProcessBlock(const arma::sp_cx_mat &H, const arma::cx_mat &B, std::vector<arma::cx_mat> &KryBasis, arma::cx_cube &Hessen, int KryDim, arma::vec &h_mplusone_m)
+	{
+		KrylovBlockInitialize(B, KryBasis, Hessen, KryDim, h_mplusone_m);
+
+		// Perform the Arnoldi process for KryDim iterations
+		for (int it1 = 0; it1 < KryDim; it1++)
+		{
+			// Compute the sparse matrix times dense block product
+			arma::cx_mat z = H * KryBasis[it1];
+
+			// Compute the elements of the Hessenberg matrices
+			for (int it2 = 0; it2 < it1 + 1; it2++)
+			{
+				arma::cx_rowvec h = arma::sum(arma::conj(KryBasis[it2]) % z, 0);
+				z -= KryBasis[it2].each_row() % h;
+				for (unsigned int col = 0; col < h.n_elem; col++)
+					Hessen(it2, it1, col) = h(col);
+			}
+
+			// Compute the next columns of the Krylov bases
+			KrylovBlockExtend(z, KryBasis, Hessen, it1, KryDim, h_mplusone_m);
+		}
+	}
+
+	// Compute the Lanczos process for each column of B independently, but with the products of H with the current basis vectors of all columns done at once.
+	void SpinSpace::LanczosProcessBlock(const arma::sp_cx_mat &H, const arma::cx_mat &B, std::vector<arma::cx_mat> &KryBasis, arma::cx_cube &Hessen, int KryDim, arma::vec &h_mplusone_m)
+	{
+		KrylovBlockInitialize(B, KryBasis, Hessen, KryDim, h_mplusone_m);
+
+		// Perform the Lanczos process for KryDim iterations.
+		for (int it1 = 0; it1 < KryDim; it1++)
+		{
+			// Compute the sparse matrix times dense block product
+			arma::cx_mat z = H * KryBasis[it1];
+
+			// Compute the elements of the Hessenberg matrices, only the two latest basis vectors are needed
+			for (int it2 = std::max(it1 - 1, 0); it2 < it1 + 1; it2++)
+			{
+				arma::cx_rowvec h = arma::sum(arma::conj(KryBasis[it2]) % z, 0);
+				z -= KryBasis[it2].each_row() % h;
+				for (unsigned int col = 0; col < h.n_elem; col++)
+					Hessen(it2, it1, col) = h(col);
+			}
+
+			// Compute the next columns of the Krylov bases
+			KrylovBlockExtend(z, KryBasis, Hessen, it1, KryDim, h_mplusone_m);
+		}
+	}
+
+	// Sets up the workspace of the block Arnoldi and Lanczos processes
+	void SpinSpace::KrylovBlockInitialize(const arma::cx_mat &B, std::vector<arma::cx_mat> &KryBasis, arma::cx_cube &Hessen, int KryDim, arma::vec &h_mplusone_m) const
+	{
+		KryBasis.assign(KryDim, arma::cx_mat(B.n_rows, B.n_cols, arma::fill::zeros));
+		Hessen.zeros(KryDim, KryDim, B.n_cols);
+		h_mplusone_m.zeros(B.n_cols);
+
+		// Columns with a vanishing norm keep a zero basis, and are propagated to zero
+		for (unsigned int col = 0; col < B.n_cols; col++)
+		{
+			double bnorm = arma::norm(B.col(col));
+			if (bnorm > 0.0)
+				KryBasis[0].col(col) = B.col(col) / bnorm;
+		}
+	}
+
+	// Normalises the orthogonalised block z into the next basis vectors, or stores the norms in h_mplusone_m after the last iteration
+	void SpinSpace::KrylovBlockExtend(const arma::cx_mat &z, std::vector<arma::cx_mat> &KryBasis, arma::cx_cube &Hessen, int it1, int KryDim, arma::vec &h_mplusone_m) const
+	{
+		for (unsigned int col = 0; col < z.n_cols; col++)
+		{
+			double znorm = arma::norm(z.col(col));
+			if (KryDim - 1 == it1)
+			{
+				h_mplusone_m(col) = znorm;
+				continue;
+			}
+
+			// A column that broke down keeps zero basis vectors, so its remaining Hessenberg elements stay zero
+			Hessen(it1 + 1, it1, col) = znorm;
+			if (znorm >= 1e-14)
+				KryBasis[it1 + 1].col(col) = z.col(col) / znorm;
+		}
+	}
+
+	// Returns the propagated columns norm(b) * V * expm(Hessen * dt) * e1 from the block Krylov bases
+	arma::cx_mat SpinSpace::KrylovBlockCombine(const arma::cx_mat &B, const std::vector<arma::cx_mat> &KryBasis, const arma::cx_cube &Hessen, const arma::cx_double dt, int HilbSize) const
+	{
+		// Coefficients of the basis vectors for each column
+		arma::cx_mat coefficients(KryBasis.size(), B.n_cols);
+		for (unsigned int col = 0; col < B.n_cols; col++)
+			coefficients.col(col) = arma::norm(B.col(col)) * arma::expmat(Hessen.slice(col) * dt).col(0);
+
+		arma::cx_mat result(HilbSize, B.n_cols, arma::fill::zeros);
+		for (unsigned int it = 0; it < KryBasis.size(); it++)
+			result += KryBasis[it].each_row() % coefficients.row(it);
+
+		return result;
+	}
+
+	// Sums of the singlet, T+, T0 and T- probabilities over all pairs of wavefunctions of two uncoupled radicals (used by the SymmUncoupled tasks).
+	// The columns of _B1 and _B2 are the wavefunctions of each radical, with the electron as the first factor of the basis. For a singlet or T0
+	// initial state, the first half of the columns started from alpha and the second half from beta, while all columns started from the same
+	// electron state for T+ and T-. Each term is a product of an expectation value on radical 1 and one on radical 2, so the sum over all
+	// pairs is the product of the sums over the columns of each radical. These are traces of B' * S * B, which need one sparse-dense product
+	// per operator instead of a loop over the columns. The result holds P_S, P_T+, P_T0 and P_T- (not divided by the number of pairs).
+	bool SpinSpace::UncoupledPairProjections(const arma::cx_mat &_B1, const arma::cx_mat &_B2, const std::string &_initialState, arma::vec &_projections) const
+	{
+		double sign;
+		if (_initialState == "singlet")
+			sign = -1.0;
+		else if (_initialState == "tripletzero")
+			sign = 1.0;
+		else if (_initialState == "tripletplus" || _initialState == "tripletminus")
+			sign = 0.0;
+		else
+			return false;
+		bool halves = (sign != 0.0);
+
+		// Electron spin operators in the basis of each radical
+		arma::sp_cx_mat Sx(2, 2);
+		Sx(0, 1) = 0.5;
+		Sx(1, 0) = 0.5;
+		arma::sp_cx_mat Sy(2, 2);
+		Sy(0, 1) = arma::cx_double(0.0, -0.5);
+		Sy(1, 0) = arma::cx_double(0.0, 0.5);
+		arma::sp_cx_mat Sz(2, 2);
+		Sz(0, 0) = 0.5;
+		Sz(1, 1) = -0.5;
+		arma::sp_cx_mat SpSm(2, 2); // S+S-
+		SpSm(0, 0) = 1.0;
+		arma::sp_cx_mat SmSp(2, 2); // S-S+
+		SmSp(1, 1) = 1.0;
+		const arma::sp_cx_mat *operators[5] = {&Sx, &Sy, &Sz, &SpSm, &SmSp};
+
+		// Sums over the columns of <A|S|A>, <A|S|B>, <B|S|A> and <B|S|B> for each radical and operator, where A and B are the two halves of the
+		// columns for singlet and T0, while only <A|S|A> is used for T+ and T- with A being all columns
+		const arma::cx_mat *B[2] = {&_B1, &_B2};
+		arma::cx_double AA[2][5];
+		arma::cx_double AB[2][5];
+		arma::cx_double BA[2][5];
+		arma::cx_double BB[2][5];
+		double pairs = 1.0;
+		for (unsigned int r = 0; r < 2; r++)
+		{
+			const arma::cx_mat &W = *B[r];
+			arma::uword n = halves ? W.n_cols / 2 : W.n_cols;
+			if (W.n_rows % 2 != 0 || n == 0)
+				return false;
+			pairs *= n;
+
+			arma::sp_cx_mat identity = arma::speye<arma::sp_cx_mat>(W.n_rows / 2, W.n_rows / 2);
+			for (unsigned int o = 0; o < 5; o++)
+			{
+				arma::cx_mat SW = arma::sp_cx_mat(arma::kron(*operators[o], identity)) * W;
+				if (halves)
+				{
+					AA[r][o] = arma::cdot(arma::vectorise(W.cols(0, n - 1)), arma::vectorise(SW.cols(0, n - 1)));
+					AB[r][o] = arma::cdot(arma::vectorise(W.cols(0, n - 1)), arma::vectorise(SW.cols(n, 2 * n - 1)));
+					BA[r][o] = arma::cdot(arma::vectorise(W.cols(n, 2 * n - 1)), arma::vectorise(SW.cols(0, n - 1)));
+					BB[r][o] = arma::cdot(arma::vectorise(W.cols(n, 2 * n - 1)), arma::vectorise(SW.cols(n, 2 * n - 1)));
+				}
+				else
+				{
+					AA[r][o] = arma::cdot(arma::vectorise(W), arma::vectorise(SW));
+				}
+			}
+		}
+
+		// Combine the sums of the two radicals
+		arma::cx_double Ps(0.25 * pairs, 0.0);
+		arma::cx_double Ptplus;
+		arma::cx_double Ptminus;
+		if (halves)
+		{
+			for (unsigned int o = 0; o < 3; o++)
+				Ps -= 0.5 * (AA[0][o] * BB[1][o] + sign * 2.0 * (AB[0][o] * BA[1][o]).real() + BB[0][o] * AA[1][o]);
+			Ptplus = 0.5 * (AA[0][3] * BB[1][3] + sign * 2.0 * (AB[0][3] * AB[1][3]).real() + BB[0][3] * AA[1][3]);
+			Ptminus = 0.5 * (AA[0][4] * BB[1][4] + sign * 2.0 * (AB[0][4] * AB[1][4]).real() + BB[0][4] * AA[1][4]);
+		}
+		else
+		{
+			for (unsigned int o = 0; o < 3; o++)
+				Ps -= AA[0][o] * AA[1][o];
+			Ptplus = AA[0][3] * AA[1][3];
+			Ptminus = AA[0][4] * AA[1][4];
+		}
+
+		_projections = {Ps.real(), Ptplus.real(), pairs - Ps.real() - Ptplus.real() - Ptminus.real(), Ptminus.real()};
+		return true;
+	}
 }
@@ -40,9 +40,9 @@ namespace SpinAPI
 
             for (auto i = spinlist.cbegin(); i < spinlist.cend(); i++)
             {
-                this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-                this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-                this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+                this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+                this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+                this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
                 tmp += Sx * rotvec[0] + Sy * rotvec[1] + Sz * rotvec[2];
             }
@@ -77,9 +77,9 @@ namespace SpinAPI
 
             for (auto i = spinlist.cbegin(); i < spinlist.cend(); i++)
             {
-                this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-                this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-                this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+                this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+                this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+                this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
                 tmp += Sx * field(0) + Sy * field(1) + Sz * field(2);
             }
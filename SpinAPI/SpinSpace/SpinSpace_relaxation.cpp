@@ -42,9 +42,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Get the contribution from Sx
 				if (!this->SuperoperatorFromOperators(Sx, Sx.t(), PB) || !this->SuperoperatorFromLeftOperator(Sx.t() * Sx, PL) || !this->SuperoperatorFromRightOperator(Sx.t() * Sx, PR))
@@ -95,9 +95,9 @@ namespace SpinAPI
 				arma::cx_mat Sxtmp, Sytmp, Sztmp;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sxtmp);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sytmp);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sztmp);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sxtmp);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sytmp);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sztmp);
 
 				// Store the operators in the vectors
 				Sx_operators.push_back(Sxtmp);
@@ -140,9 +140,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Get the contribution from Sx
 				if (!this->SuperoperatorFromOperators(Sx, Sx.t(), PB))
@@ -182,8 +182,8 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sp()), (*i), S_plus);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sm()), (*i), S_minus);
+				this->CreateOperator(SpinOperatorType::Sp, (*i), S_plus);
+				this->CreateOperator(SpinOperatorType::Sm, (*i), S_minus);
 
 				// Get the contribution from T1 relaxation
 				if (!this->SuperoperatorFromOperators(S_plus, S_minus.t(), PB) || !this->SuperoperatorFromLeftOperator(S_minus.t() * S_plus, PL) || !this->SuperoperatorFromRightOperator(S_minus.t() * S_plus, PR))
@@ -216,9 +216,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Get the contribution from T2 relaxation
 				if (!this->SuperoperatorFromOperators(Sz, Sz.t(), PB) || !this->SuperoperatorFromLeftOperator(Sz.t() * Sz, PL) || !this->SuperoperatorFromRightOperator(Sz.t() * Sz, PR))
@@ -274,9 +274,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sx(), (*i), Sx);
-				this->CreateOperator((*i)->Sy(), (*i), Sy);
-				this->CreateOperator((*i)->Sz(), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Get the contribution from Sx
 				if (!this->SuperoperatorFromOperators(Sx, Sx.t(), PB) || !this->SuperoperatorFromLeftOperator(Sx.t() * Sx, PL) || !this->SuperoperatorFromRightOperator(Sx.t() * Sx, PR))
@@ -328,9 +328,9 @@ namespace SpinAPI
 				arma::sp_cx_mat Sxtmp, Sytmp, Sztmp;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sx(), (*i), Sxtmp);
-				this->CreateOperator((*i)->Sy(), (*i), Sytmp);
-				this->CreateOperator((*i)->Sz(), (*i), Sztmp);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sxtmp);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sytmp);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sztmp);
 
 				// Store the operators in the vectors
 				Sx_operators.push_back(Sxtmp);
@@ -373,9 +373,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sx(), (*i), Sx);
-				this->CreateOperator((*i)->Sy(), (*i), Sy);
-				this->CreateOperator((*i)->Sz(), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Get the contribution from Sx
 				if (!this->SuperoperatorFromOperators(Sx, Sx.t(), PB))
@@ -415,8 +415,8 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sp(), (*i), S_plus);
-				this->CreateOperator((*i)->Sm(), (*i), S_minus);
+				this->CreateOperator(SpinOperatorType::Sp, (*i), S_plus);
+				this->CreateOperator(SpinOperatorType::Sm, (*i), S_minus);
 
 				// Get the contribution from T1 relaxation
 				if (!this->SuperoperatorFromOperators(S_plus, S_minus.t(), PB) || !this->SuperoperatorFromLeftOperator(S_minus.t() * S_plus, PL) || !this->SuperoperatorFromRightOperator(S_minus.t() * S_plus, PR))
@@ -449,9 +449,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sx(), (*i), Sx);
-				this->CreateOperator((*i)->Sy(), (*i), Sy);
-				this->CreateOperator((*i)->Sz(), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Get the contribution from T2 relaxation
 				if (!this->SuperoperatorFromOperators(Sz, Sz.t(), PB) || !this->SuperoperatorFromLeftOperator(Sz.t() * Sz, PL) || !this->SuperoperatorFromRightOperator(Sz.t() * Sz, PR))
@@ -510,9 +510,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Rotate into the new frame with given unitary rotation matrix
 				Sx = _rotationmatrix.t() * Sx * _rotationmatrix;
@@ -568,9 +568,9 @@ namespace SpinAPI
 				arma::cx_mat Sxtmp, Sytmp, Sztmp;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sxtmp);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sytmp);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sztmp);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sxtmp);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sytmp);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sztmp);
 
 				// Store the operators in the vectors
 				Sx_operators.push_back(Sxtmp);
@@ -617,9 +617,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Rotate into the eigenbasis of the spin system
 				Sx = _rotationmatrix.t() * Sx * _rotationmatrix;
@@ -664,8 +664,8 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sp()), (*i), S_plus);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sm()), (*i), S_minus);
+				this->CreateOperator(SpinOperatorType::Sp, (*i), S_plus);
+				this->CreateOperator(SpinOperatorType::Sm, (*i), S_minus);
 
 				// Rotate into the eigenbasis of the spin system
 				S_plus = _rotationmatrix.t() * S_plus * _rotationmatrix;
@@ -702,9 +702,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sx()), (*i), Sx);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sy()), (*i), Sy);
-				this->CreateOperator(arma::conv_to<arma::cx_mat>::from((*i)->Sz()), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Rotate into the eigenbasis of the spin system
 				Sx = _rotationmatrix.t() * Sx * _rotationmatrix;
@@ -765,9 +765,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sx(), (*i), Sx);
-				this->CreateOperator((*i)->Sy(), (*i), Sy);
-				this->CreateOperator((*i)->Sz(), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Rotate into the new frame with given unitary rotation matrix
 				Sx = _rotationmatrix.t() * Sx * _rotationmatrix;
@@ -824,9 +824,9 @@ namespace SpinAPI
 				arma::sp_cx_mat Sxtmp, Sytmp, Sztmp;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sx(), (*i), Sxtmp);
-				this->CreateOperator((*i)->Sy(), (*i), Sytmp);
-				this->CreateOperator((*i)->Sz(), (*i), Sztmp);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sxtmp);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sytmp);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sztmp);
 
 				// Store the operators in the vectors
 				Sx_operators.push_back(Sxtmp);
@@ -873,9 +873,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sx(), (*i), Sx);
-				this->CreateOperator((*i)->Sy(), (*i), Sy);
-				this->CreateOperator((*i)->Sz(), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Rotate into the eigenbasis of the spin system
 				Sx = _rotationmatrix.t() * Sx * _rotationmatrix;
@@ -920,8 +920,8 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sp(), (*i), S_plus);
-				this->CreateOperator((*i)->Sm(), (*i), S_minus);
+				this->CreateOperator(SpinOperatorType::Sp, (*i), S_plus);
+				this->CreateOperator(SpinOperatorType::Sm, (*i), S_minus);
 
 				// Rotate into the eigenbasis of the spin system
 				S_plus = _rotationmatrix.t() * S_plus * _rotationmatrix;
@@ -958,9 +958,9 @@ namespace SpinAPI
 					continue;
 
 				// Create the spin operators
-				this->CreateOperator((*i)->Sx(), (*i), Sx);
-				this->CreateOperator((*i)->Sy(), (*i), Sy);
-				this->CreateOperator((*i)->Sz(), (*i), Sz);
+				this->CreateOperator(SpinOperatorType::Sx, (*i), Sx);
+				this->CreateOperator(SpinOperatorType::Sy, (*i), Sy);
+				this->CreateOperator(SpinOperatorType::Sz, (*i), Sz);
 
 				// Rotate into the eigenbasis of the spin system
 				Sx = _rotationmatrix.t() * Sx * _rotationmatrix;
@@ -0,0 +1,355 @@
+/////////////////////////////////////////////////////////////////////////
+// SpinSpace class (SpinAPI Module)
+// ------------------
+// This source file contains methods for solving linear systems on the
+// spin space, e.g. the Laplace-domain equation A*x = b for a sparse
+// Liouvillian A, without converting A to a dense matrix.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+/////////////////////////////////////////////////////////////////////////
+namespace SpinAPI
+{
+	// -----------------------------------------------------
+	// Preconditioning
+	// -----------------------------------------------------
+	// Returns the inverse of the diagonal of the matrix (Jacobi preconditioner), using 1 where the diagonal vanishes
+	arma::cx_vec SpinSpace::JacobiPreconditioner(const arma::sp_cx_mat &_A) const
+	{
+		arma::cx_mat diagonal(arma::diagvec(_A));
+		arma::cx_vec result(_A.n_rows);
+
+		for (unsigned int k = 0; k < _A.n_rows; k++)
+		{
+			if (std::abs(diagonal(k, 0)) > 0.0)
+				result(k) = 1.0 / diagonal(k, 0);
+			else
+				result(k) = 1.0;
+		}
+
+		return result;
+	}
+
+	// -----------------------------------------------------
+	// Iterative solvers
+	// -----------------------------------------------------
+	// Restarted GMRES with right Jacobi preconditioning. The vector _x is used as initial guess if it has the right size.
+	// Returns true if the relative residual ||b - A*x|| / ||b|| dropped below _tolerance within _maxIterations iterations.
+	bool SpinSpace::SolveGMRES(const arma::sp_cx_mat &_A, const arma::cx_vec &_b, arma::cx_vec &_x, double _tolerance, unsigned int _restart, unsigned int _maxIterations, unsigned int &_iterations, double &_residual) const
+	{
+		_iterations = 0;
+		_residual = 0.0;
+
+		// Validate the input
+		if (_A.n_rows != _A.n_cols || _A.n_rows != _b.n_elem)
+			return false;
+
+		auto product = [&_A](const arma::cx_vec &_v) -> arma::cx_vec { return _A * _v; };
+		return this->SolveGMRES(product, this->JacobiPreconditioner(_A), _b, _x, _tolerance, _restart, _maxIterations, _iterations, _residual);
+	}
+
+	// Matrix-free version, where _A returns the product of the matrix with a vector and _preconditioner holds the inverse of its diagonal
+	bool SpinSpace::SolveGMRES(const std::function<arma::cx_vec(const arma::cx_vec &)> &_A, const arma::cx_vec &_preconditioner, const arma::cx_vec &_b, arma::cx_vec &_x, double _tolerance, unsigned int _restart, unsigned int _maxIterations, unsigned int &_iterations, double &_residual) const
+	{
+		_iterations = 0;
+		_residual = 0.0;
+
+		// Validate the input
+		if (_preconditioner.n_elem != _b.n_elem || _restart < 1)
+			return false;
+
+		if (_x.n_elem != _b.n_elem)
+			_x.zeros(_b.n_elem);
+
+		double bnorm = arma::norm(_b);
+		if (bnorm == 0.0)
+		{
+			_x.zeros(_b.n_elem);
+			return true;
+		}
+
+		// The restart length can never exceed the dimension of the problem
+		unsigned int m = std::min(_restart, static_cast<unsigned int>(_b.n_elem));
+		const arma::cx_vec &Minv = _preconditioner;
+
+		// Workspace for the Arnoldi basis, the Hessenberg matrix and the Givens rotations
+		arma::cx_mat V(_b.n_elem, m + 1);
+		arma::cx_mat Hm(m + 1, m);
+		arma::cx_vec g(m + 1);
+		arma::cx_vec cs(m);
+		arma::cx_vec sn(m);
+
+		while (_iterations < _maxIterations)
+		{
+			arma::cx_vec r = _b - _A(_x);
+			double beta = arma::norm(r);
+			_residual = beta / bnorm;
+			if (_residual < _tolerance)
+				return true;
+
+			V.zeros();
+			Hm.zeros();
+			g.zeros();
+			g(0) = beta;
+			V.col(0) = r / beta;
+
+			unsigned int k = 0;
+			for (unsigned int j = 0; j < m && _iterations < _maxIterations; j++)
+			{
+				// Arnoldi step on the preconditioned operator A*M^-1
+				arma::cx_vec w = _A(Minv % V.col(j));
+				for (unsigned int i = 0; i <= j; i++)
+				{
+					Hm(i, j) = arma::cdot(V.col(i), w);
+					w -= Hm(i, j) * V.col(i);
+				}
+				double hnext = arma::norm(w);
+				Hm(j + 1, j) = hnext;
+				if (hnext > 0.0)
+					V.col(j + 1) = w / hnext;
+
+				// Apply the previous Givens rotations to the new column
+				for (unsigned int i = 0; i < j; i++)
+				{
+					arma::cx_double tmp = std::conj(cs(i)) * Hm(i, j) + std::conj(sn(i)) * Hm(i + 1, j);
+					Hm(i + 1, j) = -sn(i) * Hm(i, j) + cs(i) * Hm(i + 1, j);
+					Hm(i, j) = tmp;
+				}
+
+				// Create a new rotation that eliminates the subdiagonal element
+				double denominator = std::sqrt(std::norm(Hm(j, j)) + hnext * hnext);
+				if (denominator == 0.0)
+					break;
+				cs(j) = Hm(j, j) / denominator;
+				sn(j) = hnext / denominator;
+				Hm(j, j) = denominator;
+				Hm(j + 1, j) = 0.0;
+				g(j + 1) = -sn(j) * g(j);
+				g(j) = std::conj(cs(j)) * g(j);
+
+				k = j + 1;
+				_iterations++;
+				_residual = std::abs(g(j + 1)) / bnorm;
+				if (_residual < _tolerance || hnext == 0.0)
+					break;
+			}
+
+			// Update the solution from the least-squares problem in the Krylov subspace
+			if (k > 0)
+			{
+				arma::cx_vec y = arma::solve(arma::trimatu(Hm.submat(0, 0, k - 1, k - 1)), g.head(k));
+				_x += Minv % (V.cols(0, k - 1) * y);
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		// Check the true residual, as the estimate from the rotations may drift for ill-conditioned problems
+		_residual = arma::norm(_b - _A(_x)) / bnorm;
+		return (_residual < _tolerance);
+	}
+
+	// BiCGSTAB with right Jacobi preconditioning. The vector _x is used as initial guess if it has the right size.
+	// Returns true if the relative residual ||b - A*x|| / ||b|| dropped below _tolerance within _maxIterations iterations.
+	bool SpinSpace::SolveBiCGSTAB(const arma::sp_cx_mat &_A, const arma::cx_vec &_b, arma::cx_vec &_x, double _tolerance, unsigned int _maxIterations, unsigned int &_iterations, double &_residual) const
+	{
+		_iterations = 0;
+		_residual = 0.0;
+
+		// Validate the input
+		if (_A.n_rows != _A.n_cols || _A.n_rows != _b.n_elem)
+			return false;
+
+		auto product = [&_A](const arma::cx_vec &_v) -> arma::cx_vec { return _A * _v; };
+		return this->SolveBiCGSTAB(product, this->JacobiPreconditioner(_A), _b, _x, _tolerance, _maxIterations, _iterations, _residual);
+	}
+
+	// Matrix-free version, where _A returns the product of the matrix with a vector and _preconditioner holds the inverse of its diagonal
+	bool SpinSpace::SolveBiCGSTAB(const std::function<arma::cx_vec(const arma::cx_vec &)> &_A, const arma::cx_vec &_preconditioner, const arma::cx_vec &_b, arma::cx_vec &_x, double _tolerance, unsigned int _maxIterations, unsigned int &_iterations, double &_residual) const
+	{
+		_iterations = 0;
+		_residual = 0.0;
+
+		// Validate the input
+		if (_preconditioner.n_elem != _b.n_elem)
+			return false;
+
+		if (_x.n_elem != _b.n_elem)
+			_x.zeros(_b.n_elem);
+
+		double bnorm = arma::norm(_b);
+		if (bnorm == 0.0)
+		{
+			_x.zeros(_b.n_elem);
+			return true;
+		}
+
+		const arma::cx_vec &Minv = _preconditioner;
+		arma::cx_vec r = _b - _A(_x);
+		arma::cx_vec rhat = r;
+		arma::cx_vec p = arma::zeros<arma::cx_vec>(_b.n_elem);
+		arma::cx_vec v = arma::zeros<arma::cx_vec>(_b.n_elem);
+		arma::cx_double rho = 1.0;
+		arma::cx_double alpha = 1.0;
+		arma::cx_double omega = 1.0;
+
+		_residual = arma::norm(r) / bnorm;
+		while (_residual >= _tolerance && _iterations < _maxIterations)
+		{
+			arma::cx_double rhoNext = arma::cdot(rhat, r);
+			if (std::abs(rhoNext) == 0.0)
+				break; // Breakdown, the method cannot continue
+
+			if (_iterations == 0)
+				p = r;
+			else
+				p = r + (rhoNext / rho) * (alpha / omega) * (p - omega * v);
+
+			arma::cx_vec phat = Minv % p;
+			v = _A(phat);
+			alpha = rhoNext / arma::cdot(rhat, v);
+			arma::cx_vec s = r - alpha * v;
+
+			_iterations++;
+			if (arma::norm(s) / bnorm < _tolerance)
+			{
+				_x += alpha * phat;
+				_residual = arma::norm(s) / bnorm;
+				break;
+			}
+
+			arma::cx_vec shat = Minv % s;
+			arma::cx_vec t = _A(shat);
+			double tnorm = arma::norm(t);
+			if (tnorm == 0.0)
+				break;
+			omega = arma::cdot(t, s) / (tnorm * tnorm);
+
+			_x += alpha * phat + omega * shat;
+			r = s - omega * t;
+			rho = rhoNext;
+			_residual = arma::norm(r) / bnorm;
+		}
+
+		_residual = arma::norm(_b - _A(_x)) / bnorm;
+		return (_residual < _tolerance);
+	}
+
+	// -----------------------------------------------------
+	// Direct solvers
+	// -----------------------------------------------------
+	// Sparse direct LU factorization through SuperLU, requires Armadillo to be built with ARMA_USE_SUPERLU
+	bool SpinSpace::SolveSparseLU(const arma::sp_cx_mat &_A, const arma::cx_vec &_b, arma::cx_vec &_x) const
+	{
+		try
+		{
+			return arma::spsolve(_x, _A, _b, "superlu");
+		}
+		catch (const std::exception &) // Thrown if SuperLU is not available
+		{
+			return false;
+		}
+	}
+
+	// -----------------------------------------------------
+	// Hilbert space solvers
+	// -----------------------------------------------------
+	// Solves the Sylvester equation A*X + X*B = C through Schur decompositions of A and B (Bartels-Stewart algorithm),
+	// which needs O(N^3) time and O(N^2) memory rather than a solve with the N^2 x N^2 matrix of the vectorized equation.
+	bool SpinSpace::SolveSylvester(const arma::cx_mat &_A, const arma::cx_mat &_B, const arma::cx_mat &_C, arma::cx_mat &_X) const
+	{
+		// Validate the input
+		if (!_A.is_square() || !_B.is_square() || _C.n_rows != _A.n_rows || _C.n_cols != _B.n_rows)
+			return false;
+
+		// Armadillo solves A*X + X*B + C = 0
+		arma::cx_mat negC = -_C;
+		return arma::sylvester(_X, _A, _B, negC);
+	}
+
+	// Solves the Laplace-domain equation L(rho) = rho0 that the Liouville-space solvers would solve with the superspace Liouvillian -iH - K,
+	// but in the Hilbert space: With Haberkorn reaction operators K(rho) = K*rho + rho*K, and the equation is (-iH - K)*rho + rho*(iH - K) = rho0.
+	// Relaxation operators cannot be written in this form, so the caller must make sure that there are none. Requires UseSuperoperatorSpace(false).
+	bool SpinSpace::SolveHaberkornSteadyState(const arma::cx_mat &_rho0, arma::cx_mat &_rho) const
+	{
+		if (this->useSuperspace || !this->HasOnlyHaberkornReactionOperators())
+			return false;
+
+		arma::cx_mat H;
+		arma::cx_mat K;
+		if (!this->Hamiltonian(H) || !this->TotalReactionOperator(K))
+			return false;
+
+		// The second coefficient is the adjoint of the first, as H and K are Hermitian
+		arma::cx_mat L = arma::cx_double(0.0, -1.0) * H - K;
+		return this->SolveSylvester(L, L.t(), _rho0, _rho);
+	}
+
+	// -----------------------------------------------------
+	// Yields of several initial states
+	// -----------------------------------------------------
+	// Returns the expectation values Y = O * A^-1 * B, where the columns of _B are initial states as superspace vectors and the rows of O are the
+	// observables (which must be a superspace ObservableSet). Y(k, j) is the expectation value of observable k for initial state j. The matrix A
+	// is LU factorized once, and the triangular solves are done for the columns of B, or for the adjoint system A^T * Z = O^T if there are fewer
+	// observables than initial states. The cost after the factorization thus scales with min(#states, #observables).
+	bool SpinSpace::SolveYields(const arma::sp_cx_mat &_A, const arma::cx_mat &_B, const ObservableSet &_observables, arma::cx_mat &_yields) const
+	{
+		const arma::sp_cx_mat &O = _observables.Observables();
+
+		// Validate the input
+		if (!_A.is_square() || _B.n_rows != _A.n_rows || !_observables.IsSuperspace() || O.n_cols != _A.n_rows)
+			return false;
+
+		if (O.n_rows == 0 || _B.n_cols == 0)
+		{
+			_yields.zeros(O.n_rows, _B.n_cols);
+			return true;
+		}
+
+		// Liouvillians with a conserved quantity are block-diagonal after a reordering of the basis, so each block is solved on its own
+		arma::uvec permutation;
+		std::vector<arma::uword> offsets;
+		if (this->BlockStructure(_A, permutation, offsets) && offsets.size() > 2)
+		{
+			arma::cx_mat X;
+			if (!this->BlockSolve(_A, _B, X))
+				return false;
+
+			_yields = O * X;
+			return true;
+		}
+
+		// A = P^T * L * U
+		arma::cx_mat L;
+		arma::cx_mat U;
+		arma::cx_mat P;
+		if (!arma::lu(L, U, P, arma::cx_mat(_A)))
+			return false;
+
+		if (_B.n_cols <= O.n_rows)
+		{
+			// X = U^-1 * L^-1 * P * B
+			arma::cx_mat Y;
+			arma::cx_mat X;
+			if (!arma::solve(Y, arma::trimatl(L), P * _B) || !arma::solve(X, arma::trimatu(U), Y))
+				return false;
+
+			_yields = O * X;
+		}
+		else
+		{
+			// Z = P^T * L^-T * U^-T * O^T, such that Z^T = O * A^-1
+			arma::cx_mat W;
+			arma::cx_mat Z;
+			if (!arma::solve(W, arma::trimatl(U.st()), arma::cx_mat(O.st())) || !arma::solve(Z, arma::trimatu(L.st()), W))
+				return false;
+
+			_yields = (P.st() * Z).st() * _B;
+		}
+
+		return true;
+	}
+}
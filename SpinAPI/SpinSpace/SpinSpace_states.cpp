@@ -13,9 +13,13 @@ namespace SpinAPI
 	// -----------------------------------------------------
 	// Spin state representations in the space
 	// -----------------------------------------------------
-	// Returns a projection operator onto the state of the single spin with the given value of the "mz" quantum number
-	arma::cx_mat SpinSpace::GetSingleSpinState(const spin_ptr &_spin, int _mz) const
+	// Sets the matrix to a projection operator onto the state of the single spin with the given value of the "mz" quantum number
+	// Returns false for groups of equivalent spins, since the "mz" of the individual spins cannot be represented in their basis of total spins
+	bool SpinSpace::GetSingleSpinState(const spin_ptr &_spin, int _mz, arma::cx_mat &_out) const
 	{
+		if (_spin->Equivalent() > 1)
+			return false;
+
 		arma::cx_mat temp;
 		arma::cx_mat result;
 		bool isFirst = true;
@@ -51,7 +55,8 @@ namespace SpinAPI
 			}
 		}
 
-		return result;
+		_out = result;
+		return true;
 	}
 
 	// Sets the vector to a representation of the state within the given spin space
@@ -106,6 +111,10 @@ namespace SpinAPI
 				// Get a vector representation of the single-spin state in the vector space of the spin
 				if (j != _cstate.cend())
 				{
+					// The basis of a group of equivalent spins consists of total spins, so the "mz" of the individual spins cannot be represented
+					if ((*i)->Equivalent() > 1)
+						return false;
+
 					// Put "1/N^2" for the state with the correct "mz", and "0" for all other indices
 					// "N^2" is the norm square of the CompleteState
 					tmpvec = arma::zeros<arma::cx_vec>(static_cast<unsigned int>((*i)->Multiplicity()));
@@ -355,6 +364,32 @@ namespace SpinAPI
 		return true;
 	}
 
+	// Multiplies the density operator by the multiplicities of the total spins of the groups of equivalent spins (see Spin::Weights), such that
+	// traces over the reduced spin space equal traces over the space of the individual spins. Nothing is done if there are no such groups.
+	bool SpinSpace::WeightEquivalentSpins(arma::cx_mat &_rho) const
+	{
+		if (_rho.n_rows != this->HilbertSpaceDimensions() || _rho.n_cols != this->HilbertSpaceDimensions())
+			return false;
+
+		arma::vec weights = arma::ones<arma::vec>(1);
+		bool hasGroups = false;
+		for (auto i = this->spins.cbegin(); i != this->spins.cend(); i++)
+		{
+			hasGroups |= ((*i)->Equivalent() > 1);
+			arma::vec tmp = arma::kron(weights, (*i)->Weights());
+			weights = tmp;
+		}
+
+		if (!hasGroups)
+			return true;
+
+		// The square root is applied on both sides to keep the operator Hermitian, which is equivalent as the dynamics never mix different total spins
+		arma::vec root = arma::sqrt(weights);
+		_rho %= arma::conv_to<arma::cx_mat>::from(arma::mat(root * root.t()));
+
+		return true;
+	}
+
 	// Produces the thermal state of a respecitve spinsystem [created by Pedro Alvarez]
 	bool SpinSpace::GetThermalState(SpinAPI::SpinSpace &_space, double _Temperature, arma::cx_mat &_mat) const
 	{
@@ -349,6 +349,23 @@ namespace SpinAPI
 		return this->reactionOperators;
 	}
 
+	// Returns true if the reaction operators of all transitions take the Haberkorn form in the superspace. The Liouville-space
+	// equations can then be written in the Hilbert space with the non-Hermitian operator -iH - K, where K is the Hilbert space TotalReactionOperator.
+	bool SpinSpace::HasOnlyHaberkornReactionOperators() const
+	{
+		for (auto i = this->transitions.cbegin(); i != this->transitions.cend(); i++)
+		{
+			ReactionOperatorType ROT = this->reactionOperators;
+			if ((*i)->GetReactionOperatorType() != ReactionOperatorType::Unspecified)
+				ROT = (*i)->GetReactionOperatorType();
+
+			if (ROT == ReactionOperatorType::Lindblad)
+				return false;
+		}
+
+		return true;
+	}
+
 	// -----------------------------------------------------
 	// Transitions/decay operators in the target system
 	// -----------------------------------------------------
@@ -8,20 +8,35 @@
 /////////////////////////////////////////////////////////////////////////
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "Trajectory.h"
 
 namespace SpinAPI
 {
+	// Identifies the binary trajectory format, which is followed by the number of rows and columns (uint64), the column headers
+	// (uint64 length and characters each), padding to a multiple of 8 bytes, and the data as column-major doubles in native byte order
+	static const char binaryTrajectoryMagic[8] = {'M', 'S', 'D', 'T', 'R', 'J', '0', '1'};
+
 	// -----------------------------------------------------
 	// Spin Constructors and Destructor
 	// -----------------------------------------------------
-	Trajectory::Trajectory() : filename(), headers(), data()
+	Trajectory::Trajectory() : filename(), headers(), rows(0), columns(0), storage(), mapping(nullptr), values(nullptr), sorted()
 	{
 	}
 
-	Trajectory::Trajectory(const Trajectory &_trajectory) : filename(_trajectory.filename), headers(_trajectory.headers), data(_trajectory.data)
+	Trajectory::Trajectory(const Trajectory &_trajectory) : filename(_trajectory.filename), headers(_trajectory.headers), rows(_trajectory.rows), columns(_trajectory.columns),
+															storage(_trajectory.storage), mapping(_trajectory.mapping), values(nullptr), sorted(_trajectory.sorted)
 	{
+		this->values = (this->mapping != nullptr) ? _trajectory.values : this->storage.data();
 	}
 
 	Trajectory::~Trajectory()
@@ -34,7 +49,12 @@ namespace SpinAPI
 	{
 		this->filename = _trajectory.filename;
 		this->headers = _trajectory.headers;
-		this->data = _trajectory.data;
+		this->rows = _trajectory.rows;
+		this->columns = _trajectory.columns;
+		this->storage = _trajectory.storage;
+		this->mapping = _trajectory.mapping;
+		this->values = (this->mapping != nullptr) ? _trajectory.values : this->storage.data();
+		this->sorted = _trajectory.sorted;
 
 		return (*this);
 	}
@@ -71,41 +91,166 @@ namespace SpinAPI
 		return false;
 	}
 
-	// Checks whether a character is a space or a tab
+	// Checks whether a character is whitespace other than a newline, e.g. a space, a tab or a carriage return
 	bool Trajectory::isDelimiter(const char &_c) const
 	{
-		const std::string delimiters(" \t");
+		return (_c == ' ' || _c == '\t' || _c == '\r' || _c == '\v' || _c == '\f');
+	}
 
-		if (delimiters.find(_c) != std::string::npos)
-			return true;
+	// Reads the whole file at once and converts the numbers in place with strtod, rather than building a string per number.
+	// The data is collected row by row and transposed to the column-major layout afterwards.
+	bool Trajectory::LoadText(const std::string &_filename)
+	{
+		std::ifstream filehandle(_filename, std::ios::binary);
+		if (!filehandle.is_open())
+			return false;
 
-		return false;
+		std::string buffer;
+		filehandle.seekg(0, std::ios::end);
+		std::streamoff length = filehandle.tellg();
+		if (length < 0)
+			return false;
+		buffer.resize(static_cast<size_t>(length));
+		filehandle.seekg(0, std::ios::beg);
+		filehandle.read(&buffer[0], buffer.size());
+
+		const char *c = buffer.c_str();
+		const char *bufferEnd = c + buffer.size();
+
+		// The first line contains the headers
+		std::string value = "";
+		for (; c < bufferEnd && *c != '\n'; c++)
+		{
+			if (this->isDelimiter(*c))
+			{
+				if (!value.empty())
+				{
+					this->SetHeader(this->columns++, value);
+					value = "";
+				}
+			}
+			else if (this->isAlphanumericCharacter(*c))
+			{
+				value += *c;
+			}
+		}
+		if (!value.empty())
+			this->SetHeader(this->columns++, value);
+
+		// Read the data lines, values without a header are ignored and missing values are stored as NaN
+		const double missing = std::numeric_limits<double>::quiet_NaN();
+		std::vector<double> rowdata;
+		while (c < bufferEnd)
+		{
+			c++; // Skip the newline character
+
+			unsigned int column = 0;
+			while (c < bufferEnd && *c != '\n')
+			{
+				if (this->isDelimiter(*c))
+				{
+					c++;
+					continue;
+				}
+
+				// Convert the number, strtod stops at the first character that does not belong to it (and the buffer is null-terminated)
+				char *numberEnd = nullptr;
+				double x = std::strtod(c, &numberEnd);
+				if (numberEnd == c || std::isnan(x))
+					x = 0.0;
+
+				// Skip the rest of the value, e.g. if it was not a number
+				c = numberEnd;
+				while (c < bufferEnd && *c != '\n' && !this->isDelimiter(*c))
+					c++;
+
+				if (column < this->columns)
+					rowdata.push_back(x);
+				column++;
+			}
+
+			// Empty lines do not add rows
+			if (column > 0)
+			{
+				for (; column < this->columns; column++)
+					rowdata.push_back(missing);
+				this->rows++;
+			}
+		}
+
+		// Transpose to the column-major layout
+		this->storage.resize(rowdata.size());
+		for (unsigned int row = 0; row < this->rows; row++)
+			for (unsigned int column = 0; column < this->columns; column++)
+				this->storage[column * this->rows + row] = rowdata[row * this->columns + column];
+
+		this->values = this->storage.data();
+		return true;
 	}
 
-	// Method to add data (a number) to the trajectory
-	void Trajectory::AddNumber(unsigned int _row, std::string _value)
+	// Maps a file written by SaveBinary into memory. The data is not copied, and pages are only read from disk when they are accessed.
+	bool Trajectory::LoadBinary(const std::string &_filename, bool &_isBinary)
 	{
-		// If we need to add more than a single new row, don't do it (intermediate columns would become empty)
-		if (_row > this->data.size())
-			return;
+		_isBinary = false;
 
-		// Create a new row if we need it
-		if (_row == this->data.size())
-			this->data.push_back(std::vector<double>());
+		// Check the format before mapping the file
+		char magic[sizeof(binaryTrajectoryMagic)] = {0};
+		std::ifstream filehandle(_filename, std::ios::binary);
+		if (!filehandle.is_open() || !filehandle.read(magic, sizeof(magic)) || std::memcmp(magic, binaryTrajectoryMagic, sizeof(magic)) != 0)
+			return false;
+		filehandle.close();
+		_isBinary = true;
 
-		// Do not load any data if there is no header for the column
-		if (this->data[_row].size() >= this->headers.size())
-			return;
+		int fd = open(_filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
 
-		// Convert from string to double
-		std::istringstream stream(_value);
-		double x;
+		struct stat filestat;
+		if (fstat(fd, &filestat) != 0)
+		{
+			close(fd);
+			return false;
+		}
 
-		if (!(stream >> x))
-			x = 0.0;
+		size_t size = static_cast<size_t>(filestat.st_size);
+		void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (address == MAP_FAILED)
+			return false;
+
+		this->mapping = std::shared_ptr<const char>(static_cast<const char *>(address), [size](const char *_address) { munmap(const_cast<char *>(_address), size); });
+		const char *base = this->mapping.get();
+
+		// Read the dimensions and the headers, checking that they fit into the file
+		size_t offset = sizeof(binaryTrajectoryMagic);
+		uint64_t dimensions[2] = {0, 0};
+		if (offset + sizeof(dimensions) > size)
+			return false;
+		std::memcpy(dimensions, base + offset, sizeof(dimensions));
+		offset += sizeof(dimensions);
 
-		// Store the value
-		this->data[_row].push_back(x);
+		for (uint64_t column = 0; column < dimensions[1]; column++)
+		{
+			uint64_t length = 0;
+			if (offset + sizeof(length) > size)
+				return false;
+			std::memcpy(&length, base + offset, sizeof(length));
+			offset += sizeof(length);
+
+			if (length > size - offset)
+				return false;
+			this->SetHeader(static_cast<unsigned int>(column), std::string(base + offset, length));
+			offset += length;
+		}
+
+		offset = (offset + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+		if (dimensions[0] * dimensions[1] > (size - std::min(offset, size)) / sizeof(double))
+			return false;
+
+		this->rows = static_cast<unsigned int>(dimensions[0]);
+		this->columns = static_cast<unsigned int>(dimensions[1]);
+		this->values = reinterpret_cast<const double *>(base + offset);
+		return true;
 	}
 
 	// Sets the header for a column in the trajectory
@@ -113,6 +258,30 @@ namespace SpinAPI
 	{
 		this->headers.insert(std::pair<std::string, unsigned int>(_name, _column));
 	}
+
+	// Finds the columns that can be binary searched, i.e. that are non-decreasing and have no missing values
+	void Trajectory::Index()
+	{
+		this->sorted.assign(this->columns, true);
+		for (unsigned int column = 0; column < this->columns; column++)
+		{
+			const double *first = this->values + static_cast<size_t>(column) * this->rows;
+			for (unsigned int row = 0; row < this->rows; row++)
+			{
+				if (std::isnan(first[row]) || (row > 0 && first[row] < first[row - 1]))
+				{
+					this->sorted[column] = false;
+					break;
+				}
+			}
+		}
+	}
+
+	// Returns the value without any checks, note that missing values are NaN
+	double Trajectory::Value(unsigned int _row, unsigned int _column) const
+	{
+		return this->values[static_cast<size_t>(_column) * this->rows + _row];
+	}
 	// -----------------------------------------------------
 	// Public methods
 	// -----------------------------------------------------
@@ -122,79 +291,105 @@ namespace SpinAPI
 		// Clean-up in case we already had a trajectory loaded
 		this->Clear();
 
-		// Open trajectory file and check that the stream is ok
-		std::ifstream filehandle(_filename);
-		if (filehandle.is_open())
+		// Binary files are recognized by their first bytes, anything else is parsed as text
+		bool isBinary = false;
+		bool loaded = this->LoadBinary(_filename, isBinary);
+		if (!isBinary)
+			loaded = this->LoadText(_filename);
+
+		if (loaded)
 		{
-			char c;
-			bool hasHeader = false; // Set to true after first newline character (first line contains the headers)
-			std::string value = "";
-			unsigned int linenumber = 0;
-			unsigned int column = 0;
+			this->filename = _filename;
+			this->Index();
+			return true;
+		}
 
-			while (filehandle.get(c))
-			{
-				if (c == '\n')
-				{
-					// Was this the header line?
-					if (hasHeader)
-					{
-						this->AddNumber(linenumber - 1, value);
-					}
-					else
-					{
-						hasHeader = true;
-						this->SetHeader(column, value);
-					}
-
-					// Reset value, ready to read the next
-					value = "";
-					column = 0;
+		this->Clear();
+		if (isBinary)
+			std::cout << "ERROR: Invalid binary trajectory file \"" << _filename << "\"! Trajectory was not loaded!" << std::endl;
+		else
+			std::cout << "ERROR: Failed to open trajectory file \"" << _filename << "\"! Trajectory was not loaded!" << std::endl;
+		return false;
+	}
 
-					// We found a newline character!
-					linenumber++;
-				}
-				else if (this->isDelimiter(c))
-				{
-					if (!value.empty())
-					{
-						// Was this the header line?
-						if (hasHeader)
-						{
-							this->AddNumber(linenumber - 1, value);
-						}
-						else
-						{
-							this->SetHeader(column, value);
-						}
-
-						// Reset value, ready to read the next
-						value = "";
-						column++;
-					}
-				}
-				else if (!hasHeader && this->isAlphanumericCharacter(c))
-				{
-					value += c;
-				}
-				else if (hasHeader && this->isNumericCharacter(c))
-				{
-					value += c;
-				}
+	// Loads a text trajectory through its binary version "<file>.bin", which is written on the first load and used afterwards instead of parsing the text file
+	bool Trajectory::LoadConverted(const std::string &_filename)
+	{
+		const std::string binaryfile = _filename + ".bin";
+
+		// Use the binary version unless the text file was modified after it was written
+		struct stat textstat;
+		struct stat binarystat;
+		if (stat(binaryfile.c_str(), &binarystat) == 0 && (stat(_filename.c_str(), &textstat) != 0 || binarystat.st_mtime >= textstat.st_mtime))
+		{
+			this->Clear();
+			bool isBinary = false;
+			if (this->LoadBinary(binaryfile, isBinary))
+			{
+				this->filename = binaryfile;
+				this->Index();
+				return true;
 			}
 
-			return true;
+			std::cout << "Warning: Could not use the binary trajectory file \"" << binaryfile << "\", loading \"" << _filename << "\" instead." << std::endl;
 		}
 
-		std::cout << "ERROR: Failed to open trajectory file \"" << _filename << "\"! Trajectory was not loaded!" << std::endl;
-		return false;
+		if (!this->Load(_filename))
+			return false;
+
+		// The file may already have been binary, in which case there is nothing to convert
+		if (this->mapping == nullptr && !this->SaveBinary(binaryfile))
+			std::cout << "Warning: Failed to write the binary trajectory file \"" << binaryfile << "\"." << std::endl;
+
+		return true;
+	}
+
+	// Writes the trajectory in the binary format described at the top of this file
+	bool Trajectory::SaveBinary(const std::string &_filename) const
+	{
+		std::ofstream filehandle(_filename, std::ios::binary | std::ios::trunc);
+		if (!filehandle.is_open())
+			return false;
+
+		// Column headers ordered by column number
+		std::vector<std::string> names(this->columns);
+		for (auto i = this->headers.cbegin(); i != this->headers.cend(); i++)
+			if (i->second < this->columns)
+				names[i->second] = i->first;
+
+		uint64_t dimensions[2] = {this->rows, this->columns};
+		filehandle.write(binaryTrajectoryMagic, sizeof(binaryTrajectoryMagic));
+		filehandle.write(reinterpret_cast<const char *>(dimensions), sizeof(dimensions));
+
+		size_t offset = sizeof(binaryTrajectoryMagic) + sizeof(dimensions);
+		for (auto i = names.cbegin(); i != names.cend(); i++)
+		{
+			uint64_t length = i->size();
+			filehandle.write(reinterpret_cast<const char *>(&length), sizeof(length));
+			filehandle.write(i->data(), i->size());
+			offset += sizeof(length) + i->size();
+		}
+
+		const char padding[sizeof(double)] = {0};
+		filehandle.write(padding, (sizeof(double) - offset % sizeof(double)) % sizeof(double));
+
+		if (this->rows > 0 && this->columns > 0)
+			filehandle.write(reinterpret_cast<const char *>(this->values), static_cast<std::streamsize>(sizeof(double)) * this->rows * this->columns);
+
+		return filehandle.good();
 	}
 
 	// Removes all loaded trajectory data
 	bool Trajectory::Clear()
 	{
+		this->filename.clear();
 		this->headers.clear();
-		this->data.clear();
+		this->rows = 0;
+		this->columns = 0;
+		this->storage.clear();
+		this->mapping.reset();
+		this->values = nullptr;
+		this->sorted.clear();
 		return true;
 	}
 	// -----------------------------------------------------
@@ -203,13 +398,11 @@ namespace SpinAPI
 	// Returns the value at the specified row and column number
 	double Trajectory::Get(const unsigned int _row, const unsigned int _column) const
 	{
-		if (_row >= this->data.size())
-			return 0.0;
-
-		if (_column >= this->data[_row].size())
+		if (_row >= this->rows || _column >= this->columns)
 			return 0.0;
 
-		return this->data[_row][_column];
+		double value = this->Value(_row, _column);
+		return std::isnan(value) ? 0.0 : value;
 	}
 
 	// Overload of Get, with a string to specify column header name
@@ -270,26 +463,34 @@ namespace SpinAPI
 	bool Trajectory::FirstRowEqGreaterThan(double _value, unsigned int _column, unsigned int &_row, double &_firstGreaterValue) const
 	{
 		// Make sure that we are checking a valid column
-		if (_column >= this->headers.size())
+		if (_column >= this->columns)
 			return false;
 
-		// Iterate throught the rows
-		unsigned int row = 0;
-		for (auto i = this->data.cbegin(); i != this->data.cend(); i++)
+		const double *first = this->values + static_cast<size_t>(_column) * this->rows;
+		const double *last = first + this->rows;
+
+		// Use a binary search on non-decreasing columns, e.g. the time column
+		if (this->sorted[_column])
 		{
-			// Check if the column has a value (note that _column is zero-based, hence don't use ">=")
-			if ((*i).size() > _column)
+			const double *i = std::lower_bound(first, last, _value);
+			if (i == last)
+				return false;
+
+			_row = static_cast<unsigned int>(i - first);
+			_firstGreaterValue = *i;
+			return true;
+		}
+
+		// Iterate throught the rows, note that the condition is false for missing (NaN) values
+		for (const double *i = first; i != last; i++)
+		{
+			// Check the Equal-to-or-Greater-than condition
+			if (*i >= _value)
 			{
-				// Check the Equal-to-or-Greater-than condition
-				if ((*i)[_column] >= _value)
-				{
-					_row = row;
-					_firstGreaterValue = (*i)[_column];
-					return true;
-				}
+				_row = static_cast<unsigned int>(i - first);
+				_firstGreaterValue = *i;
+				return true;
 			}
-
-			row++;
 		}
 
 		return false;
@@ -310,26 +511,26 @@ namespace SpinAPI
 	bool Trajectory::FirstRowEqLessThan(double _value, unsigned int _column, unsigned int &_row, double &_firstLessValue) const
 	{
 		// Make sure that we are checking a valid column
-		if (_column >= this->headers.size())
+		if (_column >= this->columns)
 			return false;
 
-		// Iterate throught the rows
-		unsigned int row = 0;
-		for (auto i = this->data.cbegin(); i != this->data.cend(); i++)
+		const double *first = this->values + static_cast<size_t>(_column) * this->rows;
+		const double *last = first + this->rows;
+
+		// In a non-decreasing column only the first row can be the first one satisfying the condition
+		if (this->sorted[_column] && this->rows > 0)
+			last = first + 1;
+
+		// Iterate throught the rows, note that the condition is false for missing (NaN) values
+		for (const double *i = first; i != last; i++)
 		{
-			// Check if the column has a value (note that _column is zero-based, hence don't use ">=")
-			if ((*i).size() > _column)
+			// Check the Equal-to-or-Less-than condition
+			if (*i <= _value)
 			{
-				// Check the Equal-to-or-Less-than condition
-				if ((*i)[_column] <= _value)
-				{
-					_row = row;
-					_firstLessValue = (*i)[_column];
-					return true;
-				}
+				_row = static_cast<unsigned int>(i - first);
+				_firstLessValue = *i;
+				return true;
 			}
-
-			row++;
 		}
 
 		return false;
@@ -350,7 +551,7 @@ namespace SpinAPI
 	// Returns the number of rows in the trajectory
 	unsigned int Trajectory::Length() const
 	{
-		return this->data.size();
+		return this->rows;
 	}
 	// -----------------------------------------------------
 }
@@ -11,6 +11,8 @@
 #define MOD_SpinAPI_Trajectory
 
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace SpinAPI
@@ -21,15 +23,23 @@ namespace SpinAPI
 		// Implementation details
 		std::string filename;
 		std::map<std::string, unsigned int> headers;
-		std::vector<std::vector<double>> data;
+		unsigned int rows;					// Number of rows
+		unsigned int columns;				// Number of columns, i.e. header entries in the file
+		std::vector<double> storage;		// Column-major data for trajectories loaded from text files
+		std::shared_ptr<const char> mapping; // Memory-mapped binary trajectory file, shared between copies
+		const double *values;				// Column-major data, pointing into either storage or mapping
+		std::vector<bool> sorted;			// Whether a column is non-decreasing, such that it can be binary searched
 
 		// Private character validation methods
 		bool isAlphanumericCharacter(const char &) const;
 		bool isNumericCharacter(const char &) const;
 		bool isDelimiter(const char &) const;
 
-		void AddNumber(unsigned int, std::string); // Puts a number into the next column of the row, provided there are enough headers
+		bool LoadText(const std::string &);					// Parses a whitespace-separated text file with a header line
+		bool LoadBinary(const std::string &, bool &);		// Maps a binary trajectory file, the bool is set to false if the file is not binary
 		void SetHeader(unsigned int, std::string);
+		void Index();										// Determines the sorted columns
+		double Value(unsigned int, unsigned int) const;		// Unchecked access, which may return NaN for missing values
 
 	public:
 		// Constructors / Destructors
@@ -41,8 +51,10 @@ namespace SpinAPI
 		const Trajectory &operator=(const Trajectory &); // Copy-assignment
 
 		// Public methods
-		bool Load(const std::string &); // Loads the given trajectory file
-		bool Clear();					// Removes any loaded trajectory data
+		bool Load(const std::string &);				// Loads the given trajectory file, either a text file or a binary file written by SaveBinary
+		bool LoadConverted(const std::string &);	// Like Load, but a text file is converted to "<file>.bin" on the first load, which is used as long as it is newer than the text file
+		bool SaveBinary(const std::string &) const; // Writes the trajectory in the binary format, which is memory-mapped when loaded
+		bool Clear();								// Removes any loaded trajectory data
 
 		// TODO: Consider using size_t or vector::size_type instead of unsigned int
 		// Note that row and column numbers are zero-based
@@ -58,6 +70,7 @@ namespace SpinAPI
 		// Sets the uint& to the first row that is equal or greater/less than the given value,
 		// and sets the double& to the value found in that row
 		// Returns false if not value was found satifying the constraint (greater/less than)
+		// Non-decreasing columns, such as time columns, are binary searched
 		bool FirstRowEqGreaterThan(double _value, unsigned int _column, unsigned int &_row, double &_firstGreaterValue) const;
 		bool FirstRowEqGreaterThan(double _value, std::string _column, unsigned int &_row, double &_firstGreaterValue) const;
 		bool FirstRowEqLessThan(double _value, unsigned int _column, unsigned int &_row, double &_firstLessValue) const;
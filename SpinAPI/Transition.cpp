@@ -34,7 +34,10 @@ namespace SpinAPI
 			}
 
 			// Load the trajectory, and check whether something was loaded
-			if (this->trajectory.Load(directory + str))
+			// With "binarytrajectory", the file is converted to the binary format on the first load, which is faster to load in subsequent runs
+			bool binaryTrajectory = false;
+			this->properties->Get("binarytrajectory", binaryTrajectory);
+			if (binaryTrajectory ? this->trajectory.LoadConverted(directory + str) : this->trajectory.Load(directory + str))
 			{
 				if (this->trajectory.Length() > 0)
 				{
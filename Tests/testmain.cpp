@@ -30,6 +30,8 @@ using test_case = std::pair<std::string, test_ptr>; // Function pointer and name
 #include "tests_TaskStaticHSSymmetricDecay.cpp"
 #include "tests_TaskStaticSS.cpp"
 #include "tests_TaskStaticRPOnlyHSSymDec.cpp"
+#include "tests_TaskActionSpectrumHistogram.cpp"
+#include "tests_TaskGammaCompute.cpp"
 //////////////////////////////////////////////////////////////////////////////
 // A simple test to test the test module itself
 bool this_is_a_test_of_the_test_module()
@@ -62,6 +64,8 @@ int main(int argc, char **argv)
 	AddTaskStaticHSSymmetricDecayTests(cases);
 	AddTaskStaticSSTests(cases);
 	AddTaskStaticRPOnlyHSSymDecTests(cases);
+	AddTaskActionSpectrumHistogramTests(cases);
+	AddTaskGammaComputeTests(cases);
 
 	// Loop through all test cases and test them
 	for (auto i = cases.cbegin(); i != cases.cend(); i++)
@@ -0,0 +1,285 @@
+//////////////////////////////////////////////////////////////////////////////
+// MolSpin Unit Testing Module
+//
+// Tests the action-spectrum histogram, both the binning of the resonance
+// effects and the histograms written by the task.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+//////////////////////////////////////////////////////////////////////////////
+#include "TaskActionSpectrumHistogram.h"
+//////////////////////////////////////////////////////////////////////////////
+// Reads the step and the histogram from a line written by the task
+bool read_histogram_for_test_actionspectrumhistogram(const std::string &_line, arma::vec &_heights)
+{
+	std::istringstream stream(_line);
+	double step = 0.0;
+	stream >> step;
+
+	std::vector<double> values;
+	double value = 0.0;
+	while (stream >> value)
+		values.push_back(value);
+
+	_heights = arma::vec(values);
+	return !values.empty();
+}
+//////////////////////////////////////////////////////////////////////////////
+// Compares the binning of the resonance effects, which runs over tiles of eigenstates in parallel, with the binning of the arrays of
+// all energy gaps and resonance effects. The dimension spans several tiles, and some of the gaps are above the upper limit.
+bool test_task_actionspectrumhistogram_binning()
+{
+	// Setup objects for the test
+	const unsigned int dim = 150;
+	arma::vec eigenvalues(dim);
+	arma::vec populations(dim);
+	arma::cx_mat T(dim, dim);
+	for (unsigned int k = 0; k < dim; k++)
+	{
+		eigenvalues(k) = 0.37 * k + 0.5 * std::sin(1.0 * k);
+		populations(k) = (1.0 + std::cos(2.0 * k)) / dim;
+		for (unsigned int s = 0; s < dim; s++)
+			T(k, s) = arma::cx_double(std::sin(k + 2.0 * s), std::cos(3.0 * k - s));
+	}
+
+	const double bin_width = 0.7;
+	const double prefactor = 1.3;
+	const unsigned int num_bins = 60;
+
+	// The arrays of all energy gaps and resonance effects, binned one after another
+	std::vector<double> gaps;
+	std::vector<double> effects;
+	for (unsigned int s = 0; s < dim; s++)
+	{
+		for (unsigned int k = 0; k < s; k++)
+		{
+			gaps.push_back(std::abs(eigenvalues(k) - eigenvalues(s)) * prefactor);
+			effects.push_back(std::abs(populations(k) - populations(s)) * std::norm(T(k, s)));
+		}
+	}
+
+	arma::vec expected(num_bins, arma::fill::zeros);
+	unsigned int outside = 0;
+	for (unsigned int i = 0; i < gaps.size(); i++)
+	{
+		unsigned int bin = static_cast<unsigned int>(std::floor(gaps[i] / bin_width));
+		if (bin < num_bins)
+			expected(bin) += effects[i];
+		else
+			outside++;
+	}
+
+	// Perform the test
+	arma::vec heights(num_bins, arma::fill::zeros);
+	RunSection::AccumulateResonanceEffects(eigenvalues, populations, T, bin_width, prefactor, heights);
+
+	bool isCorrect = (outside > 0);
+	isCorrect &= equal_vec(heights, expected, 1e-10);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests that "accumulate" sums the histograms of the steps. The field is rotated between the steps, and a second task without
+// "accumulate" gives the histogram of each step. The accumulated histogram of the second step must be a weighted average of these.
+bool test_task_actionspectrumhistogram_accumulate()
+{
+	// Setup objects for the test
+	// Spins
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;tensor=isotropic(1);");
+
+	// Interactions
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=anisotropic(2e-4, 3e-4, 8e-4);");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=zeeman;spins=electron1;field=0 0 5e-4;");
+
+	// States
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spin(electron1)=|1/2>;");
+
+	// SpinSystem
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(state1);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->ValidateInteractions();
+
+	// Add an ObjectParser with settings to the SpinSystem
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection to run the calculation
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// Create the tasks and get pointers to them
+	MSDParser::ObjectParser accumulatingParser("accumulating", "type=actionspectrumhistogram;bin_width=1;upper_limit=40;units_in_MHz=true;rf_field=1 0 0;accumulate=true;");
+	MSDParser::ObjectParser singleParser("single", "type=actionspectrumhistogram;bin_width=1;upper_limit=40;units_in_MHz=true;rf_field=1 0 0;");
+	rs.Add(MSDParser::ObjectType::Task, accumulatingParser);
+	rs.Add(MSDParser::ObjectType::Task, singleParser);
+	auto accumulating = rs.GetTask("accumulating");
+	auto single = rs.GetTask("single");
+
+	// Create an Action
+	MSDParser::ObjectParser actionParser("action1", "type=rotatevector;vector=System.interaction2.field;axis=0 1 0;value=60;");
+	rs.Add(MSDParser::ObjectType::Action, actionParser);
+
+	// Set the Log and Data streams to something we can read off within this function
+	std::ostringstream logstream;
+	std::ostringstream accumulatingData;
+	std::ostringstream singleData;
+	accumulating->SetLogStream(logstream);
+	accumulating->SetDataStream(accumulatingData);
+	single->SetLogStream(logstream);
+	single->SetDataStream(singleData);
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys); // Get a valid state object
+	std::vector<arma::vec> accumulated(2);
+	std::vector<arma::vec> separate(2);
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		isCorrect &= rs.Run(i + 1);
+
+		// Remove header from first run
+		std::string accumulating_string = accumulatingData.str();
+		std::string single_string = singleData.str();
+		if (i == 0)
+		{
+			accumulating_string.erase(0, accumulating_string.find("\n") + 1);
+			single_string.erase(0, single_string.find("\n") + 1);
+		}
+
+		isCorrect &= read_histogram_for_test_actionspectrumhistogram(accumulating_string, accumulated[i]);
+		isCorrect &= read_histogram_for_test_actionspectrumhistogram(single_string, separate[i]);
+		accumulatingData.str("");
+		accumulatingData.clear();
+		singleData.str("");
+		singleData.clear();
+		isCorrect &= rs.Step(i + 2);
+	}
+
+	if (!isCorrect || accumulated[0].n_elem != separate[0].n_elem || accumulated[1].n_elem != separate[1].n_elem)
+		return false;
+
+	// The histograms are written with the precision of the Armadillo output
+	const double tolerance = 1e-3;
+	isCorrect &= equal_vec(accumulated[0], separate[0], tolerance);
+	isCorrect &= (arma::abs(separate[1] - separate[0]).max() > 100.0 * tolerance);
+
+	// The weights of the two steps are their unnormalised sums, which are found from the best fit
+	arma::vec difference = separate[0] - separate[1];
+	double weight = arma::dot(accumulated[1] - separate[1], difference) / arma::dot(difference, difference);
+	isCorrect &= (weight > 0.0 && weight < 1.0);
+	isCorrect &= equal_vec(accumulated[1], arma::vec(weight * separate[0] + (1.0 - weight) * separate[1]), tolerance);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests that "accumulate" is rejected for the copies of the task that run the steps of "--parallel-steps", which keep their output in memory
+bool test_task_actionspectrumhistogram_accumulate_parallelsteps()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=zeeman;spins=electron1;field=0 0 5e-4;");
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spin(electron1)=|1/2>;");
+
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(state1);
+	spinsys->Add(interaction1);
+	spinsys->ValidateInteractions();
+
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection that keeps the output in memory, as for the workers of "--parallel-steps"
+	RunSection::RunSection rs;
+	rs.SetBufferOutputMode(true);
+	rs.Add(spinsys);
+
+	MSDParser::ObjectParser accumulatingParser("accumulating", "type=actionspectrumhistogram;bin_width=1;upper_limit=40;units_in_MHz=true;rf_field=1 0 0;accumulate=true;");
+	MSDParser::ObjectParser singleParser("single", "type=actionspectrumhistogram;bin_width=1;upper_limit=40;units_in_MHz=true;rf_field=1 0 0;");
+	rs.Add(MSDParser::ObjectType::Task, accumulatingParser);
+	rs.Add(MSDParser::ObjectType::Task, singleParser);
+	auto accumulating = rs.GetTask("accumulating");
+	auto single = rs.GetTask("single");
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= !accumulating->IsValid();
+	isCorrect &= single->IsValid();
+
+	std::vector<std::string> logs;
+	std::vector<std::string> data;
+	isCorrect &= rs.TakeBufferedOutput(logs, data);
+	isCorrect &= (logs.size() == 2 && logs[0].find("--parallel-steps") != std::string::npos);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests that a histogram without any transitions below the upper limit is written as zeros
+bool test_task_actionspectrumhistogram_empty()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=zeeman;spins=electron1;field=0 0 5e-4;");
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spin(electron1)=|1/2>;");
+
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(state1);
+	spinsys->Add(interaction1);
+	spinsys->ValidateInteractions();
+
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// The gap of about 14 MHz is above the upper limit
+	std::string taskname = "testtask";
+	MSDParser::ObjectParser taskParser(taskname, "type=actionspectrumhistogram;bin_width=1;upper_limit=5;units_in_MHz=true;rf_field=perpendicular;");
+	rs.Add(MSDParser::ObjectType::Task, taskParser);
+	auto task = rs.GetTask(taskname);
+
+	std::ostringstream logstream;
+	std::ostringstream datastream;
+	task->SetLogStream(logstream);
+	task->SetDataStream(datastream);
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys);
+	isCorrect &= rs.Run(1);
+
+	std::string result_string = datastream.str();
+	result_string.erase(0, result_string.find("\n") + 1);
+
+	arma::vec heights;
+	isCorrect &= read_histogram_for_test_actionspectrumhistogram(result_string, heights);
+	isCorrect &= heights.is_finite();
+	isCorrect &= (arma::abs(heights).max() == 0.0);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Add all the test cases
+void AddTaskActionSpectrumHistogramTests(std::vector<test_case> &_cases)
+{
+	_cases.push_back(test_case("Task ActionSpectrumHistogram binning compared to arrays of all gaps", test_task_actionspectrumhistogram_binning));
+	_cases.push_back(test_case("Task ActionSpectrumHistogram accumulated over two steps", test_task_actionspectrumhistogram_accumulate));
+	_cases.push_back(test_case("Task ActionSpectrumHistogram rejects accumulate with parallel steps", test_task_actionspectrumhistogram_accumulate_parallelsteps));
+	_cases.push_back(test_case("Task ActionSpectrumHistogram without transitions below the upper limit", test_task_actionspectrumhistogram_empty));
+}
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////
+// MolSpin Unit Testing Module
+//
+// Tests the Gamma-COMPUTE method for periodic time-dependent Hamiltonians.
+//
+// Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
+// (c) 2019 Quantum Biology and Computational Physics Group.
+// See LICENSE.txt for license information.
+//////////////////////////////////////////////////////////////////////////////
+#include "TaskGammaCompute.h"
+//////////////////////////////////////////////////////////////////////////////
+// Tests a single calculation with an oscillating field, both with stored propagators and with propagators that are
+// recomputed for each state. The gold values were obtained with the correlation sum over all pairs of steps.
+bool test_task_gammacompute_oscillatingfield()
+{
+	// Setup objects for the test
+	// Spins
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;tensor=isotropic(1);");
+
+	// Interactions
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=isotropic(5e-4);");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=zeeman;spins=electron1;field=0 0 1e-3;");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=zeeman;spins=electron1;field=5e-4 0 0;fieldtype=oscillating;frequency=0.2;");
+
+	// States
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spin(electron1)=|1/2>;");
+	auto state2 = std::make_shared<SpinAPI::State>("state2", ""); // Identity
+
+	// SpinSystem
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(state1);
+	spinsys->Add(state2);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->Add(interaction3);
+	spinsys->ValidateInteractions();
+
+	// Add an ObjectParser with settings to the SpinSystem
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection to run the calculation
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// Create a task for each of the storepropagators settings and get pointers to them
+	MSDParser::ObjectParser storedParser("storedtask", "type=gamma-compute;steps=50;decayrate=0.05;storepropagators=true;");
+	MSDParser::ObjectParser recomputedParser("recomputedtask", "type=gamma-compute;steps=50;decayrate=0.05;storepropagators=false;");
+	rs.Add(MSDParser::ObjectType::Task, storedParser);
+	rs.Add(MSDParser::ObjectType::Task, recomputedParser);
+	auto storedtask = rs.GetTask("storedtask");
+	auto recomputedtask = rs.GetTask("recomputedtask");
+
+	// Set the Log and Data streams to something we can read off within this function
+	std::ostringstream logstream;
+	std::ostringstream storedstream;
+	std::ostringstream recomputedstream;
+	storedtask->SetLogStream(logstream);
+	storedtask->SetDataStream(storedstream);
+	recomputedtask->SetLogStream(logstream);
+	recomputedtask->SetDataStream(recomputedstream);
+
+	// "Gold values", i.e. correct results to test against.
+	std::string value1 = "1 3.18591 2.50663";
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys); // Get a valid state object
+	isCorrect &= state2->ParseFromSystem(*spinsys); // Get a valid state object; Identity
+	isCorrect &= rs.Run(1);							// Run a calculation
+
+	// Remove header from first run
+	for (auto stream : {&storedstream, &recomputedstream})
+	{
+		std::string result_string = stream->str();
+		auto lb = result_string.find("\n");
+		if (lb != std::string::npos && lb < result_string.size() - 1)
+		{
+			result_string.erase(0, lb + 1);
+		}
+
+		isCorrect &= equal_doublesfromstring(result_string, value1, 1e-5);
+	}
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Add all the test cases
+void AddTaskGammaComputeTests(std::vector<test_case> &_cases)
+{
+	_cases.push_back(test_case("Task GammaCompute with stored and recomputed propagators", test_task_gammacompute_oscillatingfield));
+}
+//////////////////////////////////////////////////////////////////////////////
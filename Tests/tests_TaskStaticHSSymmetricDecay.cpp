@@ -200,10 +200,120 @@ bool test_task_statichssymmetricdecay_simplemodel2()
 	return isCorrect;
 }
 //////////////////////////////////////////////////////////////////////////////
+// Tests a Hamiltonian with complex matrix elements, from a Zeeman field with a y-component, against a direct summation over the eigenstates
+bool test_task_statichssymmetricdecay_complexhamiltonian()
+{
+	// Setup objects for the test
+	// Spins
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;tensor=isotropic(1);");
+	auto spin4 = std::make_shared<SpinAPI::Spin>("nucleus2", "spin=1/2;tensor=isotropic(1);");
+
+	// Interactions
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=anisotropic(2e-4, 3e-4, 8e-4);");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron2;group2=nucleus2;tensor=anisotropic(1e-4, 1e-4, 1e-3);");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=zeeman;spins=electron1,electron2;field=0 3e-5 4e-5;");
+
+	// States
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spins(electron1,electron2)=|1/2,-1/2>-|-1/2,1/2>;"); // Singlet
+	auto state2 = std::make_shared<SpinAPI::State>("state2", "spin(electron1)=|1/2>;spin(electron2)=|1/2>;");	   // |T+>
+
+	// SpinSystem
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(spin3);
+	spinsys->Add(spin4);
+	spinsys->Add(state1);
+	spinsys->Add(state2);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->Add(interaction3);
+	spinsys->ValidateInteractions();
+
+	// Add an ObjectParser with settings to the SpinSystem
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection to run the calculation
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// Create a task and get a pointer to it
+	std::string taskname = "testtask";
+	MSDParser::ObjectParser taskParser(taskname, "type=statichs-symmetricdecay;rateconstant=1e-4;");
+	rs.Add(MSDParser::ObjectType::Task, taskParser);
+	auto task = rs.GetTask(taskname);
+
+	// Set the Log and Data streams to something we can read off within this function
+	std::ostringstream logstream;
+	std::ostringstream datastream;
+	task->SetLogStream(logstream);
+	task->SetDataStream(datastream);
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys); // Get a valid state object; Singlet
+	isCorrect &= state2->ParseFromSystem(*spinsys); // Get a valid state object; |T+>
+	isCorrect &= rs.Run(1);							// Run a calculation
+
+	// Remove header from first run
+	std::string result_string = datastream.str();
+	auto lb = result_string.find("\n");
+	if (lb != std::string::npos)
+	{
+		result_string.erase(0, lb + 1);
+	}
+
+	// The yields summed over all pairs of eigenstates, as the task did before the summation was written as matrix products
+	SpinAPI::SpinSpace space(*spinsys);
+	arma::cx_mat H;
+	arma::cx_mat rho0;
+	isCorrect &= space.Hamiltonian(H);
+	isCorrect &= space.GetState(state1, rho0);
+	rho0 /= arma::trace(rho0);
+
+	arma::vec lambda;
+	arma::cx_mat V;
+	isCorrect &= arma::eig_sym(lambda, V, H);
+	const double ksq = 1e-4 * 1e-4;
+	arma::cx_mat rho0V = rho0 * V;
+
+	std::ostringstream expected;
+	expected << "1";
+	SpinAPI::state_ptr states[2] = {state1, state2};
+	for (unsigned int s = 0; s < 2; s++)
+	{
+		arma::cx_mat P;
+		isCorrect &= space.GetState(states[s], P);
+
+		double yield = 0.0;
+		for (unsigned int h = 0; h < lambda.n_elem; h++)
+		{
+			arma::cx_mat PV = P * V.col(h) * rho0V.col(h).t();
+			for (unsigned int g = 0; g < lambda.n_elem; g++)
+			{
+				double w = lambda(g) - lambda(h);
+				yield += std::real(arma::cdot(V.col(g), PV * V.col(g))) / (1.0 + w * w / ksq);
+			}
+		}
+		expected << " " << yield;
+	}
+
+	// The output is written with the default precision of the stream
+	isCorrect &= equal_doublesfromstring(result_string, expected.str(), 1e-5);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
 // Add all the test cases
 void AddTaskStaticHSSymmetricDecayTests(std::vector<test_case> &_cases)
 {
 	_cases.push_back(test_case("Task StaticHS-SymmetricDecay test 1", test_task_statichssymmetricdecay_simplemodel));
 	_cases.push_back(test_case("Task StaticHS-SymmetricDecay test 2", test_task_statichssymmetricdecay_simplemodel2));
+	_cases.push_back(test_case("Task StaticHS-SymmetricDecay complex Hamiltonian", test_task_statichssymmetricdecay_complexhamiltonian));
 }
 //////////////////////////////////////////////////////////////////////////////
@@ -201,10 +201,72 @@ bool test_task_staticrponlyhssymdec_simplemodel2()
 	return isCorrect;
 }
 //////////////////////////////////////////////////////////////////////////////
+// The radical Hilbert spaces do not account for the multiplicities of a group of equivalent spins, so the task must be rejected
+bool test_task_staticrponlyhssymdec_equivalentspins()
+{
+	// Setup objects for the test
+	// Spins, where "nuclei1" is a group of two equivalent nuclei
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);type=electron;");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);type=electron;");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nuclei1", "spin=1/2;tensor=isotropic(1);equivalent=2;");
+
+	// Interactions
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nuclei1;tensor=isotropic(5e-4);");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=zeeman;spins=electron1,electron2;field=0 0 5e-5;");
+
+	// States
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spins(electron1,electron2)=|1/2,-1/2>-|-1/2,1/2>;"); // Singlet
+
+	// SpinSystem
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(spin3);
+	spinsys->Add(state1);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->ValidateInteractions();
+
+	// Add an ObjectParser with settings to the SpinSystem
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection to run the calculation
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// Create a task and get a pointer to it
+	std::string taskname = "testtask";
+	MSDParser::ObjectParser taskParser(taskname, "type=rp-symmetricuncoupled;rateconstant=1e-4;");
+	rs.Add(MSDParser::ObjectType::Task, taskParser);
+	auto task = rs.GetTask(taskname);
+
+	// Set the Log and Data streams to something we can read off within this function
+	std::ostringstream logstream;
+	std::ostringstream datastream;
+	task->SetLogStream(logstream);
+	task->SetDataStream(datastream);
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys); // Get a valid state object; Singlet
+	rs.Run(1);										// Run a calculation, which should not be performed
+
+	// The task must be invalid, and no yields must be written
+	isCorrect &= !task->IsValid();
+	isCorrect &= datastream.str().empty();
+	isCorrect &= (logstream.str().find("equivalent spins") != std::string::npos);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
 // Add all the test cases
 void AddTaskStaticRPOnlyHSSymDecTests(std::vector<test_case> &_cases)
 {
 	_cases.push_back(test_case("Task RP-SymmetricUncoupled test 1", test_task_staticrponlyhssymdec_simplemodel));
 	_cases.push_back(test_case("Task RP-SymmetricUncoupled test 2", test_task_staticrponlyhssymdec_simplemodel2));
+	_cases.push_back(test_case("Task RP-SymmetricUncoupled rejects groups of equivalent spins", test_task_staticrponlyhssymdec_equivalentspins));
 }
 //////////////////////////////////////////////////////////////////////////////
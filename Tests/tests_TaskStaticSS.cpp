@@ -8,6 +8,7 @@
 // See LICENSE.txt for license information.
 //////////////////////////////////////////////////////////////////////////////
 #include "TaskStaticSS.h"
+#include "TaskStaticSSRedfield.h"
 //////////////////////////////////////////////////////////////////////////////
 // Tests a single calculation without any Actions
 bool test_task_staticss_simplemodel()
@@ -95,6 +96,375 @@ bool test_task_staticss_simplemodel()
 	return isCorrect;
 }
 //////////////////////////////////////////////////////////////////////////////
+// Like the first test, but solving the Liouville-space equation with the iterative sparse solvers
+bool test_task_staticss_simplemodel_iterativesolvers()
+{
+	// Setup objects for the test
+	// Spins
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;tensor=isotropic(1);");
+	auto spin4 = std::make_shared<SpinAPI::Spin>("nucleus2", "spin=1/2;tensor=isotropic(1);");
+
+	// Interactions
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=isotropic(5e-4);");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron2;group2=nucleus2;tensor=anisotropic(1e-4, 1e-4, 1e-3);");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=zeeman;spins=electron1,electron2;field=0 0 5e-5;");
+
+	// States
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spins(electron1,electron2)=|1/2,-1/2>-|-1/2,1/2>;"); // Singlet
+	auto state2 = std::make_shared<SpinAPI::State>("state2", "spin(electron1)=|1/2>;spin(electron2)=|1/2>;");	   // |T+>
+	auto state3 = std::make_shared<SpinAPI::State>("state3", "");												   // Identity
+
+	// SpinSystem
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(spin3);
+	spinsys->Add(spin4);
+	spinsys->Add(state1);
+	spinsys->Add(state2);
+	spinsys->Add(state3);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->Add(interaction3);
+	spinsys->ValidateInteractions();
+	std::vector<std::shared_ptr<SpinAPI::SpinSystem>> spinsystems;
+	spinsystems.push_back(spinsys);
+
+	// Transition
+	auto transition1 = std::make_shared<SpinAPI::Transition>("transition1", "sourcestate=state3;rate=1e-4;", spinsys);
+	spinsys->Add(transition1);
+
+	// Add an ObjectParser with settings to the SpinSystem
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection to run the calculation
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// Create a task for each of the iterative solvers and get pointers to them
+	std::string gmresname = "gmrestask";
+	std::string bicgstabname = "bicgstabtask";
+	MSDParser::ObjectParser gmresParser(gmresname, "type=staticss;solver=gmres;solvertolerance=1e-12;solverrestart=256;solvermaxiterations=5000;");
+	MSDParser::ObjectParser bicgstabParser(bicgstabname, "type=staticss;solver=bicgstab;solvertolerance=1e-12;solvermaxiterations=5000;");
+	rs.Add(MSDParser::ObjectType::Task, gmresParser);
+	rs.Add(MSDParser::ObjectType::Task, bicgstabParser);
+	auto gmrestask = rs.GetTask(gmresname);
+	auto bicgstabtask = rs.GetTask(bicgstabname);
+
+	// Set the Log and Data streams to something we can read off within this function
+	std::ostringstream logstream;
+	std::ostringstream gmresstream;
+	std::ostringstream bicgstabstream;
+	gmrestask->SetLogStream(logstream);
+	gmrestask->SetDataStream(gmresstream);
+	bicgstabtask->SetLogStream(logstream);
+	bicgstabtask->SetDataStream(bicgstabstream);
+
+	// "Gold values", i.e. correct results to test against.
+	std::string value1 = "1 3257.57 1742.56 10000";
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys);							// Get a valid state object; Singlet
+	isCorrect &= state2->ParseFromSystem(*spinsys);							// Get a valid state object; |T+>
+	isCorrect &= state3->ParseFromSystem(*spinsys);							// Get a valid state object; Identity
+	isCorrect &= ((spinsys->ValidateTransitions(spinsystems)).size() == 0); // Put state object into transition
+	isCorrect &= rs.Run(1);													// Run a calculation
+
+	// Remove header from first run, and compare to the result of the dense solver
+	for (auto stream : {&gmresstream, &bicgstabstream})
+	{
+		std::string result_string = stream->str();
+		auto lb = result_string.find("\n");
+		if (lb != std::string::npos && lb < result_string.size() - 1)
+		{
+			result_string.erase(0, lb + 1);
+		}
+
+		isCorrect &= equal_doublesfromstring(result_string, value1);
+	}
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// An iterative solver that does not converge within the iteration limit must not write yields
+bool test_task_staticss_simplemodel_iterativesolvers_notconverged()
+{
+	// Setup objects for the test
+	// Spins
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;tensor=isotropic(1);");
+	auto spin4 = std::make_shared<SpinAPI::Spin>("nucleus2", "spin=1/2;tensor=isotropic(1);");
+
+	// Interactions
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=isotropic(5e-4);");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron2;group2=nucleus2;tensor=anisotropic(1e-4, 1e-4, 1e-3);");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=zeeman;spins=electron1,electron2;field=0 0 5e-5;");
+
+	// States
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spins(electron1,electron2)=|1/2,-1/2>-|-1/2,1/2>;"); // Singlet
+	auto state2 = std::make_shared<SpinAPI::State>("state2", "spin(electron1)=|1/2>;spin(electron2)=|1/2>;");	   // |T+>
+	auto state3 = std::make_shared<SpinAPI::State>("state3", "");												   // Identity
+
+	// SpinSystem
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(spin3);
+	spinsys->Add(spin4);
+	spinsys->Add(state1);
+	spinsys->Add(state2);
+	spinsys->Add(state3);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->Add(interaction3);
+	spinsys->ValidateInteractions();
+	std::vector<std::shared_ptr<SpinAPI::SpinSystem>> spinsystems;
+	spinsystems.push_back(spinsys);
+
+	// Transition
+	auto transition1 = std::make_shared<SpinAPI::Transition>("transition1", "sourcestate=state3;rate=1e-4;", spinsys);
+	spinsys->Add(transition1);
+
+	// Add an ObjectParser with settings to the SpinSystem
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection to run the calculation
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// A task with far too few iterations for the solver to converge
+	std::string taskname = "gmrestask";
+	MSDParser::ObjectParser taskParser(taskname, "type=staticss;solver=gmres;solvertolerance=1e-12;solverrestart=2;solvermaxiterations=1;");
+	rs.Add(MSDParser::ObjectType::Task, taskParser);
+	auto task = rs.GetTask(taskname);
+
+	// Set the Log and Data streams to something we can read off within this function
+	std::ostringstream logstream;
+	std::ostringstream datastream;
+	task->SetLogStream(logstream);
+	task->SetDataStream(datastream);
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys);							// Get a valid state object; Singlet
+	isCorrect &= state2->ParseFromSystem(*spinsys);							// Get a valid state object; |T+>
+	isCorrect &= state3->ParseFromSystem(*spinsys);							// Get a valid state object; Identity
+	isCorrect &= ((spinsys->ValidateTransitions(spinsystems)).size() == 0); // Put state object into transition
+	isCorrect &= rs.Run(1);													// Run a calculation
+
+	// Only the header and an empty line should have been written, and the failure should be reported in the log
+	std::string result_string = datastream.str();
+	auto lb = result_string.find("\n");
+	isCorrect &= (lb != std::string::npos);
+	if (lb != std::string::npos)
+		isCorrect &= (result_string.substr(lb + 1).compare("\n") == 0);
+	isCorrect &= (logstream.str().find("did not reach the requested tolerance") != std::string::npos);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Like the first test, but solving the Sylvester equation in the Hilbert space
+bool test_task_staticss_simplemodel_sylvester()
+{
+	// Setup objects for the test
+	// Spins
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;tensor=isotropic(1);");
+	auto spin4 = std::make_shared<SpinAPI::Spin>("nucleus2", "spin=1/2;tensor=isotropic(1);");
+
+	// Interactions
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=isotropic(5e-4);");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron2;group2=nucleus2;tensor=anisotropic(1e-4, 1e-4, 1e-3);");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=zeeman;spins=electron1,electron2;field=0 0 5e-5;");
+
+	// States
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spins(electron1,electron2)=|1/2,-1/2>-|-1/2,1/2>;"); // Singlet
+	auto state2 = std::make_shared<SpinAPI::State>("state2", "spin(electron1)=|1/2>;spin(electron2)=|1/2>;");	   // |T+>
+	auto state3 = std::make_shared<SpinAPI::State>("state3", "");												   // Identity
+
+	// SpinSystem
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(spin3);
+	spinsys->Add(spin4);
+	spinsys->Add(state1);
+	spinsys->Add(state2);
+	spinsys->Add(state3);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->Add(interaction3);
+	spinsys->ValidateInteractions();
+	std::vector<std::shared_ptr<SpinAPI::SpinSystem>> spinsystems;
+	spinsystems.push_back(spinsys);
+
+	// Transition
+	auto transition1 = std::make_shared<SpinAPI::Transition>("transition1", "sourcestate=state3;rate=1e-4;", spinsys);
+	spinsys->Add(transition1);
+
+	// Add an ObjectParser with settings to the SpinSystem
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection to run the calculation
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// Create a task and get a pointer to it
+	std::string taskname = "testtask";
+	MSDParser::ObjectParser taskParser(taskname, "type=staticss;solver=sylvester;");
+	rs.Add(MSDParser::ObjectType::Task, taskParser);
+	auto task = rs.GetTask(taskname);
+
+	// Set the Log and Data streams to something we can read off within this function
+	std::ostringstream logstream;
+	std::ostringstream datastream;
+	task->SetLogStream(logstream);
+	task->SetDataStream(datastream);
+
+	// "Gold values", i.e. correct results to test against.
+	std::string value1 = "1 3257.57 1742.56 10000";
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys);							// Get a valid state object; Singlet
+	isCorrect &= state2->ParseFromSystem(*spinsys);							// Get a valid state object; |T+>
+	isCorrect &= state3->ParseFromSystem(*spinsys);							// Get a valid state object; Identity
+	isCorrect &= ((spinsys->ValidateTransitions(spinsystems)).size() == 0); // Put state object into transition
+	isCorrect &= rs.Run(1);													// Run a calculation
+
+	// Remove header from first run
+	std::string result_string = datastream.str();
+	auto lb = result_string.find("\n");
+	if (lb != std::string::npos && lb < result_string.size() - 1)
+	{
+		result_string.erase(0, lb + 1);
+	}
+
+	isCorrect &= equal_doublesfromstring(result_string, value1);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Like the first test, but running two steps. The tasks create a new SpinSpace in each step,
+// so the interaction operators of the first step must be reused from the Interaction objects.
+bool test_task_staticss_simplemodel_cachedoperators()
+{
+	// Setup objects for the test
+	// Spins
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;tensor=isotropic(1);");
+	auto spin4 = std::make_shared<SpinAPI::Spin>("nucleus2", "spin=1/2;tensor=isotropic(1);");
+
+	// Interactions
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=isotropic(5e-4);");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron2;group2=nucleus2;tensor=anisotropic(1e-4, 1e-4, 1e-3);");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=zeeman;spins=electron1,electron2;field=0 0 5e-5;");
+
+	// States
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spins(electron1,electron2)=|1/2,-1/2>-|-1/2,1/2>;"); // Singlet
+	auto state2 = std::make_shared<SpinAPI::State>("state2", "spin(electron1)=|1/2>;spin(electron2)=|1/2>;");	   // |T+>
+	auto state3 = std::make_shared<SpinAPI::State>("state3", "");												   // Identity
+
+	// SpinSystem
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(spin3);
+	spinsys->Add(spin4);
+	spinsys->Add(state1);
+	spinsys->Add(state2);
+	spinsys->Add(state3);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->Add(interaction3);
+	spinsys->ValidateInteractions();
+	std::vector<std::shared_ptr<SpinAPI::SpinSystem>> spinsystems;
+	spinsystems.push_back(spinsys);
+
+	// Transition
+	auto transition1 = std::make_shared<SpinAPI::Transition>("transition1", "sourcestate=state3;rate=1e-4;", spinsys);
+	spinsys->Add(transition1);
+
+	// Add an ObjectParser with settings to the SpinSystem
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection to run the calculation
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// Create a task and get a pointer to it
+	std::string taskname = "testtask";
+	MSDParser::ObjectParser taskParser(taskname, "type=staticss;");
+	rs.Add(MSDParser::ObjectType::Task, taskParser);
+	auto task = rs.GetTask(taskname);
+
+	// Set the Log and Data streams to something we can read off within this function
+	std::ostringstream logstream;
+	std::ostringstream datastream;
+	task->SetLogStream(logstream);
+	task->SetDataStream(datastream);
+
+	// "Gold values", as in the first test since nothing changes between the steps
+	std::string values[2] = {"1 3257.57 1742.56 10000", "2 3257.57 1742.56 10000"};
+	std::shared_ptr<SpinAPI::Interaction> interactions[3] = {interaction1, interaction2, interaction3};
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys);							// Get a valid state object; Singlet
+	isCorrect &= state2->ParseFromSystem(*spinsys);							// Get a valid state object; |T+>
+	isCorrect &= state3->ParseFromSystem(*spinsys);							// Get a valid state object; Identity
+	isCorrect &= ((spinsys->ValidateTransitions(spinsystems)).size() == 0); // Put state object into transition
+
+	unsigned int hits[3] = {0, 0, 0};
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		isCorrect &= rs.Run(i + 1);
+
+		// Remove header from first run
+		std::string result_string = datastream.str();
+		auto lb = result_string.find("\n");
+		if (lb != std::string::npos && lb < result_string.size() - 1)
+		{
+			result_string.erase(0, lb + 1);
+		}
+
+		isCorrect &= equal_doublesfromstring(result_string, values[i]);
+		datastream.str("");
+		datastream.clear();
+
+		// The first step creates the operators, and the second step must use them
+		for (unsigned int j = 0; j < 3; j++)
+		{
+			if (i == 0)
+				hits[j] = interactions[j]->CachedOperatorHits();
+			else
+				isCorrect &= (interactions[j]->CachedOperatorHits() > hits[j]);
+		}
+
+		isCorrect &= rs.Step(i + 2);
+	}
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
 // Like the previous, but with a RotateVector action on the Zeeman field
 bool test_task_staticss_simplemodel2()
 {
@@ -340,11 +710,119 @@ bool test_task_staticss_simplemodel2_basisreordering()
 	return isCorrect;
 }
 //////////////////////////////////////////////////////////////////////////////
+// Compares the Redfield yields of the matrix-free mode, where the Redfield tensor is applied in operator form and solved
+// iteratively with both solvers, to the yields obtained with the full Redfield tensor
+bool test_task_staticss_redfield_matrixfree()
+{
+	// Setup objects for the test
+	// Spins
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;tensor=isotropic(1);");
+
+	// Interactions, where the hyperfine interaction is modulated and gives the Redfield relaxation
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=matrix(\"0.5 0.0 0.0;0.0 0.5 0.0;0.0 0.0 2.0\");tau_c=0.1;g=1;");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=zeeman;spins=electron1,electron2;field=0 0 0.5;");
+
+	// States
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spins(electron1,electron2)=|1/2,-1/2>-|-1/2,1/2>;"); // Singlet
+	auto state2 = std::make_shared<SpinAPI::State>("state2", "spins(electron1,electron2)=|1/2,-1/2>+|-1/2,1/2>;"); // |T0>
+
+	// SpinSystem
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(spin3);
+	spinsys->Add(state1);
+	spinsys->Add(state2);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->ValidateInteractions();
+	std::vector<std::shared_ptr<SpinAPI::SpinSystem>> spinsystems;
+	spinsystems.push_back(spinsys);
+
+	// Transitions
+	auto transition1 = std::make_shared<SpinAPI::Transition>("transition1", "sourcestate=state1;rate=0.01;", spinsys);
+	auto transition2 = std::make_shared<SpinAPI::Transition>("transition2", "sourcestate=state2;rate=0.01;", spinsys);
+	spinsys->Add(transition1);
+	spinsys->Add(transition2);
+
+	// Add an ObjectParser with settings to the SpinSystem
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	// A RunSection to run the calculation
+	RunSection::RunSection rs;
+	rs.Add(spinsys);
+
+	// Create a task with the full Redfield tensor, and a matrix-free task for each of the iterative solvers
+	MSDParser::ObjectParser denseParser("densetask", "type=redfield-relaxation;transitionyields=true;");
+	MSDParser::ObjectParser gmresParser("gmrestask", "type=redfield-relaxation;transitionyields=true;matrixfree=true;solver=gmres;solvertolerance=1e-12;solverrestart=64;solvermaxiterations=5000;");
+	MSDParser::ObjectParser bicgstabParser("bicgstabtask", "type=redfield-relaxation;transitionyields=true;matrixfree=true;solver=bicgstab;solvertolerance=1e-12;solvermaxiterations=5000;");
+	rs.Add(MSDParser::ObjectType::Task, denseParser);
+	rs.Add(MSDParser::ObjectType::Task, gmresParser);
+	rs.Add(MSDParser::ObjectType::Task, bicgstabParser);
+	auto densetask = rs.GetTask("densetask");
+	auto gmrestask = rs.GetTask("gmrestask");
+	auto bicgstabtask = rs.GetTask("bicgstabtask");
+
+	// Set the Log and Data streams to something we can read off within this function
+	std::ostringstream logstream;
+	std::ostringstream densestream;
+	std::ostringstream gmresstream;
+	std::ostringstream bicgstabstream;
+	densetask->SetLogStream(logstream);
+	densetask->SetDataStream(densestream);
+	gmrestask->SetLogStream(logstream);
+	gmrestask->SetDataStream(gmresstream);
+	bicgstabtask->SetLogStream(logstream);
+	bicgstabtask->SetDataStream(bicgstabstream);
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= state1->ParseFromSystem(*spinsys);							// Get a valid state object; Singlet
+	isCorrect &= state2->ParseFromSystem(*spinsys);							// Get a valid state object; |T0>
+	isCorrect &= ((spinsys->ValidateTransitions(spinsystems)).size() == 0); // Put state objects into transitions
+	isCorrect &= rs.Run(1);													// Run a calculation
+
+	// The relaxation must have been included, and the matrix-free tasks must not fall back to the full tensor
+	isCorrect &= (logstream.str().find("Added relaxation matrix term") != std::string::npos);
+	isCorrect &= (logstream.str().find("matrix-free") != std::string::npos);
+
+	// Remove header from first run
+	std::vector<std::string> results;
+	for (auto stream : {&densestream, &gmresstream, &bicgstabstream})
+	{
+		std::string result_string = stream->str();
+		auto lb = result_string.find("\n");
+		if (lb != std::string::npos && lb < result_string.size() - 1)
+		{
+			result_string.erase(0, lb + 1);
+		}
+
+		results.push_back(result_string);
+	}
+
+	// The yields are written with the default precision of the data stream
+	isCorrect &= !results[0].empty();
+	isCorrect &= equal_doublesfromstring(results[1], results[0], 1e-5);
+	isCorrect &= equal_doublesfromstring(results[2], results[0], 1e-5);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
 // Add all the test cases
 void AddTaskStaticSSTests(std::vector<test_case> &_cases)
 {
 	_cases.push_back(test_case("Task StaticSS test 1", test_task_staticss_simplemodel));
+	_cases.push_back(test_case("Task StaticSS test 1 - With iterative sparse solvers", test_task_staticss_simplemodel_iterativesolvers));
+	_cases.push_back(test_case("Task StaticSS test 1 - Unconverged iterative solver writes no yields", test_task_staticss_simplemodel_iterativesolvers_notconverged));
+	_cases.push_back(test_case("Task StaticSS test 1 - With the Hilbert space Sylvester solver", test_task_staticss_simplemodel_sylvester));
+	_cases.push_back(test_case("Task StaticSS test 1 - Interaction operators are reused in the next step", test_task_staticss_simplemodel_cachedoperators));
 	_cases.push_back(test_case("Task StaticSS test 2", test_task_staticss_simplemodel2));
 	_cases.push_back(test_case("Task StaticSS test 2 - With spin reordering (tests SpinSpace::GetState for reordering of basis)", test_task_staticss_simplemodel2_basisreordering));
+	_cases.push_back(test_case("Task Redfield-Relaxation - Matrix-free mode compared to the full Redfield tensor", test_task_staticss_redfield_matrixfree));
 }
 //////////////////////////////////////////////////////////////////////////////
@@ -1,7 +1,8 @@
 //////////////////////////////////////////////////////////////////////////////
 // MolSpin Unit Testing Module
 //
-// Unit test functions for the Action classes and ActionTargets.
+// Unit test functions for the Action classes and ActionTargets, and for
+// the orientation averaging that rotates ActionVectors.
 //
 // Molecular Spin Dynamics Software - developed by Claus Nielsen and Luca Gerhards.
 // (c) 2019 Quantum Biology and Computational Physics Group.
@@ -13,6 +14,9 @@
 #include "ActionAddVector.h"
 #include "ActionScaleVector.h"
 #include "ActionRotateVector.h"
+#include "OrientationGrid.h"
+#include "OutputAverage.h"
+#include "BasicTask.h"
 //////////////////////////////////////////////////////////////////////////////
 // Tests the ActionTarget alias ActionScalar
 // First we define a check-function
@@ -241,6 +245,255 @@ bool test_action_rotatevector()
 	return isCorrect;
 }
 //////////////////////////////////////////////////////////////////////////////
+// Tests the orientation grids, which should integrate low order polynomials exactly (Lebedev) or accurately (ZCW)
+bool test_orientationgrid()
+{
+	bool isCorrect = true;
+
+	// <x^2> = 1/3, <x^2 y^2> = 1/15, <z^4> = 1/5 and <x^2 y^2 z^2> = 1/105 over the unit sphere
+	const unsigned int lebedevSizes[8] = {6, 14, 26, 38, 50, 74, 86, 110};
+	for (unsigned int k = 0; k < 8; k++)
+	{
+		RunSection::OrientationGrid grid("lebedev", lebedevSizes[k]);
+		isCorrect &= (grid.Size() == lebedevSizes[k]);
+
+		double sum = 0.0, x2 = 0.0, x2y2 = 0.0, z4 = 0.0, x2y2z2 = 0.0;
+		for (unsigned int i = 0; i < grid.Size(); i++)
+		{
+			const arma::vec &n = grid.Direction(i);
+			sum += grid.Weight(i);
+			x2 += grid.Weight(i) * n(0) * n(0);
+			x2y2 += grid.Weight(i) * n(0) * n(0) * n(1) * n(1);
+			z4 += grid.Weight(i) * std::pow(n(2), 4);
+			x2y2z2 += grid.Weight(i) * n(0) * n(0) * n(1) * n(1) * n(2) * n(2);
+		}
+		isCorrect &= equal_double(sum, 1.0, 1e-12);
+		isCorrect &= equal_double(x2, 1.0 / 3.0, 1e-12);
+		if (lebedevSizes[k] > 6)
+		{
+			isCorrect &= equal_double(x2y2, 1.0 / 15.0, 1e-12);
+			isCorrect &= equal_double(z4, 1.0 / 5.0, 1e-12);
+		}
+		if (lebedevSizes[k] > 14)
+			isCorrect &= equal_double(x2y2z2, 1.0 / 105.0, 1e-12);
+	}
+
+	// Larger Lebedev grids are not tabulated
+	RunSection::OrientationGrid grid;
+	isCorrect &= !grid.Create("lebedev", 111);
+	isCorrect &= !grid.Create("unknown", 10);
+
+	// ZCW grids have a Fibonacci number of points with equal weights
+	isCorrect &= grid.Create("zcw", 1000);
+	isCorrect &= (grid.Size() == 1597);
+	double z2 = 0.0;
+	for (unsigned int i = 0; i < grid.Size(); i++)
+		z2 += grid.Weight(i) * grid.Direction(i)(2) * grid.Direction(i)(2);
+	isCorrect &= equal_double(z2, 1.0 / 3.0, 1e-3);
+
+	// The rotations take the z-axis into the directions, and are proper rotations
+	arma::vec z = {0.0, 0.0, 1.0};
+	for (unsigned int i = 0; i < grid.Size(); i += 97)
+	{
+		arma::mat R = grid.Rotation(i);
+		isCorrect &= equal_vec(R * z, grid.Direction(i), 1e-12);
+		isCorrect &= equal_matrices(R.t() * R, arma::mat(3, 3, arma::fill::eye), 1e-12);
+		isCorrect &= equal_double(arma::det(R), 1.0, 1e-12);
+	}
+
+	// A vector along the x-axis is rotated into the directions, such that its average vanishes
+	arma::vec x = {1.0, 0.0, 0.0};
+	arma::vec y = {0.0, 1.0, 0.0};
+	isCorrect &= grid.Create("lebedev", 110);
+	arma::vec average(3, arma::fill::zeros);
+	for (unsigned int i = 0; i < grid.Size(); i++)
+	{
+		arma::mat R = grid.Rotation(i, 2.0 * x);
+		isCorrect &= equal_vec(R * x, grid.Direction(i), 1e-12);
+		isCorrect &= equal_double(arma::det(R), 1.0, 1e-12);
+		average += grid.Weight(i) * R * x;
+	}
+	isCorrect &= equal_vec(average, arma::vec(3, arma::fill::zeros), 1e-12);
+
+	// With angles about the first vector, a second vector perpendicular to it is also distributed isotropically
+	isCorrect &= grid.Create("lebedev", 110, 4);
+	isCorrect &= (grid.Size() == 440 && grid.GammaPoints() == 4);
+	double sum = 0.0;
+	average.zeros();
+	arma::mat secondMoments(3, 3, arma::fill::zeros);
+	for (unsigned int i = 0; i < grid.Size(); i++)
+	{
+		arma::mat R = grid.Rotation(i, x);
+		isCorrect &= equal_vec(R * x, grid.Direction(i), 1e-12);
+		sum += grid.Weight(i);
+		average += grid.Weight(i) * R * y;
+		secondMoments += grid.Weight(i) * (R * y) * (R * y).t();
+	}
+	isCorrect &= equal_double(sum, 1.0, 1e-12);
+	isCorrect &= equal_vec(average, arma::vec(3, arma::fill::zeros), 1e-12);
+	isCorrect &= equal_matrices(secondMoments, arma::mat(3, 3, arma::fill::eye) / 3.0, 1e-12);
+	isCorrect &= !grid.Create("lebedev", 110, 0);
+
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Creates a radical pair where the yields only depend on the angle between the Zeeman field and the z-axis,
+// as one of the hyperfine tensors is isotropic and the other one is axially symmetric about the z-axis
+std::shared_ptr<SpinAPI::SpinSystem> create_radicalpair_for_test_orientationaverage()
+{
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;tensor=isotropic(1);");
+	auto spin4 = std::make_shared<SpinAPI::Spin>("nucleus2", "spin=1/2;tensor=isotropic(1);");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=isotropic(5e-4);");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron2;group2=nucleus2;tensor=anisotropic(1e-4, 1e-4, 1e-3);");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=zeeman;spins=electron1,electron2;field=0 0 5e-5;");
+
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spins(electron1,electron2)=|1/2,-1/2>-|-1/2,1/2>;"); // Singlet
+	auto state2 = std::make_shared<SpinAPI::State>("state2", "spin(electron1)=|1/2>;spin(electron2)=|1/2>;");	   // |T+>
+
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(spin2);
+	spinsys->Add(spin3);
+	spinsys->Add(spin4);
+	spinsys->Add(state1);
+	spinsys->Add(state2);
+	spinsys->Add(interaction1);
+	spinsys->Add(interaction2);
+	spinsys->Add(interaction3);
+	spinsys->ValidateInteractions();
+	state1->ParseFromSystem(*spinsys);
+	state2->ParseFromSystem(*spinsys);
+
+	auto spinsysParser = std::make_shared<MSDParser::ObjectParser>("spinsyssettings", "initialstate=state1;");
+	spinsys->SetProperties(spinsysParser);
+
+	return spinsys;
+}
+
+// Tests the average of the yields over a Lebedev grid, where the output of each orientation is buffered and averaged as for the
+// "orientationgrid" setting, against a serial scan of the field direction with a RotateVector action. The average over the sphere is
+// then the integral over the angle of the scan weighted by sin(angle), which is calculated with Simpson's rule.
+bool test_orientationaverage_radicalpair()
+{
+	bool isCorrect = true;
+	MSDParser::ObjectParser taskParser("testtask", "type=statichs-symmetricdecay;rateconstant=1e-3;");
+
+	// The average over the Lebedev grid
+	RunSection::RunSection rsGrid;
+	rsGrid.SetBufferOutputMode(true);
+	rsGrid.SetBufferPrecision(17);
+	rsGrid.Add(create_radicalpair_for_test_orientationaverage());
+	rsGrid.Add(MSDParser::ObjectType::Task, taskParser);
+
+	auto vectors = rsGrid.GetActionVectors();
+	auto field = vectors.find("System.interaction3.field");
+	if (field == vectors.end())
+		return false;
+	RunSection::ActionVector fieldVector = field->second;
+	arma::vec initial = fieldVector.Get();
+
+	RunSection::OrientationGrid grid("lebedev", 110);
+	RunSection::OutputAverage average;
+	std::vector<std::string> logs;
+	std::vector<std::string> data;
+	for (unsigned int o = 0; o < grid.Size(); o++)
+	{
+		fieldVector.Set(grid.Rotation(o, initial) * initial);
+		isCorrect &= rsGrid.Run(1);
+		isCorrect &= rsGrid.TakeBufferedOutput(logs, data);
+		if (data.size() != 1)
+			return false;
+		isCorrect &= average.Add(data.front(), grid.Weight(o));
+	}
+
+	// Remove the header
+	std::string result_string = average.Str();
+	auto lb = result_string.find("\n");
+	if (lb != std::string::npos)
+		result_string.erase(0, lb + 1);
+
+	double step = 0.0;
+	arma::vec gridYields(2);
+	std::istringstream gridStream(result_string);
+	gridStream >> step >> gridYields(0) >> gridYields(1);
+	isCorrect &= !gridStream.fail();
+
+	// The serial scan from 0 to 180 degrees
+	const unsigned int scanSteps = 37;
+	const double angleStep = 5.0 * M_PI / 180.0;
+	RunSection::RunSection rsScan;
+	rsScan.Add(create_radicalpair_for_test_orientationaverage());
+	rsScan.Add(MSDParser::ObjectType::Task, taskParser);
+	MSDParser::ObjectParser actionParser("action1", "type=rotatevector;vector=System.interaction3.field;axis=0 1 0;value=5;");
+	rsScan.Add(MSDParser::ObjectType::Action, actionParser);
+
+	std::ostringstream logstream;
+	std::ostringstream datastream;
+	auto task = rsScan.GetTask("testtask");
+	task->SetLogStream(logstream);
+	task->SetDataStream(datastream);
+
+	arma::vec scanYields(2, arma::fill::zeros);
+	for (unsigned int k = 0; k < scanSteps; k++)
+	{
+		isCorrect &= rsScan.Run(k + 1);
+
+		// Remove header from first run
+		result_string = datastream.str();
+		lb = result_string.find("\n");
+		if (k == 0 && lb != std::string::npos)
+			result_string.erase(0, lb + 1);
+
+		arma::vec yields(2);
+		std::istringstream scanStream(result_string);
+		scanStream >> step >> yields(0) >> yields(1);
+		isCorrect &= !scanStream.fail();
+
+		double simpson = (k == 0 || k == scanSteps - 1) ? 1.0 : ((k % 2 == 1) ? 4.0 : 2.0);
+		scanYields += simpson * std::sin(k * angleStep) * yields;
+
+		datastream.str("");
+		datastream.clear();
+		isCorrect &= rsScan.Step(k + 2);
+	}
+	scanYields *= 0.5 * angleStep / 3.0;
+
+	// The scan is written with the default precision of the stream
+	isCorrect &= equal_vec(gridYields, scanYields, 1e-5);
+
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the weighted average of task output, where only the numbers that differ are averaged
+bool test_outputaverage()
+{
+	bool isCorrect = true;
+
+	RunSection::OutputAverage first;
+	RunSection::OutputAverage second;
+	isCorrect &= first.Add("Step yield\n3 0.5 \n", 0.25);
+	isCorrect &= first.Add("Step yield\n3 1.5 \n", 0.25);
+	isCorrect &= second.Add("Step yield\n3 3 \n", 0.5);
+
+	// Combining the averages of two parts of a grid
+	isCorrect &= first.Add(second);
+	isCorrect &= (first.Str().compare("Step yield\n3 2 \n") == 0);
+
+	// Outputs with another layout cannot be averaged
+	RunSection::OutputAverage third;
+	isCorrect &= third.Add("a b", 1.0);
+	isCorrect &= !third.Add("a c", 1.0);
+	isCorrect &= !third.Add("a b c", 1.0);
+
+	first.Clear();
+	isCorrect &= first.Empty();
+
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
 // Add all the Action classes test cases
 void AddActionsTests(std::vector<test_case> &_cases)
 {
@@ -251,5 +504,8 @@ void AddActionsTests(std::vector<test_case> &_cases)
 	_cases.push_back(test_case("Action AddVector", test_action_addvector));
 	_cases.push_back(test_case("Action ScaleVector", test_action_scalevector));
 	_cases.push_back(test_case("Action RotateVector", test_action_rotatevector));
+	_cases.push_back(test_case("RunSection::OrientationGrid quadrature and rotations", test_orientationgrid));
+	_cases.push_back(test_case("RunSection::OutputAverage weighted averages", test_outputaverage));
+	_cases.push_back(test_case("Orientation average of radical pair yields compared to a RotateVector scan", test_orientationaverage_radicalpair));
 }
 //////////////////////////////////////////////////////////////////////////////
@@ -7,7 +7,12 @@
 // (c) 2019 Quantum Biology and Computational Physics Group.
 // See LICENSE.txt for license information.
 //////////////////////////////////////////////////////////////////////////////
+#include <cstdio>
+#include <fstream>
 #include "ObjectParser.h"
+#include "MSDParser.h"
+#include "FileReader.h"
+#include "Settings.h"
 //////////////////////////////////////////////////////////////////////////////
 // Tests the ObjectParser::Get method for strings
 bool test_msdparser_objectparser_getstring()
@@ -220,6 +225,47 @@ bool test_msdparser_objectparser_gettensor()
 	return isCorrect;
 }
 //////////////////////////////////////////////////////////////////////////////
+// Tests that an input with "include" and "define" directives can be loaded more than once, as for the workers of "--parallel-steps"
+bool test_msdparser_loadtwice()
+{
+	// Setup objects for the test
+	std::string mainfile = "/tmp/molspin_test_loadtwice_main.msd";
+	std::string subfile = "/tmp/molspin_test_loadtwice_sub.msd";
+	{
+		std::ofstream main(mainfile);
+		main << "#define STEPCOUNT 7\n#include \"molspin_test_loadtwice_sub.msd\"\n";
+		std::ofstream sub(subfile);
+		sub << "Settings\n{\n\tSettings general\n\t{\n\t\tsteps = STEPCOUNT;\n\t}\n}\n";
+	}
+
+	bool isCorrect = true;
+
+	// Perform the test, the definitions given on the commandline must survive the reset
+	std::map<std::string, std::string> definitions;
+	definitions["COMMANDLINE"] = "1";
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		MSDParser::FileReader::Reset(definitions);
+		MSDParser::MSDParser parser(mainfile);
+		RunSection::RunSection rs;
+		isCorrect &= parser.Load();
+		parser.FillRunSection(rs);
+
+		isCorrect &= (rs.GetSettings()->Steps() == 7);
+		isCorrect &= (MSDParser::FileReader::GetFileList().size() == 2);
+		isCorrect &= (MSDParser::FileReader::GetDefinitions().size() == 2);
+		isCorrect &= (MSDParser::FileReader::GetDefinitions().count("COMMANDLINE") == 1);
+	}
+
+	// Leave no state behind for other tests
+	MSDParser::FileReader::Reset();
+	std::remove(mainfile.c_str());
+	std::remove(subfile.c_str());
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
 // Add all the MSDParser test cases
 void AddMSDParserTests(std::vector<test_case> &_cases)
 {
@@ -229,5 +275,6 @@ void AddMSDParserTests(std::vector<test_case> &_cases)
 	_cases.push_back(test_case("MSDParser::ObjectParser::Get to get boolean", test_msdparser_objectparser_getbool));
 	_cases.push_back(test_case("MSDParser::ObjectParser::Get to get vector", test_msdparser_objectparser_getvector));
 	_cases.push_back(test_case("MSDParser::ObjectParser::Get to get tensor", test_msdparser_objectparser_gettensor));
+	_cases.push_back(test_case("MSDParser::MSDParser loading an input with directives twice", test_msdparser_loadtwice));
 }
 //////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,8 @@
 // (c) 2019 Quantum Biology and Computational Physics Group.
 // See LICENSE.txt for license information.
 //////////////////////////////////////////////////////////////////////////////
+#include <cstdio>
+#include <fstream>
 #include "SpinAPIDefines.h"
 #include "Spin.h"
 #include "Interaction.h"
@@ -14,6 +16,11 @@
 #include "Transition.h"
 #include "SpinSystem.h"
 #include "SpinSpace.h"
+#include "Trajectory.h"
+#include "KrylovPropagator.h"
+#include "ChebyshevPropagator.h"
+#include "ObservableSet.h"
+#include "AffineOperator.h"
 //////////////////////////////////////////////////////////////////////////////
 // Tests whether the spin quantum number is stored correctly.
 // DEPENDENCY NOTE: ObjectParser
@@ -698,7 +705,67 @@ bool test_spinapi_subspacefuncs_extendbyspinsys()
 	// Return the result
 	return isCorrect;
 }
-//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+// Tests the cached spin matrices and the Kronecker-structured operators of the
+// SpinSpace class against the operators created directly by CreateOperator.
+bool test_spinapi_spinspace_cachedandkroneckeroperators()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("spin1", "spin=1/2;");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("spin2", "spin=1;");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("spin3", "spin=1/2;");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(spin3);
+
+	SpinAPI::SpinSpace space(spinsys);
+	space.UseSuperoperatorSpace(false);
+
+	arma::cx_mat denseM;
+	arma::sp_cx_mat sparseM;
+	arma::sp_cx_mat cachedM;
+	SpinAPI::KroneckerOperator kronM;
+	arma::cx_mat vectors = arma::randu<arma::cx_mat>(space.HilbertSpaceDimensions(), 3);
+
+	bool isCorrect = true;
+
+	// Perform the test, the cached operators are requested twice to also compare the results taken from the cache
+	for (int k = 0; k < 2; k++)
+	{
+		isCorrect &= space.CreateOperator(spin2->Sx(), spin2, sparseM);
+		isCorrect &= space.CreateOperator(SpinAPI::SpinOperatorType::Sx, spin2, cachedM);
+		isCorrect &= equal_matrices(sparseM, cachedM);
+		isCorrect &= space.CreateOperator(SpinAPI::SpinOperatorType::Sy, spin2, denseM);
+		isCorrect &= space.CreateOperator(spin2->Sy(), spin2, sparseM);
+		isCorrect &= equal_matrices(denseM, sparseM);
+	}
+
+	isCorrect &= space.CreateKroneckerOperator(SpinAPI::SpinOperatorType::Sz, spin1, kronM);
+	isCorrect &= space.CreateOperator(spin1->Sz(), spin1, sparseM);
+	isCorrect &= equal_matrices(kronM.Materialize(), sparseM);
+	isCorrect &= equal_matrices(kronM.Apply(vectors), arma::cx_mat(sparseM * vectors));
+
+	isCorrect &= space.CreateKroneckerOperator(SpinAPI::SpinOperatorType::Sp, spin2, kronM);
+	isCorrect &= space.CreateOperator(spin2->Sp(), spin2, sparseM);
+	isCorrect &= equal_matrices(kronM.Apply(vectors), arma::cx_mat(sparseM * vectors));
+
+	isCorrect &= space.CreateKroneckerOperator(SpinAPI::SpinOperatorType::Sx, spin3, kronM);
+	isCorrect &= space.CreateOperator(spin3->Sx(), spin3, sparseM);
+	isCorrect &= equal_matrices(kronM.Apply(vectors), arma::cx_mat(sparseM * vectors));
+
+	// Removing a spin must invalidate the cache, as the dimension of the space changes
+	space.Remove(spin3);
+	isCorrect &= space.CreateOperator(SpinAPI::SpinOperatorType::Sx, spin2, cachedM);
+	isCorrect &= space.CreateOperator(spin2->Sx(), spin2, sparseM);
+	isCorrect &= equal_matrices(sparseM, cachedM);
+	isCorrect &= (cachedM.n_rows == 6);
+
+	// Return the result
+	return isCorrect;
+}
+////////////////////////////////////////////////////////////////////
 // Tests the sparse matrices generated by the SpinSpace class
 // Test: Tests the CreateOperator method.
 bool test_spinapi_spinspace_sparsevsdense_createoperator()
@@ -881,6 +948,67 @@ bool test_spinapi_spinspace_sparsevsdense_dynamichamiltonian()
 	return isCorrect;
 }
 //////////////////////////////////////////////////////////////////////////////
+// Tests the incremental assembly of the sparse Hamiltonian
+// Test: The cached interaction operators must be rebuilt when the interactions change between calls.
+bool test_spinapi_spinspace_incrementalhamiltonian()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("spin1", "spin=1/2;");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("spin2", "spin=1/2;");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("spin3", "spin=1;");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=doublespin;group1=spin1;group2=spin3;");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=zeeman;group1=spin1,spin2;field=0.1 0.2 0.3;");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=singlespin;group1=spin2,spin3;field=1 0 0;timedependence=oscillating;");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(spin3);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.Add(interaction3);
+	spinsys.ValidateInteractions();
+
+	SpinAPI::SpinSpace space(spinsys);
+	space.UseSuperoperatorSpace(false);
+
+	arma::cx_mat denseM;
+	arma::sp_cx_mat sparseM;
+
+	bool isCorrect = true;
+
+	// Perform the test, the dense Hamiltonian is always assembled from scratch
+	for (int k = 0; k < 4; k++)
+	{
+		isCorrect &= space.SetTime(0.3 * k);
+		isCorrect &= space.Hamiltonian(denseM);
+		isCorrect &= space.Hamiltonian(sparseM);
+		isCorrect &= equal_matrices(denseM, sparseM);
+		isCorrect &= space.DynamicHamiltonian(denseM);
+		isCorrect &= space.DynamicHamiltonian(sparseM);
+		isCorrect &= equal_matrices(denseM, sparseM);
+	}
+
+	// Switching to the superspace must not reuse the Hilbert space operators
+	space.UseSuperoperatorSpace(true);
+	isCorrect &= space.Hamiltonian(denseM);
+	isCorrect &= space.Hamiltonian(sparseM);
+	isCorrect &= equal_matrices(denseM, sparseM);
+
+	// Adding a spin changes the dimension of all operators
+	space.UseSuperoperatorSpace(false);
+	auto spin4 = std::make_shared<SpinAPI::Spin>("spin4", "spin=1/2;");
+	isCorrect &= space.Add(spin4);
+	isCorrect &= space.StaticHamiltonian(denseM);
+	isCorrect &= space.StaticHamiltonian(sparseM);
+	isCorrect &= equal_matrices(denseM, sparseM);
+	isCorrect &= (sparseM.n_rows == 24);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
 // Tests the sparse matrices generated by the SpinSpace class
 // Test: Tests the InteractionOperator method.
 bool test_spinapi_spinspace_sparsevsdense_interactionoperator()
@@ -1418,6 +1546,1078 @@ bool test_spinapi_spinspace_spinmanagement2()
 	return isCorrect;
 }
 //////////////////////////////////////////////////////////////////////////////
+// Tests the Trajectory class
+// Test: Loads a text trajectory, searches it, and compares it to the binary (memory-mapped) version and the converted file.
+bool test_spinapi_trajectory_textandbinary()
+{
+	// Setup objects for the test, note the missing value, the empty line and the missing newline at the end
+	const std::string textfile = "test_spinapi_trajectory.txt";
+	const std::string binaryfile = "test_spinapi_trajectory.bin";
+	{
+		std::ofstream filehandle(textfile);
+		filehandle << "time field.x field.y\n0.0 1e-3 2\n\n0.5 -2.5\n1.0\t7 8 9\n2.0 1 1";
+	}
+
+	SpinAPI::Trajectory text;
+	SpinAPI::Trajectory binary;
+	unsigned int row = 0;
+	double value = 0.0;
+
+	bool isCorrect = true;
+
+	// Perform the test
+	isCorrect &= text.Load(textfile);
+	isCorrect &= (text.Length() == 4);
+	isCorrect &= (text.Get(0, std::string("field.x")) == 1e-3);
+	isCorrect &= (text.Get(1, std::string("field.y")) == 0.0);
+	isCorrect &= (text.Get(2, std::string("field.y")) == 8.0);
+	isCorrect &= (text.Get(4, std::string("time")) == 0.0);
+
+	isCorrect &= text.FirstRowEqGreaterThan(0.7, std::string("time"), row, value);
+	isCorrect &= (row == 2 && value == 1.0);
+	isCorrect &= !text.FirstRowEqGreaterThan(2.5, std::string("time"), row, value);
+	isCorrect &= text.FirstRowEqGreaterThan(4.0, std::string("field.x"), row, value);
+	isCorrect &= (row == 2 && value == 7.0);
+	isCorrect &= text.FirstRowEqLessThan(0.0, std::string("field.x"), row, value);
+	isCorrect &= (row == 1 && value == -2.5);
+
+	isCorrect &= text.SaveBinary(binaryfile);
+	isCorrect &= binary.Load(binaryfile);
+	isCorrect &= (binary.Length() == text.Length());
+	for (unsigned int i = 0; i < 5; i++)
+		for (unsigned int j = 0; j < 4; j++)
+			isCorrect &= (binary.Get(i, j) == text.Get(i, j));
+
+	// Copies share the mapped file, which must stay valid after the original is cleared
+	SpinAPI::Trajectory copy(binary);
+	binary.Clear();
+	isCorrect &= copy.FirstRowEqGreaterThan(0.7, std::string("time"), row, value);
+	isCorrect &= (row == 2 && value == 1.0);
+	isCorrect &= (copy.Get(3, std::string("field.x")) == 1.0);
+
+	// The first load converts the text file to "<file>.bin", which the next load maps instead of parsing the text file
+	const std::string convertedfile = textfile + ".bin";
+	SpinAPI::Trajectory converted;
+	SpinAPI::Trajectory reloaded;
+	SpinAPI::Trajectory direct;
+	isCorrect &= converted.LoadConverted(textfile);
+	isCorrect &= direct.Load(convertedfile);
+	isCorrect &= reloaded.LoadConverted(textfile);
+	isCorrect &= (direct.Length() == text.Length() && reloaded.Length() == text.Length());
+	for (unsigned int i = 0; i < 5; i++)
+		for (unsigned int j = 0; j < 4; j++)
+			isCorrect &= (converted.Get(i, j) == text.Get(i, j) && direct.Get(i, j) == text.Get(i, j) && reloaded.Get(i, j) == text.Get(i, j));
+
+	std::remove(textfile.c_str());
+	std::remove(binaryfile.c_str());
+	std::remove(convertedfile.c_str());
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the KrylovPropagator class
+// Test: Propagates a state with a non-Hermitian superspace Liouvillian and compares it to the dense propagator.
+bool test_spinapi_krylovpropagator_liouvillian()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("spin1", "spin=1/2;");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("spin2", "spin=1/2;");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("spin3", "spin=1;");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=doublespin;group1=spin1;group2=spin3;");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=zeeman;group1=spin1,spin2;field=0.1 0.2 0.3;");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(spin3);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.ValidateInteractions();
+
+	SpinAPI::SpinSpace space(spinsys);
+	space.UseSuperoperatorSpace(true);
+
+	arma::sp_cx_mat H;
+	bool isCorrect = space.Hamiltonian(H);
+
+	// Add a non-uniform decay to make the Liouvillian non-normal
+	arma::vec rates = arma::linspace<arma::vec>(0.0, 0.5, H.n_rows);
+	arma::sp_cx_mat A = arma::cx_double(0.0, -1.0) * H;
+	A.diag() -= arma::conv_to<arma::cx_vec>::from(rates);
+
+	arma::cx_vec state(H.n_rows);
+	state.fill(arma::cx_double(1.0, 0.5));
+
+	// Perform the test, the subspace is kept between steps and may be rebuilt
+	double dt = 0.7;
+	arma::cx_mat P = arma::expmat(arma::cx_mat(A) * dt);
+	SpinAPI::KrylovPropagator krylov(A, arma::cx_double(1.0, 0.0), false, 8, 32, 1e-12);
+	krylov.SetState(state);
+	for (int k = 0; k < 10; k++)
+	{
+		isCorrect &= krylov.Step(dt);
+		state = P * state;
+		isCorrect &= equal_matrices(arma::cx_mat(krylov.State()), arma::cx_mat(state), 1e-8);
+	}
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the ObservableSet class
+// Test: Compares the expectation values to tr(P * rho), using both the superspace and the Hilbert space representations.
+bool test_spinapi_observableset_expectationvalues()
+{
+	// Setup objects for the test, the matrices are neither Hermitian nor symmetric to catch a transposed layout
+	unsigned int dimension = 6;
+	arma::cx_mat rho(dimension, dimension);
+	arma::cx_mat dense(dimension, dimension);
+	arma::cx_mat sparse = arma::zeros<arma::cx_mat>(dimension, dimension);
+	for (unsigned int a = 0; a < dimension; a++)
+	{
+		for (unsigned int b = 0; b < dimension; b++)
+		{
+			rho(a, b) = arma::cx_double(1.0 + a + 2.0 * b, 0.5 * a - b);
+			dense(a, b) = arma::cx_double(std::cos(a + 3.0 * b), std::sin(2.0 * a - b));
+		}
+		sparse(a, (2 * a + 1) % dimension) = arma::cx_double(a, 1.0);
+	}
+
+	std::vector<arma::cx_mat> operators;
+	operators.push_back(dense);
+	operators.push_back(sparse);
+	operators.push_back(arma::eye<arma::cx_mat>(dimension, dimension));
+
+	SpinAPI::SpinSystem spinsys("System");
+	SpinAPI::SpinSpace space(spinsys);
+	SpinAPI::ObservableSet superspaceSet(dimension, true);
+	SpinAPI::ObservableSet hilbertSet(dimension, false);
+
+	arma::cx_vec expected(operators.size());
+	bool isCorrect = true;
+	for (unsigned int k = 0; k < operators.size(); k++)
+	{
+		expected(k) = arma::trace(operators[k] * rho);
+		isCorrect &= superspaceSet.Add(operators[k]);
+		isCorrect &= hilbertSet.Add(arma::sp_cx_mat(operators[k]));
+	}
+
+	// Perform the test
+	arma::cx_vec rhovec;
+	arma::cx_vec result;
+	isCorrect &= space.OperatorToSuperspace(rho, rhovec);
+	isCorrect &= superspaceSet.Evaluate(rhovec, result);
+	isCorrect &= equal_matrices(arma::cx_mat(result), arma::cx_mat(expected));
+	isCorrect &= hilbertSet.Evaluate(rho, result);
+	isCorrect &= equal_matrices(arma::cx_mat(result), arma::cx_mat(expected));
+
+	// The representation must match the set, and observables must have the right dimension
+	isCorrect &= !superspaceSet.Evaluate(rho, result);
+	isCorrect &= !hilbertSet.Evaluate(rhovec, result);
+	isCorrect &= !hilbertSet.Add(arma::eye<arma::cx_mat>(dimension + 1, dimension + 1));
+	isCorrect &= (hilbertSet.Size() == operators.size());
+
+	// The observables in the Heisenberg picture must give the expectation values of the propagated density operator
+	arma::cx_mat U(dimension, dimension);
+	for (unsigned int a = 0; a < dimension; a++)
+		for (unsigned int b = 0; b < dimension; b++)
+			U(a, b) = arma::cx_double(std::sin(a + 2.0 * b), 0.1 * a * b - 0.3);
+	arma::cx_mat heisenberg;
+	arma::cx_vec propagated;
+	isCorrect &= hilbertSet.HeisenbergObservables(U, heisenberg);
+	isCorrect &= hilbertSet.Evaluate(arma::cx_mat(U * rho * U.t()), propagated);
+	isCorrect &= equal_matrices(arma::cx_mat(heisenberg * arma::vectorise(rho)), arma::cx_mat(propagated), 1e-10);
+
+	arma::cx_mat superU = arma::kron(U, arma::conj(U));
+	isCorrect &= superspaceSet.HeisenbergObservables(superU, heisenberg);
+	isCorrect &= superspaceSet.Evaluate(arma::cx_vec(superU * rhovec), propagated);
+	isCorrect &= equal_matrices(arma::cx_mat(heisenberg * rhovec), arma::cx_mat(propagated), 1e-10);
+	isCorrect &= !hilbertSet.HeisenbergObservables(superU, heisenberg);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the block structure methods of the SpinSpace class
+// Test: A radical pair in a z-field with isotropic hyperfine couplings conserves Mz, and the block-wise diagonalization must agree with eig_sym.
+bool test_spinapi_spinspace_blockeigendecomposition()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;");
+	auto spin4 = std::make_shared<SpinAPI::Spin>("nucleus2", "spin=1;");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=zeeman;group1=electron1,electron2;field=0 0 5e-5;");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=isotropic(5e-4);");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=hyperfine;group1=electron2;group2=nucleus2;tensor=isotropic(2e-4);");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(spin3);
+	spinsys.Add(spin4);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.Add(interaction3);
+	spinsys.ValidateInteractions();
+
+	SpinAPI::SpinSpace space(spinsys);
+	space.UseSuperoperatorSpace(false);
+
+	arma::sp_cx_mat H;
+	bool isCorrect = space.Hamiltonian(H);
+
+	// Perform the test, each block must be closed under H
+	arma::uvec permutation;
+	std::vector<arma::uword> offsets;
+	isCorrect &= space.BlockStructure(H, permutation, offsets);
+	isCorrect &= (offsets.size() > 5);
+	isCorrect &= (offsets.back() == H.n_rows);
+	isCorrect &= arma::all(arma::sort(permutation) == arma::regspace<arma::uvec>(0, H.n_rows - 1));
+
+	arma::cx_mat reordered = arma::cx_mat(H)(permutation, permutation);
+	for (unsigned int b = 0; b + 1 < offsets.size(); b++)
+		reordered.submat(offsets[b], offsets[b], offsets[b + 1] - 1, offsets[b + 1] - 1).zeros();
+	isCorrect &= (arma::norm(reordered, "fro") == 0.0);
+
+	// The eigenvalues must match those of the full diagonalization, and the eigenvectors must be orthonormal
+	arma::vec lambda;
+	arma::cx_mat V;
+	arma::vec lambdaFull;
+	arma::cx_mat VFull;
+	isCorrect &= space.BlockEigenDecomposition(H, lambda, V);
+	isCorrect &= arma::eig_sym(lambdaFull, VFull, arma::cx_mat(H));
+	isCorrect &= arma::approx_equal(lambda, lambdaFull, "absdiff", 1e-10);
+	isCorrect &= equal_matrices(arma::cx_mat(H * V), arma::cx_mat(V * arma::diagmat(lambda)));
+	isCorrect &= equal_matrices(arma::cx_mat(V.t() * V), arma::eye<arma::cx_mat>(H.n_rows, H.n_cols));
+
+	// The eigenvalues alone must also match
+	isCorrect &= space.BlockEigenvalues(H, lambda);
+	isCorrect &= arma::approx_equal(lambda, lambdaFull, "absdiff", 1e-10);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the block-wise solver and exponential of the SpinSpace class
+// Test: Compares them to the full solve and matrix exponential for a block-diagonal Liouvillian.
+bool test_spinapi_spinspace_blocksolveandexponential()
+{
+	// Setup objects for the test, the z-field and isotropic couplings conserve the total Mz
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=zeeman;group1=electron1,electron2;field=0 0 5e-5;");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=isotropic(5e-4);");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(spin3);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.ValidateInteractions();
+
+	SpinAPI::SpinSpace space(spinsys);
+	space.UseSuperoperatorSpace(true);
+
+	arma::sp_cx_mat H;
+	bool isCorrect = space.Hamiltonian(H);
+
+	// A Liouvillian with a uniform decay, such that it can be inverted
+	arma::sp_cx_mat A = arma::cx_double(0.0, -1.0) * H;
+	A -= arma::cx_double(1e-3, 0.0) * arma::speye<arma::sp_cx_mat>(A.n_rows, A.n_cols);
+
+	arma::uvec permutation;
+	std::vector<arma::uword> offsets;
+	isCorrect &= space.BlockStructure(A, permutation, offsets);
+	isCorrect &= (offsets.size() > 2);
+
+	// Perform the test
+	arma::cx_mat B(A.n_rows, 3, arma::fill::randn);
+	arma::cx_mat X;
+	arma::cx_mat XFull;
+	isCorrect &= space.BlockSolve(A, B, X);
+	isCorrect &= arma::solve(XFull, arma::cx_mat(A), B);
+	isCorrect &= equal_matrices(X, XFull, 1e-10 * arma::abs(XFull).max());
+
+	arma::cx_mat U;
+	isCorrect &= space.BlockExponential(A, arma::cx_double(2.0, 0.0), U);
+	isCorrect &= equal_matrices(U, arma::expmat(arma::cx_mat(A) * 2.0));
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the partial eigensolver of the SpinSpace class
+// Test: The lowest and highest levels of a radical pair with anisotropic hyperfine couplings must match the full diagonalization, also when
+// starting from the eigenvectors of a slightly different Hamiltonian.
+bool test_spinapi_spinspace_partialeigendecomposition()
+{
+	// Setup objects for the test, the space is large enough that the Krylov method is used rather than the dense fallback
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1;");
+	auto spin4 = std::make_shared<SpinAPI::Spin>("nucleus2", "spin=1;");
+	auto spin5 = std::make_shared<SpinAPI::Spin>("nucleus3", "spin=1/2;");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=zeeman;group1=electron1,electron2;field=1e-4 0 5e-5;");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron1;group2=nucleus1;tensor=anisotropic(1e-4, 2e-4, 8e-4);");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=hyperfine;group1=electron2;group2=nucleus2;tensor=anisotropic(-3e-4, 1e-4, 5e-4);");
+	auto interaction4 = std::make_shared<SpinAPI::Interaction>("interaction4", "type=hyperfine;group1=electron1;group2=nucleus3;tensor=isotropic(7e-4);");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(spin3);
+	spinsys.Add(spin4);
+	spinsys.Add(spin5);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.Add(interaction3);
+	spinsys.Add(interaction4);
+	spinsys.ValidateInteractions();
+
+	SpinAPI::SpinSpace space(spinsys);
+	space.UseSuperoperatorSpace(false);
+
+	arma::sp_cx_mat H;
+	bool isCorrect = space.Hamiltonian(H);
+
+	arma::vec lambdaFull;
+	isCorrect &= arma::eig_sym(lambdaFull, arma::cx_mat(H));
+	double scale = arma::abs(lambdaFull).max();
+
+	// Perform the test
+	unsigned int k = 3;
+	arma::vec lambda;
+	arma::cx_mat V;
+	isCorrect &= space.PartialEigenDecomposition(H, k, true, lambda, V);
+	isCorrect &= arma::approx_equal(lambda, arma::vec(lambdaFull.head(k)), "absdiff", 1e-8 * scale);
+	isCorrect &= (arma::norm(H * V - V * arma::diagmat(lambda), "fro") < 1e-8 * scale);
+
+	// Start from the lowest levels of a perturbed Hamiltonian
+	arma::sp_cx_mat Hperturbed = 1.01 * H;
+	arma::cx_mat Vguess = V;
+	isCorrect &= space.PartialEigenDecomposition(Hperturbed, k, true, lambda, Vguess);
+	isCorrect &= arma::approx_equal(lambda, arma::vec(1.01 * lambdaFull.head(k)), "absdiff", 1e-8 * scale);
+
+	V.reset();
+	isCorrect &= space.PartialEigenDecomposition(H, k, false, lambda, V);
+	isCorrect &= arma::approx_equal(lambda, arma::vec(lambdaFull.tail(k)), "absdiff", 1e-8 * scale);
+	isCorrect &= (arma::norm(H * V - V * arma::diagmat(lambda), "fro") < 1e-8 * scale);
+	isCorrect &= equal_matrices(arma::cx_mat(V.t() * V), arma::eye<arma::cx_mat>(k, k), 1e-10);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Test: A block-diagonal matrix where a level of the second block crosses below the levels of the first block. The partial eigensolver
+// starts from the eigenvectors before the crossing, which only span the first block, and must still find the level of the second block.
+bool test_spinapi_spinspace_partialeigendecomposition_crossing()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("spin1", "spin=1/2;");
+	SpinAPI::SpinSpace space(spin1);
+
+	const unsigned int m = 100;
+	arma::sp_cx_mat H(2 * m, 2 * m);
+	arma::sp_cx_mat shift(2 * m, 2 * m);
+	for (unsigned int r = 0; r < m; r++)
+	{
+		H(r, r) = arma::cx_double(0.1 * r, 0.0);
+		H(m + r, m + r) = arma::cx_double(0.5 + 0.1 * r, 0.0);
+		shift(m + r, m + r) = arma::cx_double(-1.0, 0.0);
+		if (r + 1 < m)
+		{
+			H(r, r + 1) = arma::cx_double(0.02, 0.01);
+			H(r + 1, r) = arma::cx_double(0.02, -0.01);
+			H(m + r, m + r + 1) = arma::cx_double(0.03, 0.0);
+			H(m + r + 1, m + r) = arma::cx_double(0.03, 0.0);
+		}
+	}
+	arma::sp_cx_mat Hshifted = H + shift;
+
+	arma::vec lambdaFull;
+	bool isCorrect = arma::eig_sym(lambdaFull, arma::cx_mat(Hshifted));
+
+	// Perform the test
+	unsigned int k = 2;
+	arma::vec lambda;
+	arma::cx_mat V;
+	isCorrect &= space.PartialEigenDecomposition(H, k, true, lambda, V);
+	isCorrect &= (arma::norm(V.tail_rows(m), "fro") < 1e-8);
+
+	// Products with the matrix never leave the first block if the guess lies exactly in it
+	V.tail_rows(m).zeros();
+	isCorrect &= space.PartialEigenDecomposition(Hshifted, k, true, lambda, V);
+	isCorrect &= arma::approx_equal(lambda, arma::vec(lambdaFull.head(k)), "absdiff", 1e-8);
+	isCorrect &= (arma::norm(Hshifted * V - V * arma::diagmat(lambda), "fro") < 1e-8);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Test: A group of equivalent spins must give the same singlet probability as the individual spins, with a smaller spin space.
+bool test_spinapi_spin_equivalentspins()
+{
+	// The group of three spin-1/2 nuclei couples to a total spin of 3/2 once and 1/2 twice
+	auto group = std::make_shared<SpinAPI::Spin>("nuclei", "spin=1/2;equivalent=3;");
+	bool isCorrect = (group->Multiplicity() == 6);
+	isCorrect &= (group->TotalSpins().size() == 2);
+	isCorrect &= (group->TotalSpins()[0] == std::pair<unsigned int, unsigned int>(3, 1));
+	isCorrect &= (group->TotalSpins()[1] == std::pair<unsigned int, unsigned int>(1, 2));
+	isCorrect &= (arma::accu(group->Weights()) == 8.0);
+	isCorrect &= equal_matrices(arma::cx_mat(group->Sx() * group->Sx() + group->Sy() * group->Sy() + group->Sz() * group->Sz()),
+								arma::cx_mat(arma::diagmat(arma::cx_vec({3.75, 3.75, 3.75, 3.75, 0.75, 0.75}))));
+
+	// The same radical pair with the nuclei as individual spins and as a group
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=isotropic(2);");
+	auto nucleus1 = std::make_shared<SpinAPI::Spin>("nucleus1", "spin=1/2;");
+	auto nucleus2 = std::make_shared<SpinAPI::Spin>("nucleus2", "spin=1/2;");
+	auto nucleus3 = std::make_shared<SpinAPI::Spin>("nucleus3", "spin=1/2;");
+
+	auto zeeman = std::make_shared<SpinAPI::Interaction>("zeeman", "type=zeeman;group1=electron1,electron2;field=0 0 5e-5;");
+	auto hyperfineFull = std::make_shared<SpinAPI::Interaction>("hyperfine", "type=hyperfine;group1=electron1;group2=nucleus1,nucleus2,nucleus3;tensor=isotropic(5e-4);");
+	auto hyperfineGroup = std::make_shared<SpinAPI::Interaction>("hyperfine", "type=hyperfine;group1=electron1;group2=nuclei;tensor=isotropic(5e-4);");
+
+	SpinAPI::SpinSystem spinsysFull("Full");
+	spinsysFull.Add(spin1);
+	spinsysFull.Add(spin2);
+	spinsysFull.Add(nucleus1);
+	spinsysFull.Add(nucleus2);
+	spinsysFull.Add(nucleus3);
+	spinsysFull.Add(zeeman);
+	spinsysFull.Add(hyperfineFull);
+	spinsysFull.ValidateInteractions();
+
+	SpinAPI::SpinSystem spinsysGroup("Group");
+	spinsysGroup.Add(spin1);
+	spinsysGroup.Add(spin2);
+	spinsysGroup.Add(group);
+	spinsysGroup.Add(zeeman);
+	spinsysGroup.Add(hyperfineGroup);
+	spinsysGroup.ValidateInteractions();
+
+	auto singlet = std::make_shared<SpinAPI::State>("singlet", "spins(electron1,electron2)=|1/2,-1/2>-|-1/2,1/2>;");
+	singlet->ParseFromSystem(spinsysFull);
+
+	SpinAPI::SpinSpace spaceFull(spinsysFull);
+	SpinAPI::SpinSpace spaceGroup(spinsysGroup);
+	spaceFull.UseSuperoperatorSpace(false);
+	spaceGroup.UseSuperoperatorSpace(false);
+	isCorrect &= (spaceGroup.HilbertSpaceDimensions() == 24);
+
+	arma::cx_mat PFull;
+	arma::cx_mat PGroup;
+	arma::cx_mat HFull;
+	arma::cx_mat HGroup;
+	isCorrect &= spaceFull.GetState(singlet, PFull);
+	isCorrect &= spaceGroup.GetState(singlet, PGroup);
+	isCorrect &= spaceFull.Hamiltonian(HFull);
+	isCorrect &= spaceGroup.Hamiltonian(HGroup);
+
+	arma::cx_mat rho0Full = PFull;
+	arma::cx_mat rho0Group = PGroup;
+	isCorrect &= spaceGroup.WeightEquivalentSpins(rho0Group);
+	isCorrect &= (std::abs(arma::trace(rho0Full) - arma::trace(rho0Group)) < 1e-10);
+
+	// Compare the singlet probability at a few times
+	for (unsigned int k = 1; k <= 4; k++)
+	{
+		double t = 10.0 * k;
+		arma::cx_mat UFull = arma::expmat(arma::cx_double(0.0, -t) * HFull);
+		arma::cx_mat UGroup = arma::expmat(arma::cx_double(0.0, -t) * HGroup);
+		arma::cx_double yieldFull = arma::trace(PFull * UFull * rho0Full * UFull.t()) / arma::trace(rho0Full);
+		arma::cx_double yieldGroup = arma::trace(PGroup * UGroup * rho0Group * UGroup.t()) / arma::trace(rho0Group);
+		isCorrect &= (std::abs(yieldFull - yieldGroup) < 1e-10);
+	}
+
+	// The mz of a group of equivalent spins cannot be addressed
+	auto polarized = std::make_shared<SpinAPI::State>("polarized", "spin(nuclei)=|1/2>;");
+	polarized->ParseFromSystem(spinsysGroup);
+	arma::cx_mat PPolarized;
+	isCorrect &= !spaceGroup.GetState(polarized, PPolarized);
+
+	// Neither can the state of a single spin in the group, while the individual spins are fine
+	arma::cx_mat PSingle;
+	isCorrect &= !spaceGroup.GetSingleSpinState(group, 1, PSingle);
+	isCorrect &= spaceFull.GetSingleSpinState(nucleus1, 1, PSingle);
+	isCorrect &= (std::abs(arma::trace(PSingle) - 16.0) < 1e-10);
+
+	// Spin coherent states are products of single-spin states, so they cannot be sampled for the group either
+	std::vector<SpinAPI::system_ptr> systems;
+	systems.push_back(std::make_shared<SpinAPI::SpinSystem>("CoherentFull"));
+	systems.push_back(std::make_shared<SpinAPI::SpinSystem>("CoherentGroup"));
+	systems[0]->Add(nucleus1);
+	systems[0]->Add(nucleus2);
+	systems[0]->Add(nucleus3);
+	systems[1]->Add(group);
+	std::mt19937 generator(1);
+	arma::cx_colvec coherent;
+	isCorrect &= spaceFull.CoherentState(systems.cbegin(), generator, coherent);
+	isCorrect &= (coherent.n_elem == 8 && std::abs(arma::norm(coherent) - 1.0) < 1e-10);
+	isCorrect &= !spaceGroup.CoherentState(systems.cbegin() + 1, generator, coherent);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the yield solver of the SpinSpace class
+// Test: Compares the yields from a single factorization to separate dense solves, using both the direct and the adjoint formulation.
+bool test_spinapi_spinspace_solveyields()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("spin1", "spin=1/2;");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("spin2", "spin=1/2;");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("spin3", "spin=1;");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=doublespin;group1=spin1;group2=spin3;");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=zeeman;group1=spin1,spin2;field=0.1 0.2 0.3;");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(spin3);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.ValidateInteractions();
+
+	SpinAPI::SpinSpace space(spinsys);
+	space.UseSuperoperatorSpace(true);
+
+	arma::sp_cx_mat H;
+	bool isCorrect = space.Hamiltonian(H);
+
+	// Add a non-uniform decay such that the Liouvillian is invertible
+	arma::vec rates = arma::linspace<arma::vec>(0.1, 0.5, H.n_rows);
+	arma::sp_cx_mat A = arma::cx_double(0.0, -1.0) * H;
+	A.diag() -= arma::conv_to<arma::cx_vec>::from(rates);
+
+	// Two initial states and three observables, all neither Hermitian nor symmetric
+	unsigned int dimension = space.HilbertSpaceDimensions();
+	std::vector<arma::cx_mat> states(2, arma::cx_mat(dimension, dimension));
+	std::vector<arma::cx_mat> operators(3, arma::cx_mat(dimension, dimension));
+	for (unsigned int a = 0; a < dimension; a++)
+	{
+		for (unsigned int b = 0; b < dimension; b++)
+		{
+			states[0](a, b) = arma::cx_double(1.0 + a + 2.0 * b, 0.5 * a - b);
+			states[1](a, b) = arma::cx_double(std::sin(a * b + 1.0), a == b ? 1.0 : 0.0);
+			operators[0](a, b) = arma::cx_double(std::cos(a + 3.0 * b), std::sin(2.0 * a - b));
+			operators[1](a, b) = (a == b) ? arma::cx_double(a, 0.0) : arma::cx_double(0.0, 0.0);
+			operators[2](a, b) = arma::cx_double(a * b, a - 2.0 * b);
+		}
+	}
+
+	arma::cx_mat B(space.SpaceDimensions(), states.size());
+	arma::cx_vec rhovec;
+	for (unsigned int c = 0; c < states.size(); c++)
+	{
+		isCorrect &= space.OperatorToSuperspace(states[c], rhovec);
+		B.col(c) = rhovec;
+	}
+
+	SpinAPI::ObservableSet many(dimension, true);
+	SpinAPI::ObservableSet few(dimension, true);
+	for (unsigned int k = 0; k < operators.size(); k++)
+		isCorrect &= many.Add(operators[k]);
+	isCorrect &= few.Add(operators[0]);
+
+	// Reference values from separate solves
+	arma::cx_mat expected(operators.size(), states.size());
+	arma::cx_mat rho;
+	for (unsigned int c = 0; c < states.size(); c++)
+	{
+		isCorrect &= space.OperatorFromSuperspace(arma::cx_vec(arma::solve(arma::cx_mat(A), arma::cx_vec(B.col(c)))), rho);
+		for (unsigned int k = 0; k < operators.size(); k++)
+			expected(k, c) = arma::trace(operators[k] * rho);
+	}
+
+	// Perform the test, with more observables than initial states (direct) and fewer (adjoint)
+	arma::cx_mat yields;
+	isCorrect &= space.SolveYields(A, B, many, yields);
+	isCorrect &= equal_matrices(yields, expected, 1e-8);
+	isCorrect &= space.SolveYields(A, B, few, yields);
+	isCorrect &= equal_matrices(yields, arma::cx_mat(expected.row(0)), 1e-8);
+
+	// Hilbert space observables cannot be used with the superspace solver
+	SpinAPI::ObservableSet hilbert(dimension, false);
+	isCorrect &= !space.SolveYields(A, B, hilbert, yields);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the expectation values used by the SymmUncoupled tasks
+// Test: Compares the sums over the columns to a loop over all pairs of wavefunctions, for a singlet and a T+ initial state.
+bool test_spinapi_spinspace_uncoupledpairprojections()
+{
+	// Setup objects for the test, two radicals with 3 and 2 nuclear states and arbitrary (non-normalized) wavefunctions
+	unsigned int Z[2] = {3, 2};
+	arma::cx_mat B[2];
+	for (unsigned int r = 0; r < 2; r++)
+	{
+		B[r].set_size(2 * Z[r], 2 * Z[r]);
+		for (unsigned int a = 0; a < B[r].n_rows; a++)
+			for (unsigned int b = 0; b < B[r].n_cols; b++)
+				B[r](a, b) = arma::cx_double(std::cos(a + 2.0 * b + r), std::sin(3.0 * a - b + r));
+	}
+
+	arma::cx_mat S[2][5];
+	for (unsigned int r = 0; r < 2; r++)
+	{
+		arma::cx_mat Sx = {{0.0, 0.5}, {0.5, 0.0}};
+		arma::cx_mat Sy = {{arma::cx_double(0.0, 0.0), arma::cx_double(0.0, -0.5)}, {arma::cx_double(0.0, 0.5), arma::cx_double(0.0, 0.0)}};
+		arma::cx_mat Sz = {{0.5, 0.0}, {0.0, -0.5}};
+		arma::cx_mat Id = arma::eye<arma::cx_mat>(Z[r], Z[r]);
+		S[r][0] = arma::kron(Sx, Id);
+		S[r][1] = arma::kron(Sy, Id);
+		S[r][2] = arma::kron(Sz, Id);
+		arma::cx_mat Sp = S[r][0] + arma::cx_double(0.0, 1.0) * S[r][1];
+		arma::cx_mat Sm = S[r][0] - arma::cx_double(0.0, 1.0) * S[r][1];
+		S[r][3] = Sp * Sm;
+		S[r][4] = Sm * Sp;
+	}
+
+	SpinAPI::SpinSystem spinsys("System");
+	SpinAPI::SpinSpace space(spinsys);
+
+	// Reference for the singlet state, as a loop over all pairs of alpha and beta wavefunctions
+	arma::vec expected = arma::zeros<arma::vec>(4);
+	for (unsigned int i = 0; i < Z[0]; i++)
+	{
+		for (unsigned int j = 0; j < Z[1]; j++)
+		{
+			arma::cx_vec a1 = B[0].col(i);
+			arma::cx_vec b1 = B[0].col(i + Z[0]);
+			arma::cx_vec a2 = B[1].col(j);
+			arma::cx_vec b2 = B[1].col(j + Z[1]);
+			double ps = 0.25;
+			for (unsigned int o = 0; o < 3; o++)
+				ps -= 0.5 * std::real(arma::cdot(a1, S[0][o] * a1) * arma::cdot(b2, S[1][o] * b2) - 2.0 * std::real(arma::cdot(a1, S[0][o] * b1) * arma::cdot(b2, S[1][o] * a2)) + arma::cdot(b1, S[0][o] * b1) * arma::cdot(a2, S[1][o] * a2));
+			double ptp = 0.5 * std::real(arma::cdot(a1, S[0][3] * a1) * arma::cdot(b2, S[1][3] * b2) - 2.0 * std::real(arma::cdot(a1, S[0][3] * b1) * arma::cdot(a2, S[1][3] * b2)) + arma::cdot(b1, S[0][3] * b1) * arma::cdot(a2, S[1][3] * a2));
+			double ptm = 0.5 * std::real(arma::cdot(a1, S[0][4] * a1) * arma::cdot(b2, S[1][4] * b2) - 2.0 * std::real(arma::cdot(a1, S[0][4] * b1) * arma::cdot(a2, S[1][4] * b2)) + arma::cdot(b1, S[0][4] * b1) * arma::cdot(a2, S[1][4] * a2));
+			expected += arma::vec({ps, ptp, 1.0 - ps - ptp - ptm, ptm});
+		}
+	}
+
+	arma::vec projections;
+	bool isCorrect = space.UncoupledPairProjections(B[0], B[1], "singlet", projections);
+	isCorrect &= arma::approx_equal(projections, expected, "absdiff", 1e-10);
+
+	// Reference for the T+ state, where all columns are used
+	expected.zeros();
+	for (unsigned int i = 0; i < B[0].n_cols; i++)
+	{
+		for (unsigned int j = 0; j < B[1].n_cols; j++)
+		{
+			arma::cx_vec a1 = B[0].col(i);
+			arma::cx_vec a2 = B[1].col(j);
+			double ps = 0.25;
+			for (unsigned int o = 0; o < 3; o++)
+				ps -= std::real(arma::cdot(a1, S[0][o] * a1) * arma::cdot(a2, S[1][o] * a2));
+			double ptp = std::real(arma::cdot(a1, S[0][3] * a1) * arma::cdot(a2, S[1][3] * a2));
+			double ptm = std::real(arma::cdot(a1, S[0][4] * a1) * arma::cdot(a2, S[1][4] * a2));
+			expected += arma::vec({ps, ptp, 1.0 - ps - ptp - ptm, ptm});
+		}
+	}
+
+	isCorrect &= space.UncoupledPairProjections(B[0], B[1], "tripletplus", projections);
+	isCorrect &= arma::approx_equal(projections, expected, "absdiff", 1e-10);
+	isCorrect &= !space.UncoupledPairProjections(B[0], B[1], "quintet", projections);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the AffineOperator class
+// Test: The operators have different sparsity patterns, and the result must equal the sum of the scaled sparse matrices.
+bool test_spinapi_affineoperator_evaluate()
+{
+	// Setup objects for the test
+	unsigned int dimension = 5;
+	arma::sp_cx_mat A0(dimension, dimension);
+	arma::sp_cx_mat A1(dimension, dimension);
+	arma::sp_cx_mat A2(dimension, dimension);
+	for (unsigned int a = 0; a < dimension; a++)
+	{
+		A0(a, a) = arma::cx_double(1.0 + a, 0.0);
+		A1(a, (a + 1) % dimension) = arma::cx_double(0.5, -1.0 * a);
+		A2((a + 2) % dimension, a) = arma::cx_double(2.0 - a, 0.25);
+	}
+	A2(0, 0) = 3.0;
+
+	SpinAPI::AffineOperator op(dimension);
+	bool isCorrect = op.SetConstant(A0);
+	isCorrect &= op.AddTerm(A1);
+	isCorrect &= op.AddTerm(A2);
+	isCorrect &= (op.Terms() == 2);
+	isCorrect &= (op.NonZeros() == 3 * dimension);
+
+	// Perform the test
+	arma::sp_cx_mat result;
+	arma::cx_vec c = {arma::cx_double(0.3, 0.0), arma::cx_double(0.0, -2.0)};
+	isCorrect &= op.Evaluate(c, result);
+	isCorrect &= equal_matrices(arma::cx_mat(result), arma::cx_mat(A0 + c(0) * A1 + c(1) * A2));
+
+	// The number of coefficients and the dimension of the terms must match
+	isCorrect &= !op.Evaluate(arma::cx_vec(3), result);
+	isCorrect &= !op.AddTerm(arma::sp_cx_mat(dimension + 1, dimension + 1));
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the affine decomposition of the dynamic Hamiltonian
+// Test: An oscillating field with an anisotropic tensor on two electrons, one of which also has an anisotropic g-tensor, must give the same dynamic Hamiltonian as
+// DynamicHamiltonian at several times, both in Hilbert space and in superspace.
+bool test_spinapi_spinspace_dynamichamiltonianterms()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1/2;tensor=matrix(\"2.0 0.1 0;0.1 2.1 0;0 0 1.9\");");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("nucleus", "spin=1;");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=zeeman;group1=electron1,electron2;fieldtype=circularpolarization;field=1e-4 0 2e-4;axis=0 0 1;frequency=3e+5;phase=0.5;perpendicularoscillations=false;tensor=matrix(\"1.0 0.2 0;0.2 0.9 0;0 0 1.1\");");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=hyperfine;group1=electron1;group2=nucleus;tensor=isotropic(5e-4);");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(spin3);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.ValidateInteractions();
+
+	bool isCorrect = true;
+	for (unsigned int superspace = 0; superspace < 2; superspace++)
+	{
+		SpinAPI::SpinSpace space(spinsys);
+		space.UseSuperoperatorSpace(superspace == 1);
+
+		SpinAPI::AffineOperator dynamicH(space.SpaceDimensions());
+		isCorrect &= space.DynamicHamiltonianTerms(dynamicH);
+		isCorrect &= (dynamicH.Terms() == 3);
+
+		// Perform the test
+		for (unsigned int k = 0; k < 4; k++)
+		{
+			space.SetTime(1.3e-6 * k);
+
+			arma::sp_cx_mat expected;
+			arma::cx_vec c;
+			arma::sp_cx_mat result;
+			isCorrect &= space.DynamicHamiltonian(expected);
+			isCorrect &= space.DynamicHamiltonianCoefficients(c);
+			isCorrect &= dynamicH.Evaluate(c, result);
+			isCorrect &= equal_matrices(arma::cx_mat(result), arma::cx_mat(expected), 1e-12);
+		}
+	}
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the affine decomposition of the dynamic Hamiltonian with spins that follow a trajectory
+// Test: A spin with trajectories for its g-tensor and quantization axes takes part in a Zeeman, a DoubleSpin and a Zfs interaction. The terms must
+// still give the same dynamic Hamiltonian as DynamicHamiltonian at times between the steps of the trajectories, both in Hilbert space and in superspace.
+bool test_spinapi_spinspace_dynamichamiltonianterms_spintrajectory()
+{
+	// Setup objects for the test
+	const std::string tensorfile = "test_spinapi_dynamichamiltonianterms_tensor.txt";
+	const std::string axesfile = "test_spinapi_dynamichamiltonianterms_axes.txt";
+	const std::string prefactorfile = "test_spinapi_dynamichamiltonianterms_prefactor.txt";
+	{
+		std::ofstream filehandle(tensorfile);
+		filehandle << "time isotropic anisotropic.x anisotropic.y anisotropic.z\n0 2.0 0.1 -0.05 0.02\n2e-6 1.9 -0.2 0.1 0.3\n4e-6 2.1 0.05 0.15 -0.1\n";
+	}
+	{
+		std::ofstream filehandle(axesfile);
+		filehandle << "time axis1.x axis1.y axis1.z axis2.x axis2.y axis2.z axis3.x axis3.y axis3.z\n";
+		filehandle << "0 1 0 0 0 1 0 0 0 1\n2e-6 0.8 0.6 0 -0.6 0.8 0 0 0 1\n4e-6 0.8 0 0.6 0 1 0 -0.6 0 0.8\n";
+	}
+	{
+		std::ofstream filehandle(prefactorfile);
+		filehandle << "time prefactor\n0 1.0\n4e-6 0.5\n";
+	}
+
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron1", "spin=1/2;tensor=isotropic(2);");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("electron2", "spin=1;tensor=trajectory(" + tensorfile + ");trajectory=" + axesfile + ";");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=zeeman;group1=electron1,electron2;fieldtype=oscillating;field=1e-4 0 2e-4;frequency=3e+5;tensor=matrix(\"1.0 0.2 0;0.2 0.9 0;0 0 1.1\");");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=doublespin;group1=electron1;group2=electron2;tensor=matrix(\"1e-4 2e-5 0;2e-5 -3e-4 1e-5;0 1e-5 2e-4\");trajectory=" + prefactorfile + ";");
+	auto interaction3 = std::make_shared<SpinAPI::Interaction>("interaction3", "type=zfs;group1=electron2;dvalue=3e-4;evalue=5e-5;trajectory=" + prefactorfile + ";");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.Add(interaction3);
+	spinsys.ValidateInteractions();
+
+	bool isCorrect = HasTrajectory(*spin2);
+	for (unsigned int superspace = 0; superspace < 2; superspace++)
+	{
+		SpinAPI::SpinSpace space(spinsys);
+		space.UseSuperoperatorSpace(superspace == 1);
+
+		// Three terms for each spin of the Zeeman interaction, nine for the pair of spins and ten for the Zfs interaction
+		SpinAPI::AffineOperator dynamicH(space.SpaceDimensions());
+		isCorrect &= space.DynamicHamiltonianTerms(dynamicH);
+		isCorrect &= (dynamicH.Terms() == 25);
+
+		// Perform the test
+		for (unsigned int k = 0; k < 4; k++)
+		{
+			space.SetTime(1.3e-6 * k);
+
+			arma::sp_cx_mat expected;
+			arma::cx_vec c;
+			arma::sp_cx_mat result;
+			isCorrect &= space.DynamicHamiltonian(expected);
+			isCorrect &= space.DynamicHamiltonianCoefficients(c);
+			isCorrect &= dynamicH.Evaluate(c, result);
+			isCorrect &= equal_matrices(arma::cx_mat(result), arma::cx_mat(expected), 1e-12);
+		}
+	}
+
+	std::remove(tensorfile.c_str());
+	std::remove(axesfile.c_str());
+	std::remove(prefactorfile.c_str());
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the integrators for time-dependent Hamiltonians
+// Test: An electron in a static field and an oscillating perpendicular field is propagated with large steps. The fourth order Magnus
+// integrator must be much closer to a reference with small steps than the piecewise constant Hamiltonian.
+bool test_spinapi_spinspace_magnusintegrator()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron", "spin=1/2;");
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=zeeman;group1=electron;field=0 0 1e-3;commonprefactor=false;");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=zeeman;group1=electron;fieldtype=linearpolarization;field=2e-3 0 0;frequency=1e-3;phase=0.3;commonprefactor=false;");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.ValidateInteractions();
+
+	SpinAPI::SpinSpace space(spinsys);
+	space.UseSuperoperatorSpace(false);
+
+	arma::sp_cx_mat H0;
+	SpinAPI::AffineOperator H(space.SpaceDimensions());
+	bool isCorrect = space.StaticHamiltonian(H0);
+	isCorrect &= H.SetConstant(H0);
+	isCorrect &= space.DynamicHamiltonianTerms(H);
+
+	// Propagates a state for the total time with the given number of steps
+	double totaltime = 4000.0;
+	auto propagate = [&](const std::string &_integrator, unsigned int _steps) -> arma::cx_vec {
+		arma::vec nodes;
+		arma::mat weights;
+		std::vector<arma::sp_cx_mat> stages;
+		arma::vec durations;
+		arma::cx_vec psi = {1.0, 0.0};
+		double dt = totaltime / _steps;
+		isCorrect &= space.IntegratorStages(_integrator, nodes, weights);
+		for (unsigned int k = 0; k < _steps; k++)
+		{
+			isCorrect &= space.StageHamiltonians(H, nodes, weights, k * dt, dt, stages, durations);
+			for (unsigned int s = 0; s < stages.size(); s++)
+				psi = arma::expmat(arma::cx_double(0.0, -durations(s)) * arma::cx_mat(stages[s])) * psi;
+		}
+		return psi;
+	};
+
+	// Perform the test
+	arma::cx_vec reference = propagate("magnus4", 4000);
+	double errorPiecewise = arma::norm(propagate("piecewise", 100) - reference);
+	double errorMagnus = arma::norm(propagate("magnus4", 100) - reference);
+	isCorrect &= (errorMagnus < 1e-2 * errorPiecewise);
+
+	// Unknown integrators are rejected
+	arma::vec nodes;
+	arma::mat weights;
+	isCorrect &= !space.IntegratorStages("euler", nodes, weights);
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the time-dependent reaction operators of the stages of the integrators
+// Test: A transition with a rate that changes linearly in time. The fourth order Magnus integrator uses the reaction operator at its nodes, and the stages
+// together must give the integral over the time step, i.e. the reaction operator at the middle of the step. The piecewise integrator uses the start of the step.
+bool test_spinapi_spinspace_stagereactionoperators()
+{
+	// Setup objects for the test
+	const std::string ratefile = "test_spinapi_stagereactionoperators_rate.txt";
+	{
+		std::ofstream filehandle(ratefile);
+		filehandle << "time rate\n0 1e-3\n100 3e-3\n";
+	}
+
+	auto spin1 = std::make_shared<SpinAPI::Spin>("electron", "spin=1/2;");
+	auto state1 = std::make_shared<SpinAPI::State>("state1", "spin(electron)=|1/2>;");
+
+	auto spinsys = std::make_shared<SpinAPI::SpinSystem>("System");
+	spinsys->Add(spin1);
+	spinsys->Add(state1);
+	auto transition1 = std::make_shared<SpinAPI::Transition>("transition1", "sourcestate=state1;trajectory=" + ratefile + ";", spinsys);
+	spinsys->Add(transition1);
+
+	bool isCorrect = state1->ParseFromSystem(*spinsys);
+	isCorrect &= !IsStatic(*transition1);
+
+	SpinAPI::SpinSpace space(*spinsys);
+	space.UseSuperoperatorSpace(false);
+
+	double time = 20.0;
+	double dt = 10.0;
+	arma::vec nodes;
+	arma::mat weights;
+	std::vector<arma::sp_cx_mat> stages;
+	arma::sp_cx_mat Kstart;
+	arma::sp_cx_mat Kmiddle;
+	space.SetTime(time);
+	isCorrect &= space.DynamicTotalReactionOperator(Kstart);
+	space.SetTime(time + 0.5 * dt);
+	isCorrect &= space.DynamicTotalReactionOperator(Kmiddle);
+
+	// Perform the test
+	isCorrect &= space.IntegratorStages("piecewise", nodes, weights);
+	isCorrect &= space.StageReactionOperators(nodes, weights, time, dt, stages);
+	isCorrect &= (stages.size() == 1);
+	if (stages.size() == 1)
+		isCorrect &= equal_matrices(arma::cx_mat(stages[0]), arma::cx_mat(Kstart), 1e-12);
+
+	isCorrect &= space.IntegratorStages("magnus4", nodes, weights);
+	isCorrect &= space.StageReactionOperators(nodes, weights, time, dt, stages);
+	isCorrect &= (stages.size() == 2);
+	if (stages.size() == 2)
+	{
+		arma::cx_mat integral = arma::accu(weights.row(0)) * arma::cx_mat(stages[0]) + arma::accu(weights.row(1)) * arma::cx_mat(stages[1]);
+		isCorrect &= equal_matrices(integral, arma::cx_mat(Kmiddle), 1e-12);
+		isCorrect &= (arma::norm(arma::cx_mat(stages[0] - stages[1])) > 1e-6 * arma::norm(arma::cx_mat(Kmiddle)));
+	}
+
+	std::remove(ratefile.c_str());
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the ChebyshevPropagator class
+// Test: Checks that the estimated spectral bounds contain the spectrum, and propagates a block of states for short, long and negative time steps,
+// comparing with the dense propagator.
+bool test_spinapi_chebyshevpropagator_propagation()
+{
+	// Setup objects for the test
+	auto spin1 = std::make_shared<SpinAPI::Spin>("spin1", "spin=1/2;");
+	auto spin2 = std::make_shared<SpinAPI::Spin>("spin2", "spin=1/2;");
+	auto spin3 = std::make_shared<SpinAPI::Spin>("spin3", "spin=1;");
+
+	auto interaction1 = std::make_shared<SpinAPI::Interaction>("interaction1", "type=doublespin;group1=spin1;group2=spin3;");
+	auto interaction2 = std::make_shared<SpinAPI::Interaction>("interaction2", "type=zeeman;group1=spin1,spin2;field=0.1 0.2 0.3;");
+
+	SpinAPI::SpinSystem spinsys("System");
+	spinsys.Add(spin1);
+	spinsys.Add(spin2);
+	spinsys.Add(spin3);
+	spinsys.Add(interaction1);
+	spinsys.Add(interaction2);
+	spinsys.ValidateInteractions();
+
+	SpinAPI::SpinSpace space(spinsys);
+
+	arma::sp_cx_mat H;
+	bool isCorrect = space.Hamiltonian(H);
+
+	// The bounds must contain the whole spectrum, otherwise the expansion diverges
+	double lowerBound = 0.0;
+	double upperBound = 0.0;
+	isCorrect &= SpinAPI::SpectralBounds(H, lowerBound, upperBound);
+	arma::vec eigenvalues = arma::eig_sym(arma::cx_mat(H));
+	isCorrect &= (lowerBound <= eigenvalues.min() && upperBound >= eigenvalues.max());
+
+	arma::cx_mat states(H.n_rows, 3);
+	for (unsigned int r = 0; r < states.n_rows; r++)
+		for (unsigned int c = 0; c < states.n_cols; c++)
+			states(r, c) = arma::cx_double(std::cos(r + 2.0 * c), std::sin(3.0 * r - c));
+
+	// Perform the test
+	SpinAPI::ChebyshevPropagator chebyshev(H, lowerBound, upperBound, 1e-14);
+	std::vector<double> timesteps = {0.7, 50.0, -3.0};
+	for (auto dt : timesteps)
+	{
+		isCorrect &= chebyshev.SetTimestep(dt);
+		arma::cx_mat P = arma::expmat(arma::cx_double(0.0, -dt) * arma::cx_mat(H));
+		isCorrect &= equal_matrices(chebyshev.Propagate(states), arma::cx_mat(P * states), 1e-8);
+	}
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
+// Tests the ChebyshevPropagator class
+// Test: A matrix that is larger than a Krylov space of a few steps, with an extremal eigenvalue in a block that is decoupled from the rest.
+// The spectral bounds must contain the whole spectrum, and the propagation is compared with the dense propagator.
+bool test_spinapi_chebyshevpropagator_largematrix()
+{
+	// Setup objects for the test
+	const unsigned int n = 80;
+	arma::sp_cx_mat H(n, n);
+	for (unsigned int k = 0; k < n - 2; k++)
+	{
+		H(k, k) = arma::cx_double(std::sin(1.7 * k), 0.0);
+		if (k + 1 < n - 2)
+		{
+			H(k, k + 1) = arma::cx_double(0.3 * std::cos(k + 0.5), 0.2 * std::sin(2.0 * k));
+			H(k + 1, k) = std::conj(H(k, k + 1));
+		}
+	}
+
+	// The decoupled block holds the extremal eigenvalues
+	H(n - 2, n - 2) = arma::cx_double(6.0, 0.0);
+	H(n - 1, n - 1) = arma::cx_double(-5.0, 0.0);
+	H(n - 2, n - 1) = arma::cx_double(0.0, 0.5);
+	H(n - 1, n - 2) = arma::cx_double(0.0, -0.5);
+
+	double lowerBound = 0.0;
+	double upperBound = 0.0;
+	bool isCorrect = SpinAPI::SpectralBounds(H, lowerBound, upperBound);
+	arma::vec eigenvalues = arma::eig_sym(arma::cx_mat(H));
+	isCorrect &= (lowerBound <= eigenvalues.min() && upperBound >= eigenvalues.max());
+
+	arma::cx_mat states(n, 2);
+	for (unsigned int r = 0; r < states.n_rows; r++)
+		for (unsigned int c = 0; c < states.n_cols; c++)
+			states(r, c) = arma::cx_double(std::cos(r + 2.0 * c), std::sin(3.0 * r - c));
+
+	// Perform the test
+	SpinAPI::ChebyshevPropagator chebyshev(H, lowerBound, upperBound, 1e-14);
+	std::vector<double> timesteps = {0.3, 20.0};
+	for (auto dt : timesteps)
+	{
+		isCorrect &= chebyshev.SetTimestep(dt);
+		arma::cx_mat P = arma::expmat(arma::cx_double(0.0, -dt) * arma::cx_mat(H));
+		isCorrect &= equal_matrices(chebyshev.Propagate(states), arma::cx_mat(P * states), 1e-8);
+	}
+
+	// Return the result
+	return isCorrect;
+}
+//////////////////////////////////////////////////////////////////////////////
 // Add all the SpinAPI test cases
 void AddSpinAPITests(std::vector<test_case> &_cases)
 {
@@ -1440,9 +2640,11 @@ void AddSpinAPITests(std::vector<test_case> &_cases)
 	_cases.push_back(test_case("Spin subspace functions - completion from state", test_spinapi_subspacefuncs_extendbystate));
 	_cases.push_back(test_case("Spin subspace functions - completion from spin system", test_spinapi_subspacefuncs_extendbyspinsys));
 	_cases.push_back(test_case("SpinSpace::CreateOperator - comparing sparse and dense version", test_spinapi_spinspace_sparsevsdense_createoperator));
+	_cases.push_back(test_case("SpinSpace::CreateOperator - cached and Kronecker-structured operators", test_spinapi_spinspace_cachedandkroneckeroperators));
 	_cases.push_back(test_case("SpinSpace::Hamiltonian - comparing sparse and dense version", test_spinapi_spinspace_sparsevsdense_hamiltonian));
 	_cases.push_back(test_case("SpinSpace::StaticHamiltonian - comparing sparse and dense version", test_spinapi_spinspace_sparsevsdense_statichamiltonian));
 	_cases.push_back(test_case("SpinSpace::DynamicHamiltonian - comparing sparse and dense version", test_spinapi_spinspace_sparsevsdense_dynamichamiltonian));
+	_cases.push_back(test_case("SpinSpace::Hamiltonian - incremental assembly from cached interaction operators", test_spinapi_spinspace_incrementalhamiltonian));
 	_cases.push_back(test_case("SpinSpace::InteractionOperator - comparing sparse and dense version", test_spinapi_spinspace_sparsevsdense_interactionoperator));
 	_cases.push_back(test_case("SpinSpace::OperatorToSuperspace - comparing sparse and dense version", test_spinapi_spinspace_sparsevsdense_operatortosuperspace));
 	_cases.push_back(test_case("SpinSpace::OperatorFromSuperspace - comparing sparse and dense version", test_spinapi_spinspace_sparsevsdense_operatorfromsuperspace));
@@ -1454,5 +2656,22 @@ void AddSpinAPITests(std::vector<test_case> &_cases)
 	_cases.push_back(test_case("SpinAPI::SpinSpace basis reordering methods (sparse matrix)", test_spinapi_reorderbasis_sparsematrix));
 	_cases.push_back(test_case("SpinAPI::SpinSpace spin management (Add, Contains, Remove)", test_spinapi_spinspace_spinmanagement1));
 	_cases.push_back(test_case("SpinAPI::SpinSpace spin management (Vector Add,Vector Contains, Clear)", test_spinapi_spinspace_spinmanagement2));
+	_cases.push_back(test_case("SpinAPI::Trajectory text and binary loading, and row searches", test_spinapi_trajectory_textandbinary));
+	_cases.push_back(test_case("SpinAPI::KrylovPropagator propagation with a Liouvillian compared to the dense propagator", test_spinapi_krylovpropagator_liouvillian));
+	_cases.push_back(test_case("SpinAPI::ObservableSet expectation values compared to the trace", test_spinapi_observableset_expectationvalues));
+	_cases.push_back(test_case("SpinAPI::SpinSpace block structure and block-wise diagonalization", test_spinapi_spinspace_blockeigendecomposition));
+	_cases.push_back(test_case("SpinAPI::SpinSpace block-wise solve and matrix exponential", test_spinapi_spinspace_blocksolveandexponential));
+	_cases.push_back(test_case("SpinAPI::SpinSpace::PartialEigenDecomposition compared to the full diagonalization", test_spinapi_spinspace_partialeigendecomposition));
+	_cases.push_back(test_case("SpinAPI::SpinSpace::PartialEigenDecomposition with a level crossing between blocks", test_spinapi_spinspace_partialeigendecomposition_crossing));
+	_cases.push_back(test_case("SpinAPI::Spin groups of equivalent spins", test_spinapi_spin_equivalentspins));
+	_cases.push_back(test_case("SpinAPI::SpinSpace::SolveYields - direct and adjoint formulation", test_spinapi_spinspace_solveyields));
+	_cases.push_back(test_case("SpinAPI::SpinSpace::UncoupledPairProjections", test_spinapi_spinspace_uncoupledpairprojections));
+	_cases.push_back(test_case("SpinAPI::AffineOperator compared to the sum of the terms", test_spinapi_affineoperator_evaluate));
+	_cases.push_back(test_case("SpinAPI::SpinSpace::DynamicHamiltonianTerms compared to DynamicHamiltonian", test_spinapi_spinspace_dynamichamiltonianterms));
+	_cases.push_back(test_case("SpinAPI::SpinSpace::DynamicHamiltonianTerms with spin trajectories compared to DynamicHamiltonian", test_spinapi_spinspace_dynamichamiltonianterms_spintrajectory));
+	_cases.push_back(test_case("SpinAPI::SpinSpace fourth order Magnus integrator compared to piecewise constant Hamiltonians", test_spinapi_spinspace_magnusintegrator));
+	_cases.push_back(test_case("SpinAPI::SpinSpace reaction operators of the integrator stages for a time-dependent rate", test_spinapi_spinspace_stagereactionoperators));
+	_cases.push_back(test_case("SpinAPI::ChebyshevPropagator propagation compared to the dense propagator", test_spinapi_chebyshevpropagator_propagation));
+	_cases.push_back(test_case("SpinAPI::ChebyshevPropagator spectral bounds and propagation of a large matrix", test_spinapi_chebyshevpropagator_largematrix));
 }
 //////////////////////////////////////////////////////////////////////////////
@@ -9,11 +9,15 @@
 #define MAX_THREADS 48
 //////////////////////////////////////////////////////////////////////////////
 #include <iostream>
+#include <algorithm>
 #include "Settings.h"
 #include "MSDParser.h"
 #include "RunSection.h"
 #include "FileReader.h"
+#include "OrientationGrid.h"
+#include "OutputAverage.h"
 #include <fstream>
+#include <memory>
 #include <unistd.h>
 
 //////////////////////////////////////////////////////////////////////////////
@@ -22,8 +26,25 @@ extern "C" void openblas_set_num_threads(int);
 // #endif
 // #ifdef USE_OPENMP
 extern "C" void omp_set_num_threads(int);
+extern "C" int omp_get_max_threads();
 // #endif
 //////////////////////////////////////////////////////////////////////////////
+// Loads the input file again into another RunSection, e.g. for the workers of "--parallel-steps"
+// The FileReader keeps track of the included files and definitions, which are reset to their state before the first load
+bool LoadInputCopy(const std::string &_inputfile, const std::map<std::string, std::string> &_definitions, RunSection::RunSection &_rs)
+{
+	MSDParser::FileReader::Reset(_definitions);
+	MSDParser::MSDParser parser(_inputfile);
+	if (!parser.Load())
+	{
+		std::cout << "ERROR: Failed to open file \"" << _inputfile << "\"!" << std::endl;
+		return false;
+	}
+
+	parser.FillRunSection(_rs);
+	return true;
+}
+//////////////////////////////////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
 	const std::string MolSpin_version = "v2.0";
@@ -71,6 +92,12 @@ int main(int argc, char **argv)
 		std::cout << "    -p\n    --threads" << std::endl;
 		std::cout << "             Specify the number of threads/processor cores to use." << std::endl;
 		std::cout << "             Example: molspin -p 24 myfile.msd" << std::endl;
+		std::cout << "    -ps\n    --parallel-steps" << std::endl;
+		std::cout << "             Run the specified number of steps at the same time, each on its own copy of the input." << std::endl;
+		std::cout << "             Only useful if the steps are independent, i.e. if the Actions alone determine each step." << std::endl;
+		std::cout << "             Data is still written in step order." << std::endl;
+		std::cout << "             With an orientation grid in the Settings object, this is the number of orientations run at the same time." << std::endl;
+		std::cout << "             Example: molspin -ps 8 myfile.msd" << std::endl;
 		std::cout << "    -r\n    --first-step" << std::endl;
 		std::cout << "             Specify which step to start from (if you don't want to start from step 0)." << std::endl;
 		std::cout << "             Example: molspin -r 5 myfile.msd" << std::endl;
@@ -128,6 +155,7 @@ int main(int argc, char **argv)
 	unsigned int reportSteps = 1;
 	unsigned int firstStep = 1;
 	unsigned int stepLimit = 0;
+	unsigned int parallelSteps = 1;
 	std::string checkpoint = "";
 
 	// -----------------------------------------------------
@@ -183,6 +211,39 @@ int main(int argc, char **argv)
 				// Don't try to parse the number of threads as a commandline parameter
 				i++;
 			}
+			else if (strargv.compare("-ps") == 0 || strargv.compare("--parallel-steps") == 0)
+			{
+				// Check whether a number is specified
+				if (argc - 2 <= i)
+				{
+					std::cout << "# - Warning: Either number-of-parallel-steps or inputfile specification is missing!" << std::endl;
+					std::cout << "#   Example of usage of -ps/--parallel-steps:\n#   molspin -ps 8 example.msd" << std::endl;
+					return 0;
+				}
+
+				// Set the number of steps to run at the same time
+				try
+				{
+					int value = std::stoi(argv[i + 1]);
+
+					if (value >= 1 && value <= MAX_THREADS)
+					{
+						parallelSteps = value;
+						std::cout << "# - Number of parallel steps set to " << parallelSteps << "." << std::endl;
+					}
+					else
+					{
+						std::cout << "# - Could not set number of parallel steps to " << value << "! Please specify a number from 1 to " << MAX_THREADS << "." << std::endl;
+					}
+				}
+				catch (const std::exception &) // Catch any conversion errors
+				{
+					std::cout << "# - Could not set number of parallel steps to " << argv[i + 1] << "! Please specify a valid number from 1 to " << MAX_THREADS << "." << std::endl;
+				}
+
+				// Don't try to parse the number of parallel steps as a commandline parameter
+				i++;
+			}
 			else if (strargv.compare("-s") == 0 || strargv.compare("--silent") == 0)
 			{
 				silentMode = true;
@@ -376,6 +437,9 @@ int main(int argc, char **argv)
 	// END of commandline parsing
 	// -----------------------------------------------------
 
+	// The definitions given on the commandline, which are needed if the input is loaded again (e.g. for "--parallel-steps")
+	const auto commandlineDefinitions = MSDParser::FileReader::GetDefinitions();
+
 	RunSection::RunSection rs;
 	rs.SetOverruleAppend(appendMode);
 	rs.SetNoCalculationsMode(noCalculations);
@@ -465,54 +529,296 @@ int main(int argc, char **argv)
 	// If we should do the calculations, do them
 	if (!noCalculations)
 	{
-		// Perform steps if we should start later than at step 1
-		for (unsigned int i = 1; i < firstStep && i <= steps; i++)
+		if (!rs.GetSettings()->OrientationGrid().empty())
 		{
-			rs.Step(i + 1);
-		}
+			// Determine the last step to run
+			unsigned int lastStep = steps;
+			if (stepLimit > 0 && firstStep + stepLimit - 1 < steps)
+				lastStep = firstStep + stepLimit - 1;
+
+			// The vectors to rotate, which are the writable interaction fields unless they were specified
+			auto actionVectors = rs.GetActionVectors();
+			auto names = rs.GetSettings()->OrientationVectors();
+			if (names.empty())
+			{
+				for (auto i = actionVectors.cbegin(); i != actionVectors.cend(); i++)
+					if (!i->second.IsReadonly() && i->first.size() > 6 && i->first.compare(i->first.size() - 6, 6, ".field") == 0)
+						names.push_back(i->first);
+			}
 
-		for (unsigned int i = firstStep; i <= steps; i++)
-		{
-			// Check that we have not exceeded the step limit (if any)
-			if (stepLimit > 0 && i - firstStep >= stepLimit)
+			for (auto i = names.cbegin(); i != names.cend(); i++)
+			{
+				auto j = actionVectors.find(*i);
+				if (j == actionVectors.end() || j->second.IsReadonly())
+				{
+					std::cout << "ERROR: Cannot rotate the ActionVector \"" << (*i) << "\" for the orientation average, it does not exist or is readonly!" << std::endl;
+					return 1;
+				}
+
+				if (!silentMode)
+					std::cout << "# Rotating ActionVector \"" << (*i) << "\"." << std::endl;
+			}
+
+			if (names.empty())
+				std::cout << "# Warning: No ActionVectors to rotate, all orientations will give the same result!" << std::endl;
+
+			// The directions are those of the first vector, and the relative orientation of several vectors also needs the angles about it
+			unsigned int gammaPoints = rs.GetSettings()->OrientationGammaPoints();
+			if (gammaPoints == 0)
+				gammaPoints = (names.size() > 1) ? rs.GetSettings()->DefaultOrientationGammaPoints : 1;
+
+			RunSection::OrientationGrid grid;
+			if (!grid.Create(rs.GetSettings()->OrientationGrid(), rs.GetSettings()->OrientationPoints(), gammaPoints))
 			{
-				steps = stepLimit; // This is the number of steps that was run, and which is used to calculate the average time per step
-				break;
+				std::cout << "ERROR: Failed to create a " << rs.GetSettings()->OrientationGrid() << " grid with " << rs.GetSettings()->OrientationPoints() << " orientations!" << std::endl;
+				std::cout << "       Lebedev grids are available with up to 110 points, use a ZCW grid for more orientations." << std::endl;
+				return 1;
 			}
 
-			// Information about the step we are about to run
-			if (!silentMode && i % reportSteps == 0)
+			// The number of orientations to run at the same time, each on its own RunSection loaded from the same input
+			unsigned int workerCount = (parallelSteps > 1) ? parallelSteps : static_cast<unsigned int>(std::max(1, omp_get_max_threads()));
+			workerCount = std::min(workerCount, grid.Size());
+
+			if (!silentMode)
 			{
-				std::cout << "# Now running step " << i << "/" << steps << "." << std::endl;
+				std::cout << "# Averaging over " << grid.Size() << " orientations of a " << rs.GetSettings()->OrientationGrid() << " grid";
+				if (grid.GammaPoints() > 1)
+					std::cout << " with " << grid.GammaPoints() << " angles about each direction";
+				std::cout << ", " << workerCount << " at a time." << std::endl;
 				std::cout << hline << std::endl;
 			}
 
-			// Start the timer
-			timer.tic();
+			// Data is buffered with full precision, as the buffers are averaged before they are written
+			// NOTE: The input is loaded sequentially, as the parser is not thread-safe
+			std::vector<std::unique_ptr<RunSection::RunSection>> workers;
+			std::vector<unsigned int> workerSteps; // The step that the ActionTargets of each worker currently correspond to
+			std::vector<std::vector<RunSection::ActionVector>> workerVectors;
+			for (unsigned int w = 0; w < workerCount; w++)
+			{
+				workers.push_back(std::unique_ptr<RunSection::RunSection>(new RunSection::RunSection()));
+				workers.back()->SetBufferOutputMode(true);
+				workers.back()->SetBufferPrecision(17);
+				workerSteps.push_back(1);
+
+				if (!LoadInputCopy(argv[argc - 1], commandlineDefinitions, *(workers.back())))
+					return 1;
+
+				auto workerActionVectors = workers.back()->GetActionVectors();
+				workerVectors.push_back(std::vector<RunSection::ActionVector>());
+				for (auto i = names.cbegin(); i != names.cend(); i++)
+					workerVectors.back().push_back(workerActionVectors.at(*i));
+			}
 
-			// Run all the tasks in the RunSection - skip some if we have a checkpoint
-			if (hasCheckpoint)
+			for (unsigned int i = firstStep; i <= lastStep; i++)
 			{
-				rs.Run(checkpoint, i);
+				// Information about the step we are about to run
+				if (!silentMode && i % reportSteps == 0)
+				{
+					std::cout << "# Now running step " << i << "/" << steps << "." << std::endl;
+					std::cout << hline << std::endl;
+				}
+
+				// Start the timer
+				timer.tic();
+
+				// Each worker averages the output over its share of the orientations
+				std::vector<std::vector<RunSection::OutputAverage>> averages(workers.size());
+				std::vector<std::vector<std::string>> logs(workers.size());
+				std::vector<int> consistent(workers.size(), 1); // Not a vector<bool>, as the workers write to it at the same time
+#pragma omp parallel for num_threads(workers.size()) schedule(static, 1)
+				for (int w = 0; w < static_cast<int>(workers.size()); w++)
+				{
+					// Replay the Actions to bring the ActionTargets of the worker to the requested step
+					for (; workerSteps[w] < i; workerSteps[w]++)
+						workers[w]->Step(workerSteps[w] + 1);
+
+					// The vectors before the rotation, which are restored before the next step
+					std::vector<arma::vec> initial;
+					for (auto v = workerVectors[w].cbegin(); v != workerVectors[w].cend(); v++)
+						initial.push_back(v->Get());
+
+					std::vector<std::string> taskLogs;
+					std::vector<std::string> taskData;
+					for (unsigned int o = w; o < grid.Size(); o += workers.size())
+					{
+						// The first vector is rotated into the direction of the grid point
+						arma::mat R = initial.empty() ? grid.Rotation(o) : grid.Rotation(o, initial.front());
+						for (unsigned int v = 0; v < workerVectors[w].size(); v++)
+							workerVectors[w][v].Set(R * initial[v]);
+
+						// Run all the tasks in the RunSection - skip some if we have a checkpoint
+						if (hasCheckpoint && i == firstStep)
+							workers[w]->Run(checkpoint, i);
+						else
+							workers[w]->Run(i);
+
+						workers[w]->TakeBufferedOutput(taskLogs, taskData);
+						averages[w].resize(taskData.size());
+						for (unsigned int t = 0; t < taskData.size(); t++)
+							consistent[w] = averages[w][t].Add(taskData[t], grid.Weight(o)) && consistent[w];
+
+						// Only the log of the first orientation is kept, the others are very similar
+						if (o == 0)
+							logs[w] = taskLogs;
+					}
+
+					for (unsigned int v = 0; v < workerVectors[w].size(); v++)
+						workerVectors[w][v].Set(initial[v]);
+				}
 				hasCheckpoint = false; // We only use the checkpoint for one step
+
+				// Reduce the averages of the workers in a fixed order and write the result to the tasks of "rs"
+				std::vector<std::string> data(averages.front().size());
+				for (unsigned int t = 0; t < data.size(); t++)
+				{
+					for (unsigned int w = 1; w < workers.size(); w++)
+						consistent[0] = averages.front()[t].Add(averages[w][t]) && consistent[0];
+					data[t] = averages.front()[t].Str();
+				}
+				rs.WriteBufferedOutput(logs.front(), data);
+
+				if (std::find(consistent.cbegin(), consistent.cend(), 0) != consistent.cend())
+					std::cout << "# Warning: The output of some tasks differed in layout between the orientations and could only be partially averaged." << std::endl;
+
+				// Get the time for the step
+				runtime = timer.toc();
+				totalruntime += runtime;
+
+				// Show time for the step after it finished
+				if (!silentMode && i % reportSteps == 0)
+				{
+					std::cout << hline << std::endl;
+					std::cout << "# Finished with step " << i << "/" << steps << " in " << runtime << " seconds." << std::endl;
+				}
 			}
-			else
+
+			// This is the number of steps that was run, and which is used to calculate the average time per step
+			steps = lastStep - firstStep + 1;
+		}
+		else if (parallelSteps > 1)
+		{
+			// Determine the last step to run
+			unsigned int lastStep = steps;
+			if (stepLimit > 0 && firstStep + stepLimit - 1 < steps)
+				lastStep = firstStep + stepLimit - 1;
+
+			// Each step is run on its own RunSection, loaded from the same input. Task output is kept in memory and
+			// written to the tasks of "rs" (which owns the output files) once all steps in a batch are done.
+			// NOTE: The input is loaded sequentially, as the parser is not thread-safe
+			std::vector<std::unique_ptr<RunSection::RunSection>> workers;
+			std::vector<unsigned int> workerSteps; // The step that the ActionTargets of each worker currently correspond to
+			for (unsigned int w = 0; w < parallelSteps && firstStep + w <= lastStep; w++)
 			{
-				rs.Run(i);
+				workers.push_back(std::unique_ptr<RunSection::RunSection>(new RunSection::RunSection()));
+				workers.back()->SetBufferOutputMode(true);
+				workerSteps.push_back(1);
+
+				if (!LoadInputCopy(argv[argc - 1], commandlineDefinitions, *(workers.back())))
+					return 1;
 			}
 
-			// Advance to the next calculation step
-			rs.Step(i + 1);
+			for (unsigned int batch = firstStep; batch <= lastStep; batch += workers.size())
+			{
+				unsigned int batchSize = std::min(static_cast<unsigned int>(workers.size()), lastStep - batch + 1);
+
+				// Information about the steps we are about to run
+				if (!silentMode)
+				{
+					std::cout << "# Now running steps " << batch << "-" << (batch + batchSize - 1) << "/" << steps << "." << std::endl;
+					std::cout << hline << std::endl;
+				}
+
+				// Start the timer
+				timer.tic();
+
+				// Run the steps of the batch at the same time. Nested OpenMP regions within the tasks run on a single thread.
+#pragma omp parallel for num_threads(batchSize) schedule(static, 1)
+				for (int w = 0; w < static_cast<int>(batchSize); w++)
+				{
+					unsigned int step = batch + w;
+
+					// Replay the Actions to bring the ActionTargets of the worker to the requested step
+					for (; workerSteps[w] < step; workerSteps[w]++)
+						workers[w]->Step(workerSteps[w] + 1);
+
+					// Run all the tasks in the RunSection - skip some if we have a checkpoint
+					if (hasCheckpoint && step == firstStep)
+						workers[w]->Run(checkpoint, step);
+					else
+						workers[w]->Run(step);
+				}
+				hasCheckpoint = false; // We only use the checkpoint for one step
+
+				// Write the output in step order
+				for (unsigned int w = 0; w < batchSize; w++)
+					workers[w]->FlushBufferedOutput(rs);
 
-			// Get the time for the step
-			runtime = timer.toc();
-			totalruntime += runtime;
+				// Get the time for the batch
+				runtime = timer.toc();
+				totalruntime += runtime;
 
-			// Show time for the step after it finished
-			if (!silentMode && i % reportSteps == 0)
+				// Show time for the steps after they finished
+				if (!silentMode)
+				{
+					std::cout << hline << std::endl;
+					std::cout << "# Finished with steps " << batch << "-" << (batch + batchSize - 1) << "/" << steps << " in " << runtime << " seconds." << std::endl;
+				}
+			}
+
+			// This is the number of steps that was run, and which is used to calculate the average time per step
+			steps = lastStep - firstStep + 1;
+		}
+		else
+		{
+			// Perform steps if we should start later than at step 1
+			for (unsigned int i = 1; i < firstStep && i <= steps; i++)
 			{
-				std::cout << hline << std::endl;
-				std::cout << "# Finished with step " << i << "/" << steps << " in " << runtime << " seconds." << std::endl;
+				rs.Step(i + 1);
+			}
+
+			for (unsigned int i = firstStep; i <= steps; i++)
+			{
+				// Check that we have not exceeded the step limit (if any)
+				if (stepLimit > 0 && i - firstStep >= stepLimit)
+				{
+					steps = stepLimit; // This is the number of steps that was run, and which is used to calculate the average time per step
+					break;
+				}
+
+				// Information about the step we are about to run
+				if (!silentMode && i % reportSteps == 0)
+				{
+					std::cout << "# Now running step " << i << "/" << steps << "." << std::endl;
+					std::cout << hline << std::endl;
+				}
+
+				// Start the timer
+				timer.tic();
+
+				// Run all the tasks in the RunSection - skip some if we have a checkpoint
+				if (hasCheckpoint)
+				{
+					rs.Run(checkpoint, i);
+					hasCheckpoint = false; // We only use the checkpoint for one step
+				}
+				else
+				{
+					rs.Run(i);
+				}
+
+				// Advance to the next calculation step
+				rs.Step(i + 1);
+
+				// Get the time for the step
+				runtime = timer.toc();
+				totalruntime += runtime;
+
+				// Show time for the step after it finished
+				if (!silentMode && i % reportSteps == 0)
+				{
+					std::cout << hline << std::endl;
+					std::cout << "# Finished with step " << i << "/" << steps << " in " << runtime << " seconds." << std::endl;
+				}
 			}
 		}
 